@@ -0,0 +1,37 @@
+#include "activation.h"
+#include "kernels/dispatch.h"
+
+// Применить активацию к массиву на месте
+void applyActivation(Activation activation, float* data, size_t size) {
+    switch (activation) {
+    case Activation::None:
+        break;
+    case Activation::ReLU:
+        kernels().relu(data, size);
+        break;
+    case Activation::Sigmoid:
+        kernels().sigmoid(data, size);
+        break;
+    case Activation::Tanh:
+        kernels().tanh(data, size);
+        break;
+    }
+}
+
+// Умножить градиент на производную активации.
+// Все поддерживаемые производные выражаются через выход y, поэтому вход кэшировать не нужно.
+void activationBackward(Activation activation, const float* output, float* grad, size_t size) {
+    switch (activation) {
+    case Activation::None:
+        break;
+    case Activation::ReLU:
+        for (size_t i = 0; i < size; ++i) grad[i] = output[i] > 0.0f ? grad[i] : 0.0f;
+        break;
+    case Activation::Sigmoid:
+        for (size_t i = 0; i < size; ++i) grad[i] *= output[i] * (1.0f - output[i]);
+        break;
+    case Activation::Tanh:
+        for (size_t i = 0; i < size; ++i) grad[i] *= 1.0f - output[i] * output[i];
+        break;
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef ACTIVATION_H
+#define ACTIVATION_H
+
+#include <cstddef>
+
+// Поэлементные функции активации, которые можно встроить в эпилог GEMM
+enum class Activation {
+    None,
+    ReLU,
+    Sigmoid,
+    Tanh
+};
+
+// Применить активацию к массиву на месте
+void applyActivation(Activation activation, float* data, size_t size);
+
+// Умножить градиент на производную активации, выраженную через её выход
+void activationBackward(Activation activation, const float* output, float* grad, size_t size);
+
+#endif // ACTIVATION_H
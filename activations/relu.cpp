@@ -1,33 +1,147 @@
 #include "relu.h"
+#include "layers/serialization.h"
+#include <algorithm>
+#include <stdexcept>
 
 // Конструктор по умолчанию
-ReLU::ReLU() : input_cache({}) {} // Инициализируем input_cache с пустой формой
+ReLU::ReLU() : mask_size(0) {}
+
+// Применить ReLU, запоминая знак входа в битовой маске
+void ReLU::apply(const float* input, float* output, size_t size) {
+    mask.assign((size + 63) / 64, 0);
+    mask_size = size;
+    for (size_t block = 0; block < size; block += 64) {
+        size_t end = std::min(size, block + 64);
+        uint64_t bits = 0;
+        for (size_t i = block; i < end; ++i) {
+            bool positive = input[i] > 0.0f;
+            bits |= static_cast<uint64_t>(positive) << (i - block);
+            output[i] = positive ? input[i] : 0.0f;
+        }
+        mask[block / 64] = bits;
+    }
+}
 
 // Прямой проход
 Tensor ReLU::forward(const Tensor& input) {
-    // Кэшируем входные данные для использования в backward pass
-    input_cache = input;
-
-    // Создаем тензор для выходных данных
     Tensor output(input.shape());
+    apply(input.data(), output.data(), input.size());
+    return output;
+}
 
-    // Применяем ReLU к каждому элементу входного тензора
+// Прямой проход на месте
+void ReLU::forwardInPlace(Tensor& data) {
+    apply(data.data(), data.data(), data.size());
+}
+
+// Вывод: маска не нужна
+Tensor ReLU::infer(const Tensor& input, LayerState* state) const {
+    Tensor output(input.shape());
+    const float* in = input.data();
+    float* out = output.data();
     for (size_t i = 0; i < input.size(); ++i) {
-        output({i}) = std::max(0.0f, input({i}));
+        out[i] = in[i] > 0.0f ? in[i] : 0.0f;
     }
-
     return output;
 }
 
+// Вывод на месте
+void ReLU::inferInPlace(Tensor& data, LayerState* state) const {
+    applyActivation(Activation::ReLU, data.data(), data.size());
+}
+
 // Обратный проход
-Tensor ReLU::backward(const Tensor& grad_output, float learning_rate) {
-    // Создаем тензор для градиента по входным данным
-    Tensor grad_input(input_cache.shape());
+Tensor ReLU::backward(const Tensor& grad_output) {
+    Tensor grad_input = grad_output;
+    backwardInPlace(grad_input);
+    return grad_input;
+}
 
-    // Вычисляем градиент: grad_input = grad_output * (input > 0 ? 1 : 0)
-    for (size_t i = 0; i < input_cache.size(); ++i) {
-        grad_input({i}) = grad_output({i}) * (input_cache({i}) > 0 ? 1.0f : 0.0f);
+// Обратный проход на месте: grad = grad * (input > 0 ? 1 : 0)
+void ReLU::backwardInPlace(Tensor& grad) {
+    backwardInto(grad, grad);
+}
+
+// Форма выхода совпадает с формой входа
+std::vector<size_t> ReLU::inferShape(const std::vector<size_t>& input_shape) {
+    shape = input_shape;
+    return shape;
+}
+
+// Прямой проход в буфер модели
+void ReLU::forwardInto(Tensor& input, Tensor& output) {
+    if (output.size() != input.size()) {
+        throw std::invalid_argument("Output buffer must have the same size as the input.");
     }
+    apply(input.data(), output.data(), input.size());
+}
 
-    return grad_input;
+// Обратный проход в буфер модели (grad_input может совпадать с grad_output)
+void ReLU::backwardInto(Tensor& grad_output, Tensor& grad_input) {
+    if (grad_output.size() != mask_size || grad_input.size() != mask_size) {
+        throw std::invalid_argument("Gradient tensor must have the same size as the last input.");
+    }
+    const float* g = grad_output.data();
+    float* out = grad_input.data();
+    for (size_t i = 0; i < mask_size; ++i) {
+        out[i] = ((mask[i / 64] >> (i % 64)) & 1u) ? g[i] : 0.0f;
+    }
+}
+
+// Маска хранится в слое, поэтому выход можно писать поверх входа
+bool ReLU::supportsInPlace() const {
+    return true;
+}
+
+// Форма входа
+std::vector<size_t> ReLU::getInputShape() const {
+    return shape;
+}
+
+// Форма выхода
+std::vector<size_t> ReLU::getOutputShape() const {
+    return shape;
+}
+
+// ReLU можно встроить в эпилог Dense/Conv2D
+Activation ReLU::fusableActivation() const {
+    return Activation::ReLU;
+}
+
+// Копия слоя
+std::shared_ptr<Layer> ReLU::clone() const {
+    return std::make_shared<ReLU>(*this);
+}
+
+// Освободить кэши прямого прохода
+void ReLU::releaseCache() {
+    mask = std::vector<uint64_t>();
+    mask_size = 0;
+}
+
+// Байты кэшей прямого прохода
+size_t ReLU::cacheBytes() const {
+    return mask.size() * sizeof(uint64_t);
+}
+
+// Имя типа слоя
+std::string ReLU::getName() const {
+    return "ReLU";
+}
+
+// Обучаемых параметров нет
+size_t ReLU::getNumParameters() const {
+    return 0;
+}
+
+// Сохранение записи слоя
+void ReLU::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, 1);
+}
+
+// Загрузка записи слоя
+std::shared_ptr<Layer> ReLU::load(std::ifstream& file) {
+    checkLayerVersion("ReLU", readU32(file), 1);
+    return std::make_shared<ReLU>();
 }
@@ -1,36 +1,136 @@
 #include "sigmoid.h"
-#include <cmath>
+#include "layers/serialization.h"
+#include <stdexcept>
 
 // Конструктор по умолчанию
 Sigmoid::Sigmoid() : output_cache({}) {} // Инициализируем output_cache с пустой формой
 
 // Прямой проход
 Tensor Sigmoid::forward(const Tensor& input) {
-    // Создаем тензор для выходных данных
-    Tensor output(input.shape());
+    Tensor output = input;
+    forwardInPlace(output);
+    return output;
+}
 
-    // Применяем сигмоиду к каждому элементу входного тензора
-    for (size_t i = 0; i < input.size(); ++i) {
-        float x = input({i});
-        output({i}) = 1.0f / (1.0f + std::exp(-x));
-    }
+// Прямой проход на месте
+void Sigmoid::forwardInPlace(Tensor& data) {
+    applyActivation(Activation::Sigmoid, data.data(), data.size());
 
-    // Кэшируем выходные данные для использования в backward pass
-    output_cache = output;
+    // Кэшируем выходные данные: производная выражается через выход
+    output_cache = data;
+}
 
+// Вывод: выход не кэшируется
+Tensor Sigmoid::infer(const Tensor& input, LayerState* state) const {
+    Tensor output = input;
+    inferInPlace(output, state);
     return output;
 }
 
+// Вывод на месте
+void Sigmoid::inferInPlace(Tensor& data, LayerState* state) const {
+    applyActivation(Activation::Sigmoid, data.data(), data.size());
+}
+
 // Обратный проход
-Tensor Sigmoid::backward(const Tensor& grad_output, float learning_rate) {
-    // Создаем тензор для градиента по входным данным
-    Tensor grad_input(output_cache.shape());
-
-    // Вычисляем градиент: grad_input = grad_output * (output_cache * (1 - output_cache))
-    for (size_t i = 0; i < output_cache.size(); ++i) {
-        float output_val = output_cache({i});
-        grad_input({i}) = grad_output({i}) * output_val * (1.0f - output_val);
+Tensor Sigmoid::backward(const Tensor& grad_output) {
+    Tensor grad_input = grad_output;
+    backwardInPlace(grad_input);
+    return grad_input;
+}
+
+// Обратный проход на месте: grad = grad * (output * (1 - output))
+void Sigmoid::backwardInPlace(Tensor& grad) {
+    if (grad.size() != output_cache.size()) {
+        throw std::invalid_argument("Gradient tensor must have the same size as the last output.");
     }
+    activationBackward(Activation::Sigmoid, output_cache.data(), grad.data(), grad.size());
+}
 
-    return grad_input;
+// Форма выхода совпадает с формой входа
+std::vector<size_t> Sigmoid::inferShape(const std::vector<size_t>& input_shape) {
+    shape = input_shape;
+    return shape;
+}
+
+// Прямой проход в буфер модели: кэш — вид на выход
+void Sigmoid::forwardInto(Tensor& input, Tensor& output) {
+    if (output.size() != input.size()) {
+        throw std::invalid_argument("Output buffer must have the same size as the input.");
+    }
+    if (output.data() != input.data()) {
+        output.copyFrom(input);
+    }
+    applyActivation(Activation::Sigmoid, output.data(), output.size());
+    output_cache.alias(output);
+}
+
+// Обратный проход в буфер модели (grad_input может совпадать с grad_output)
+void Sigmoid::backwardInto(Tensor& grad_output, Tensor& grad_input) {
+    if (grad_input.data() != grad_output.data()) {
+        grad_input.copyFrom(grad_output);
+    }
+    backwardInPlace(grad_input);
+}
+
+// Вычисления на месте
+bool Sigmoid::supportsInPlace() const {
+    return true;
+}
+
+// Производная выражается через выход
+bool Sigmoid::backwardNeedsOutput() const {
+    return true;
+}
+
+// Форма входа
+std::vector<size_t> Sigmoid::getInputShape() const {
+    return shape;
+}
+
+// Форма выхода
+std::vector<size_t> Sigmoid::getOutputShape() const {
+    return shape;
+}
+
+// Сигмоиду можно встроить в эпилог Dense/Conv2D
+Activation Sigmoid::fusableActivation() const {
+    return Activation::Sigmoid;
+}
+
+// Копия слоя
+std::shared_ptr<Layer> Sigmoid::clone() const {
+    return std::make_shared<Sigmoid>(*this);
+}
+
+// Освободить кэши прямого прохода
+void Sigmoid::releaseCache() {
+    output_cache = Tensor({0});
+}
+
+// Байты кэшей прямого прохода
+size_t Sigmoid::cacheBytes() const {
+    return output_cache.size() * sizeof(float);
+}
+
+// Имя типа слоя
+std::string Sigmoid::getName() const {
+    return "Sigmoid";
+}
+
+// Обучаемых параметров нет
+size_t Sigmoid::getNumParameters() const {
+    return 0;
+}
+
+// Сохранение записи слоя
+void Sigmoid::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, 1);
+}
+
+// Загрузка записи слоя
+std::shared_ptr<Layer> Sigmoid::load(std::ifstream& file) {
+    checkLayerVersion("Sigmoid", readU32(file), 1);
+    return std::make_shared<Sigmoid>();
 }
@@ -12,9 +12,45 @@ public:
     Tensor forward(const Tensor& input) override;
 
     // Обратный проход: вычисляет градиент
-    Tensor backward(const Tensor& grad_output, float learning_rate) override;
+    Tensor backward(const Tensor& grad_output) override;
+
+    // Вывод без кэшей
+    Tensor infer(const Tensor& input, LayerState* state) const override;
+    void inferInPlace(Tensor& data, LayerState* state) const override;
+
+    // Копия слоя с собственными параметрами и кэшами
+    std::shared_ptr<Layer> clone() const override;
+
+    // Кэши прямого прохода
+    void releaseCache() override;
+    size_t cacheBytes() const override;
+
+    // Вычисления на месте
+    void forwardInPlace(Tensor& data) override;
+    void backwardInPlace(Tensor& grad) override;
+
+    // Форма выхода и проходы в буферы модели (выход может совпадать со входом)
+    std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) override;
+    void forwardInto(Tensor& input, Tensor& output) override;
+    void backwardInto(Tensor& grad_output, Tensor& grad_input) override;
+    bool supportsInPlace() const override;
+    bool backwardNeedsOutput() const override;
+    std::vector<size_t> getInputShape() const override;
+    std::vector<size_t> getOutputShape() const override;
+
+    // Сигмоиду можно встроить в эпилог Dense/Conv2D
+    Activation fusableActivation() const override;
+
+    // Сохранение и загрузка записи слоя (параметров нет, только имя и версия)
+    void save(std::ofstream& file) const override;
+    static std::shared_ptr<Layer> load(std::ifstream& file);
+    std::string getName() const override;
+
+    // Обучаемых параметров нет
+    size_t getNumParameters() const override;
 
 private:
+    std::vector<size_t> shape; // Форма входа и выхода, выведенная inferShape
     Tensor output_cache; // Кэш выходных данных для использования в backward pass
 };
 
@@ -1,5 +1,6 @@
 #include "softmax.h"
-#include <cmath>
+#include "kernels/softmax.h"
+#include "layers/serialization.h"
 #include <stdexcept>
 
 // Конструктор по умолчанию
@@ -7,44 +8,153 @@ Softmax::Softmax() : output_cache({}) {} // Инициализируем output_
 
 // Прямой проход
 Tensor Softmax::forward(const Tensor& input) {
-    // Создаем тензор для выходных данных
+    Tensor output = input;
+    forwardInPlace(output);
+    return output;
+}
+
+// Прямой проход на месте
+void Softmax::forwardInPlace(Tensor& data) {
+    if (data.shape().empty() || data.size() == 0) {
+        throw std::invalid_argument("Softmax input must have at least one class.");
+    }
+    size_t classes = data.shape().back();
+    softmaxRows(data.data(), data.data(), data.size() / classes, classes);
+
+    // Кэшируем выходные данные для использования в backward pass
+    output_cache = data;
+}
+
+// Вывод: выход не кэшируется
+Tensor Softmax::infer(const Tensor& input, LayerState* state) const {
+    if (input.shape().empty() || input.size() == 0) {
+        throw std::invalid_argument("Softmax input must have at least one class.");
+    }
     Tensor output(input.shape());
+    size_t classes = input.shape().back();
+    softmaxRows(input.data(), output.data(), input.size() / classes, classes);
+    return output;
+}
+
+// Вывод на месте
+void Softmax::inferInPlace(Tensor& data, LayerState* state) const {
+    if (data.shape().empty() || data.size() == 0) {
+        throw std::invalid_argument("Softmax input must have at least one class.");
+    }
+    size_t classes = data.shape().back();
+    softmaxRows(data.data(), data.data(), data.size() / classes, classes);
+}
+
+// Обратный проход
+Tensor Softmax::backward(const Tensor& grad_output) {
+    Tensor grad_input = grad_output;
+    backwardInPlace(grad_input);
+    return grad_input;
+}
 
-    // Вычисляем экспоненты и их сумму
-    float max_val = input({0});
-    for (size_t i = 1; i < input.size(); ++i) {
-        if (input({i}) > max_val) {
-            max_val = input({i});
+// Обратный проход на месте: grad_input = y * (grad_output - sum(grad_output * y)) для каждой строки
+void Softmax::backwardInPlace(Tensor& grad) {
+    if (grad.size() != output_cache.size()) {
+        throw std::invalid_argument("Gradient tensor must have the same size as the last output.");
+    }
+    size_t classes = output_cache.shape().back();
+    size_t rows = output_cache.size() / classes;
+    const float* y = output_cache.data();
+    float* g = grad.data();
+    for (size_t r = 0; r < rows; ++r) {
+        float dot = 0.0f;
+        for (size_t c = 0; c < classes; ++c) {
+            dot += g[r * classes + c] * y[r * classes + c];
+        }
+        for (size_t c = 0; c < classes; ++c) {
+            g[r * classes + c] = y[r * classes + c] * (g[r * classes + c] - dot);
         }
     }
+}
 
-    float sum_exp = 0.0f;
-    for (size_t i = 0; i < input.size(); ++i) {
-        output({i}) = std::exp(input({i}) - max_val); // Для численной стабильности
-        sum_exp += output({i});
+// Форма выхода совпадает с формой входа
+std::vector<size_t> Softmax::inferShape(const std::vector<size_t>& input_shape) {
+    if (input_shape.empty() || input_shape.back() == 0) {
+        throw std::invalid_argument("Softmax input must have at least one class.");
     }
+    shape = input_shape;
+    return shape;
+}
 
-    // Нормализуем выходные данные
-    for (size_t i = 0; i < input.size(); ++i) {
-        output({i}) /= sum_exp;
+// Прямой проход в буфер модели: кэш — вид на выход
+void Softmax::forwardInto(Tensor& input, Tensor& output) {
+    if (input.shape().empty() || input.size() == 0) {
+        throw std::invalid_argument("Softmax input must have at least one class.");
+    }
+    if (output.size() != input.size()) {
+        throw std::invalid_argument("Output buffer must have the same size as the input.");
     }
+    size_t classes = input.shape().back();
+    softmaxRows(input.data(), output.data(), input.size() / classes, classes);
+    output_cache.alias(output);
+}
 
-    // Кэшируем выходные данные для использования в backward pass
-    output_cache = output;
+// Обратный проход в буфер модели (grad_input может совпадать с grad_output)
+void Softmax::backwardInto(Tensor& grad_output, Tensor& grad_input) {
+    if (grad_input.data() != grad_output.data()) {
+        grad_input.copyFrom(grad_output);
+    }
+    backwardInPlace(grad_input);
+}
 
-    return output;
+// Вычисления на месте
+bool Softmax::supportsInPlace() const {
+    return true;
 }
 
-// Обратный проход
-Tensor Softmax::backward(const Tensor& grad_output, float learning_rate) {
-    // Создаем тензор для градиента по входным данным
-    Tensor grad_input(output_cache.shape());
+// Якобиан выражается через выход
+bool Softmax::backwardNeedsOutput() const {
+    return true;
+}
 
-    // Вычисляем градиент: grad_input = grad_output * (output_cache * (1 - output_cache))
-    for (size_t i = 0; i < output_cache.size(); ++i) {
-        float output_val = output_cache({i});
-        grad_input({i}) = grad_output({i}) * output_val * (1.0f - output_val);
-    }
+// Форма входа
+std::vector<size_t> Softmax::getInputShape() const {
+    return shape;
+}
 
-    return grad_input;
+// Форма выхода
+std::vector<size_t> Softmax::getOutputShape() const {
+    return shape;
+}
+
+// Копия слоя
+std::shared_ptr<Layer> Softmax::clone() const {
+    return std::make_shared<Softmax>(*this);
+}
+
+// Освободить кэши прямого прохода
+void Softmax::releaseCache() {
+    output_cache = Tensor({0});
+}
+
+// Байты кэшей прямого прохода
+size_t Softmax::cacheBytes() const {
+    return output_cache.size() * sizeof(float);
+}
+
+// Имя типа слоя
+std::string Softmax::getName() const {
+    return "Softmax";
+}
+
+// Обучаемых параметров нет
+size_t Softmax::getNumParameters() const {
+    return 0;
+}
+
+// Сохранение записи слоя
+void Softmax::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, 1);
+}
+
+// Загрузка записи слоя
+std::shared_ptr<Layer> Softmax::load(std::ifstream& file) {
+    checkLayerVersion("Softmax", readU32(file), 1);
+    return std::make_shared<Softmax>();
 }
@@ -0,0 +1,87 @@
+// Контрольные точки активаций: пиковая память и время шага обучения глубокой сверточной сети
+// без контрольных точек, с автоматическими сегментами (√N) и с заданным числом сегментов.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_checkpointing.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp
+//       utils/*.cpp -o bench_checkpointing
+// Запуск:
+//   ./bench_checkpointing [блоков conv+relu] [размер батча] [сторона изображения] [шагов]
+
+#include "model.h"
+#include "layers/conv2d.h"
+#include "activations/relu.h"
+#include "metrics/mse.h"
+#include "optimizers/sgd.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+const size_t CHANNELS = 16;
+
+std::unique_ptr<Model> buildModel(size_t blocks) {
+    std::unique_ptr<Model> model(new Model());
+    model->addLayer(std::make_shared<Conv2D>(3, CHANNELS, 3, 1, 1));
+    model->addLayer(std::make_shared<ReLU>());
+    for (size_t b = 1; b < blocks; ++b) {
+        model->addLayer(std::make_shared<Conv2D>(CHANNELS, CHANNELS, 3, 1, 1));
+        model->addLayer(std::make_shared<ReLU>());
+    }
+    model->addLayer(std::make_shared<Conv2D>(CHANNELS, 1, 3, 1, 1));
+    return model;
+}
+
+// Среднее время шага; пик памяти активаций — за все шаги
+void run(const std::string& name, Model& model, const Tensor& inputs, const Tensor& targets, size_t steps) {
+    MeanSquaredError loss;
+    SGD optimizer(0.001f);
+    model.resetPeakActivationBytes();
+    double recompute = model.getRecomputeSeconds();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t step = 0; step < steps; ++step) {
+        model.zeroGrad();
+        loss.forward(model.predict(inputs), targets);
+        model.backward(loss.backward());
+        optimizer.step(model.getParameters());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / steps;
+    std::cout << std::setw(18) << std::left << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << model.getPeakActivationBytes() / 1048576.0 << " MB" << std::setprecision(3)
+              << std::setw(10) << seconds << " s/step" << std::setprecision(3) << std::setw(10)
+              << (model.getRecomputeSeconds() - recompute) / steps << " s recompute\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t blocks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 24;
+    size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+    size_t side = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 64;
+    size_t steps = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 3;
+
+    Tensor inputs({batch, 3, side, side});
+    Tensor targets({batch, 1, side, side});
+    inputs.randomize(-1.0f, 1.0f);
+    targets.randomize(0.0f, 1.0f);
+
+    std::unique_ptr<Model> model = buildModel(blocks);
+    std::cout << model->getLayers().size() << " layers, batch " << batch << ", " << side << "x" << side << "\n";
+
+    run("no checkpoints", *model, inputs, targets, steps);
+
+    // Кэши, оставшиеся от прошлых шагов, не должны попасть в пик следующих режимов
+    for (const auto& layer : model->getLayers()) {
+        layer->releaseCache();
+    }
+    model->enableCheckpointing();
+    run("auto (sqrt N)", *model, inputs, targets, steps);
+
+    model->enableCheckpointing(4);
+    run("4 segments", *model, inputs, targets, steps);
+    return 0;
+}
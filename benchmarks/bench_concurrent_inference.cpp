@@ -0,0 +1,73 @@
+// Одновременный вывод: одна общая модель обслуживает несколько потоков, у каждого потока
+// свой ExecutionContext. Печатает запросы в секунду по числу потоков и память весов, которую
+// заняли бы копии модели на каждый поток, против одной общей модели.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_concurrent_inference.cpp model.cpp
+//       tensor.cpp layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp
+//       kernels/*.cpp utils/*.cpp -o bench_concurrent_inference
+// Запуск:
+//   ./bench_concurrent_inference [запросов на поток] [размер запроса]
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "layers/conv2d.h"
+#include "activations/relu.h"
+#include "activations/softmax.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t requests = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200;
+    size_t batch = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8;
+
+    // Небольшая сверточная модель с классификатором
+    Model model;
+    model.addLayer(std::make_shared<Conv2D>(3, 16, 3, 1, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<Conv2D>(16, 16, 3, 2, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(16 * 16 * 16, 128));
+    model.addLayer(std::make_shared<ReLU>());
+    model.addLayer(std::make_shared<DenseLayer>(128, 10));
+    model.addLayer(std::make_shared<Softmax>());
+
+    Tensor input({batch, 3, 32, 32});
+    input.randomize(-1.0f, 1.0f);
+    size_t weight_bytes = model.getParameters().numParameters() * sizeof(float);
+    std::cout << "Conv2D 3-16-16 + Dense 4096-128-10, 32x32, batch " << batch << ", " << requests
+              << " requests per thread, " << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "requests/s" << std::setw(12) << "speedup"
+              << std::setw(18) << "shared weights" << std::setw(18) << "cloned weights" << "\n";
+
+    double base = 0.0;
+    for (size_t threads : {1, 2, 4, 8}) {
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                // Контекст потока: рабочие буферы слоев, веса общие
+                ExecutionContext context = model.createContext();
+                for (size_t r = 0; r < requests; ++r) {
+                    model.infer(input, context);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double qps = threads * requests / time;
+        if (base == 0.0) {
+            base = qps;
+        }
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(0) << std::setw(14) << qps
+                  << std::setprecision(2) << std::setw(11) << qps / base << "x" << std::setprecision(1)
+                  << std::setw(15) << weight_bytes / 1e6 << " MB" << std::setw(15)
+                  << threads * weight_bytes / 1e6 << " MB\n";
+    }
+    return 0;
+}
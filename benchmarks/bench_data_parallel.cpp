@@ -0,0 +1,127 @@
+// Бенчмарк масштабирования синхронного обучения с параллелизмом по данным.
+// Обучает одну и ту же MLP на синтетических данных с 1, 2, 4, ... репликами
+// и печатает примеры в секунду, ускорение, эффективность и разбивку времени шага.
+// Перед замером проверяет, что реплики получают независимые маски Dropout.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_data_parallel.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp data/*.cpp
+//       training/*.cpp utils/*.cpp distributed/*.cpp -o bench_data_parallel
+// Запуск:
+//   ./bench_data_parallel [максимум реплик] [размер батча]
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "layers/dropout.h"
+#include "metrics/cross_entropy.h"
+#include "optimizers/sgd.h"
+#include "data/tensor_dataset.h"
+#include "training/data_parallel_trainer.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace {
+
+const size_t NUM_SAMPLES = 8192;
+const size_t INPUTS = 256;
+const size_t HIDDEN = 512;
+const size_t CLASSES = 10;
+
+void buildModel(Model& model) {
+    model.addLayer(std::make_shared<DenseLayer>(INPUTS, HIDDEN, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(HIDDEN, HIDDEN, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(HIDDEN, CLASSES));
+}
+
+// Реплики должны тянуть независимые маски Dropout: иначе шарды обучаются с одинаковым шумом.
+// Две реплики и сама модель пропускают один вход; все три выхода должны различаться.
+bool dropoutMasksIndependent() {
+    Model model;
+    model.addLayer(std::make_shared<Dropout>(0.5f));
+    std::unique_ptr<Model> first = model.replicate(1);
+    std::unique_ptr<Model> second = model.replicate(2);
+    Tensor input({64, INPUTS});
+    input.fill(1.0f);
+    Tensor a = model.predict(input);
+    Tensor b = first->predict(input);
+    Tensor c = second->predict(input);
+    auto same = [](const Tensor& x, const Tensor& y) {
+        for (size_t i = 0; i < x.size(); ++i) {
+            if (x[i] != y[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    return !same(a, b) && !same(a, c) && !same(b, c);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t max_replicas = argc > 1 ? std::strtoull(argv[1], nullptr, 10)
+                                   : std::max(1u, std::thread::hardware_concurrency());
+    size_t batch_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+
+    // Синтетическая классификация: класс определяется знаком суммы первых признаков
+    Tensor inputs({NUM_SAMPLES, INPUTS});
+    inputs.randomize(-1.0f, 1.0f);
+    Tensor targets({NUM_SAMPLES, CLASSES});
+    for (size_t n = 0; n < NUM_SAMPLES; ++n) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < CLASSES; ++i) {
+            sum += inputs[n * INPUTS + i];
+        }
+        targets[n * CLASSES + (sum > 0.0f ? 1 : 0)] = 1.0f;
+    }
+    TensorDataset dataset(inputs, targets);
+
+    if (!dropoutMasksIndependent()) {
+        std::cerr << "replicas share the Dropout random stream\n";
+        return 1;
+    }
+
+    TrainerConfig config;
+    config.epochs = 2;
+    config.batch_size = batch_size;
+    config.learning_rate = 0.01f;
+    config.log = nullptr;
+
+    std::cout << "samples: " << NUM_SAMPLES << ", batch: " << batch_size
+              << ", MLP " << INPUTS << "-" << HIDDEN << "-" << HIDDEN << "-" << CLASSES << "\n\n";
+    std::cout << std::setw(9) << "replicas" << std::setw(12) << "samples/s" << std::setw(10) << "speedup"
+              << std::setw(12) << "efficiency" << std::setw(12) << "compute %" << std::setw(11) << "reduce %"
+              << std::setw(10) << "optim %" << std::setw(10) << "loss" << "\n";
+
+    double baseline = 0.0;
+    for (size_t replicas = 1; replicas <= max_replicas; replicas *= 2) {
+        Model model;
+        buildModel(model);
+        SoftmaxCrossEntropy loss;
+        SGD optimizer(config.learning_rate);
+        DataParallelTrainer trainer(model, loss, optimizer, config, replicas);
+
+        TrainingStats stats = trainer.fit(dataset);
+        double rate = stats.samplesPerSecond();
+        if (replicas == 1) {
+            baseline = rate;
+        }
+        double total = trainer.getComputeSeconds() + trainer.getReduceSeconds() + trainer.getOptimizerSeconds();
+
+        std::cout << std::fixed << std::setprecision(1) << std::setw(9) << replicas << std::setw(12) << rate
+                  << std::setprecision(2) << std::setw(9) << rate / baseline << "x"
+                  << std::setw(11) << 100.0 * rate / baseline / replicas << "%"
+                  << std::setprecision(1) << std::setw(11) << 100.0 * trainer.getComputeSeconds() / total << "%"
+                  << std::setw(10) << 100.0 * trainer.getReduceSeconds() / total << "%"
+                  << std::setw(9) << 100.0 * trainer.getOptimizerSeconds() / total << "%"
+                  << std::setprecision(4) << std::setw(10) << stats.loss << "\n";
+
+        if (replicas * 2 > max_replicas && replicas != max_replicas) {
+            replicas = max_replicas / 2;
+        }
+    }
+    return 0;
+}
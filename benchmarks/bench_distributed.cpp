@@ -0,0 +1,128 @@
+// Бенчмарк распределенного обучения: 1, 2, 4, ... локальных процессов, соединенных в кольцо
+// через Unix-сокеты. Печатает примеры в секунду, эффективность масштабирования, время обмена
+// и долю обмена, перекрытую обратным проходом.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_distributed.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp data/*.cpp
+//       training/*.cpp utils/*.cpp distributed/*.cpp -o bench_distributed
+// Запуск:
+//   ./bench_distributed [максимум процессов] [размер батча]
+// Для честного измерения процессам нужны свободные ядра; KOKORO_NUM_THREADS=1 отключает
+// многопоточность оптимизатора внутри процесса.
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "metrics/cross_entropy.h"
+#include "optimizers/sgd.h"
+#include "data/tensor_dataset.h"
+#include "distributed/launcher.h"
+#include "training/distributed_trainer.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const size_t NUM_SAMPLES = 4096;
+const size_t INPUTS = 256;
+const size_t HIDDEN = 1024;
+const size_t CLASSES = 10;
+
+// Результат процесса 0, передаваемый родителю через канал
+struct RankResult {
+    double samples_per_second;
+    double compute_seconds;
+    double comm_seconds;
+    double exposed_seconds;
+    double overlap;
+    float loss;
+};
+
+int trainRank(Communicator& communicator, size_t batch_size, int result_fd) {
+    // Одинаковые данные на всех процессах: генератор с фиксированным зерном
+    Tensor inputs({NUM_SAMPLES, INPUTS});
+    Tensor targets({NUM_SAMPLES, CLASSES});
+    unsigned state = 12345;
+    for (size_t n = 0; n < NUM_SAMPLES; ++n) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < INPUTS; ++i) {
+            state = state * 1664525u + 1013904223u;
+            inputs[n * INPUTS + i] = static_cast<float>(state >> 8) / (1u << 24) * 2.0f - 1.0f;
+            sum += i < 8 ? inputs[n * INPUTS + i] : 0.0f;
+        }
+        targets[n * CLASSES + (sum > 0.0f ? 1 : 0)] = 1.0f;
+    }
+    TensorDataset dataset(inputs, targets);
+
+    Model model;
+    model.addLayer(std::make_shared<DenseLayer>(INPUTS, HIDDEN, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(HIDDEN, HIDDEN, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(HIDDEN, CLASSES));
+    SoftmaxCrossEntropy loss;
+
+    TrainerConfig config;
+    config.epochs = 1;
+    config.batch_size = batch_size;
+    config.learning_rate = 0.001f;
+    config.log = nullptr;
+    SGD optimizer(config.learning_rate);
+    DistributedTrainer trainer(model, loss, optimizer, config, communicator);
+
+    TrainingStats stats = trainer.fit(dataset);
+    if (communicator.getRank() == 0) {
+        RankResult result = {stats.samplesPerSecond(), trainer.getComputeSeconds(), trainer.getCommSeconds(),
+                             trainer.getExposedCommSeconds(), trainer.getOverlap(), stats.loss};
+        if (write(result_fd, &result, sizeof(result)) != sizeof(result)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t max_ranks = argc > 1 ? std::strtoull(argv[1], nullptr, 10)
+                                : std::max(1u, std::thread::hardware_concurrency());
+    size_t batch_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256;
+
+    std::cout << "samples: " << NUM_SAMPLES << ", batch: " << batch_size << ", MLP " << INPUTS << "-" << HIDDEN
+              << "-" << HIDDEN << "-" << CLASSES << "\n\n";
+    std::cout << std::setw(6) << "ranks" << std::setw(12) << "samples/s" << std::setw(12) << "efficiency"
+              << std::setw(12) << "compute s" << std::setw(10) << "comm s" << std::setw(11) << "exposed s"
+              << std::setw(10) << "overlap" << std::setw(10) << "loss" << "\n";
+
+    double baseline = 0.0;
+    for (size_t ranks = 1; ranks <= max_ranks; ranks *= 2) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return 1;
+        }
+        int code = launchLocalRanks(ranks, [&](Communicator& communicator) {
+            return trainRank(communicator, batch_size, fds[1]);
+        });
+        close(fds[1]);
+        RankResult result;
+        bool ok = code == 0 && read(fds[0], &result, sizeof(result)) == sizeof(result);
+        close(fds[0]);
+        if (!ok) {
+            std::cerr << "run with " << ranks << " ranks failed\n";
+            return 1;
+        }
+
+        if (ranks == 1) {
+            baseline = result.samples_per_second;
+        }
+        std::cout << std::fixed << std::setw(6) << ranks << std::setprecision(1) << std::setw(12)
+                  << result.samples_per_second << std::setw(11)
+                  << 100.0 * result.samples_per_second / baseline / ranks << "%" << std::setprecision(3)
+                  << std::setw(12) << result.compute_seconds << std::setw(10) << result.comm_seconds
+                  << std::setw(11) << result.exposed_seconds << std::setprecision(1) << std::setw(9)
+                  << 100.0 * result.overlap << "%" << std::setprecision(4) << std::setw(10) << result.loss << "\n";
+    }
+    return 0;
+}
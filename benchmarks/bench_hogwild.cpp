@@ -0,0 +1,116 @@
+// Сравнение асинхронного обучения (Hogwild) с синхронным на одном и том же разреженном наборе данных.
+// Печатает время, примеры в секунду, итоговые потери и счетчики задержки обновлений.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_hogwild.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp data/*.cpp
+//       training/*.cpp utils/*.cpp distributed/*.cpp -o bench_hogwild
+// Запуск:
+//   ./bench_hogwild [потоков] [размер батча] [эпох]
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "metrics/mse.h"
+#include "optimizers/sgd.h"
+#include "data/tensor_dataset.h"
+#include "training/trainer.h"
+#include "training/data_parallel_trainer.h"
+#include "training/hogwild_trainer.h"
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace {
+
+const size_t NUM_SAMPLES = 20000;
+const size_t FEATURES = 4096; // Ширина разреженного входа
+const size_t ACTIVE = 16;     // Ненулевых признаков в примере
+const size_t HIDDEN = 32;
+
+void buildModel(Model& model) {
+    model.addLayer(std::make_shared<DenseLayer>(FEATURES, HIDDEN, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(HIDDEN, 1));
+}
+
+void report(const char* name, const TrainingStats& stats) {
+    std::cout << std::setw(14) << std::left << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << stats.seconds << " s"
+              << std::setprecision(0) << std::setw(12) << stats.samplesPerSecond() << " samples/s"
+              << std::setprecision(5) << std::setw(11) << stats.loss;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10)
+                              : std::max(1u, std::thread::hardware_concurrency());
+    size_t batch_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+    size_t epochs = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 3;
+
+    // Разреженная линейная регрессия: цель — сумма скрытых весов активных признаков
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<size_t> feature(0, FEATURES - 1);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<float> true_weights(FEATURES);
+    for (float& w : true_weights) {
+        w = normal(gen) * 0.1f;
+    }
+    Tensor inputs({NUM_SAMPLES, FEATURES});
+    Tensor targets({NUM_SAMPLES, 1});
+    for (size_t n = 0; n < NUM_SAMPLES; ++n) {
+        for (size_t k = 0; k < ACTIVE; ++k) {
+            size_t f = feature(gen);
+            inputs[n * FEATURES + f] = 1.0f;
+        }
+        float sum = 0.0f;
+        for (size_t f = 0; f < FEATURES; ++f) {
+            sum += inputs[n * FEATURES + f] * true_weights[f];
+        }
+        targets[n] = sum;
+    }
+    TensorDataset dataset(inputs, targets);
+
+    TrainerConfig config;
+    config.epochs = epochs;
+    config.batch_size = batch_size;
+    config.learning_rate = 0.01f;
+    config.log = nullptr;
+
+    std::cout << "samples: " << NUM_SAMPLES << ", features: " << FEATURES << " (" << ACTIVE
+              << " active), batch: " << batch_size << ", threads: " << threads << ", epochs: " << epochs << "\n\n";
+
+    {
+        Model model;
+        buildModel(model);
+        MeanSquaredError loss;
+        Trainer trainer(model, loss, config);
+        report("sync 1 thread", trainer.fit(dataset));
+        std::cout << "\n";
+    }
+    {
+        Model model;
+        buildModel(model);
+        MeanSquaredError loss;
+        SGD optimizer(config.learning_rate);
+        DataParallelTrainer trainer(model, loss, optimizer, config, threads);
+        report("sync parallel", trainer.fit(dataset));
+        std::cout << "   reduce " << std::setprecision(1)
+                  << 100.0 * trainer.getReduceSeconds() /
+                         (trainer.getComputeSeconds() + trainer.getReduceSeconds() + trainer.getOptimizerSeconds())
+                  << "% of step\n";
+    }
+    {
+        Model model;
+        buildModel(model);
+        MeanSquaredError loss;
+        HogwildTrainer trainer(model, loss, config, threads);
+        report("hogwild", trainer.fit(dataset));
+        std::cout << "   updates " << trainer.getUpdates() << ", staleness mean " << std::setprecision(2)
+                  << trainer.getMeanStaleness() << " max " << trainer.getMaxStaleness()
+                  << ", skipped blocks " << std::setprecision(1) << 100.0 * trainer.getSkippedFraction() << "%\n";
+    }
+    return 0;
+}
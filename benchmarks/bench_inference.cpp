@@ -0,0 +1,92 @@
+// Вывод без кэшей: Model::predict (слои копируют вход и выход в кэши для обратного прохода)
+// против Model::infer на полносвязной и сверточной моделях.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_inference.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp
+//       utils/*.cpp -o bench_inference
+// Запуск:
+//   ./bench_inference [размер батча] [повторов]
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "layers/conv2d.h"
+#include "layers/dropout.h"
+#include "activations/relu.h"
+#include "activations/softmax.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Среднее время вызова
+double seconds(const std::function<void()>& fn, size_t repeats) {
+    fn(); // Прогрев: первые вызовы выделяют кэши и рабочие буферы
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; ++r) {
+        fn();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+void compare(const std::string& name, Model& model, const Tensor& inputs, size_t repeats) {
+    Tensor expected = model.predict(inputs);
+    Tensor actual = model.infer(inputs);
+    float max_diff = 0.0f;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        max_diff = std::max(max_diff, std::fabs(expected[i] - actual[i]));
+    }
+
+    double predict_time = seconds([&] { model.predict(inputs); }, repeats);
+    double infer_time = seconds([&] { model.infer(inputs); }, repeats);
+    size_t batch = inputs.shape()[0];
+    std::cout << name << " (max |predict - infer| " << max_diff << ")\n" << std::fixed << std::setprecision(3)
+              << "  predict " << std::setw(9) << 1000.0 * predict_time << " ms" << std::setprecision(0)
+              << std::setw(10) << batch / predict_time << " samples/s\n" << std::setprecision(3)
+              << "  infer   " << std::setw(9) << 1000.0 * infer_time << " ms" << std::setprecision(0)
+              << std::setw(10) << batch / infer_time << " samples/s" << std::setprecision(2)
+              << "  (x" << predict_time / infer_time << ")\n" << std::defaultfloat;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t batch = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4096;
+    size_t repeats = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+
+    // Полносвязная модель с отдельными слоями активаций и Dropout
+    // (в predict Dropout работает, поэтому выходы predict и infer различаются)
+    Model mlp;
+    mlp.addLayer(std::make_shared<DenseLayer>(64, 128));
+    mlp.addLayer(std::make_shared<ReLU>());
+    mlp.addLayer(std::make_shared<Dropout>(0.1f));
+    mlp.addLayer(std::make_shared<DenseLayer>(128, 128));
+    mlp.addLayer(std::make_shared<ReLU>());
+    mlp.addLayer(std::make_shared<Dropout>(0.1f));
+    mlp.addLayer(std::make_shared<DenseLayer>(128, 10));
+    mlp.addLayer(std::make_shared<Softmax>());
+    Tensor mlp_inputs({batch, 64});
+    mlp_inputs.randomize(0.0f, 1.0f);
+    compare("Dense 64-128-128-10", mlp, mlp_inputs, repeats);
+
+    // Сверточная модель
+    Model cnn;
+    cnn.addLayer(std::make_shared<Conv2D>(3, 8, 3, 1, 1));
+    cnn.addLayer(std::make_shared<ReLU>());
+    cnn.addLayer(std::make_shared<Conv2D>(8, 8, 3, 1, 1));
+    cnn.addLayer(std::make_shared<ReLU>());
+    cnn.addLayer(std::make_shared<Conv2D>(8, 8, 3, 2, 1));
+    cnn.addLayer(std::make_shared<ReLU>());
+    cnn.addLayer(std::make_shared<Conv2D>(8, 10, 16, 1, 0));
+    Tensor cnn_inputs({std::max<size_t>(1, batch / 64), 3, 32, 32});
+    cnn_inputs.randomize(-1.0f, 1.0f);
+    compare("Conv2D 3-8-8-8-10, 32x32", cnn, cnn_inputs, repeats);
+    return 0;
+}
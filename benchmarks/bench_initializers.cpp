@@ -0,0 +1,87 @@
+// Время инициализации весов большой модели: поэлементные NNUtils::xavier_init и Tensor::randomize
+// против тензорных инициализаторов (счетчиковый генератор, SIMD, все потоки).
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_initializers.cpp tensor.cpp
+//       initializers/*.cpp kernels/*.cpp utils/*.cpp -o bench_initializers
+// Запуск:
+//   ./bench_initializers [миллионов параметров] [ширина слоя]
+
+#include "tensor.h"
+#include "nn_utils.h"
+#include "initializers/he.h"
+#include "initializers/orthogonal.h"
+#include "initializers/xavier.h"
+#include "utils/thread_pool.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+double seconds(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, double time, size_t params) {
+    std::cout << std::setw(22) << std::left << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(9) << time << " s" << std::setprecision(0) << std::setw(10) << params / time / 1e6
+              << " M/s\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t millions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100;
+    size_t width = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4096;
+
+    // Модель — стопка квадратных слоев width x width
+    size_t layers = std::max<size_t>(1, millions * 1000000 / (width * width));
+    size_t params = layers * width * width;
+    std::vector<Tensor> weights;
+    double alloc = seconds([&] {
+        for (size_t l = 0; l < layers; ++l) {
+            weights.emplace_back(std::vector<size_t>{width, width});
+        }
+    });
+    std::cout << layers << " layers of " << width << "x" << width << " (" << params / 1000000 << "M parameters), "
+              << ThreadPool::global().concurrency() << " threads, allocation " << std::setprecision(3) << alloc
+              << " s\n";
+
+    report("NNUtils::xavier_init", seconds([&] {
+        for (Tensor& w : weights) {
+            for (size_t i = 0; i < w.size(); ++i) {
+                w[i] = static_cast<float>(NNUtils::xavier_init(static_cast<int>(width), static_cast<int>(width)));
+            }
+        }
+    }), params);
+    report("Tensor::randomize", seconds([&] {
+        for (Tensor& w : weights) {
+            w.randomize(-0.5f, 0.5f);
+        }
+    }), params);
+    report("Xavier uniform", seconds([&] {
+        Xavier init;
+        for (Tensor& w : weights) {
+            init.initialize(w, width, width);
+        }
+    }), params);
+    report("He normal", seconds([&] {
+        He init(Distribution::Normal);
+        for (Tensor& w : weights) {
+            init.initialize(w, width, width);
+        }
+    }), params);
+
+    // Ортогональная инициализация кубическая, поэтому меряется на одном слое меньшей ширины
+    size_t ortho_width = std::min<size_t>(width, 1024);
+    Tensor ortho({ortho_width, ortho_width});
+    report("Orthogonal (1 layer)", seconds([&] { Orthogonal().initialize(ortho, ortho_width, ortho_width); }),
+           ortho.size());
+    return 0;
+}
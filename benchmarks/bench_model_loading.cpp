@@ -0,0 +1,82 @@
+// Загрузка модели из файла: Model::load (чтение и копирование весов с проверкой контрольных
+// сумм) против Model::loadMapped (отображение файла, тензоры весов — виды на его страницы).
+// Печатает время загрузки и первого вывода; без отображения второе почти не зависит от
+// размера модели, а первый вывод догружает только нужные страницы.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_model_loading.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp
+//       utils/*.cpp -o bench_model_loading
+// Запуск:
+//   ./bench_model_loading [мегабайт весов] [файл]
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "initializers/constant.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+double seconds(const std::function<void()>& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, double load, double first) {
+    std::cout << std::setw(14) << std::left << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << load * 1e3 << " ms" << std::setw(14) << first * 1e3 << " ms\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 512;
+    std::string path = argc > 2 ? argv[2] : "bench_model_loading.kkm";
+
+    // Стопка квадратных слоев 2048x2048 (16 МБ каждый)
+    const size_t width = 2048;
+    size_t layers = std::max<size_t>(1, megabytes * 1024 * 1024 / (width * width * sizeof(float)));
+    {
+        Model model;
+        for (size_t l = 0; l < layers; ++l) {
+            model.addLayer(std::make_shared<DenseLayer>(width, width, Activation::ReLU,
+                                                        std::make_shared<Constant>(1e-3f)));
+        }
+        double save = seconds([&] { model.save(path); });
+        std::cout << layers << " Dense layers " << width << "x" << width << ", "
+                  << layers * width * width * sizeof(float) / (1024 * 1024) << " MB of weights, saved in "
+                  << std::setprecision(0) << std::fixed << save * 1e3 << " ms\n";
+    }
+
+    Tensor input({1, width});
+    input.fill(1.0f);
+    std::cout << std::setw(14) << std::left << "" << std::right << std::setw(15) << "load" << std::setw(17)
+              << "first infer\n";
+
+    std::unique_ptr<Model> model;
+    double load = seconds([&] { model = Model::load(path); });
+    double first = seconds([&] { model->infer(input); });
+    report("load", load, first);
+    model.reset();
+
+    load = seconds([&] { model = Model::loadMapped(path); });
+    first = seconds([&] { model->infer(input); });
+    report("loadMapped", load, first);
+    model.reset();
+
+    load = seconds([&] { model = Model::loadMapped(path, true); });
+    first = seconds([&] { model->infer(input); });
+    report("  + verify", load, first);
+    model.reset();
+
+    std::remove(path.c_str());
+    return 0;
+}
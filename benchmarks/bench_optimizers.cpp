@@ -0,0 +1,190 @@
+// Бенчмарк шагов оптимизаторов: обновлений параметров в секунду для разных размеров модели.
+// Сравнивает векторизованные многопоточные ядра с исходными поэлементными формулами
+// (std::pow на каждый элемент) и проверяет, что результаты совпадают.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_optimizers.cpp optimizers/*.cpp
+//       kernels/*.cpp utils/*.cpp layers/parameter.cpp tensor.cpp activations/activation.cpp -o bench_optimizers
+// Запуск:
+//   ./bench_optimizers [размер ...]      (по умолчанию 1000000 10000000; например 100000000)
+// Количество потоков задается переменной окружения KOKORO_NUM_THREADS.
+
+#include "optimizers/sgd.h"
+#include "optimizers/adam.h"
+#include "optimizers/adamw.h"
+#include "optimizers/nadam.h"
+#include "optimizers/adamax.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const float LR = 1e-3f, BETA1 = 0.9f, BETA2 = 0.999f, EPS = 1e-8f, WD = 1e-2f;
+
+// Исходная реализация шага: состояние и формулы как до объединения в ядра
+struct Reference {
+    std::string name;
+    std::vector<float> m, v;
+    size_t t = 0;
+
+    void step(float* params, const float* grads, size_t size) {
+        if (m.size() != size) {
+            m.assign(size, 0.0f);
+            v.assign(size, 0.0f);
+        }
+        t += 1;
+        if (name == "SGD") {
+            for (size_t i = 0; i < size; ++i) {
+                params[i] -= LR * grads[i];
+            }
+        } else if (name == "Adamax") {
+            for (size_t i = 0; i < size; ++i) {
+                m[i] = BETA1 * m[i] + (1 - BETA1) * grads[i];
+                v[i] = std::max(BETA2 * v[i], std::abs(grads[i]));
+                params[i] -= LR * m[i] / (v[i] + EPS);
+            }
+        } else if (name == "Nadam") {
+            for (size_t i = 0; i < size; ++i) {
+                m[i] = BETA1 * m[i] + (1 - BETA1) * grads[i];
+                v[i] = BETA2 * v[i] + (1 - BETA2) * grads[i] * grads[i];
+                float m_hat = m[i] / (1 - std::pow(BETA1, t));
+                float v_hat = v[i] / (1 - std::pow(BETA2, t));
+                params[i] -= LR * ((BETA1 * m_hat / (1 - std::pow(BETA1, t))) + ((1 - BETA1) * grads[i])) /
+                             (std::sqrt(v_hat) + EPS);
+            }
+        } else {
+            float decay = name == "AdamW" ? WD : 0.0f;
+            for (size_t i = 0; i < size; ++i) {
+                m[i] = BETA1 * m[i] + (1 - BETA1) * grads[i];
+                v[i] = BETA2 * v[i] + (1 - BETA2) * grads[i] * grads[i];
+                float m_hat = m[i] / (1 - std::pow(BETA1, t));
+                float v_hat = v[i] / (1 - std::pow(BETA2, t));
+                params[i] -= LR * m_hat / (std::sqrt(v_hat) + EPS);
+                params[i] -= LR * decay * params[i];
+            }
+        }
+    }
+};
+
+std::unique_ptr<Optimizer> makeOptimizer(const std::string& name) {
+    if (name == "SGD") return std::unique_ptr<Optimizer>(new SGD(LR));
+    if (name == "Adam") return std::unique_ptr<Optimizer>(new Adam(LR, BETA1, BETA2, EPS));
+    if (name == "AdamW") return std::unique_ptr<Optimizer>(new AdamW(LR, BETA1, BETA2, EPS, WD));
+    if (name == "Nadam") return std::unique_ptr<Optimizer>(new Nadam(LR, BETA1, BETA2, EPS));
+    return std::unique_ptr<Optimizer>(new Adamax(LR, BETA1, BETA2, EPS));
+}
+
+void fillRandom(std::vector<float>& data, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    for (float& x : data) {
+        x = dist(gen);
+    }
+}
+
+// Среднее время одного вызова fn (секунды): прогрев, затем повторы не менее min_seconds
+double timeIt(const std::function<void()>& fn, double min_seconds) {
+    fn();
+    size_t reps = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        fn();
+        ++reps;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    return elapsed / reps;
+}
+
+// Максимальная относительная ошибка после нескольких шагов на нескольких массивах
+float checkAgainstReference(const std::string& name) {
+    const std::vector<size_t> sizes = {1, 15, 333, 70000, 4097};
+    std::vector<std::vector<float>> params, grads, ref_params;
+    for (size_t s = 0; s < sizes.size(); ++s) {
+        params.emplace_back(sizes[s]);
+        grads.emplace_back(sizes[s]);
+        fillRandom(params[s], 1 + s);
+        ref_params.push_back(params[s]);
+    }
+
+    std::unique_ptr<Optimizer> optimizer = makeOptimizer(name);
+    std::vector<Reference> reference(sizes.size(), Reference{name, {}, {}, 0});
+    for (size_t step = 0; step < 20; ++step) {
+        std::vector<ParameterSpan> spans;
+        for (size_t s = 0; s < sizes.size(); ++s) {
+            fillRandom(grads[s], 100 * step + s);
+            spans.push_back({params[s].data(), grads[s].data(), sizes[s]});
+            reference[s].step(ref_params[s].data(), grads[s].data(), sizes[s]);
+        }
+        optimizer->update(spans);
+    }
+
+    float max_error = 0.0f;
+    for (size_t s = 0; s < sizes.size(); ++s) {
+        for (size_t i = 0; i < sizes[s]; ++i) {
+            float diff = std::abs(params[s][i] - ref_params[s][i]);
+            max_error = std::max(max_error, diff / std::max(1.0f, std::abs(ref_params[s][i])));
+        }
+    }
+    return max_error;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) {
+        sizes = {1000000, 10000000};
+    }
+
+    const std::vector<std::string> names = {"SGD", "Adam", "AdamW", "Nadam", "Adamax"};
+    std::cout << "threads: " << ThreadPool::global().concurrency() << "\n\n";
+
+    std::cout << "max relative error vs reference after 20 steps:\n";
+    for (const std::string& name : names) {
+        std::cout << "  " << std::setw(8) << std::left << name << checkAgainstReference(name) << "\n";
+    }
+
+    std::cout << "\n" << std::setw(8) << "optim" << std::right << std::setw(12) << "params"
+              << std::setw(14) << "ref Mupd/s" << std::setw(14) << "fused Mupd/s"
+              << std::setw(12) << "fused GB/s" << std::setw(10) << "speedup" << "\n";
+    for (size_t size : sizes) {
+        std::vector<float> params(size), grads(size);
+        fillRandom(params, 1);
+        fillRandom(grads, 2);
+
+        for (const std::string& name : names) {
+            Reference reference{name, {}, {}, 0};
+            double ref_time = timeIt([&] { reference.step(params.data(), grads.data(), size); }, 0.5);
+
+            std::unique_ptr<Optimizer> optimizer = makeOptimizer(name);
+            double fused_time = timeIt([&] { optimizer->update(params.data(), grads.data(), size); }, 0.5);
+
+            // Трафик памяти: параметры (чтение+запись), градиент (чтение), моменты (чтение+запись)
+            double streams = name == "SGD" ? 3.0 : 7.0;
+            double bytes = streams * sizeof(float) * size;
+
+            std::cout << std::setw(8) << std::left << name << std::right << std::setw(12) << size
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(14) << size / ref_time * 1e-6
+                      << std::setw(14) << size / fused_time * 1e-6
+                      << std::setw(12) << bytes / fused_time * 1e-9
+                      << std::setw(9) << ref_time / fused_time << "x" << "\n";
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Потоковый вывод через Model::predictAsync: один поток (все слои подряд) против конвейера
+// из нескольких стадий и микробатчей на сверточно-полносвязной модели. Генератор подает
+// запросы с заданной частотой (0 — все сразу, предел пропускной способности), сборщик
+// ждет ответы по порядку. Печатает запросы в секунду и p50/p99 задержки.
+// Выигрыш конвейера ограничен числом ядер: на одном ядре стадии делят его между собой.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_pipeline.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp
+//       utils/*.cpp -o bench_pipeline
+// Запуск:
+//   ./bench_pipeline [запросов в секунду] [всего запросов] [размер запроса]
+
+#include "model.h"
+#include "layers/conv2d.h"
+#include "layers/dense_layer.h"
+#include "activations/softmax.h"
+#include "utils/latency_histogram.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Подать total запросов с частотой rate и дождаться ответов; возвращает запросы в секунду
+double stream(Model& model, const Tensor& input, double rate, size_t total, LatencyHistogram& latency) {
+    std::vector<std::future<Tensor>> results(total);
+    std::vector<clock_type::time_point> sent(total);
+    std::mutex mutex;
+    std::condition_variable submitted;
+    size_t published = 0;
+    auto start = clock_type::now();
+
+    // Сборщик ждет ответы в порядке отправки (конвейер завершает их в том же порядке)
+    std::thread collector([&] {
+        for (size_t i = 0; i < total; ++i) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                submitted.wait(lock, [&] { return published > i; });
+            }
+            results[i].get();
+            latency.record(std::chrono::duration<double>(clock_type::now() - sent[i]).count());
+        }
+    });
+    for (size_t i = 0; i < total; ++i) {
+        if (rate > 0.0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<clock_type::duration>(
+                                                      std::chrono::duration<double>(i / rate)));
+        }
+        sent[i] = clock_type::now();
+        results[i] = model.predictAsync(input);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            published = i + 1;
+        }
+        submitted.notify_one();
+    }
+    collector.join();
+    return total / std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double rate = argc > 1 ? std::strtod(argv[1], nullptr) : 0.0;
+    size_t total = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 400;
+    size_t batch = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 8;
+
+    Model model;
+    model.addLayer(std::make_shared<Conv2D>(3, 16, 3, 1, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<Conv2D>(16, 32, 3, 2, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<Conv2D>(32, 32, 3, 1, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<Conv2D>(32, 64, 3, 2, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(64 * 8 * 8, 256, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(256, 256, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(256, 10));
+    model.addLayer(std::make_shared<Softmax>());
+    Tensor input({batch, 3, 32, 32});
+    input.randomize(-1.0f, 1.0f);
+
+    std::cout << "Conv2D x4 + Dense x3, 32x32, batch " << batch << ", " << total << " requests at "
+              << (rate > 0.0 ? std::to_string(static_cast<long>(rate)) + "/s" : std::string("max rate")) << ", "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::setw(8) << "stages" << std::setw(8) << "micro" << std::setw(14) << "requests/s"
+              << std::setw(12) << "p50 ms" << std::setw(12) << "p99 ms" << "   boundaries\n";
+
+    struct Setting {
+        size_t stages;
+        size_t micro_batch;
+    };
+    for (const Setting& setting : {Setting{1, 0}, Setting{2, 0}, Setting{4, 0}, Setting{4, batch / 4}}) {
+        model.enablePipeline(setting.stages, setting.micro_batch);
+        model.predictAsync(input).get(); // Запуск конвейера и замер слоев
+        LatencyHistogram latency;
+        double qps = stream(model, input, rate, total, latency);
+        std::cout << std::setw(8) << setting.stages << std::setw(8) << setting.micro_batch << std::fixed
+                  << std::setprecision(0) << std::setw(14) << qps << std::setprecision(3) << std::setw(12)
+                  << latency.percentile(50) * 1e3 << std::setw(12) << latency.percentile(99) * 1e3 << "   ";
+        for (size_t boundary : model.getPipelineStages()) {
+            std::cout << " " << boundary;
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
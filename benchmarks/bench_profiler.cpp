@@ -0,0 +1,99 @@
+// Стоимость профилировщика: цена одной области (выключенный профилировщик — проверка флага,
+// включенный — два чтения часов и запись события) и пропускная способность обучения
+// сверточной модели без профилировщика и с ним. В конце печатает таблицу профиля
+// и пишет временную шкалу Chrome trace_event.
+//
+// Сборка (из корня репозитория, одной командой; -DKOKORO_NO_PROFILER убирает профилировщик
+// из сборки целиком):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_profiler.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp data/*.cpp
+//       training/*.cpp utils/*.cpp distributed/*.cpp -o bench_profiler
+// Запуск:
+//   ./bench_profiler [файл временной шкалы]
+
+#include "model.h"
+#include "layers/conv2d.h"
+#include "layers/dense_layer.h"
+#include "metrics/cross_entropy.h"
+#include "optimizers/adam.h"
+#include "data/tensor_dataset.h"
+#include "training/trainer.h"
+#include "utils/profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+const size_t NUM_SAMPLES = 2048;
+const size_t CLASSES = 10;
+
+// Наносекунд на одну пустую область
+double scopeNanos(size_t count) {
+    static const uint32_t id = Profiler::global().intern("bench.empty", "bench");
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        ProfileScope scope(id, 1.0, 1.0);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+// Примеры в секунду за одну эпоху обучения
+double trainRate(const Dataset& dataset, const std::string& trace_path) {
+    Model model;
+    model.addLayer(std::make_shared<Conv2D>(3, 16, 3, 1, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<Conv2D>(16, 32, 3, 2, 1, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(32 * 8 * 8, 128, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(128, CLASSES));
+    SoftmaxCrossEntropy loss;
+    Adam optimizer(1e-3f);
+    TrainerConfig config;
+    config.epochs = 1;
+    config.batch_size = 64;
+    config.log = nullptr;
+    config.trace_path = trace_path;
+    Trainer trainer(model, loss, optimizer, config);
+    return trainer.fit(dataset).samplesPerSecond();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string trace_path = argc > 1 ? argv[1] : "bench_profiler.json";
+
+    Profiler& profiler = Profiler::global();
+    profiler.setEnabled(false);
+    double disabled = scopeNanos(50000000);
+    profiler.setEnabled(true);
+    double enabled = scopeNanos(1000000);
+    profiler.setEnabled(false);
+    profiler.clear();
+    std::cout << "profile scope: " << std::fixed << std::setprecision(2) << disabled << " ns disabled, " << enabled
+              << " ns enabled\n";
+
+    Tensor inputs({NUM_SAMPLES, 3, 16, 16});
+    inputs.randomize(-1.0f, 1.0f);
+    Tensor targets({NUM_SAMPLES, CLASSES});
+    for (size_t n = 0; n < NUM_SAMPLES; ++n) {
+        targets[n * CLASSES + n % CLASSES] = 1.0f;
+    }
+    TensorDataset dataset(inputs, targets);
+
+    // Прогрев, затем попеременные замеры без профилировщика и с ним (лучший из трех)
+    trainRate(dataset, "");
+    double off = 0.0;
+    double on = 0.0;
+    for (int round = 0; round < 3; ++round) {
+        off = std::max(off, trainRate(dataset, ""));
+        on = std::max(on, trainRate(dataset, trace_path));
+    }
+    std::cout << "training: " << std::setprecision(1) << off << " samples/s without profiler, " << on
+              << " samples/s with profiler (" << std::setprecision(2) << 100.0 * (1.0 - on / off) << "% overhead)\n\n";
+
+    profiler.report(std::cout);
+    std::cout << "\ntrace: " << trace_path << "\n";
+    return 0;
+}
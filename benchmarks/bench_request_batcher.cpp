@@ -0,0 +1,97 @@
+// Динамическое пакетирование запросов: генератор нагрузки подает запросы по одному примеру
+// с пуассоновскими интервалами (открытая модель нагрузки) и сравнивает обслуживание без
+// пакетирования (max_batch_size = 1) с батчами разного размера и срока ожидания.
+// Печатает пропускную способность, p50/p99 задержки и средний размер батча.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_request_batcher.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp
+//       utils/*.cpp serving/*.cpp -o bench_request_batcher
+// Запуск:
+//   ./bench_request_batcher [запросов в секунду] [всего запросов] [исполнителей]
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "activations/relu.h"
+#include "activations/softmax.h"
+#include "serving/request_batcher.h"
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Подать total запросов с частотой rate (0 — все сразу) и дождаться ответов
+BatcherMetrics load(const Model& model, const Tensor& sample, const BatcherConfig& config, double rate,
+                    size_t total) {
+    RequestBatcher batcher(model, sample.shape(), config);
+    std::mt19937 rng(7);
+    std::exponential_distribution<double> interval(rate > 0.0 ? rate : 1.0);
+    std::vector<std::future<Tensor>> results;
+    results.reserve(total);
+
+    auto next = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < total; ++i) {
+        if (rate > 0.0) {
+            next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(interval(rng)));
+            std::this_thread::sleep_until(next);
+        }
+        results.push_back(batcher.submit(sample));
+    }
+    for (std::future<Tensor>& result : results) {
+        result.get();
+    }
+    return batcher.getMetrics();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double rate = argc > 1 ? std::strtod(argv[1], nullptr) : 4000.0;
+    size_t total = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000;
+    size_t executors = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+
+    Model model;
+    model.addLayer(std::make_shared<DenseLayer>(256, 512, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(512, 512, Activation::ReLU));
+    model.addLayer(std::make_shared<DenseLayer>(512, 10));
+    model.addLayer(std::make_shared<Softmax>());
+    Tensor sample({256});
+    sample.randomize(-1.0f, 1.0f);
+
+    std::cout << "Dense 256-512-512-10, " << total << " requests, " << executors << " executor(s)\n";
+    std::cout << std::setw(10) << "rate" << std::setw(8) << "batch" << std::setw(10) << "delay"
+              << std::setw(14) << "requests/s" << std::setw(12) << "p50 ms" << std::setw(12) << "p99 ms"
+              << std::setw(12) << "mean batch" << "\n";
+
+    struct Setting {
+        size_t max_batch_size;
+        double max_delay_ms;
+    };
+    const Setting settings[] = {{1, 0.0}, {8, 0.5}, {32, 1.0}, {64, 2.0}};
+    // Заданная частота и насыщение (все запросы сразу) — предел пропускной способности
+    for (double load_rate : {rate, 0.0}) {
+        for (const Setting& setting : settings) {
+            BatcherConfig config;
+            config.max_batch_size = setting.max_batch_size;
+            config.max_delay_ms = setting.max_delay_ms;
+            config.num_executors = executors;
+            BatcherMetrics metrics = load(model, sample, config, load_rate, total);
+            std::cout << std::setw(10) << (load_rate > 0.0 ? std::to_string(static_cast<long>(load_rate)) : "max")
+                      << std::setw(8) << setting.max_batch_size << std::fixed << std::setprecision(1)
+                      << std::setw(8) << setting.max_delay_ms << "ms" << std::setprecision(0) << std::setw(14)
+                      << metrics.throughput() << std::setprecision(3) << std::setw(12)
+                      << metrics.latency.percentile(50) * 1e3 << std::setw(12)
+                      << metrics.latency.percentile(99) * 1e3 << std::setprecision(1) << std::setw(12)
+                      << metrics.meanBatchSize() << "\n";
+        }
+    }
+    return 0;
+}
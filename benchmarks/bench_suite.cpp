@@ -0,0 +1,420 @@
+// Набор микро- и макробенчмарков для отслеживания регрессий между версиями: Tensor::dot
+// на разных формах, поэлементные операции, прямой и обратный проходы Conv2D, шаг LSTM,
+// BatchNorm, шаг каждого оптимизатора, обучение и вывод MLP, CNN и LSTM целиком.
+//
+// Каждый замер: прогрев, затем повторения, пока не набрано не меньше --min-time секунд
+// и не меньше 5 повторений; короткие операции выполняются пачками так, чтобы одно
+// повторение длилось не меньше 200 мкс. Печатает медиану, разброс, GFLOP/s и GB/s по
+// оценке Layer::cost (для тензорных операций — по формуле), примеры в секунду, и при
+// --json пишет все результаты с полной статистикой (среднее, медиана, минимум, максимум,
+// стандартное отклонение, 90-й процентиль) в файл.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_suite.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp data/*.cpp
+//       training/*.cpp utils/*.cpp distributed/*.cpp -o bench_suite
+// Запуск:
+//   ./bench_suite [--json файл] [--filter подстрока] [--min-time секунд] [--quick]
+// Количество потоков задается переменной окружения KOKORO_NUM_THREADS, набор инструкций
+// ядер — KOKORO_FORCE_ISA (см. kernels/dispatch.h).
+
+#include "model.h"
+#include "layers/batch_norm.h"
+#include "layers/conv2d.h"
+#include "layers/dense_layer.h"
+#include "layers/lstm.h"
+#include "activations/relu.h"
+#include "activations/sigmoid.h"
+#include "activations/softmax.h"
+#include "metrics/cross_entropy.h"
+#include "optimizers/sgd.h"
+#include "optimizers/adam.h"
+#include "optimizers/adamw.h"
+#include "optimizers/nadam.h"
+#include "optimizers/adamax.h"
+#include "training/trainer.h"
+#include "kernels/dispatch.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Параметры запуска
+struct Options {
+    std::string json_path;
+    std::string filter;
+    double min_seconds = 0.5; // Минимальное суммарное время замеров одного бенчмарка
+    bool quick = false;       // Уменьшенные размеры для быстрой проверки
+};
+
+// Статистика времени одной итерации, секунды
+struct Stats {
+    double mean = 0.0;
+    double median = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double stddev = 0.0;
+    double p90 = 0.0;
+};
+
+// Результат одного бенчмарка
+struct Result {
+    std::string group;
+    std::string name;
+    size_t repetitions = 0;    // Количество замеров
+    size_t batch = 0;          // Итераций в одном замере
+    Stats seconds;             // Время одной итерации
+    double flops = 0.0;        // Операций на итерацию
+    double bytes = 0.0;        // Байтов на итерацию
+    double items = 0.0;        // Примеров на итерацию
+
+    double gflops() const { return flops > 0.0 ? flops / seconds.median * 1e-9 : 0.0; }
+    double gbytesPerSecond() const { return bytes > 0.0 ? bytes / seconds.median * 1e-9 : 0.0; }
+    double itemsPerSecond() const { return items > 0.0 ? items / seconds.median : 0.0; }
+};
+
+using clock_type = std::chrono::steady_clock;
+
+const size_t MIN_REPETITIONS = 5;
+const size_t MAX_REPETITIONS = 1000;
+const double MIN_SAMPLE_SECONDS = 200e-6;
+
+double elapsed(clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// Процентиль отсортированной выборки с линейной интерполяцией
+double percentile(const std::vector<double>& sorted, double p) {
+    double position = p * (sorted.size() - 1);
+    size_t low = static_cast<size_t>(position);
+    size_t high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (sorted[high] - sorted[low]) * (position - low);
+}
+
+Stats summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    Stats stats;
+    for (double value : samples) {
+        stats.mean += value;
+    }
+    stats.mean /= samples.size();
+    for (double value : samples) {
+        stats.stddev += (value - stats.mean) * (value - stats.mean);
+    }
+    stats.stddev = samples.size() > 1 ? std::sqrt(stats.stddev / (samples.size() - 1)) : 0.0;
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.median = percentile(samples, 0.5);
+    stats.p90 = percentile(samples, 0.9);
+    return stats;
+}
+
+class Suite {
+public:
+    explicit Suite(const Options& options) : options(options) {}
+
+    // Замерить fn; flops, bytes и items — работа одной итерации
+    void run(const std::string& group, const std::string& name, double flops, double bytes, double items,
+             const std::function<void()>& fn) {
+        std::string full_name = group + "/" + name;
+        if (!options.filter.empty() && full_name.find(options.filter) == std::string::npos) {
+            return;
+        }
+
+        // Прогрев: первые вызовы выделяют буферы, заполняют кэши и будят потоки пула
+        auto start = clock_type::now();
+        size_t warmup = 0;
+        do {
+            fn();
+            ++warmup;
+        } while (warmup < 2 || (warmup < 100 && elapsed(start) < 0.1 * options.min_seconds));
+        double estimate = elapsed(start) / warmup;
+
+        // Итераций в замере, чтобы замер был заметно длиннее разрешения часов
+        size_t batch = std::max<size_t>(1, static_cast<size_t>(std::ceil(MIN_SAMPLE_SECONDS / estimate)));
+
+        std::vector<double> samples;
+        double total = 0.0;
+        while (samples.size() < MIN_REPETITIONS ||
+               (total < options.min_seconds && samples.size() < MAX_REPETITIONS)) {
+            auto sample_start = clock_type::now();
+            for (size_t i = 0; i < batch; ++i) {
+                fn();
+            }
+            double seconds = elapsed(sample_start);
+            total += seconds;
+            samples.push_back(seconds / batch);
+        }
+
+        Result result;
+        result.group = group;
+        result.name = name;
+        result.repetitions = samples.size();
+        result.batch = batch;
+        result.seconds = summarize(samples);
+        result.flops = flops;
+        result.bytes = bytes;
+        result.items = items;
+        print(result);
+        results.push_back(result);
+    }
+
+    void printHeader() const {
+        std::cout << std::left << std::setw(52) << "benchmark" << std::right << std::setw(7) << "reps"
+                  << std::setw(12) << "median ms" << std::setw(9) << "+-%" << std::setw(10) << "GFLOP/s"
+                  << std::setw(9) << "GB/s" << std::setw(14) << "items/s" << "\n";
+    }
+
+    // Записать результаты в JSON
+    void writeJson(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            throw std::runtime_error("Cannot create results file: " + path);
+        }
+        file << "{\n  \"config\": {\"kernels\": \"" << KernelRegistry::global().describe() << "\", \"threads\": "
+             << ThreadPool::global().concurrency()
+             << ", \"min_seconds\": " << options.min_seconds << ", \"quick\": " << (options.quick ? "true" : "false")
+             << "},\n  \"results\": [";
+        file << std::setprecision(9);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            file << (i ? ",\n" : "\n") << "    {\"group\": \"" << r.group << "\", \"name\": \"" << r.name
+                 << "\", \"repetitions\": " << r.repetitions << ", \"batch\": " << r.batch
+                 << ", \"seconds\": {\"mean\": " << r.seconds.mean << ", \"median\": " << r.seconds.median
+                 << ", \"min\": " << r.seconds.min << ", \"max\": " << r.seconds.max
+                 << ", \"stddev\": " << r.seconds.stddev << ", \"p90\": " << r.seconds.p90
+                 << "}, \"flops\": " << r.flops << ", \"bytes\": " << r.bytes << ", \"items\": " << r.items
+                 << ", \"gflops\": " << r.gflops() << ", \"gbytes_per_second\": " << r.gbytesPerSecond()
+                 << ", \"items_per_second\": " << r.itemsPerSecond() << "}";
+        }
+        file << "\n  ]\n}\n";
+    }
+
+private:
+    void print(const Result& r) const {
+        std::cout << std::left << std::setw(52) << r.group + "/" + r.name << std::right << std::setw(7)
+                  << r.repetitions << std::fixed << std::setprecision(4) << std::setw(12) << r.seconds.median * 1e3
+                  << std::setprecision(1) << std::setw(9) << 100.0 * r.seconds.stddev / r.seconds.mean
+                  << std::setprecision(2) << std::setw(10) << r.gflops() << std::setw(9) << r.gbytesPerSecond()
+                  << std::setprecision(0) << std::setw(14) << r.itemsPerSecond() << std::defaultfloat << "\n";
+    }
+
+    Options options;
+    std::vector<Result> results;
+};
+
+std::string shapeName(const std::vector<size_t>& dims) {
+    std::string name;
+    for (size_t i = 0; i < dims.size(); ++i) {
+        name += (i ? "x" : "") + std::to_string(dims[i]);
+    }
+    return name;
+}
+
+Tensor randomTensor(const std::vector<size_t>& shape) {
+    Tensor tensor(shape);
+    tensor.randomize(-1.0f, 1.0f);
+    return tensor;
+}
+
+// Цели классификации: по одному классу на пример
+Tensor oneHot(size_t samples, size_t classes) {
+    Tensor targets({samples, classes});
+    for (size_t n = 0; n < samples; ++n) {
+        targets[n * classes + n % classes] = 1.0f;
+    }
+    return targets;
+}
+
+// Суммарная оценка работы модели для формы входа
+LayerCost modelCost(const Model& model, std::vector<size_t> shape) {
+    LayerCost total;
+    for (const std::shared_ptr<Layer>& layer : model.getLayers()) {
+        LayerCost cost = layer->cost(shape);
+        total.forward_flops += cost.forward_flops;
+        total.forward_bytes += cost.forward_bytes;
+        total.backward_flops += cost.backward_flops;
+        total.backward_bytes += cost.backward_bytes;
+        shape = layer->inferShape(shape);
+    }
+    return total;
+}
+
+void benchTensor(Suite& suite, bool quick) {
+    // Формы (M, K, N): квадратные, вектор на матрицу, узкие
+    std::vector<std::vector<size_t>> shapes = {{64, 64, 64}, {256, 256, 256}, {1, 1024, 1024}, {4096, 256, 64}};
+    if (!quick) {
+        shapes.push_back({1024, 1024, 1024});
+    }
+    for (const std::vector<size_t>& mkn : shapes) {
+        Tensor a = randomTensor({mkn[0], mkn[1]});
+        Tensor b = randomTensor({mkn[1], mkn[2]});
+        double flops = 2.0 * mkn[0] * mkn[1] * mkn[2];
+        double bytes = 4.0 * (mkn[0] * mkn[1] + mkn[1] * mkn[2] + mkn[0] * mkn[2]);
+        suite.run("tensor", "dot_" + shapeName(mkn), flops, bytes, 0.0, [&] { Tensor c = a.dot(b); });
+    }
+
+    size_t size = quick ? (size_t(1) << 18) : (size_t(1) << 22);
+    Tensor a = randomTensor({size});
+    Tensor b = randomTensor({size});
+    double bytes = 3.0 * 4.0 * size;
+    std::string suffix = "_" + std::to_string(size);
+    suite.run("tensor", "add" + suffix, size, bytes, 0.0, [&] { Tensor c = a + b; });
+    suite.run("tensor", "sub" + suffix, size, bytes, 0.0, [&] { Tensor c = a - b; });
+    suite.run("tensor", "mul" + suffix, size, bytes, 0.0, [&] { Tensor c = a * b; });
+
+    // Активации на батче (256, 1024)
+    std::vector<size_t> shape = {256, 1024};
+    Tensor input = randomTensor(shape);
+    std::vector<std::pair<std::string, std::shared_ptr<Layer>>> activations = {
+        {"relu", std::make_shared<ReLU>()}, {"sigmoid", std::make_shared<Sigmoid>()},
+        {"softmax", std::make_shared<Softmax>()}};
+    for (auto& activation : activations) {
+        Layer& layer = *activation.second;
+        LayerCost cost = layer.cost(shape);
+        suite.run("tensor", activation.first + "_" + shapeName(shape), cost.forward_flops, cost.forward_bytes,
+                  shape[0], [&] { Tensor c = layer.forward(input); });
+    }
+}
+
+// Прямой и обратный проходы одного слоя
+void benchLayer(Suite& suite, const std::string& name, Layer& layer, const std::vector<size_t>& shape) {
+    Tensor input = randomTensor(shape);
+    Tensor grad = randomTensor(layer.inferShape(shape));
+    LayerCost cost = layer.cost(shape);
+    std::string label = name + "_" + shapeName(shape);
+    suite.run("layer", label + "/forward", cost.forward_flops, cost.forward_bytes, shape[0],
+              [&] { Tensor output = layer.forward(input); });
+    // Каждый обратный проход — после своего прямого, как при обучении
+    suite.run("layer", label + "/forward_backward", cost.forward_flops + cost.backward_flops,
+              cost.forward_bytes + cost.backward_bytes, shape[0], [&] {
+                  layer.forward(input);
+                  Tensor input_grad = layer.backward(grad);
+              });
+}
+
+void benchLayers(Suite& suite, bool quick) {
+    size_t batch = quick ? 8 : 32;
+    Conv2D conv1(3, 16, 3, 1, 1);
+    benchLayer(suite, "conv2d_3to16_k3", conv1, {batch, 3, 32, 32});
+    Conv2D conv2(16, 32, 3, 1, 1);
+    benchLayer(suite, "conv2d_16to32_k3", conv2, {batch, 16, 16, 16});
+
+    LSTM lstm(128, 256);
+    benchLayer(suite, "lstm_128to256_step", lstm, {quick ? size_t(16) : size_t(64), 128});
+
+    BatchNorm batch_norm(1024);
+    benchLayer(suite, "batchnorm", batch_norm, {quick ? size_t(64) : size_t(256), 1024});
+}
+
+void benchOptimizers(Suite& suite, bool quick) {
+    size_t size = quick ? 100000 : 1000000;
+    std::vector<std::pair<std::string, std::shared_ptr<Optimizer>>> optimizers = {
+        {"sgd", std::make_shared<SGD>(1e-3f)},
+        {"adam", std::make_shared<Adam>(1e-3f)},
+        {"adamw", std::make_shared<AdamW>(1e-3f)},
+        {"nadam", std::make_shared<Nadam>(1e-3f)},
+        {"adamax", std::make_shared<Adamax>(1e-3f)}};
+    Tensor params = randomTensor({size});
+    Tensor grads = randomTensor({size});
+    for (auto& entry : optimizers) {
+        Optimizer& optimizer = *entry.second;
+        // Оценка как у области optimizer.step профилировщика: параметры, градиенты и буферы состояния
+        optimizer.update(params.data(), grads.data(), size);
+        double buffers = static_cast<double>(optimizer.stateBuffers().size());
+        suite.run("optimizer", entry.first + "_" + std::to_string(size), (2.0 + 5.0 * buffers) * size,
+                  (3.0 + 2.0 * buffers) * 4.0 * size, 0.0,
+                  [&] { optimizer.update(params.data(), grads.data(), size); });
+    }
+}
+
+// Шаг обучения и вывод модели целиком на одном батче
+void benchModel(Suite& suite, const std::string& name, Model& model, const std::vector<size_t>& shape,
+                size_t classes) {
+    Tensor inputs = randomTensor(shape);
+    Tensor targets = oneHot(shape[0], classes);
+    LayerCost cost = modelCost(model, shape);
+    SoftmaxCrossEntropy loss;
+    Adam optimizer(1e-3f);
+    TrainerConfig config;
+    config.log = nullptr;
+    Trainer trainer(model, loss, optimizer, config);
+
+    suite.run("model", name + "/train_step", cost.forward_flops + cost.backward_flops,
+              cost.forward_bytes + cost.backward_bytes, shape[0], [&] { trainer.trainStep(inputs, targets); });
+    suite.run("model", name + "/infer", cost.forward_flops, cost.forward_bytes, shape[0],
+              [&] { Tensor output = model.infer(inputs); });
+}
+
+void benchModels(Suite& suite, bool quick) {
+    size_t batch = quick ? 16 : 64;
+
+    Model mlp;
+    mlp.addLayer(std::make_shared<DenseLayer>(784, 512, Activation::ReLU));
+    mlp.addLayer(std::make_shared<DenseLayer>(512, 256, Activation::ReLU));
+    mlp.addLayer(std::make_shared<DenseLayer>(256, 10));
+    benchModel(suite, "mlp_784-512-256-10", mlp, {batch, 784}, 10);
+
+    Model cnn;
+    cnn.addLayer(std::make_shared<Conv2D>(3, 16, 3, 1, 1, Activation::ReLU));
+    cnn.addLayer(std::make_shared<Conv2D>(16, 32, 3, 2, 1, Activation::ReLU));
+    cnn.addLayer(std::make_shared<DenseLayer>(32 * 16 * 16, 128, Activation::ReLU));
+    cnn.addLayer(std::make_shared<DenseLayer>(128, 10));
+    benchModel(suite, "cnn_32x32", cnn, {batch, 3, 32, 32}, 10);
+
+    // Один шаг последовательности на батч: LSTM и классификатор по скрытому состоянию
+    Model lstm;
+    lstm.addLayer(std::make_shared<LSTM>(64, 256));
+    lstm.addLayer(std::make_shared<DenseLayer>(256, 10));
+    benchModel(suite, "lstm_64-256-10", lstm, {batch, 64}, 10);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            options.json_path = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.min_seconds = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--quick") {
+            options.quick = true;
+            options.min_seconds = std::min(options.min_seconds, 0.1);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--json file] [--filter substring] [--min-time seconds] [--quick]\n";
+            return 2;
+        }
+    }
+
+    std::cout << "kernels: " << KernelRegistry::global().describe() << "\n";
+    std::cout << "threads: " << ThreadPool::global().concurrency() << ", min time: " << options.min_seconds
+              << " s per benchmark\n\n";
+    Suite suite(options);
+    suite.printHeader();
+    benchTensor(suite, options.quick);
+    benchLayers(suite, options.quick);
+    benchOptimizers(suite, options.quick);
+    benchModels(suite, options.quick);
+
+    if (!options.json_path.empty()) {
+        suite.writeJson(options.json_path);
+        std::cout << "\nresults: " << options.json_path << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// Стоимость контрольных точек обучения: обучение MLP с Adam без точек, с фоновой записью
+// точки каждые N шагов (снимок в память в потоке обучения, запись на диск в фоне) и с
+// синхронной записью каждые N шагов. Печатает примеры в секунду, время, которое точки
+// отнимают у потока обучения (и его долю), и время фоновой записи, затем проверяет, что
+// обучение, продолженное с точки, дает те же веса бит в бит, что и обучение без перерыва.
+// На одном ядре фоновая запись делит его с обучением.
+//
+// Сборка (из корня репозитория, одной командой):
+//   g++ -std=c++17 -O2 -march=native -pthread -I. benchmarks/bench_training_checkpoints.cpp model.cpp tensor.cpp
+//       layers/*.cpp initializers/*.cpp activations/*.cpp metrics/*.cpp optimizers/*.cpp kernels/*.cpp data/*.cpp
+//       training/*.cpp utils/*.cpp distributed/*.cpp -o bench_training_checkpoints
+// Запуск:
+//   ./bench_training_checkpoints [шагов между точками] [файл точки]
+
+#include "model.h"
+#include "layers/dense_layer.h"
+#include "layers/dropout.h"
+#include "metrics/cross_entropy.h"
+#include "optimizers/adam.h"
+#include "data/tensor_dataset.h"
+#include "training/trainer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+const size_t NUM_SAMPLES = 16384;
+const size_t INPUTS = 256;
+const size_t HIDDEN = 1024;
+const size_t CLASSES = 10;
+
+std::unique_ptr<Model> buildModel() {
+    std::unique_ptr<Model> model(new Model());
+    model->addLayer(std::make_shared<DenseLayer>(INPUTS, HIDDEN, Activation::ReLU));
+    model->addLayer(std::make_shared<Dropout>(0.1f));
+    model->addLayer(std::make_shared<DenseLayer>(HIDDEN, HIDDEN, Activation::ReLU));
+    model->addLayer(std::make_shared<DenseLayer>(HIDDEN, CLASSES));
+    return model;
+}
+
+// Синхронная запись точки каждые interval шагов (для сравнения с фоновой)
+class SyncCheckpointTrainer : public Trainer {
+public:
+    SyncCheckpointTrainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config,
+                          size_t interval, std::string path)
+        : Trainer(model, loss, optimizer, config), interval(interval), path(std::move(path)) {}
+
+    float trainStep(const Tensor& inputs, const Tensor& targets) override {
+        float value = Trainer::trainStep(inputs, targets);
+        if (++steps % interval == 0) {
+            auto start = std::chrono::steady_clock::now();
+            saveCheckpoint(path);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return value;
+    }
+
+    double seconds = 0.0; // Время синхронной записи
+
+private:
+    size_t interval;
+    std::string path;
+    size_t steps = 0;
+};
+
+// Точка, сохраненная синхронно перед шагом at (для проверки продолжения)
+class StopTrainer : public Trainer {
+public:
+    StopTrainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config, size_t at,
+                std::string path)
+        : Trainer(model, loss, optimizer, config), at(at), path(std::move(path)) {}
+
+    float trainStep(const Tensor& inputs, const Tensor& targets) override {
+        if (++steps == at) {
+            saveCheckpoint(path);
+        }
+        return Trainer::trainStep(inputs, targets);
+    }
+
+private:
+    size_t at;
+    std::string path;
+    size_t steps = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t interval = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50;
+    std::string path = argc > 2 ? argv[2] : "bench_training_checkpoints.kkc";
+
+    Tensor inputs({NUM_SAMPLES, INPUTS});
+    inputs.randomize(-1.0f, 1.0f);
+    Tensor targets({NUM_SAMPLES, CLASSES});
+    for (size_t n = 0; n < NUM_SAMPLES; ++n) {
+        targets[n * CLASSES + n % CLASSES] = 1.0f;
+    }
+    TensorDataset dataset(inputs, targets);
+    SoftmaxCrossEntropy loss;
+
+    TrainerConfig config;
+    config.epochs = 2;
+    config.batch_size = 128;
+    config.log = nullptr;
+
+    size_t parameters = INPUTS * HIDDEN + HIDDEN + HIDDEN * HIDDEN + HIDDEN + HIDDEN * CLASSES + CLASSES;
+    std::cout << "MLP " << INPUTS << "-" << HIDDEN << "-" << HIDDEN << "-" << CLASSES << ", Adam, "
+              << parameters * 3 * sizeof(float) / (1024 * 1024) << " MB per checkpoint, every " << interval
+              << " steps\n\n";
+    std::cout << std::setw(12) << "mode" << std::setw(12) << "samples/s" << std::setw(14) << "in training"
+              << std::setw(10) << "share" << std::setw(14) << "background" << "\n";
+
+    for (int mode = 0; mode < 3; ++mode) {
+        std::unique_ptr<Model> model = buildModel();
+        Adam optimizer(1e-3f);
+        TrainerConfig run_config = config;
+        std::unique_ptr<Trainer> trainer;
+        SyncCheckpointTrainer* sync = nullptr;
+        if (mode == 1) {
+            run_config.checkpoint_path = path;
+            run_config.checkpoint_interval = interval;
+            trainer.reset(new Trainer(*model, loss, optimizer, run_config));
+        } else if (mode == 2) {
+            sync = new SyncCheckpointTrainer(*model, loss, optimizer, run_config, interval, path);
+            trainer.reset(sync);
+        } else {
+            trainer.reset(new Trainer(*model, loss, optimizer, run_config));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        TrainingStats stats = trainer->fit(dataset);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double in_training = sync ? sync->seconds : stats.checkpoint_seconds;
+        const CheckpointWriter* writer = trainer->getCheckpointWriter();
+        static const char* names[] = {"none", "background", "sync"};
+        std::cout << std::setw(12) << names[mode] << std::fixed << std::setprecision(1) << std::setw(12)
+                  << stats.samples / seconds << std::setprecision(3) << std::setw(12) << in_training << " s"
+                  << std::setprecision(2) << std::setw(9) << 100.0 * in_training / seconds << "%"
+                  << std::setprecision(3) << std::setw(12) << (writer ? writer->getWriteSeconds() : 0.0) << " s\n";
+    }
+
+    // Продолжение с точки в середине эпохи дает те же веса, что и обучение без перерыва
+    std::unique_ptr<Model> reference = buildModel();
+    Adam reference_optimizer(1e-3f);
+    size_t stop = NUM_SAMPLES / config.batch_size + 7;
+    StopTrainer(*reference, loss, reference_optimizer, config, stop, path).fit(dataset);
+
+    std::unique_ptr<Model> resumed = buildModel();
+    Adam resumed_optimizer(1e-3f);
+    Trainer trainer(*resumed, loss, resumed_optimizer, config);
+    trainer.loadCheckpoint(path);
+    trainer.fit(dataset);
+
+    ParameterRegistry& expected = reference->getParameters();
+    ParameterRegistry& actual = resumed->getParameters();
+    bool exact = std::memcmp(expected.values(), actual.values(), expected.size() * sizeof(float)) == 0;
+    std::cout << "\nresume from step " << stop - 1 << ": weights " << (exact ? "bit-exact" : "DIFFER") << "\n";
+
+    std::remove(path.c_str());
+    return exact ? 0 : 1;
+}
@@ -0,0 +1,22 @@
+#include "dataset.h"
+#include <stdexcept>
+
+// Собрать батч по одному примеру
+void Dataset::getBatch(const size_t* indices, size_t count, Tensor& inputs, Tensor& targets) const {
+    if (count == 0) {
+        return;
+    }
+    size_t input_stride = inputs.size() / count;
+    size_t target_stride = targets.size() / count;
+    if (input_stride * count != inputs.size() || target_stride * count != targets.size()) {
+        throw std::invalid_argument("Batch tensors must have a leading axis of size count.");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        getSample(indices[i], inputs.data() + i * input_stride, targets.data() + i * target_stride);
+    }
+}
+
+// По умолчанию вид без копирования недоступен
+bool Dataset::viewBatch(size_t, size_t, Tensor&, Tensor&) const {
+    return false;
+}
@@ -0,0 +1,33 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "tensor.h"
+#include <vector>
+
+// Базовый класс для наборов данных с произвольным доступом к примерам
+class Dataset {
+public:
+    virtual ~Dataset() = default;
+
+    // Количество примеров
+    virtual size_t size() const = 0;
+
+    // Форма одного входного примера (без оси батча)
+    virtual std::vector<size_t> inputShape() const = 0;
+
+    // Форма цели одного примера (без оси батча)
+    virtual std::vector<size_t> targetShape() const = 0;
+
+    // Скопировать пример с индексом index в непрерывные буферы input и target
+    virtual void getSample(size_t index, float* input, float* target) const = 0;
+
+    // Собрать батч из примеров indices[0..count) в тензоры (count, ...).
+    // Тензоры должны быть заранее выделены нужной формы.
+    virtual void getBatch(const size_t* indices, size_t count, Tensor& inputs, Tensor& targets) const;
+
+    // Вид на подряд идущие примеры [first, first + count) без копирования.
+    // Возвращает false, если набор не может выдать такой вид; тогда используется getBatch.
+    virtual bool viewBatch(size_t first, size_t count, Tensor& inputs, Tensor& targets) const;
+};
+
+#endif // DATASET_H
@@ -0,0 +1,45 @@
+#ifndef DATASET_FORMAT_H
+#define DATASET_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Двоичный формат набора данных, разбитого на файлы-шарды (*.kds).
+//
+// Шард: заголовок (128 байт) | признаки | столбец меток.
+// Признаки начинаются с границы страницы и хранятся записями фиксированного размера
+// (record_bytes), поэтому несколько подряд идущих примеров float32 — непрерывный массив,
+// на который можно сделать Tensor-вид прямо в отображенной памяти.
+// Метки хранятся отдельным столбцом float32 (label_size значений на пример), выровненным по 64 байтам.
+// Все числа — little-endian.
+
+// Тип значений признаков
+enum class RecordType : uint32_t {
+    Float32 = 0, // float32
+    UInt8 = 1    // uint8, значение = байт * scale
+};
+
+// Заголовок шарда
+struct DatasetShardHeader {
+    char magic[4];            // "KKDS"
+    uint32_t version;         // Версия формата
+    uint32_t record_type;     // RecordType
+    uint32_t input_rank;      // Количество осей примера (не больше 4)
+    uint64_t input_shape[4];  // Форма примера
+    uint64_t label_size;      // Количество меток на пример (float32)
+    uint64_t num_records;     // Количество примеров в шарде
+    uint64_t record_bytes;    // Размер записи признаков в байтах
+    uint64_t features_offset; // Смещение признаков от начала файла
+    uint64_t labels_offset;   // Смещение столбца меток от начала файла
+    float scale;              // Множитель для UInt8
+    uint8_t reserved[36];
+};
+
+static_assert(sizeof(DatasetShardHeader) == 128, "Dataset shard header must be 128 bytes.");
+
+constexpr char DATASET_MAGIC[4] = {'K', 'K', 'D', 'S'};
+constexpr uint32_t DATASET_VERSION = 1;
+constexpr size_t DATASET_PAGE = 4096;     // Выравнивание начала признаков
+constexpr size_t DATASET_ALIGNMENT = 64;  // Выравнивание столбца меток
+
+#endif // DATASET_FORMAT_H
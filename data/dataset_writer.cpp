@@ -0,0 +1,131 @@
+#include "dataset_writer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Дополнить файл нулями до смещения offset
+void padTo(std::ofstream& file, size_t offset) {
+    static const char zeros[DATASET_PAGE] = {};
+    size_t position = static_cast<size_t>(file.tellp());
+    while (position < offset) {
+        size_t chunk = std::min(offset - position, DATASET_PAGE);
+        file.write(zeros, chunk);
+        position += chunk;
+    }
+}
+}
+
+// Конструктор
+DatasetWriter::DatasetWriter(const std::string& prefix, const std::vector<size_t>& input_shape, size_t label_size,
+                             RecordType type, float scale, size_t records_per_shard)
+    : prefix(prefix), records_per_shard(records_per_shard) {
+    if (input_shape.empty() || input_shape.size() > 4) {
+        throw std::invalid_argument("Input shape must have between 1 and 4 axes.");
+    }
+    if (records_per_shard == 0 || (type == RecordType::UInt8 && !(scale > 0.0f))) {
+        throw std::invalid_argument("Records per shard and uint8 scale must be positive.");
+    }
+
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+    header.version = DATASET_VERSION;
+    header.record_type = static_cast<uint32_t>(type);
+    header.input_rank = static_cast<uint32_t>(input_shape.size());
+    input_size = 1;
+    for (size_t i = 0; i < input_shape.size(); ++i) {
+        header.input_shape[i] = input_shape[i];
+        input_size *= input_shape[i];
+    }
+    header.label_size = label_size;
+    header.record_bytes = input_size * (type == RecordType::Float32 ? sizeof(float) : 1);
+    header.features_offset = DATASET_PAGE;
+    header.scale = type == RecordType::UInt8 ? scale : 1.0f;
+    record.resize(header.record_bytes);
+}
+
+// Деструктор
+DatasetWriter::~DatasetWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Ошибки записи при разрушении не пробрасываются; вызывайте close() явно
+    }
+}
+
+// Открыть новый шард
+void DatasetWriter::openShard() {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), "-%05zu.kds", paths.size());
+    std::string path = prefix + suffix;
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot create dataset shard: " + path);
+    }
+    paths.push_back(path);
+    header.num_records = 0;
+    labels.clear();
+
+    // Заголовок перезаписывается при закрытии шарда
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    padTo(file, header.features_offset);
+}
+
+// Добавить пример
+void DatasetWriter::write(const float* input, const float* label) {
+    if (!file.is_open()) {
+        openShard();
+    }
+
+    if (static_cast<RecordType>(header.record_type) == RecordType::Float32) {
+        std::memcpy(record.data(), input, header.record_bytes);
+    } else {
+        float inv_scale = 1.0f / header.scale;
+        for (size_t i = 0; i < input_size; ++i) {
+            float value = std::round(input[i] * inv_scale);
+            record[i] = static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, value)));
+        }
+    }
+    file.write(reinterpret_cast<const char*>(record.data()), record.size());
+    labels.insert(labels.end(), label, label + header.label_size);
+
+    header.num_records += 1;
+    total_records += 1;
+    if (header.num_records == records_per_shard) {
+        close();
+    }
+}
+
+// Завершить текущий шард
+void DatasetWriter::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    header.labels_offset = alignUp(header.features_offset + header.num_records * header.record_bytes,
+                                   DATASET_ALIGNMENT);
+    padTo(file, header.labels_offset);
+    file.write(reinterpret_cast<const char*>(labels.data()), labels.size() * sizeof(float));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Failed to write dataset shard: " + paths.back());
+    }
+    file.clear();
+}
+
+// Пути шардов
+const std::vector<std::string>& DatasetWriter::getShardPaths() const {
+    return paths;
+}
+
+// Количество примеров
+size_t DatasetWriter::getNumRecords() const {
+    return total_records;
+}
@@ -0,0 +1,50 @@
+#ifndef DATASET_WRITER_H
+#define DATASET_WRITER_H
+
+#include "dataset_format.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Запись набора данных в шарды формата KKDS (см. dataset_format.h).
+// Шарды называются "<prefix>-00000.kds", "<prefix>-00001.kds", ...
+class DatasetWriter {
+public:
+    // input_shape — форма примера, label_size — количество меток на пример.
+    // Для RecordType::UInt8 значения сохраняются как round(x / scale) с насыщением в [0, 255].
+    DatasetWriter(const std::string& prefix, const std::vector<size_t>& input_shape, size_t label_size,
+                  RecordType type = RecordType::Float32, float scale = 1.0f, size_t records_per_shard = 1 << 20);
+
+    // Завершает текущий шард
+    ~DatasetWriter();
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    // Добавить пример: input — input_size значений, label — label_size значений
+    void write(const float* input, const float* label);
+
+    // Завершить текущий шард (записать метки и заголовок)
+    void close();
+
+    // Пути записанных шардов
+    const std::vector<std::string>& getShardPaths() const;
+
+    // Количество записанных примеров
+    size_t getNumRecords() const;
+
+private:
+    std::string prefix;
+    DatasetShardHeader header;         // Заголовок текущего шарда
+    size_t input_size;                 // Значений признаков в примере
+    size_t records_per_shard;
+    std::ofstream file;                // Текущий шард
+    std::vector<float> labels;         // Метки текущего шарда (пишутся при закрытии)
+    std::vector<unsigned char> record; // Буфер одной записи
+    std::vector<std::string> paths;
+    size_t total_records = 0;
+
+    void openShard();
+};
+
+#endif // DATASET_WRITER_H
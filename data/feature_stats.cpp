@@ -0,0 +1,271 @@
+#include "feature_stats.h"
+#include "kernels/simd.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+constexpr char STATS_MAGIC[4] = {'K', 'K', 'S', 'T'};
+constexpr uint32_t STATS_VERSION = 1;
+
+// Статистика столбцов [f, f + V::width) куска из count строк: сначала минимум, максимум и среднее,
+// затем сумма квадратов отклонений от среднего куска (кусок еще в кэше, поэтому второй проход дешев)
+template <class V>
+void columnBlock(const float* rows, size_t count, size_t stride, size_t f, float* mn, float* mx, float* mean,
+                 float* m2) {
+    const float* p = rows + f;
+    // Суммируются отклонения от первой строки: меньше потеря точности при большом смещении данных
+    V pivot = V::load(p);
+    V lo = pivot;
+    V hi = pivot;
+    V sum = V::set1(0.0f);
+    for (size_t r = 1; r < count; ++r) {
+        V x = V::load(p + r * stride);
+        lo = min(lo, x);
+        hi = max(hi, x);
+        sum = sum + (x - pivot);
+    }
+    V mu = pivot + sum * V::set1(1.0f / static_cast<float>(count));
+    V sq = V::set1(0.0f);
+    for (size_t r = 0; r < count; ++r) {
+        V d = V::load(p + r * stride) - mu;
+        sq = sq + d * d;
+    }
+    lo.store(mn + f);
+    hi.store(mx + f);
+    mu.store(mean + f);
+    sq.store(m2 + f);
+}
+
+// Статистика куска строк; out — четыре массива по features значений (min, max, mean, m2)
+void chunkStats(const float* rows, size_t count, size_t features, float* out) {
+    float* mn = out;
+    float* mx = out + features;
+    float* mean = out + 2 * features;
+    float* m2 = out + 3 * features;
+    size_t f = 0;
+    for (; f + simd::Native::width <= features; f += simd::Native::width) {
+        columnBlock<simd::Native>(rows, count, features, f, mn, mx, mean, m2);
+    }
+    for (; f < features; ++f) {
+        columnBlock<simd::Scalar>(rows, count, features, f, mn, mx, mean, m2);
+    }
+}
+
+// Объединение моментов (формула Чана): к (n_a, mean, m2, min, max) добавляется часть из n_b примеров
+template <class T>
+void combine(size_t n_a, size_t n_b, size_t features, double* mean, double* m2, double* mn, double* mx,
+             const T* mean_b, const T* m2_b, const T* mn_b, const T* mx_b) {
+    if (n_b == 0) {
+        return;
+    }
+    double n = static_cast<double>(n_a + n_b);
+    double w = static_cast<double>(n_b) / n;
+    double cross = static_cast<double>(n_a) * static_cast<double>(n_b) / n;
+    for (size_t f = 0; f < features; ++f) {
+        double delta = static_cast<double>(mean_b[f]) - mean[f];
+        mean[f] += delta * w;
+        m2[f] += static_cast<double>(m2_b[f]) + delta * delta * cross;
+        if (n_a == 0) {
+            mn[f] = mn_b[f];
+            mx[f] = mx_b[f];
+        } else {
+            mn[f] = std::min<double>(mn[f], mn_b[f]);
+            mx[f] = std::max<double>(mx[f], mx_b[f]);
+        }
+        // Постоянный признак: округления float не должны давать ненулевую дисперсию
+        if (mn[f] == mx[f]) {
+            mean[f] = mn[f];
+            m2[f] = 0.0;
+        }
+    }
+}
+}
+
+// Конструктор
+FeatureStats::FeatureStats(size_t num_features)
+    : num_features(num_features), min(num_features, 0.0), max(num_features, 0.0), mean(num_features, 0.0),
+      m2(num_features, 0.0) {}
+
+// Учесть строки
+void FeatureStats::update(const float* rows, size_t rows_count) {
+    if (rows_count == 0 || num_features == 0) {
+        return;
+    }
+
+    // Кусок ~256 КБ: помещается в L2 на время обоих проходов
+    size_t chunk_rows = std::max<size_t>(16, (size_t(1) << 16) / num_features);
+    size_t chunks = (rows_count + chunk_rows - 1) / chunk_rows;
+    std::vector<float> partial(chunks * 4 * num_features);
+    ThreadPool::global().parallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            size_t first = c * chunk_rows;
+            size_t n = std::min(chunk_rows, rows_count - first);
+            chunkStats(rows + first * num_features, n, num_features, partial.data() + c * 4 * num_features);
+        }
+    });
+
+    // Куски объединяются по порядку, поэтому результат не зависит от числа потоков
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t n = std::min(chunk_rows, rows_count - c * chunk_rows);
+        const float* p = partial.data() + c * 4 * num_features;
+        combine(count, n, num_features, mean.data(), m2.data(), min.data(), max.data(), p + 2 * num_features,
+                p + 3 * num_features, p, p + num_features);
+        count += n;
+    }
+}
+
+// Объединить статистики
+void FeatureStats::merge(const FeatureStats& other) {
+    if (other.num_features != num_features) {
+        throw std::invalid_argument("Cannot merge statistics with a different number of features.");
+    }
+    combine(count, other.count, num_features, mean.data(), m2.data(), min.data(), max.data(), other.mean.data(),
+            other.m2.data(), other.min.data(), other.max.data());
+    count += other.count;
+}
+
+// Статистика набора данных за один проход
+FeatureStats FeatureStats::fit(const Dataset& dataset, size_t batch_size) {
+    std::vector<size_t> input_shape = dataset.inputShape();
+    std::vector<size_t> target_shape = dataset.targetShape();
+    size_t features = std::accumulate(input_shape.begin(), input_shape.end(), size_t(1), std::multiplies<size_t>());
+    FeatureStats stats(features);
+
+    size_t num_samples = dataset.size();
+    batch_size = std::max<size_t>(1, std::min(batch_size, num_samples));
+    input_shape.insert(input_shape.begin(), batch_size);
+    target_shape.insert(target_shape.begin(), batch_size);
+    Tensor inputs(input_shape);
+    Tensor targets(target_shape);
+    Tensor view_inputs({0});
+    Tensor view_targets({0});
+    std::vector<size_t> indices(batch_size);
+
+    for (size_t start = 0; start < num_samples; start += batch_size) {
+        size_t n = std::min(batch_size, num_samples - start);
+        if (dataset.viewBatch(start, n, view_inputs, view_targets)) {
+            stats.update(view_inputs.data(), n);
+            continue;
+        }
+        std::iota(indices.begin(), indices.begin() + n, start);
+        if (n == batch_size) {
+            dataset.getBatch(indices.data(), n, inputs, targets);
+        } else {
+            // Неполный последний батч собирается в начало полного буфера
+            input_shape[0] = n;
+            target_shape[0] = n;
+            Tensor tail_inputs = Tensor::view(inputs.data(), input_shape);
+            Tensor tail_targets = Tensor::view(targets.data(), target_shape);
+            dataset.getBatch(indices.data(), n, tail_inputs, tail_targets);
+        }
+        stats.update(inputs.data(), n);
+    }
+    return stats;
+}
+
+// Количество признаков
+size_t FeatureStats::getNumFeatures() const {
+    return num_features;
+}
+
+// Количество учтенных примеров
+size_t FeatureStats::getCount() const {
+    return count;
+}
+
+// Минимумы
+const std::vector<double>& FeatureStats::getMin() const {
+    return min;
+}
+
+// Максимумы
+const std::vector<double>& FeatureStats::getMax() const {
+    return max;
+}
+
+// Средние
+const std::vector<double>& FeatureStats::getMean() const {
+    return mean;
+}
+
+// Дисперсии
+std::vector<double> FeatureStats::getVariance() const {
+    std::vector<double> variance(num_features, 0.0);
+    if (count > 0) {
+        for (size_t f = 0; f < num_features; ++f) {
+            variance[f] = m2[f] / static_cast<double>(count);
+        }
+    }
+    return variance;
+}
+
+// Стандартизация
+std::shared_ptr<AffineTransform> FeatureStats::standardizer(double epsilon) const {
+    if (count == 0) {
+        throw std::logic_error("Statistics are empty.");
+    }
+    std::vector<float> shift(num_features);
+    std::vector<float> scale(num_features);
+    for (size_t f = 0; f < num_features; ++f) {
+        double stddev = std::sqrt(m2[f] / static_cast<double>(count));
+        shift[f] = static_cast<float>(mean[f]);
+        scale[f] = stddev > epsilon ? static_cast<float>(1.0 / stddev) : 0.0f;
+    }
+    return std::make_shared<AffineTransform>(std::move(shift), std::move(scale));
+}
+
+// Масштабирование в [0, 1]
+std::shared_ptr<AffineTransform> FeatureStats::minMaxScaler() const {
+    if (count == 0) {
+        throw std::logic_error("Statistics are empty.");
+    }
+    std::vector<float> shift(num_features);
+    std::vector<float> scale(num_features);
+    for (size_t f = 0; f < num_features; ++f) {
+        double range = max[f] - min[f];
+        shift[f] = static_cast<float>(min[f]);
+        scale[f] = range > 0.0 ? static_cast<float>(1.0 / range) : 0.0f;
+    }
+    return std::make_shared<AffineTransform>(std::move(shift), std::move(scale));
+}
+
+// Сохранить статистику
+void FeatureStats::save(std::ofstream& file) const {
+    uint64_t header[2] = {num_features, count};
+    file.write(STATS_MAGIC, sizeof(STATS_MAGIC));
+    file.write(reinterpret_cast<const char*>(&STATS_VERSION), sizeof(STATS_VERSION));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const std::vector<double>* values : {&min, &max, &mean, &m2}) {
+        file.write(reinterpret_cast<const char*>(values->data()), values->size() * sizeof(double));
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write feature statistics.");
+    }
+}
+
+// Загрузить статистику
+FeatureStats FeatureStats::load(std::ifstream& file) {
+    char magic[4];
+    uint32_t version = 0;
+    uint64_t header[2] = {0, 0};
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(magic, STATS_MAGIC, sizeof(magic)) != 0 || version != STATS_VERSION) {
+        throw std::runtime_error("Not a feature statistics file.");
+    }
+    FeatureStats stats(header[0]);
+    stats.count = header[1];
+    for (std::vector<double>* values : {&stats.min, &stats.max, &stats.mean, &stats.m2}) {
+        file.read(reinterpret_cast<char*>(values->data()), values->size() * sizeof(double));
+    }
+    if (!file) {
+        throw std::runtime_error("Feature statistics file is truncated.");
+    }
+    return stats;
+}
@@ -0,0 +1,55 @@
+#ifndef FEATURE_STATS_H
+#define FEATURE_STATS_H
+
+#include "dataset.h"
+#include "transform.h"
+#include <fstream>
+#include <memory>
+#include <vector>
+
+// Потоковая статистика признаков: минимум, максимум, среднее и дисперсия каждого признака.
+// Данные обрабатываются кусками строк параллельно; статистики кусков объединяются
+// формулой Чана (параллельный Велфорд), поэтому весь набор просматривается один раз
+// и его не нужно держать в памяти. Накопители — double, обход данных — float SIMD.
+class FeatureStats {
+public:
+    explicit FeatureStats(size_t num_features = 0);
+
+    // Учесть count строк по num_features значений (строки подряд в rows)
+    void update(const float* rows, size_t count);
+
+    // Объединить со статистикой другой части данных
+    void merge(const FeatureStats& other);
+
+    // Статистика входов набора данных за один проход
+    static FeatureStats fit(const Dataset& dataset, size_t batch_size = 4096);
+
+    size_t getNumFeatures() const;
+    size_t getCount() const;
+    const std::vector<double>& getMin() const;
+    const std::vector<double>& getMax() const;
+    const std::vector<double>& getMean() const;
+
+    // Дисперсия по совокупности (деление на count)
+    std::vector<double> getVariance() const;
+
+    // Стандартизация (x - mean) / std. Признаки с std <= epsilon переводятся в 0.
+    std::shared_ptr<AffineTransform> standardizer(double epsilon = 1e-12) const;
+
+    // Масштабирование в [0, 1]. Постоянные признаки переводятся в 0.
+    std::shared_ptr<AffineTransform> minMaxScaler() const;
+
+    // Сохранить и загрузить подобранную статистику
+    void save(std::ofstream& file) const;
+    static FeatureStats load(std::ifstream& file);
+
+private:
+    size_t num_features;
+    size_t count = 0;
+    std::vector<double> min;
+    std::vector<double> max;
+    std::vector<double> mean;
+    std::vector<double> m2; // Сумма квадратов отклонений от среднего
+};
+
+#endif // FEATURE_STATS_H
@@ -0,0 +1,252 @@
+#include "mapped_dataset.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Открыть шарды
+MappedDataset::MappedDataset(const std::vector<std::string>& shard_paths) {
+    if (shard_paths.empty()) {
+        throw std::invalid_argument("No dataset shards given.");
+    }
+    try {
+        for (const std::string& path : shard_paths) {
+            mapShard(path);
+        }
+    } catch (...) {
+        for (const Shard& shard : shards) {
+            munmap(shard.base, shard.length);
+        }
+        throw;
+    }
+}
+
+// Открыть шарды по префиксу
+MappedDataset::MappedDataset(const std::string& prefix) : MappedDataset(findShards(prefix)) {}
+
+// Освободить отображения
+MappedDataset::~MappedDataset() {
+    for (const Shard& shard : shards) {
+        munmap(shard.base, shard.length);
+    }
+}
+
+// Найти шарды по префиксу
+std::vector<std::string> MappedDataset::findShards(const std::string& prefix) {
+    std::vector<std::string> paths;
+    for (size_t i = 0;; ++i) {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), "-%05zu.kds", i);
+        struct stat info;
+        if (stat((prefix + suffix).c_str(), &info) != 0) {
+            break;
+        }
+        paths.push_back(prefix + suffix);
+    }
+    if (paths.empty()) {
+        paths.push_back(prefix);
+    }
+    return paths;
+}
+
+// Открыть и проверить шард
+void MappedDataset::mapShard(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open dataset shard: " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(DatasetShardHeader)) {
+        close(fd);
+        throw std::runtime_error("Dataset shard is truncated: " + path);
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+
+    // MAP_PRIVATE с правом записи: виды батчей можно передавать слоям как обычные тензоры,
+    // случайная запись изменит только копию страницы, а не файл
+    void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Cannot map dataset shard: " + path);
+    }
+
+    DatasetShardHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    auto fail = [&](const std::string& what) {
+        munmap(base, length);
+        throw std::runtime_error(what + ": " + path);
+    };
+    if (std::memcmp(header.magic, DATASET_MAGIC, sizeof(header.magic)) != 0) {
+        fail("Not a dataset shard");
+    }
+    if (header.version != DATASET_VERSION) {
+        fail("Unsupported dataset version " + std::to_string(header.version));
+    }
+    if (header.input_rank == 0 || header.input_rank > 4 ||
+        header.record_type > static_cast<uint32_t>(RecordType::UInt8)) {
+        fail("Corrupted dataset header");
+    }
+
+    std::vector<size_t> shape(header.input_shape, header.input_shape + header.input_rank);
+    size_t size = 1;
+    for (size_t dim : shape) {
+        size *= dim;
+    }
+    RecordType type = static_cast<RecordType>(header.record_type);
+    size_t bytes = size * (type == RecordType::Float32 ? sizeof(float) : 1);
+    if (header.record_bytes != bytes || header.features_offset % DATASET_PAGE != 0 ||
+        header.labels_offset % DATASET_ALIGNMENT != 0 ||
+        header.features_offset + header.num_records * header.record_bytes > header.labels_offset ||
+        header.labels_offset + header.num_records * header.label_size * sizeof(float) > length) {
+        fail("Dataset shard layout is inconsistent");
+    }
+
+    if (shards.empty()) {
+        input_shape = shape;
+        input_size = size;
+        label_size = header.label_size;
+        record_bytes = header.record_bytes;
+        record_type = type;
+        scale = header.scale;
+    } else if (shape != input_shape || header.label_size != label_size || type != record_type ||
+               header.scale != scale) {
+        fail("Dataset shard does not match the first shard");
+    }
+
+    const unsigned char* bytes_base = static_cast<const unsigned char*>(base);
+    shards.push_back({base, length, total, header.num_records, bytes_base + header.features_offset,
+                      reinterpret_cast<const float*>(bytes_base + header.labels_offset)});
+    total += header.num_records;
+}
+
+// Количество примеров
+size_t MappedDataset::size() const {
+    return total;
+}
+
+// Форма примера
+std::vector<size_t> MappedDataset::inputShape() const {
+    return input_shape;
+}
+
+// Форма меток
+std::vector<size_t> MappedDataset::targetShape() const {
+    return {label_size};
+}
+
+// Шард, содержащий пример
+const MappedDataset::Shard& MappedDataset::locate(size_t index) const {
+    if (index >= total) {
+        throw std::out_of_range("Dataset index out of range.");
+    }
+    auto it = std::upper_bound(shards.begin(), shards.end(), index,
+                               [](size_t value, const Shard& shard) { return value < shard.first; });
+    return *(it - 1);
+}
+
+// Скопировать подряд идущие примеры шарда
+void MappedDataset::copyRecords(const Shard& shard, size_t local, size_t count, float* input, float* target) const {
+    const unsigned char* src = shard.features + local * record_bytes;
+    if (record_type == RecordType::Float32) {
+        std::memcpy(input, src, count * record_bytes);
+    } else {
+        size_t n = count * input_size;
+        for (size_t i = 0; i < n; ++i) {
+            input[i] = src[i] * scale;
+        }
+    }
+    std::memcpy(target, shard.labels + local * label_size, count * label_size * sizeof(float));
+}
+
+// Скопировать пример
+void MappedDataset::getSample(size_t index, float* input, float* target) const {
+    const Shard& shard = locate(index);
+    copyRecords(shard, index - shard.first, 1, input, target);
+}
+
+// Собрать батч: серии подряд идущих индексов одного шарда копируются одним блоком
+void MappedDataset::getBatch(const size_t* indices, size_t count, Tensor& inputs, Tensor& targets) const {
+    if (count == 0) {
+        return;
+    }
+    if (inputs.size() != count * input_size || targets.size() != count * label_size) {
+        throw std::invalid_argument("Batch tensors must have a leading axis of size count.");
+    }
+    float* input = inputs.data();
+    float* target = targets.data();
+    for (size_t i = 0; i < count;) {
+        const Shard& shard = locate(indices[i]);
+        size_t run = 1;
+        while (i + run < count && indices[i + run] == indices[i] + run && indices[i + run] < shard.first + shard.count) {
+            ++run;
+        }
+        copyRecords(shard, indices[i] - shard.first, run, input + i * input_size, target + i * label_size);
+        i += run;
+    }
+}
+
+// Вид на подряд идущие примеры без копирования
+bool MappedDataset::viewBatch(size_t first, size_t count, Tensor& inputs, Tensor& targets) const {
+    if (record_type != RecordType::Float32 || count == 0 || first + count > total) {
+        return false;
+    }
+    const Shard& shard = locate(first);
+    size_t local = first - shard.first;
+    if (local + count > shard.count) {
+        return false;
+    }
+
+    std::vector<size_t> shape = input_shape;
+    shape.insert(shape.begin(), count);
+    // Отображение создано с PROT_WRITE | MAP_PRIVATE, поэтому снятие const безопасно
+    inputs = Tensor::view(reinterpret_cast<float*>(const_cast<unsigned char*>(shard.features + local * record_bytes)),
+                          shape);
+    targets = Tensor::view(const_cast<float*>(shard.labels + local * label_size), {count, label_size});
+    return true;
+}
+
+// Последовательное чтение: ядро читает страницы наперед
+void MappedDataset::adviseSequential() const {
+    for (const Shard& shard : shards) {
+        madvise(shard.base, shard.length, MADV_SEQUENTIAL);
+    }
+}
+
+// Случайное чтение: без упреждающего чтения
+void MappedDataset::adviseRandom() const {
+    for (const Shard& shard : shards) {
+        madvise(shard.base, shard.length, MADV_RANDOM);
+    }
+}
+
+// Начать чтение страниц примеров
+void MappedDataset::prefetch(size_t first, size_t count) const {
+    size_t end = std::min(total, first + count);
+    while (first < end) {
+        const Shard& shard = locate(first);
+        size_t local = first - shard.first;
+        size_t run = std::min(end - first, shard.count - local);
+
+        // madvise требует адрес, выровненный по странице
+        const unsigned char* begin = shard.features + local * record_bytes;
+        const unsigned char* stop = begin + run * record_bytes;
+        uintptr_t aligned = reinterpret_cast<uintptr_t>(begin) & ~(uintptr_t(DATASET_PAGE) - 1);
+        madvise(reinterpret_cast<void*>(aligned), stop - reinterpret_cast<const unsigned char*>(aligned),
+                MADV_WILLNEED);
+        first += run;
+    }
+}
+
+// Тип значений признаков
+RecordType MappedDataset::getRecordType() const {
+    return record_type;
+}
+
+// Количество шардов
+size_t MappedDataset::getNumShards() const {
+    return shards.size();
+}
@@ -0,0 +1,82 @@
+#ifndef MAPPED_DATASET_H
+#define MAPPED_DATASET_H
+
+#include "dataset.h"
+#include "dataset_format.h"
+#include <string>
+#include <vector>
+
+// Набор данных в шардах формата KKDS, отображенных в память (mmap).
+// Страницы читаются с диска по мере обращения, поэтому набор может быть больше памяти.
+// Для признаков float32 батч из подряд идущих примеров одного шарда выдается как вид
+// на отображенные страницы без копирования (viewBatch). Перемешивание выполняется
+// перестановкой индексов, передаваемых в getBatch.
+class MappedDataset : public Dataset {
+public:
+    // Открыть шарды (должны иметь одинаковые формы примеров и меток)
+    explicit MappedDataset(const std::vector<std::string>& shard_paths);
+
+    // Открыть шарды "<prefix>-00000.kds", "<prefix>-00001.kds", ... или один файл prefix
+    explicit MappedDataset(const std::string& prefix);
+
+    ~MappedDataset() override;
+
+    MappedDataset(const MappedDataset&) = delete;
+    MappedDataset& operator=(const MappedDataset&) = delete;
+
+    size_t size() const override;
+    std::vector<size_t> inputShape() const override;
+    std::vector<size_t> targetShape() const override;
+    void getSample(size_t index, float* input, float* target) const override;
+
+    // Сборка батча: подряд идущие индексы копируются одним блоком
+    void getBatch(const size_t* indices, size_t count, Tensor& inputs, Tensor& targets) const override;
+
+    // Вид на примеры [first, first + count) без копирования (float32, в пределах одного шарда)
+    bool viewBatch(size_t first, size_t count, Tensor& inputs, Tensor& targets) const override;
+
+    // Подсказки ядру о порядке чтения (madvise)
+    void adviseSequential() const;
+    void adviseRandom() const;
+
+    // Начать асинхронное чтение страниц примеров [first, first + count)
+    void prefetch(size_t first, size_t count) const;
+
+    // Тип значений признаков и количество шардов
+    RecordType getRecordType() const;
+    size_t getNumShards() const;
+
+    // Найти шарды по префиксу
+    static std::vector<std::string> findShards(const std::string& prefix);
+
+private:
+    // Отображенный шард
+    struct Shard {
+        void* base;                    // Начало отображения
+        size_t length;                 // Длина отображения
+        size_t first;                  // Глобальный индекс первого примера
+        size_t count;                  // Количество примеров
+        const unsigned char* features; // Начало признаков
+        const float* labels;           // Начало столбца меток
+    };
+
+    std::vector<Shard> shards;
+    std::vector<size_t> input_shape;
+    size_t input_size = 0;  // Значений признаков в примере
+    size_t label_size = 0;  // Меток в примере
+    size_t record_bytes = 0;
+    RecordType record_type = RecordType::Float32;
+    float scale = 1.0f;
+    size_t total = 0;
+
+    // Открыть и проверить шард
+    void mapShard(const std::string& path);
+
+    // Шард, содержащий пример index
+    const Shard& locate(size_t index) const;
+
+    // Скопировать count подряд идущих примеров шарда, начиная с локального индекса local
+    void copyRecords(const Shard& shard, size_t local, size_t count, float* input, float* target) const;
+};
+
+#endif // MAPPED_DATASET_H
@@ -0,0 +1,291 @@
+#include "pipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <sys/mman.h>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+uint64_t nanosSince(clock_type::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start).count();
+}
+
+// Ожидание в цикле опроса: сначала уступаем процессор, затем короткий сон
+void backoff(size_t& attempt) {
+    if (attempt < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    ++attempt;
+}
+
+size_t elements(const std::vector<size_t>& shape) {
+    return std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+}
+
+std::vector<size_t> batchShape(size_t count, std::vector<size_t> shape) {
+    shape.insert(shape.begin(), count);
+    return shape;
+}
+}
+
+// Доля времени ожидания данных
+double PipelineMetrics::stallFraction(double wall_seconds) const {
+    return wall_seconds > 0.0 ? stall_seconds / wall_seconds : 0.0;
+}
+
+// Конструктор: выделить буферы и запустить производителей
+DataPipeline::DataPipeline(const Dataset& dataset, const PipelineConfig& config)
+    : dataset(dataset), config(config), rng(config.seed), slots(std::max<size_t>(1, config.prefetch)),
+      free_slots(slots.size()), ready_slots(slots.size()) {
+    size_t num_samples = dataset.size();
+    if (config.batch_size == 0 || num_samples == 0) {
+        throw std::invalid_argument("Batch size and dataset size must be positive.");
+    }
+    size_t batch_size = std::min(config.batch_size, num_samples);
+    this->config.batch_size = batch_size;
+    size_t tail = num_samples % batch_size;
+    steps_per_epoch = num_samples / batch_size + ((tail && !config.drop_last) ? 1 : 0);
+    input_stride = elements(dataset.inputShape());
+    target_stride = elements(dataset.targetShape());
+
+    indices.resize(num_samples);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+        slots[i].inputs.resize(batch_size * input_stride);
+        slots[i].targets.resize(batch_size * target_stride);
+        if (config.lock_memory) {
+            // Без прав на закрепление буферы остаются обычной памятью
+            mlock(slots[i].inputs.data(), slots[i].inputs.size() * sizeof(float));
+            mlock(slots[i].targets.data(), slots[i].targets.size() * sizeof(float));
+        }
+        free_slots.tryPush(i);
+    }
+
+    size_t num_workers = std::max<size_t>(1, config.num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(&DataPipeline::workerLoop, this);
+    }
+}
+
+// Деструктор: остановить производителей
+DataPipeline::~DataPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    epoch_changed.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Добавить стадию преобразования
+void DataPipeline::addTransform(std::shared_ptr<BatchTransform> transform) {
+    if (epoch_started) {
+        throw std::logic_error("Transforms must be added before the epoch starts.");
+    }
+    transforms.push_back(std::move(transform));
+}
+
+// Начать эпоху
+void DataPipeline::startEpoch() {
+    // Незавершенная эпоха дочитывается, чтобы все буферы вернулись в пул
+    while (epoch_started && next()) {
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    workers_idle.wait(lock, [this] { return idle_workers == workers.size(); });
+    if (config.shuffle) {
+        std::shuffle(indices.begin(), indices.end(), rng);
+    }
+    next_step.store(0);
+    delivered = 0;
+    reorder.clear();
+    epoch_started = true;
+    epoch += 1;
+    lock.unlock();
+    epoch_changed.notify_all();
+}
+
+// Следующий батч эпохи
+const PipelineBatch* DataPipeline::next() {
+    if (!epoch_started) {
+        throw std::logic_error("startEpoch() must be called before next().");
+    }
+    if (current != SIZE_MAX) {
+        free_slots.tryPush(current);
+        current = SIZE_MAX;
+    }
+    if (delivered == steps_per_epoch) {
+        epoch_started = false;
+        return nullptr;
+    }
+
+    depth_sum += ready_slots.sizeApprox() + reorder.size();
+
+    // Батчи выдаются по порядку шагов: пришедшие раньше ждут в reorder
+    size_t slot = SIZE_MAX;
+    for (size_t i = 0; i < reorder.size(); ++i) {
+        if (slots[reorder[i]].batch.step == delivered) {
+            slot = reorder[i];
+            reorder.erase(reorder.begin() + i);
+            break;
+        }
+    }
+
+    size_t attempt = 0;
+    clock_type::time_point stall_start;
+    while (slot == SIZE_MAX) {
+        size_t candidate;
+        if (ready_slots.tryPop(candidate)) {
+            if (slots[candidate].batch.step == delivered) {
+                slot = candidate;
+            } else {
+                reorder.push_back(candidate);
+            }
+            continue;
+        }
+        if (failed.load()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::rethrow_exception(error);
+        }
+        if (attempt == 0) {
+            stall_start = clock_type::now();
+            metrics.stalls += 1;
+        }
+        backoff(attempt);
+    }
+    if (attempt > 0) {
+        metrics.stall_seconds += nanosSince(stall_start) * 1e-9;
+    }
+
+    metrics.batches += 1;
+    delivered += 1;
+    current = slot;
+    return &slots[slot].batch;
+}
+
+// Цикл производителя
+void DataPipeline::workerLoop() {
+    size_t seen_epoch = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            idle_workers += 1;
+            workers_idle.notify_all();
+            epoch_changed.wait(lock, [&] { return stopping || epoch != seen_epoch; });
+            if (stopping) {
+                return;
+            }
+            seen_epoch = epoch;
+            idle_workers -= 1;
+        }
+
+        while (true) {
+            // Сначала буфер, затем номер шага: шаг с наименьшим номером всегда имеет буфер,
+            // поэтому потребитель не может ждать батч, которому не хватило места
+            size_t slot;
+            size_t attempt = 0;
+            clock_type::time_point wait_start = clock_type::now();
+            bool halted = false;
+            while (!free_slots.tryPop(slot)) {
+                if (failed.load() || stopping.load()) {
+                    halted = true;
+                    break;
+                }
+                backoff(attempt);
+            }
+            if (halted) {
+                break;
+            }
+            if (attempt > 0) {
+                starve_nanos.fetch_add(nanosSince(wait_start), std::memory_order_relaxed);
+            }
+
+            size_t step = next_step.fetch_add(1);
+            if (step >= steps_per_epoch) {
+                free_slots.tryPush(slot);
+                break;
+            }
+
+            try {
+                produce(step, slot);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed.store(true);
+                free_slots.tryPush(slot);
+                break;
+            }
+            ready_slots.tryPush(slot);
+        }
+    }
+}
+
+// Собрать и преобразовать батч
+void DataPipeline::produce(size_t step, size_t slot) {
+    clock_type::time_point start = clock_type::now();
+    size_t begin = step * config.batch_size;
+    size_t count = std::min(config.batch_size, indices.size() - begin);
+
+    Slot& s = slots[slot];
+    s.batch.inputs = Tensor::view(s.inputs.data(), batchShape(count, dataset.inputShape()));
+    s.batch.targets = Tensor::view(s.targets.data(), batchShape(count, dataset.targetShape()));
+    s.batch.count = count;
+    s.batch.step = step;
+
+    dataset.getBatch(indices.data() + begin, count, s.batch.inputs, s.batch.targets);
+    for (const auto& transform : transforms) {
+        transform->apply(s.batch.inputs, s.batch.targets);
+    }
+    produce_nanos.fetch_add(nanosSince(start), std::memory_order_relaxed);
+}
+
+// Количество батчей в эпохе
+size_t DataPipeline::stepsPerEpoch() const {
+    return steps_per_epoch;
+}
+
+// Состояние перемешивания
+void DataPipeline::getShuffleState(std::vector<size_t>& order, std::mt19937& generator) const {
+    order = indices;
+    generator = rng;
+}
+
+void DataPipeline::setShuffleState(const std::vector<size_t>& order, const std::mt19937& generator) {
+    if (order.size() != indices.size()) {
+        throw std::invalid_argument("Shuffle order does not match the dataset size.");
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    indices = order;
+    rng = generator;
+}
+
+// Набор данных
+const Dataset& DataPipeline::getDataset() const {
+    return dataset;
+}
+
+// Показатели конвейера
+PipelineMetrics DataPipeline::getMetrics() const {
+    PipelineMetrics result = metrics;
+    result.queue_depth = metrics.batches > 0 ? static_cast<double>(depth_sum) / metrics.batches : 0.0;
+    result.produce_seconds = produce_nanos.load() * 1e-9;
+    result.starve_seconds = starve_nanos.load() * 1e-9;
+    return result;
+}
+
+// Сбросить показатели
+void DataPipeline::resetMetrics() {
+    metrics = PipelineMetrics();
+    depth_sum = 0;
+    produce_nanos.store(0);
+    starve_nanos.store(0);
+}
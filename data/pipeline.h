@@ -0,0 +1,134 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "dataset.h"
+#include "transform.h"
+#include "utils/aligned_buffer.h"
+#include "utils/bounded_queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Параметры конвейера данных
+struct PipelineConfig {
+    size_t batch_size = 32;   // Размер батча
+    bool shuffle = true;      // Перемешивать примеры в каждой эпохе
+    bool drop_last = false;   // Отбрасывать неполный последний батч
+    unsigned seed = 42;       // Зерно генератора перемешивания
+    size_t num_workers = 2;   // Потоки-производители
+    size_t prefetch = 4;      // Количество буферов батчей (готовых и заполняемых)
+    bool lock_memory = false; // Закрепить буферы в памяти (mlock), если разрешено системой
+};
+
+// Показатели конвейера
+struct PipelineMetrics {
+    size_t batches = 0;            // Выданные батчи
+    double stall_seconds = 0.0;    // Ожидание потребителем готового батча
+    size_t stalls = 0;             // Сколько раз готового батча не оказалось
+    double queue_depth = 0.0;      // Средняя глубина очереди готовых батчей при запросе
+    double produce_seconds = 0.0;  // Суммарное время сборки и преобразования батчей
+    double starve_seconds = 0.0;   // Ожидание производителями свободного буфера
+
+    // Доля времени потребителя, потерянная на ожидание данных, за wall_seconds
+    double stallFraction(double wall_seconds) const;
+};
+
+// Батч в буфере конвейера. Тензоры — виды на закрепленные буферы и действительны
+// до следующего вызова DataPipeline::next().
+struct PipelineBatch {
+    Tensor inputs = Tensor({0});  // (count, ...форма входа)
+    Tensor targets = Tensor({0}); // (count, ...форма цели)
+    size_t count = 0;             // Количество примеров
+    size_t step = 0;              // Номер батча в эпохе
+};
+
+// Конвейер данных с фоновой подготовкой батчей.
+// Производители собирают батчи в переиспользуемые выровненные буферы и применяют стадии
+// преобразования; готовые батчи передаются потребителю через очередь без блокировок
+// и выдаются в порядке шагов, поэтому результат не зависит от числа потоков.
+class DataPipeline {
+public:
+    DataPipeline(const Dataset& dataset, const PipelineConfig& config);
+    ~DataPipeline();
+
+    DataPipeline(const DataPipeline&) = delete;
+    DataPipeline& operator=(const DataPipeline&) = delete;
+
+    // Добавить стадию преобразования (до начала первой эпохи)
+    void addTransform(std::shared_ptr<BatchTransform> transform);
+
+    // Начать эпоху: перемешать индексы и запустить подготовку батчей
+    void startEpoch();
+
+    // Следующий батч эпохи (nullptr в конце эпохи). Предыдущий батч возвращается в пул буферов.
+    const PipelineBatch* next();
+
+    // Количество батчей в эпохе
+    size_t stepsPerEpoch() const;
+
+    // Состояние перемешивания (для контрольных точек обучения): порядок примеров и генератор,
+    // из которых следующий startEpoch получит порядок эпохи. Задается между эпохами.
+    void getShuffleState(std::vector<size_t>& order, std::mt19937& generator) const;
+    void setShuffleState(const std::vector<size_t>& order, const std::mt19937& generator);
+
+    // Набор данных
+    const Dataset& getDataset() const;
+
+    // Показатели конвейера и их сброс
+    PipelineMetrics getMetrics() const;
+    void resetMetrics();
+
+private:
+    // Буфер батча
+    struct Slot {
+        AlignedBuffer inputs;
+        AlignedBuffer targets;
+        PipelineBatch batch;
+    };
+
+    const Dataset& dataset;
+    PipelineConfig config;
+    std::vector<std::shared_ptr<BatchTransform>> transforms;
+    std::vector<size_t> indices;
+    std::mt19937 rng;
+    size_t steps_per_epoch;
+    size_t input_stride;
+    size_t target_stride;
+
+    std::vector<Slot> slots;
+    BoundedQueue<size_t> free_slots;  // Буферы, доступные производителям
+    BoundedQueue<size_t> ready_slots; // Заполненные буферы
+    std::vector<size_t> reorder;      // Батчи, пришедшие раньше своей очереди
+    size_t current = SIZE_MAX;        // Буфер, выданный потребителю
+    size_t delivered = 0;             // Выданные в эпохе батчи
+    bool epoch_started = false;
+
+    // Управление производителями
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable epoch_changed;
+    std::condition_variable workers_idle;
+    size_t epoch = 0;
+    size_t idle_workers = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> next_step{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    // Показатели
+    std::atomic<uint64_t> produce_nanos{0};
+    std::atomic<uint64_t> starve_nanos{0};
+    PipelineMetrics metrics;
+    size_t depth_sum = 0;
+
+    void workerLoop();
+    void produce(size_t step, size_t slot);
+};
+
+#endif // PIPELINE_H
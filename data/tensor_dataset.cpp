@@ -0,0 +1,49 @@
+#include "tensor_dataset.h"
+#include <cstring>
+#include <stdexcept>
+
+// Конструктор
+TensorDataset::TensorDataset(const Tensor& inputs, const Tensor& targets)
+    : inputs(inputs), targets(targets) {
+    if (inputs.shape().empty() || targets.shape().empty() || inputs.shape()[0] != targets.shape()[0]) {
+        throw std::invalid_argument("Inputs and targets must share the leading (sample) axis.");
+    }
+    input_stride = inputs.shape()[0] ? inputs.size() / inputs.shape()[0] : 0;
+    target_stride = targets.shape()[0] ? targets.size() / targets.shape()[0] : 0;
+}
+
+// Количество примеров
+size_t TensorDataset::size() const {
+    return inputs.shape()[0];
+}
+
+// Форма одного входного примера
+std::vector<size_t> TensorDataset::inputShape() const {
+    return std::vector<size_t>(inputs.shape().begin() + 1, inputs.shape().end());
+}
+
+// Форма цели одного примера
+std::vector<size_t> TensorDataset::targetShape() const {
+    return std::vector<size_t>(targets.shape().begin() + 1, targets.shape().end());
+}
+
+// Скопировать пример
+void TensorDataset::getSample(size_t index, float* input, float* target) const {
+    std::memcpy(input, inputs.data() + index * input_stride, input_stride * sizeof(float));
+    std::memcpy(target, targets.data() + index * target_stride, target_stride * sizeof(float));
+}
+
+// Вид на подряд идущие примеры
+bool TensorDataset::viewBatch(size_t first, size_t count, Tensor& batch_inputs, Tensor& batch_targets) const {
+    if (count == 0 || first + count > size()) {
+        return false;
+    }
+    std::vector<size_t> input_shape = inputs.shape();
+    std::vector<size_t> target_shape = targets.shape();
+    input_shape[0] = count;
+    target_shape[0] = count;
+    // Виды используются только для чтения, как и константный набор
+    batch_inputs = Tensor::view(const_cast<float*>(inputs.data()) + first * input_stride, input_shape);
+    batch_targets = Tensor::view(const_cast<float*>(targets.data()) + first * target_stride, target_shape);
+    return true;
+}
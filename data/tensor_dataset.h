@@ -0,0 +1,24 @@
+#ifndef TENSOR_DATASET_H
+#define TENSOR_DATASET_H
+
+#include "dataset.h"
+
+// Набор данных в памяти: первая ось тензоров — номер примера
+class TensorDataset : public Dataset {
+public:
+    TensorDataset(const Tensor& inputs, const Tensor& targets);
+
+    size_t size() const override;
+    std::vector<size_t> inputShape() const override;
+    std::vector<size_t> targetShape() const override;
+    void getSample(size_t index, float* input, float* target) const override;
+    bool viewBatch(size_t first, size_t count, Tensor& inputs, Tensor& targets) const override;
+
+private:
+    Tensor inputs;        // Входные данные (num_samples, ...)
+    Tensor targets;       // Цели (num_samples, ...)
+    size_t input_stride;  // Количество элементов в одном входном примере
+    size_t target_stride; // Количество элементов в одной цели
+};
+
+#endif // TENSOR_DATASET_H
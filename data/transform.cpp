@@ -0,0 +1,68 @@
+#include "transform.h"
+#include "kernels/simd.h"
+#include <stdexcept>
+
+namespace {
+// x[f] = (x[f] - s[f]) * k[f] для одной строки из n признаков
+template <class V>
+size_t affineRow(float* x, const float* s, const float* k, size_t n) {
+    size_t f = 0;
+    for (; f + V::width <= n; f += V::width) {
+        ((V::load(x + f) - V::load(s + f)) * V::load(k + f)).store(x + f);
+    }
+    return f;
+}
+}
+
+// Конструктор
+AffineTransform::AffineTransform(std::vector<float> shift, std::vector<float> scale)
+    : shift(std::move(shift)), scale(std::move(scale)) {
+    if (this->shift.size() != this->scale.size() || this->shift.empty()) {
+        throw std::invalid_argument("Shift and scale must be non-empty and of the same size.");
+    }
+}
+
+// Применить преобразование ко входам
+void AffineTransform::apply(Tensor& inputs, Tensor& targets) const {
+    (void)targets;
+    size_t count = inputs.shape().empty() ? 0 : inputs.shape()[0];
+    if (count == 0) {
+        return;
+    }
+    size_t features = inputs.size() / count;
+    float* x = inputs.data();
+
+    if (shift.size() == 1) {
+        float s = shift[0], k = scale[0];
+        simd::Native vs = simd::Native::set1(s);
+        simd::Native vk = simd::Native::set1(k);
+        size_t i = 0;
+        for (; i + simd::Native::width <= inputs.size(); i += simd::Native::width) {
+            ((simd::Native::load(x + i) - vs) * vk).store(x + i);
+        }
+        for (; i < inputs.size(); ++i) {
+            x[i] = (x[i] - s) * k;
+        }
+        return;
+    }
+    if (shift.size() != features) {
+        throw std::invalid_argument("AffineTransform size does not match the number of input features.");
+    }
+
+    const float* s = shift.data();
+    const float* k = scale.data();
+    for (size_t n = 0; n < count; ++n) {
+        float* row = x + n * features;
+        for (size_t f = affineRow<simd::Native>(row, s, k, features); f < features; ++f) {
+            row[f] = (row[f] - s[f]) * k[f];
+        }
+    }
+}
+
+// Конструктор
+FunctionTransform::FunctionTransform(std::function<void(Tensor&, Tensor&)> fn) : fn(std::move(fn)) {}
+
+// Применить функцию
+void FunctionTransform::apply(Tensor& inputs, Tensor& targets) const {
+    fn(inputs, targets);
+}
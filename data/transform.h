@@ -0,0 +1,45 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "tensor.h"
+#include <functional>
+#include <vector>
+
+// Стадия преобразования батча в конвейере данных.
+// Выполняется потоком-производителем сразу после сборки батча, поэтому должна быть
+// безопасной для одновременного вызова из нескольких потоков (не изменять свое состояние).
+class BatchTransform {
+public:
+    virtual ~BatchTransform() = default;
+
+    // Преобразовать батч на месте; inputs и targets имеют форму (count, ...)
+    virtual void apply(Tensor& inputs, Tensor& targets) const = 0;
+};
+
+// Поэлементное аффинное преобразование признаков входа: x[f] = (x[f] - shift[f]) * scale[f].
+// f — номер элемента внутри примера; векторы длины 1 применяются ко всем признакам.
+// Нормализация по подобранной статистике (FeatureStats) выполняется этим преобразованием
+// в потоке-производителе, пока собранный батч еще в кэше.
+class AffineTransform : public BatchTransform {
+public:
+    AffineTransform(std::vector<float> shift, std::vector<float> scale);
+
+    void apply(Tensor& inputs, Tensor& targets) const override;
+
+private:
+    std::vector<float> shift;
+    std::vector<float> scale;
+};
+
+// Произвольное преобразование, заданное функцией
+class FunctionTransform : public BatchTransform {
+public:
+    explicit FunctionTransform(std::function<void(Tensor&, Tensor&)> fn);
+
+    void apply(Tensor& inputs, Tensor& targets) const override;
+
+private:
+    std::function<void(Tensor&, Tensor&)> fn;
+};
+
+#endif // TRANSFORM_H
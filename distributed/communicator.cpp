@@ -0,0 +1,223 @@
+#include "communicator.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+// Ошибка системного вызова
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Адрес сокета процесса
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long: " + path);
+    }
+    std::strcpy(address.sun_path, path.c_str());
+    return address;
+}
+
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw systemError("fcntl");
+    }
+}
+
+// Границы части k из n для массива длины count
+size_t segmentBegin(size_t count, size_t k, size_t n) {
+    return count * k / n;
+}
+}
+
+// Установить кольцо
+Communicator::Communicator(size_t rank, size_t world_size, const std::string& path_prefix, double timeout_seconds)
+    : rank(rank), world_size(world_size) {
+    if (world_size == 0 || rank >= world_size) {
+        throw std::invalid_argument("Invalid rank or world size.");
+    }
+    if (world_size == 1) {
+        return;
+    }
+
+    // Сначала все процессы начинают слушать, затем подключаются к следующему и принимают предыдущего
+    std::string own_path = path_prefix + "." + std::to_string(rank);
+    std::string next_path = path_prefix + "." + std::to_string((rank + 1) % world_size);
+    sockaddr_un own_address = socketAddress(own_path);
+    sockaddr_un next_address = socketAddress(next_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw systemError("socket");
+    }
+    unlink(own_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&own_address), sizeof(own_address)) < 0 ||
+        listen(listen_fd, 1) < 0) {
+        close(listen_fd);
+        throw systemError("bind " + own_path);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout_seconds);
+    send_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (send_fd < 0) {
+        close(listen_fd);
+        throw systemError("socket");
+    }
+    while (connect(send_fd, reinterpret_cast<sockaddr*>(&next_address), sizeof(next_address)) < 0) {
+        if ((errno != ENOENT && errno != ECONNREFUSED) || std::chrono::steady_clock::now() > deadline) {
+            close(listen_fd);
+            unlink(own_path.c_str());
+            throw systemError("connect " + next_path);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    recv_fd = accept(listen_fd, nullptr, nullptr);
+    close(listen_fd);
+    unlink(own_path.c_str());
+    if (recv_fd < 0) {
+        throw systemError("accept");
+    }
+
+    setNonBlocking(send_fd);
+    setNonBlocking(recv_fd);
+}
+
+// Закрыть соединения
+Communicator::~Communicator() {
+    if (send_fd >= 0) {
+        close(send_fd);
+    }
+    if (recv_fd >= 0) {
+        close(recv_fd);
+    }
+}
+
+size_t Communicator::getRank() const { return rank; }
+size_t Communicator::getWorldSize() const { return world_size; }
+size_t Communicator::getBytesSent() const { return bytes_sent; }
+
+// Одновременно отправить и принять
+void Communicator::sendRecv(const void* send_data, size_t send_bytes, void* recv_data, size_t recv_bytes) {
+    const char* out = static_cast<const char*>(send_data);
+    char* in = static_cast<char*>(recv_data);
+    bytes_sent += send_bytes;
+
+    while (send_bytes > 0 || recv_bytes > 0) {
+        pollfd fds[2];
+        nfds_t count = 0;
+        if (send_bytes > 0) {
+            fds[count++] = {send_fd, POLLOUT, 0};
+        }
+        if (recv_bytes > 0) {
+            fds[count++] = {recv_fd, POLLIN, 0};
+        }
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("poll");
+        }
+
+        for (nfds_t i = 0; i < count; ++i) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            if (fds[i].fd == send_fd && send_bytes > 0) {
+                ssize_t n = send(send_fd, out, send_bytes, MSG_NOSIGNAL);
+                if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                    throw systemError("send");
+                }
+                if (n > 0) {
+                    out += n;
+                    send_bytes -= static_cast<size_t>(n);
+                }
+            } else if (fds[i].fd == recv_fd && recv_bytes > 0) {
+                ssize_t n = recv(recv_fd, in, recv_bytes, 0);
+                if (n == 0) {
+                    throw std::runtime_error("Peer closed the connection.");
+                }
+                if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                    throw systemError("recv");
+                }
+                if (n > 0) {
+                    in += n;
+                    recv_bytes -= static_cast<size_t>(n);
+                }
+            }
+        }
+    }
+}
+
+// Кольцевой all-reduce
+void Communicator::allReduce(float* data, size_t count) {
+    size_t n = world_size;
+    if (n == 1 || count == 0) {
+        return;
+    }
+    recv_buffer.resize(count / n + 1);
+
+    // Reduce-scatter: на шаге s отправляется часть (rank - s), принимается и суммируется (rank - s - 1).
+    // После n - 1 шагов часть (rank + 1) содержит полную сумму.
+    for (size_t s = 0; s + 1 < n; ++s) {
+        size_t send_k = (rank + n - s) % n;
+        size_t recv_k = (rank + n - s - 1) % n;
+        size_t send_begin = segmentBegin(count, send_k, n);
+        size_t send_end = segmentBegin(count, send_k + 1, n);
+        size_t recv_begin = segmentBegin(count, recv_k, n);
+        size_t recv_end = segmentBegin(count, recv_k + 1, n);
+
+        sendRecv(data + send_begin, (send_end - send_begin) * sizeof(float),
+                 recv_buffer.data(), (recv_end - recv_begin) * sizeof(float));
+        float* __restrict dst = data + recv_begin;
+        const float* __restrict src = recv_buffer.data();
+        for (size_t i = 0; i < recv_end - recv_begin; ++i) {
+            dst[i] += src[i];
+        }
+    }
+
+    // All-gather: готовые части передаются по кольцу и записываются на место
+    for (size_t s = 0; s + 1 < n; ++s) {
+        size_t send_k = (rank + 1 + n - s) % n;
+        size_t recv_k = (rank + n - s) % n;
+        size_t send_begin = segmentBegin(count, send_k, n);
+        size_t send_end = segmentBegin(count, send_k + 1, n);
+        size_t recv_begin = segmentBegin(count, recv_k, n);
+        size_t recv_end = segmentBegin(count, recv_k + 1, n);
+
+        sendRecv(data + send_begin, (send_end - send_begin) * sizeof(float),
+                 data + recv_begin, (recv_end - recv_begin) * sizeof(float));
+    }
+}
+
+// Разослать данные процесса root по кольцу
+void Communicator::broadcast(float* data, size_t count, size_t root) {
+    if (world_size == 1 || count == 0) {
+        return;
+    }
+    size_t bytes = count * sizeof(float);
+    size_t next = (rank + 1) % world_size;
+    if (rank != root) {
+        sendRecv(nullptr, 0, data, bytes);
+    }
+    if (next != root) {
+        sendRecv(data, bytes, nullptr, 0);
+    }
+}
+
+// Барьер: all-reduce по одному элементу на процесс (каждый процесс ждет всех остальных)
+void Communicator::barrier() {
+    std::vector<float> tokens(world_size, 0.0f);
+    allReduce(tokens.data(), tokens.size());
+}
@@ -0,0 +1,50 @@
+#ifndef COMMUNICATOR_H
+#define COMMUNICATOR_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Связь между процессами обучения, соединенными в кольцо через Unix-сокеты.
+// Процесс rank принимает данные от rank - 1 и отправляет их rank + 1 (по модулю world_size).
+// Все процессы должны вызывать коллективные операции в одном и том же порядке.
+class Communicator {
+public:
+    // Установить кольцо. Процесс слушает сокет "<path_prefix>.<rank>" и подключается к соседу;
+    // ожидает соседей не дольше timeout_seconds.
+    Communicator(size_t rank, size_t world_size, const std::string& path_prefix, double timeout_seconds = 30.0);
+    ~Communicator();
+
+    Communicator(const Communicator&) = delete;
+    Communicator& operator=(const Communicator&) = delete;
+
+    // Номер процесса и количество процессов
+    size_t getRank() const;
+    size_t getWorldSize() const;
+
+    // Кольцевой all-reduce: после вызова data на всех процессах содержит сумму по процессам.
+    // Reduce-scatter и all-gather по world_size частям, каждый процесс передает 2(N-1)/N объема.
+    void allReduce(float* data, size_t count);
+
+    // Разослать data процесса root всем остальным
+    void broadcast(float* data, size_t count, size_t root = 0);
+
+    // Дождаться, пока все процессы дойдут до этой точки
+    void barrier();
+
+    // Количество отправленных байт
+    size_t getBytesSent() const;
+
+private:
+    size_t rank;
+    size_t world_size;
+    int send_fd = -1;               // Соединение с rank + 1
+    int recv_fd = -1;               // Соединение с rank - 1
+    std::vector<float> recv_buffer; // Принятая часть при reduce-scatter
+    size_t bytes_sent = 0;
+
+    // Одновременно отправить send_bytes и принять recv_bytes (без взаимной блокировки соседей)
+    void sendRecv(const void* send_data, size_t send_bytes, void* recv_data, size_t recv_bytes);
+};
+
+#endif // COMMUNICATOR_H
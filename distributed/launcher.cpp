@@ -0,0 +1,54 @@
+#include "launcher.h"
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Запустить локальные процессы
+int launchLocalRanks(size_t world_size, const std::function<int(Communicator&)>& fn) {
+    // Уникальный префикс сокетов для этого запуска
+    static std::atomic<size_t> launch_counter{0};
+    std::string prefix = "/tmp/kokoro-" + std::to_string(getpid()) + "-" + std::to_string(launch_counter++);
+
+    // Сбросить буферы, чтобы дочерние процессы не вывели их повторно
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    std::vector<pid_t> children;
+    for (size_t rank = 0; rank < world_size; ++rank) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            int code = 1;
+            try {
+                Communicator communicator(rank, world_size, prefix);
+                code = fn(communicator);
+            } catch (const std::exception& e) {
+                std::cerr << "rank " << rank << ": " << e.what() << '\n';
+            }
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush(nullptr);
+            _exit(code);
+        }
+        children.push_back(pid);
+    }
+
+    int result = children.size() == world_size ? 0 : 1;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        int code = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+        if (result == 0 && code != 0) {
+            result = code;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,14 @@
+#ifndef LAUNCHER_H
+#define LAUNCHER_H
+
+#include "communicator.h"
+#include <functional>
+
+// Запустить world_size локальных процессов обучения (fork) и соединить их в кольцо.
+// Каждый процесс вызывает fn со своим Communicator; код возврата fn — код завершения процесса.
+// Возвращает 0, если все процессы завершились успешно, иначе первый ненулевой код.
+// Вызывать до создания потоков (в том числе ThreadPool::global()): после fork остается
+// только вызывающий поток.
+int launchLocalRanks(size_t world_size, const std::function<int(Communicator&)>& fn);
+
+#endif // LAUNCHER_H
@@ -0,0 +1,12 @@
+#include "constant.h"
+
+// Конструктор
+Constant::Constant(float value) : value(value) {}
+
+// Заполнить тензор
+void Constant::initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const {
+    (void)fan_in;
+    (void)fan_out;
+    (void)seed;
+    tensor.fill(value);
+}
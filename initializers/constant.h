@@ -0,0 +1,18 @@
+#ifndef CONSTANT_H
+#define CONSTANT_H
+
+#include "initializer.h"
+
+// Заполнение одним значением (смещения, тесты)
+class Constant : public Initializer {
+public:
+    explicit Constant(float value = 0.0f);
+
+    using Initializer::initialize;
+    void initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const override;
+
+private:
+    float value;
+};
+
+#endif // CONSTANT_H
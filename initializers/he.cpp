@@ -0,0 +1,17 @@
+#include "he.h"
+#include <cmath>
+
+// Конструктор
+He::He(Distribution distribution, float gain) : distribution(distribution), gain(gain) {}
+
+// Заполнить тензор
+void He::initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const {
+    (void)fan_out;
+    float stddev = gain * std::sqrt(2.0f / static_cast<float>(fan_in));
+    if (distribution == Distribution::Uniform) {
+        float bound = stddev * std::sqrt(3.0f);
+        fillUniform(tensor, -bound, bound, seed);
+    } else {
+        fillNormal(tensor, 0.0f, stddev, seed);
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef HE_H
+#define HE_H
+
+#include "initializer.h"
+
+// Инициализация Хе (Кайминга): дисперсия 2 / fan_in.
+// Сохраняет масштаб сигнала в глубоких сетях с ReLU.
+class He : public Initializer {
+public:
+    explicit He(Distribution distribution = Distribution::Uniform, float gain = 1.0f);
+
+    using Initializer::initialize;
+    void initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const override;
+
+private:
+    Distribution distribution;
+    float gain; // Множитель стандартного отклонения
+};
+
+#endif // HE_H
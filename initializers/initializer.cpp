@@ -0,0 +1,65 @@
+#include "initializer.h"
+#include "kernels/random.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+// Кусок для одного потока; кратен блоку генератора, поэтому края блоков не зависят от разбиения
+constexpr size_t CHUNK = size_t(1) << 16;
+
+std::atomic<uint64_t> base_seed{0};
+std::atomic<uint64_t> seed_counter{0};
+
+// Перемешивание SplitMix64: соседние номера дают независимые зерна
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Разбить тензор на куски и заполнить их параллельно
+template <class Fill>
+void parallelFill(Tensor& tensor, const Fill& fill) {
+    float* data = tensor.data();
+    size_t size = tensor.size();
+    size_t chunks = (size + CHUNK - 1) / CHUNK;
+    ThreadPool::global().parallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            size_t begin = c * CHUNK;
+            fill(data + begin, std::min(CHUNK, size - begin), begin);
+        }
+    });
+}
+}
+
+// Заполнить со следующим зерном
+void Initializer::initialize(Tensor& tensor, size_t fan_in, size_t fan_out) const {
+    initialize(tensor, fan_in, fan_out, nextSeed());
+}
+
+// Задать базовое зерно
+void Initializer::setSeed(uint64_t seed) {
+    base_seed = seed;
+    seed_counter = 0;
+}
+
+// Следующее зерно
+uint64_t Initializer::nextSeed() {
+    return mix(base_seed.load() ^ mix(seed_counter.fetch_add(1)));
+}
+
+// Равномерное заполнение
+void Initializer::fillUniform(Tensor& tensor, float low, float high, uint64_t seed) {
+    parallelFill(tensor, [&](float* dst, size_t size, size_t offset) {
+        uniformKernel(dst, size, seed, offset, low, high);
+    });
+}
+
+// Нормальное заполнение
+void Initializer::fillNormal(Tensor& tensor, float mean, float stddev, uint64_t seed) {
+    parallelFill(tensor, [&](float* dst, size_t size, size_t offset) {
+        normalKernel(dst, size, seed, offset, mean, stddev);
+    });
+}
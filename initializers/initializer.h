@@ -0,0 +1,40 @@
+#ifndef INITIALIZER_H
+#define INITIALIZER_H
+
+#include "tensor.h"
+#include <cstdint>
+
+// Распределение начальных весов
+enum class Distribution {
+    Uniform,
+    Normal
+};
+
+// Базовый класс инициализаторов весов.
+// Тензор заполняется целиком, параллельно и счетчиковым генератором (kernels/random.h),
+// поэтому результат определяется только зерном и не зависит от числа потоков.
+class Initializer {
+public:
+    virtual ~Initializer() = default;
+
+    // Заполнить тензор; fan_in и fan_out — число входов и выходов одного нейрона
+    virtual void initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const = 0;
+
+    // Заполнить тензор со следующим зерном из глобальной последовательности
+    void initialize(Tensor& tensor, size_t fan_in, size_t fan_out) const;
+
+    // Задать базовое зерно: модели, построенные после вызова в одном порядке, получают одинаковые веса
+    static void setSeed(uint64_t seed);
+
+    // Следующее зерно глобальной последовательности
+    static uint64_t nextSeed();
+
+protected:
+    // Параллельное заполнение равномерными значениями из [low, high)
+    static void fillUniform(Tensor& tensor, float low, float high, uint64_t seed);
+
+    // Параллельное заполнение нормальными значениями N(mean, stddev²)
+    static void fillNormal(Tensor& tensor, float mean, float stddev, uint64_t seed);
+};
+
+#endif // INITIALIZER_H
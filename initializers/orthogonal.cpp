@@ -0,0 +1,97 @@
+#include "orthogonal.h"
+#include "kernels/simd.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+using V = simd::Native;
+
+// Скалярное произведение
+float dot(const float* a, const float* b, size_t n) {
+    V acc = V::set1(0.0f);
+    size_t k = 0;
+    for (; k + V::width <= n; k += V::width) {
+        acc = acc + V::load(a + k) * V::load(b + k);
+    }
+    float lanes[V::width];
+    acc.store(lanes);
+    float sum = 0.0f;
+    for (size_t j = 0; j < V::width; ++j) {
+        sum += lanes[j];
+    }
+    for (; k < n; ++k) {
+        sum += a[k] * b[k];
+    }
+    return sum;
+}
+
+// Ортонормировать строки матрицы rows x cols (rows <= cols) на месте.
+// Для каждой строки проекции на предыдущие вычитаются дважды (CGS2): скалярные произведения
+// независимы и считаются параллельно, а повторный проход восстанавливает точность.
+void orthonormalizeRows(float* q, size_t rows, size_t cols) {
+    ThreadPool& pool = ThreadPool::global();
+    std::vector<float> coef(rows);
+    for (size_t j = 0; j < rows; ++j) {
+        float* row = q + j * cols;
+        for (int pass = 0; pass < 2 && j > 0; ++pass) {
+            pool.parallelFor(0, j, std::max<size_t>(1, 4096 / cols), [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    coef[i] = dot(q + i * cols, row, cols);
+                }
+            });
+            pool.parallelFor(0, cols, 1024, [&](size_t lo, size_t hi) {
+                for (size_t i = 0; i < j; ++i) {
+                    const float* prev = q + i * cols;
+                    for (size_t k = lo; k < hi; ++k) {
+                        row[k] -= coef[i] * prev[k];
+                    }
+                }
+            });
+        }
+        float norm = std::sqrt(dot(row, row, cols));
+        if (norm > 0.0f) {
+            float inv = 1.0f / norm;
+            for (size_t k = 0; k < cols; ++k) {
+                row[k] *= inv;
+            }
+        }
+    }
+}
+}
+
+// Конструктор
+Orthogonal::Orthogonal(float gain) : gain(gain) {}
+
+// Заполнить тензор
+void Orthogonal::initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const {
+    (void)fan_in;
+    (void)fan_out;
+    if (tensor.size() == 0) {
+        return;
+    }
+    size_t rows = tensor.shape().empty() ? 1 : tensor.shape()[0];
+    size_t cols = tensor.size() / rows;
+    float* data = tensor.data();
+
+    if (rows <= cols) {
+        fillNormal(tensor, 0.0f, 1.0f, seed);
+        orthonormalizeRows(data, rows, cols);
+        for (size_t i = 0; i < tensor.size(); ++i) {
+            data[i] *= gain;
+        }
+        return;
+    }
+
+    // Строк больше, чем столбцов: ортонормируются строки транспонированной матрицы
+    Tensor transposed({cols, rows});
+    fillNormal(transposed, 0.0f, 1.0f, seed);
+    orthonormalizeRows(transposed.data(), cols, rows);
+    const float* t = transposed.data();
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            data[r * cols + c] = gain * t[c * rows + r];
+        }
+    }
+}
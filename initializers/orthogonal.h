@@ -0,0 +1,21 @@
+#ifndef ORTHOGONAL_H
+#define ORTHOGONAL_H
+
+#include "initializer.h"
+
+// Ортогональная инициализация: тензор рассматривается как матрица (shape[0], остальные оси),
+// и ее строки (или столбцы, если строк больше) образуют ортонормированную систему.
+// Случайная нормальная матрица ортогонализуется методом Грама — Шмидта с повторной
+// ортогонализацией; стоимость O(min(r, c)² · max(r, c)). Часто используется для рекуррентных весов.
+class Orthogonal : public Initializer {
+public:
+    explicit Orthogonal(float gain = 1.0f);
+
+    using Initializer::initialize;
+    void initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const override;
+
+private:
+    float gain;
+};
+
+#endif // ORTHOGONAL_H
@@ -0,0 +1,17 @@
+#include "xavier.h"
+#include <cmath>
+
+// Конструктор
+Xavier::Xavier(Distribution distribution, float gain) : distribution(distribution), gain(gain) {}
+
+// Заполнить тензор
+void Xavier::initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const {
+    float stddev = gain * std::sqrt(2.0f / static_cast<float>(fan_in + fan_out));
+    if (distribution == Distribution::Uniform) {
+        // У равномерного на [-a, a] стандартное отклонение a / sqrt(3)
+        float bound = stddev * std::sqrt(3.0f);
+        fillUniform(tensor, -bound, bound, seed);
+    } else {
+        fillNormal(tensor, 0.0f, stddev, seed);
+    }
+}
@@ -0,0 +1,20 @@
+#ifndef XAVIER_H
+#define XAVIER_H
+
+#include "initializer.h"
+
+// Инициализация Ксавье (Глоро): дисперсия 2 / (fan_in + fan_out).
+// Подходит для слоев с симметричными активациями (tanh, сигмоида) и без активации.
+class Xavier : public Initializer {
+public:
+    explicit Xavier(Distribution distribution = Distribution::Uniform, float gain = 1.0f);
+
+    using Initializer::initialize;
+    void initialize(Tensor& tensor, size_t fan_in, size_t fan_out, uint64_t seed) const override;
+
+private:
+    Distribution distribution;
+    float gain; // Множитель стандартного отклонения
+};
+
+#endif // XAVIER_H
@@ -0,0 +1,106 @@
+#include "cpu_features.h"
+#include <cstdint>
+#include <cstring>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define KOKORO_HAS_CPUID 1
+#endif
+
+namespace {
+
+#ifdef KOKORO_HAS_CPUID
+// Регистр XCR0: какие состояния регистров сохраняет операционная система.
+// Инструкция записана напрямую, чтобы не требовать -mxsave для всего файла
+uint64_t readXcr0() {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+#endif
+
+CpuFeatures detect() {
+    CpuFeatures features;
+#ifdef KOKORO_HAS_CPUID
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+    unsigned max_leaf = eax;
+    char vendor[13] = {};
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+    features.vendor = vendor;
+
+    __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+    features.sse2 = edx & bit_SSE2;
+    features.sse41 = ecx & bit_SSE4_1;
+    bool osxsave = ecx & bit_OSXSAVE;
+    uint64_t xcr0 = osxsave ? readXcr0() : 0;
+    bool ymm = (xcr0 & 0x06) == 0x06;   // XMM и YMM
+    bool zmm = (xcr0 & 0xe6) == 0xe6;   // Плюс opmask и ZMM
+    features.avx = ymm && (ecx & bit_AVX);
+    features.fma = ymm && (ecx & bit_FMA);
+
+    if (max_leaf >= 7) {
+        __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+        features.avx2 = ymm && (ebx & bit_AVX2);
+        features.avx512f = zmm && (ebx & bit_AVX512F);
+        features.avx512dq = zmm && (ebx & bit_AVX512DQ);
+        features.avx512bw = zmm && (ebx & bit_AVX512BW);
+        features.avx512vl = zmm && (ebx & bit_AVX512VL);
+    }
+
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000004) {
+        char brand[49] = {};
+        for (unsigned leaf = 0; leaf < 3; ++leaf) {
+            __get_cpuid(0x80000002 + leaf, &eax, &ebx, &ecx, &edx);
+            std::memcpy(brand + 16 * leaf, &eax, 4);
+            std::memcpy(brand + 16 * leaf + 4, &ebx, 4);
+            std::memcpy(brand + 16 * leaf + 8, &ecx, 4);
+            std::memcpy(brand + 16 * leaf + 12, &edx, 4);
+        }
+        features.brand = brand;
+        size_t first = features.brand.find_first_not_of(' ');
+        features.brand = first == std::string::npos ? "" : features.brand.substr(first);
+    }
+#endif
+    return features;
+}
+
+} // namespace
+
+// Имя набора инструкций
+const char* isaName(Isa isa) {
+    switch (isa) {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::Sse2:
+        return "sse2";
+    case Isa::Avx2:
+        return "avx2";
+    case Isa::Avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+// Самый широкий доступный набор инструкций
+Isa CpuFeatures::bestIsa() const {
+    if (avx512f && avx512dq && avx512bw && avx512vl && avx2 && fma) {
+        return Isa::Avx512;
+    }
+    if (avx2 && fma) {
+        return Isa::Avx2;
+    }
+    if (sse2) {
+        return Isa::Sse2;
+    }
+    return Isa::Scalar;
+}
+
+// Возможности процессора
+const CpuFeatures& cpuFeatures() {
+    static const CpuFeatures features = detect();
+    return features;
+}
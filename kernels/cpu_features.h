@@ -0,0 +1,39 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <string>
+
+// Наборы инструкций, под которые собраны ядра (в порядке возрастания)
+enum class Isa {
+    Scalar, // Переносимый C++
+    Sse2,   // Базовый x86-64
+    Avx2,   // AVX2 + FMA (Haswell и новее)
+    Avx512  // AVX-512 F/DQ/BW/VL (Skylake-SP и новее)
+};
+
+// Имя набора инструкций: "scalar", "sse2", "avx2", "avx512"
+const char* isaName(Isa isa);
+
+// Возможности процессора по cpuid. Расширения AVX считаются доступными, только если
+// операционная система сохраняет соответствующие регистры (XCR0)
+struct CpuFeatures {
+    std::string vendor; // Например, "GenuineIntel"
+    std::string brand;  // Название модели процессора
+    bool sse2 = false;
+    bool sse41 = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+    bool avx512dq = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+
+    // Самый широкий набор инструкций, ядра которого можно выполнять на этом процессоре
+    Isa bestIsa() const;
+};
+
+// Возможности процессора, определенные один раз при первом обращении
+const CpuFeatures& cpuFeatures();
+
+#endif // CPU_FEATURES_H
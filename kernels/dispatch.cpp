@@ -0,0 +1,131 @@
+#include "dispatch.h"
+#include "utils/profiler.h"
+#include <cstdlib>
+
+namespace {
+
+// Разобрать значение KOKORO_FORCE_ISA; false для неизвестного имени
+bool parseIsa(const std::string& name, Isa& isa) {
+    for (Isa candidate : {Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Avx512}) {
+        if (name == isaName(candidate)) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Вариант ядер набора инструкций (nullptr, если не собран)
+const KernelTable* variant(Isa isa) {
+    switch (isa) {
+    case Isa::Scalar:
+        return scalarKernels();
+    case Isa::Sse2:
+        return sse2Kernels();
+    case Isa::Avx2:
+        return avx2Kernels();
+    case Isa::Avx512:
+        return avx512Kernels();
+    }
+    return nullptr;
+}
+
+// Для каждого ядра — первый вариант от самого широкого набора, в котором оно есть
+template <typename Fn>
+void choose(KernelTable& table, std::vector<KernelChoice>& choices, const char* name, Fn KernelTable::*slot,
+            const std::vector<std::pair<Isa, const KernelTable*>>& variants) {
+    for (const auto& entry : variants) {
+        if (entry.second->*slot) {
+            table.*slot = entry.second->*slot;
+            choices.push_back({name, entry.first});
+            return;
+        }
+    }
+}
+
+// Выбор ядер при запуске процесса и его запись в отчет профилировщика
+struct StartupSelection {
+    StartupSelection() { KernelRegistry::global(); }
+} startup_selection;
+
+} // namespace
+
+// Реестр процесса
+KernelRegistry& KernelRegistry::global() {
+    static KernelRegistry registry;
+    return registry;
+}
+
+// Конструктор: набор инструкций процессора, ограниченный KOKORO_FORCE_ISA
+KernelRegistry::KernelRegistry() {
+    detected = cpuFeatures().bestIsa();
+    Isa limit = detected;
+    if (const char* env = std::getenv("KOKORO_FORCE_ISA")) {
+        forced = env;
+        Isa requested = Isa::Scalar;
+        if (parseIsa(forced, requested) && requested < limit) {
+            limit = requested;
+        }
+    }
+    select(limit);
+}
+
+// Выбрать ядра не шире isa
+void KernelRegistry::select(Isa isa) {
+    if (isa > detected) {
+        isa = detected;
+    }
+    // Варианты от самого широкого к переносимому; вызываются только поддерживаемые процессором
+    std::vector<std::pair<Isa, const KernelTable*>> variants;
+    for (int level = static_cast<int>(isa); level >= 0; --level) {
+        if (const KernelTable* table = variant(static_cast<Isa>(level))) {
+            variants.emplace_back(static_cast<Isa>(level), table);
+        }
+    }
+
+    KernelTable table;
+    std::vector<KernelChoice> chosen;
+    choose(table, chosen, "gemm", &KernelTable::gemm_tile, variants);
+    choose(table, chosen, "add", &KernelTable::add, variants);
+    choose(table, chosen, "sub", &KernelTable::sub, variants);
+    choose(table, chosen, "mul", &KernelTable::mul, variants);
+    choose(table, chosen, "scale", &KernelTable::scale, variants);
+    choose(table, chosen, "relu", &KernelTable::relu, variants);
+    choose(table, chosen, "sigmoid", &KernelTable::sigmoid, variants);
+    choose(table, chosen, "tanh", &KernelTable::tanh, variants);
+    choose(table, chosen, "exp_sum", &KernelTable::exp_sum, variants);
+    choose(table, chosen, "log_sum_exp", &KernelTable::log_sum_exp, variants);
+    choose(table, chosen, "softmax_xent", &KernelTable::softmax_xent, variants);
+    choose(table, chosen, "sum", &KernelTable::sum, variants);
+    choose(table, chosen, "max", &KernelTable::max, variants);
+    choose(table, chosen, "dot", &KernelTable::dot, variants);
+    choose(table, chosen, "sgd", &KernelTable::sgd, variants);
+    choose(table, chosen, "adam", &KernelTable::adam, variants);
+    choose(table, chosen, "adamw", &KernelTable::adamw, variants);
+    choose(table, chosen, "nadam", &KernelTable::nadam, variants);
+    choose(table, chosen, "adamax", &KernelTable::adamax, variants);
+
+    kernels = table;
+    choices = chosen;
+    this->isa = variants.empty() ? Isa::Scalar : variants.front().first;
+    Profiler::global().setInfo("kernels", describe());
+}
+
+// Описание выбора
+std::string KernelRegistry::describe() const {
+    const CpuFeatures& cpu = cpuFeatures();
+    std::string text = isaName(isa);
+    text += " (cpu ";
+    text += isaName(detected);
+    if (!cpu.brand.empty()) {
+        text += ", " + cpu.brand;
+    }
+    if (!forced.empty()) {
+        text += ", KOKORO_FORCE_ISA=" + forced;
+    }
+    text += "):";
+    for (const KernelChoice& choice : choices) {
+        text += " " + choice.kernel + "=" + isaName(choice.isa);
+    }
+    return text;
+}
@@ -0,0 +1,105 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "kernels/cpu_features.h"
+#include "kernels/optimizer_kernels.h"
+
+// Размер тайла микроядра GEMM: MR строк на NR столбцов
+constexpr size_t GEMM_MR = 6;
+constexpr size_t GEMM_NR = 16;
+
+// Таблица горячих ядер. Каждое ядро собрано в нескольких вариантах (kernels/isa_*.cpp),
+// при запуске для каждого выбирается самый широкий вариант, который поддерживает процессор.
+struct KernelTable {
+    // Микроядро GEMM: acc[MR x NR] += Ap[kc x MR]^T * Bp[kc x NR] (упакованные панели)
+    void (*gemm_tile)(size_t kc, const float* Ap, const float* Bp, float* acc) = nullptr;
+
+    // Поэлементные операции; out может совпадать с входом
+    void (*add)(const float* a, const float* b, float* out, size_t size) = nullptr;
+    void (*sub)(const float* a, const float* b, float* out, size_t size) = nullptr;
+    void (*mul)(const float* a, const float* b, float* out, size_t size) = nullptr;
+    void (*scale)(float* data, float factor, size_t size) = nullptr;
+    void (*relu)(float* data, size_t size) = nullptr;
+
+    // Трансцендентные функции на месте (формулы vmath.h)
+    void (*sigmoid)(float* data, size_t size) = nullptr;
+    void (*tanh)(float* data, size_t size) = nullptr;
+
+    // sum(exp(x - shift)); при out != nullptr экспоненты записываются в out
+    float (*exp_sum)(const float* x, float shift, float* out, size_t size) = nullptr;
+    // log(sum(exp(x))) за один проход с бегущим максимумом; size > 0
+    float (*log_sum_exp)(const float* x, size_t size) = nullptr;
+    // out = exp(x - lse) и lse * sum(t) - sum(t * x) за один проход (строка перекрестной энтропии)
+    float (*softmax_xent)(const float* x, const float* t, float lse, float* out, size_t size) = nullptr;
+
+    // Редукции
+    float (*sum)(const float* x, size_t size) = nullptr;
+    float (*max)(const float* x, size_t size) = nullptr; // size > 0
+    float (*dot)(const float* a, const float* b, size_t size) = nullptr;
+
+    // Шаги оптимизаторов (формулы см. optimizer_kernels.h)
+    void (*sgd)(float learning_rate, float* params, const float* grads, size_t size) = nullptr;
+    void (*adam)(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) = nullptr;
+    void (*adamw)(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) = nullptr;
+    void (*nadam)(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) = nullptr;
+    void (*adamax)(const AdamScalars& s, float* params, const float* grads, float* m, float* u, size_t size) = nullptr;
+};
+
+// Выбранный вариант одного ядра
+struct KernelChoice {
+    std::string kernel;
+    Isa isa;
+};
+
+// Реестр ядер процесса. Набор инструкций определяется по cpuid; переменная окружения
+// KOKORO_FORCE_ISA=scalar|sse2|avx2|avx512 ограничивает его сверху (для проверки
+// запасных вариантов на новом процессоре). Набор шире поддерживаемого процессором
+// не выбирается. Выбор печатается в отчете профилировщика.
+class KernelRegistry {
+public:
+    static KernelRegistry& global();
+
+    // Ядра выбранного набора инструкций
+    const KernelTable& table() const { return kernels; }
+
+    // Набор инструкций, под который выбраны ядра, и наилучший для процессора
+    Isa getIsa() const { return isa; }
+    Isa getDetectedIsa() const { return detected; }
+
+    // Значение KOKORO_FORCE_ISA (пустое, если не задано)
+    const std::string& getForced() const { return forced; }
+
+    // Вариант каждого ядра
+    const std::vector<KernelChoice>& getChoices() const { return choices; }
+
+    // Однострочное описание выбора: процессор, набор инструкций, варианты ядер
+    std::string describe() const;
+
+    // Выбрать ядра заново не шире isa (для тестов и бенчмарков; не вызывать во время вычислений)
+    void select(Isa isa);
+
+private:
+    KernelRegistry();
+
+    KernelTable kernels;
+    Isa isa = Isa::Scalar;
+    Isa detected = Isa::Scalar;
+    std::string forced;
+    std::vector<KernelChoice> choices;
+};
+
+// Ядра процесса
+inline const KernelTable& kernels() {
+    return KernelRegistry::global().table();
+}
+
+// Варианты ядер, собранные в kernels/isa_*.cpp; nullptr, если вариант не собран для этой платформы
+const KernelTable* scalarKernels();
+const KernelTable* sse2Kernels();
+const KernelTable* avx2Kernels();
+const KernelTable* avx512Kernels();
+
+#endif // DISPATCH_H
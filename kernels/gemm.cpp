@@ -0,0 +1,146 @@
+#include "gemm.h"
+#include "kernels/dispatch.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Размеры микроядра (kernels/dispatch.h) и блоков (подобраны под L1/L2 типичных x86-ядер)
+constexpr size_t MR = GEMM_MR;
+constexpr size_t NR = GEMM_NR;
+constexpr size_t MC = 96;
+constexpr size_t KC = 256;
+constexpr size_t NC = 1024;
+
+// Упаковка блока op(A) в панели по MR строк (недостающие строки заполняются нулями)
+void packA(bool trans_a, const float* A, size_t lda, size_t row0, size_t col0,
+           size_t mc, size_t kc, float* packed) {
+    for (size_t ip = 0; ip < mc; ip += MR) {
+        size_t mr = std::min(MR, mc - ip);
+        for (size_t k = 0; k < kc; ++k) {
+            float* dst = packed + (ip * kc) + k * MR;
+            for (size_t i = 0; i < mr; ++i) {
+                size_t r = row0 + ip + i;
+                size_t c = col0 + k;
+                dst[i] = trans_a ? A[c * lda + r] : A[r * lda + c];
+            }
+            for (size_t i = mr; i < MR; ++i) dst[i] = 0.0f;
+        }
+    }
+}
+
+// Упаковка блока op(B) в панели по NR столбцов
+void packB(bool trans_b, const float* B, size_t ldb, size_t row0, size_t col0,
+           size_t kc, size_t nc, float* packed) {
+    for (size_t jp = 0; jp < nc; jp += NR) {
+        size_t nr = std::min(NR, nc - jp);
+        for (size_t k = 0; k < kc; ++k) {
+            float* dst = packed + (jp * kc) + k * NR;
+            size_t r = row0 + k;
+            if (!trans_b) {
+                const float* src = B + r * ldb + col0 + jp;
+                for (size_t j = 0; j < nr; ++j) dst[j] = src[j];
+            } else {
+                for (size_t j = 0; j < nr; ++j) dst[j] = B[(col0 + jp + j) * ldb + r];
+            }
+            for (size_t j = nr; j < NR; ++j) dst[j] = 0.0f;
+        }
+    }
+}
+
+// Тайл MR x NR: цикл по k выполняет микроядро выбранного набора инструкций,
+// пока тайл лежит в регистрах; эпилог применяется к тайлу до записи в память
+void microKernel(const KernelTable& table, size_t kc, const float* Ap, const float* Bp, float* C, size_t ldc,
+                 size_t mr, size_t nr, bool load_c, bool last,
+                 const GemmEpilogue& ep, size_t row0, size_t col0) {
+    alignas(64) float acc[MR * NR] = {};
+    if (load_c) {
+        for (size_t i = 0; i < mr; ++i) {
+            for (size_t j = 0; j < nr; ++j) acc[i * NR + j] = C[i * ldc + j];
+        }
+    }
+
+    table.gemm_tile(kc, Ap, Bp, acc);
+
+    // Эпилог: смещение и активация до записи тайла в память
+    if (last) {
+        if (ep.row_bias) {
+            for (size_t i = 0; i < mr; ++i) {
+                float bias = ep.row_bias[row0 + i];
+                for (size_t j = 0; j < NR; ++j) acc[i * NR + j] += bias;
+            }
+        }
+        if (ep.col_bias) {
+            float bias[NR] = {};
+            for (size_t j = 0; j < nr; ++j) bias[j] = ep.col_bias[col0 + j];
+            for (size_t i = 0; i < MR; ++i) {
+                for (size_t j = 0; j < NR; ++j) acc[i * NR + j] += bias[j];
+            }
+        }
+        switch (ep.activation) {
+        case Activation::None:
+            break;
+        case Activation::ReLU:
+            table.relu(acc, MR * NR);
+            break;
+        case Activation::Sigmoid:
+            table.sigmoid(acc, MR * NR);
+            break;
+        case Activation::Tanh:
+            table.tanh(acc, MR * NR);
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < mr; ++i) {
+        for (size_t j = 0; j < nr; ++j) C[i * ldc + j] = acc[i * NR + j];
+    }
+}
+
+} // namespace
+
+// Блочное матричное умножение (схема Goto: NC -> KC -> MC -> микроядро)
+void gemm(bool trans_a, bool trans_b, size_t M, size_t N, size_t K,
+          const float* A, size_t lda, const float* B, size_t ldb,
+          float* C, size_t ldc, bool accumulate, const GemmEpilogue& epilogue) {
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    const KernelTable& table = kernels();
+
+    // Буферы упаковки переиспользуются между вызовами
+    thread_local std::vector<float> packed_a;
+    thread_local std::vector<float> packed_b;
+    packed_a.resize(((MC + MR - 1) / MR) * MR * KC);
+    packed_b.resize(((NC + NR - 1) / NR) * NR * KC);
+
+    // При K == 0 все равно нужен один проход, чтобы применить эпилог
+    size_t k_blocks = std::max<size_t>(1, (K + KC - 1) / KC);
+
+    for (size_t jc = 0; jc < N; jc += NC) {
+        size_t nc = std::min(NC, N - jc);
+        for (size_t kb = 0; kb < k_blocks; ++kb) {
+            size_t pc = kb * KC;
+            size_t kc = K > pc ? std::min(KC, K - pc) : 0;
+            bool last = (kb + 1 == k_blocks);
+            bool load_c = accumulate || kb > 0;
+            packB(trans_b, B, ldb, pc, jc, kc, nc, packed_b.data());
+
+            for (size_t ic = 0; ic < M; ic += MC) {
+                size_t mc = std::min(MC, M - ic);
+                packA(trans_a, A, lda, ic, pc, mc, kc, packed_a.data());
+
+                for (size_t jr = 0; jr < nc; jr += NR) {
+                    size_t nr = std::min(NR, nc - jr);
+                    for (size_t ir = 0; ir < mc; ir += MR) {
+                        size_t mr = std::min(MR, mc - ir);
+                        microKernel(table, kc, packed_a.data() + ir * kc, packed_b.data() + jr * kc,
+                                    C + (ic + ir) * ldc + jc + jr, ldc, mr, nr, load_c, last,
+                                    epilogue, ic + ir, jc + jr);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <cstddef>
+#include "activations/activation.h"
+
+// Операции, выполняемые над тайлом результата до записи в память
+struct GemmEpilogue {
+    const float* row_bias = nullptr;          // bias[i] прибавляется к строке i
+    const float* col_bias = nullptr;          // bias[j] прибавляется к столбцу j
+    Activation activation = Activation::None; // Активация после смещения
+};
+
+// Матричное умножение C = op(A) * op(B) с эпилогом, все матрицы в row-major.
+// op(A) имеет размер M x K, op(B) — K x N. При accumulate результат прибавляется к C.
+// Смещение и активация применяются к тайлу, пока он еще находится в регистрах.
+void gemm(bool trans_a, bool trans_b, size_t M, size_t N, size_t K,
+          const float* A, size_t lda, const float* B, size_t ldb,
+          float* C, size_t ldc, bool accumulate = false,
+          const GemmEpilogue& epilogue = GemmEpilogue());
+
+#endif // GEMM_H
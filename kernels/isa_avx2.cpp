@@ -0,0 +1,18 @@
+// Вариант ядер для AVX2 + FMA (Haswell и новее). Файл собирается с этим набором
+// инструкций независимо от флагов сборки; вызывается, только если его поддерживает процессор.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC target("avx2,fma")
+#define KOKORO_SIMD_AVX2
+#include "kernels/kernel_impl.h"
+
+const KernelTable* avx2Kernels() {
+    static const KernelTable table = impl::makeTable<simd::Avx>();
+    return &table;
+}
+#else
+#include "kernels/dispatch.h"
+
+const KernelTable* avx2Kernels() {
+    return nullptr;
+}
+#endif
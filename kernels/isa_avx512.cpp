@@ -0,0 +1,18 @@
+// Вариант ядер для AVX-512 F/DQ/BW/VL (Skylake-SP и новее). Файл собирается с этим набором
+// инструкций независимо от флагов сборки; вызывается, только если его поддерживает процессор.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC target("avx512f,avx512dq,avx512bw,avx512vl,avx2,fma")
+#define KOKORO_SIMD_AVX512
+#include "kernels/kernel_impl.h"
+
+const KernelTable* avx512Kernels() {
+    static const KernelTable table = impl::makeTable<simd::Avx512>();
+    return &table;
+}
+#else
+#include "kernels/dispatch.h"
+
+const KernelTable* avx512Kernels() {
+    return nullptr;
+}
+#endif
@@ -0,0 +1,8 @@
+// Переносимый вариант ядер: скалярные шаблоны, собранные с флагами сборки.
+// Используется на платформах без x86 и при KOKORO_FORCE_ISA=scalar.
+#include "kernels/kernel_impl.h"
+
+const KernelTable* scalarKernels() {
+    static const KernelTable table = impl::makeTable<simd::Scalar>();
+    return &table;
+}
@@ -0,0 +1,16 @@
+// Вариант ядер для базового x86-64 (SSE2)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#pragma GCC target("sse2")
+#include "kernels/kernel_impl.h"
+
+const KernelTable* sse2Kernels() {
+    static const KernelTable table = impl::makeTable<simd::Sse2>();
+    return &table;
+}
+#else
+#include "kernels/dispatch.h"
+
+const KernelTable* sse2Kernels() {
+    return nullptr;
+}
+#endif
@@ -0,0 +1,434 @@
+#ifndef KERNEL_IMPL_H
+#define KERNEL_IMPL_H
+
+// Общие реализации ядер таблицы KernelTable. Включается только файлами kernels/isa_*.cpp,
+// каждый из которых собирает их под свой набор инструкций (#pragma GCC target).
+//
+// Все определения находятся в анонимном пространстве имен: экземпляры шаблонов и встроенных
+// функций, собранные под разные наборы инструкций, не должны сливаться компоновщиком
+// (иначе код AVX-512 мог бы попасть в вариант для старого процессора). Точки входа помечены
+// KOKORO_FLATTEN, чтобы все вызовы внутри них встраивались и внешние копии не создавались.
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "kernels/dispatch.h"
+#include "kernels/simd.h"
+
+#if defined(__GNUC__)
+#define KOKORO_FLATTEN __attribute__((flatten))
+#else
+#define KOKORO_FLATTEN
+#endif
+
+namespace {
+namespace impl {
+
+// Обход массива: основная часть векторами ширины V::width, хвост скалярно.
+// Тело одно и то же для обоих случаев, поэтому формулы не расходятся.
+template <typename V, typename Body>
+void sweep(size_t size, Body body) {
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        body.template operator()<V>(i);
+    }
+    for (; i < size; ++i) {
+        body.template operator()<simd::Scalar>(i);
+    }
+}
+
+// Сумма элементов регистра
+template <typename V>
+float horizontalSum(V v) {
+    float lanes[V::width];
+    v.store(lanes);
+    float total = 0.0f;
+    for (size_t j = 0; j < V::width; ++j) total += lanes[j];
+    return total;
+}
+
+// Микроядро GEMM: аккумуляторы тайла живут в регистрах на протяжении всего цикла по k
+template <typename V>
+KOKORO_FLATTEN void gemmTile(size_t kc, const float* Ap, const float* Bp, float* acc) {
+    constexpr size_t COLS = GEMM_NR / V::width;
+    V c[GEMM_MR][COLS];
+    for (size_t i = 0; i < GEMM_MR; ++i) {
+        for (size_t j = 0; j < COLS; ++j) c[i][j] = V::load(acc + i * GEMM_NR + j * V::width);
+    }
+    for (size_t k = 0; k < kc; ++k) {
+        const float* a = Ap + k * GEMM_MR;
+        const float* b = Bp + k * GEMM_NR;
+        V bv[COLS];
+        for (size_t j = 0; j < COLS; ++j) bv[j] = V::load(b + j * V::width);
+        for (size_t i = 0; i < GEMM_MR; ++i) {
+            V ai = V::set1(a[i]);
+            for (size_t j = 0; j < COLS; ++j) c[i][j] = fmadd(ai, bv[j], c[i][j]);
+        }
+    }
+    for (size_t i = 0; i < GEMM_MR; ++i) {
+        for (size_t j = 0; j < COLS; ++j) c[i][j].store(acc + i * GEMM_NR + j * V::width);
+    }
+}
+
+// Поэлементные операции
+struct AddBody {
+    const float* a; const float* b; float* out;
+    template <typename T> void operator()(size_t i) const { (T::load(a + i) + T::load(b + i)).store(out + i); }
+};
+
+struct SubBody {
+    const float* a; const float* b; float* out;
+    template <typename T> void operator()(size_t i) const { (T::load(a + i) - T::load(b + i)).store(out + i); }
+};
+
+struct MulBody {
+    const float* a; const float* b; float* out;
+    template <typename T> void operator()(size_t i) const { (T::load(a + i) * T::load(b + i)).store(out + i); }
+};
+
+struct ScaleBody {
+    float* data; float factor;
+    template <typename T> void operator()(size_t i) const { (T::load(data + i) * T::set1(factor)).store(data + i); }
+};
+
+struct ReluBody {
+    float* data;
+    template <typename T> void operator()(size_t i) const { max(T::load(data + i), T::set1(0.0f)).store(data + i); }
+};
+
+template <typename V>
+KOKORO_FLATTEN void add(const float* a, const float* b, float* out, size_t size) {
+    sweep<V>(size, AddBody{a, b, out});
+}
+
+template <typename V>
+KOKORO_FLATTEN void sub(const float* a, const float* b, float* out, size_t size) {
+    sweep<V>(size, SubBody{a, b, out});
+}
+
+template <typename V>
+KOKORO_FLATTEN void mul(const float* a, const float* b, float* out, size_t size) {
+    sweep<V>(size, MulBody{a, b, out});
+}
+
+template <typename V>
+KOKORO_FLATTEN void scale(float* data, float factor, size_t size) {
+    sweep<V>(size, ScaleBody{data, factor});
+}
+
+template <typename V>
+KOKORO_FLATTEN void relu(float* data, size_t size) {
+    sweep<V>(size, ReluBody{data});
+}
+
+// Экспонента по формуле vexp (vmath.h) на регистрах; T — тип регистра
+template <typename T>
+T expv(T x) {
+    x = min(max(x, T::set1(-87.3f)), T::set1(88.7f));
+    T n = floor(x * T::set1(1.44269504088896341f) + T::set1(0.5f));
+    T r = x - n * T::set1(0.693359375f) + n * T::set1(2.12194440e-4f);
+    T p = T::set1(1.9875691500E-4f);
+    p = p * r + T::set1(1.3981999507E-3f);
+    p = p * r + T::set1(8.3334519073E-3f);
+    p = p * r + T::set1(4.1665795894E-2f);
+    p = p * r + T::set1(1.6666665459E-1f);
+    p = p * r + T::set1(5.0000001201E-1f);
+    p = p * r * r + r + T::set1(1.0f);
+    return p * pow2(n);
+}
+
+// Трансцендентные функции
+struct SigmoidBody {
+    float* data;
+    template <typename T> void operator()(size_t i) const {
+        T one = T::set1(1.0f);
+        (one / (one + expv(T::set1(0.0f) - T::load(data + i)))).store(data + i);
+    }
+};
+
+// tanh(x) = 2·σ(2x) − 1
+struct TanhBody {
+    float* data;
+    template <typename T> void operator()(size_t i) const {
+        T one = T::set1(1.0f);
+        (T::set1(2.0f) / (one + expv(T::set1(-2.0f) * T::load(data + i))) - one).store(data + i);
+    }
+};
+
+template <typename V>
+KOKORO_FLATTEN void sigmoid(float* data, size_t size) {
+    sweep<V>(size, SigmoidBody{data});
+}
+
+template <typename V>
+KOKORO_FLATTEN void tanh(float* data, size_t size) {
+    sweep<V>(size, TanhBody{data});
+}
+
+template <typename V>
+KOKORO_FLATTEN float expSum(const float* x, float shift, float* out, size_t size) {
+    V acc = V::set1(0.0f);
+    V s = V::set1(shift);
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        V e = expv(V::load(x + i) - s);
+        acc = acc + e;
+        if (out) {
+            e.store(out + i);
+        }
+    }
+    float total = horizontalSum(acc);
+    for (; i < size; ++i) {
+        float e = expv(simd::Scalar{x[i] - shift}).v;
+        total += e;
+        if (out) {
+            out[i] = e;
+        }
+    }
+    return total;
+}
+
+// Онлайн log-sum-exp за один проход: каждая дорожка хранит свой максимум и сумму
+// exp(x - максимум). Максимум обновляется сразу по четырем регистрам, поэтому сумма
+// пересчитывается одной экспонентой на четыре регистра входа. В конце дорожки
+// приводятся к общему максимуму, хвост добавляется скалярно тем же способом.
+template <typename V>
+KOKORO_FLATTEN float logSumExp(const float* x, size_t size) {
+    float shift = -std::numeric_limits<float>::infinity();
+    float total = 0.0f;
+    size_t i = 0;
+    if (size >= V::width) {
+        V m = V::load(x);
+        V s = V::set1(0.0f);
+        for (; i + 4 * V::width <= size; i += 4 * V::width) {
+            V a = V::load(x + i), b = V::load(x + i + V::width);
+            V c = V::load(x + i + 2 * V::width), d = V::load(x + i + 3 * V::width);
+            V next = max(m, max(max(a, b), max(c, d)));
+            s = s * expv(m - next) + ((expv(a - next) + expv(b - next)) + (expv(c - next) + expv(d - next)));
+            m = next;
+        }
+        for (; i + V::width <= size; i += V::width) {
+            V a = V::load(x + i);
+            V next = max(m, a);
+            s = s * expv(m - next) + expv(a - next);
+            m = next;
+        }
+        float lanes[V::width];
+        m.store(lanes);
+        for (size_t j = 0; j < V::width; ++j) shift = lanes[j] > shift ? lanes[j] : shift;
+        total = horizontalSum(s * expv(m - V::set1(shift)));
+    }
+    for (; i < size; ++i) {
+        if (x[i] > shift) {
+            total = total == 0.0f ? 0.0f : total * expv(simd::Scalar{shift - x[i]}).v;
+            shift = x[i];
+        }
+        total += expv(simd::Scalar{x[i] - shift}).v;
+    }
+    return shift + std::log(total);
+}
+
+// Строка softmax с перекрестной энтропией: out = exp(x - lse), а в том же проходе
+// sum(t) и sum(t * x); возвращает lse * sum(t) - sum(t * x)
+template <typename V>
+KOKORO_FLATTEN float softmaxXent(const float* x, const float* t, float lse, float* out, size_t size) {
+    V shift = V::set1(lse);
+    V t_acc = V::set1(0.0f), dot_acc = t_acc;
+    size_t i = 0;
+    for (; i + V::width <= size; i += V::width) {
+        V xi = V::load(x + i);
+        V ti = V::load(t + i);
+        expv(xi - shift).store(out + i);
+        t_acc = t_acc + ti;
+        dot_acc = fmadd(ti, xi, dot_acc);
+    }
+    float target_sum = horizontalSum(t_acc);
+    float dot = horizontalSum(dot_acc);
+    for (; i < size; ++i) {
+        out[i] = expv(simd::Scalar{x[i] - lse}).v;
+        target_sum += t[i];
+        dot += t[i] * x[i];
+    }
+    return lse * target_sum - dot;
+}
+
+// Редукции: четыре независимых аккумулятора скрывают задержку сложения
+template <typename V>
+KOKORO_FLATTEN float sum(const float* x, size_t size) {
+    V acc0 = V::set1(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * V::width <= size; i += 4 * V::width) {
+        acc0 = acc0 + V::load(x + i);
+        acc1 = acc1 + V::load(x + i + V::width);
+        acc2 = acc2 + V::load(x + i + 2 * V::width);
+        acc3 = acc3 + V::load(x + i + 3 * V::width);
+    }
+    for (; i + V::width <= size; i += V::width) {
+        acc0 = acc0 + V::load(x + i);
+    }
+    float total = horizontalSum((acc0 + acc1) + (acc2 + acc3));
+    for (; i < size; ++i) total += x[i];
+    return total;
+}
+
+template <typename V>
+KOKORO_FLATTEN float max(const float* x, size_t size) {
+    float result = x[0];
+    size_t i = 0;
+    if (size >= V::width) {
+        V acc = V::load(x);
+        for (i = V::width; i + V::width <= size; i += V::width) {
+            acc = max(acc, V::load(x + i));
+        }
+        float lanes[V::width];
+        acc.store(lanes);
+        for (size_t j = 0; j < V::width; ++j) result = lanes[j] > result ? lanes[j] : result;
+    }
+    for (; i < size; ++i) result = x[i] > result ? x[i] : result;
+    return result;
+}
+
+template <typename V>
+KOKORO_FLATTEN float dot(const float* a, const float* b, size_t size) {
+    V acc0 = V::set1(0.0f), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * V::width <= size; i += 4 * V::width) {
+        acc0 = fmadd(V::load(a + i), V::load(b + i), acc0);
+        acc1 = fmadd(V::load(a + i + V::width), V::load(b + i + V::width), acc1);
+        acc2 = fmadd(V::load(a + i + 2 * V::width), V::load(b + i + 2 * V::width), acc2);
+        acc3 = fmadd(V::load(a + i + 3 * V::width), V::load(b + i + 3 * V::width), acc3);
+    }
+    for (; i + V::width <= size; i += V::width) {
+        acc0 = fmadd(V::load(a + i), V::load(b + i), acc0);
+    }
+    float total = horizontalSum((acc0 + acc1) + (acc2 + acc3));
+    for (; i < size; ++i) total += a[i] * b[i];
+    return total;
+}
+
+// Поэлементные шаги оптимизаторов; T — тип регистра (V или simd::Scalar для хвоста)
+struct AdamBody {
+    const AdamScalars& s;
+    float* params; const float* grads; float* m; float* v;
+    template <typename T> void operator()(size_t i) const {
+        T g = T::load(grads + i);
+        T mi = T::set1(s.beta1) * T::load(m + i) + T::set1(1.0f - s.beta1) * g;
+        T vi = T::set1(s.beta2) * T::load(v + i) + T::set1(1.0f - s.beta2) * g * g;
+        mi.store(m + i);
+        vi.store(v + i);
+        T step = T::set1(s.learning_rate) * (mi * T::set1(s.inv_bias1))
+               / (sqrt(vi * T::set1(s.inv_bias2)) + T::set1(s.epsilon));
+        (T::load(params + i) - step).store(params + i);
+    }
+};
+
+struct AdamWBody {
+    const AdamScalars& s;
+    float* params; const float* grads; float* m; float* v;
+    template <typename T> void operator()(size_t i) const {
+        T g = T::load(grads + i);
+        T mi = T::set1(s.beta1) * T::load(m + i) + T::set1(1.0f - s.beta1) * g;
+        T vi = T::set1(s.beta2) * T::load(v + i) + T::set1(1.0f - s.beta2) * g * g;
+        mi.store(m + i);
+        vi.store(v + i);
+        T step = T::set1(s.learning_rate) * (mi * T::set1(s.inv_bias1))
+               / (sqrt(vi * T::set1(s.inv_bias2)) + T::set1(s.epsilon));
+        T p = T::load(params + i) - step;
+        (p - T::set1(s.learning_rate * s.weight_decay) * p).store(params + i);
+    }
+};
+
+struct NadamBody {
+    const AdamScalars& s;
+    float* params; const float* grads; float* m; float* v;
+    template <typename T> void operator()(size_t i) const {
+        T g = T::load(grads + i);
+        T mi = T::set1(s.beta1) * T::load(m + i) + T::set1(1.0f - s.beta1) * g;
+        T vi = T::set1(s.beta2) * T::load(v + i) + T::set1(1.0f - s.beta2) * g * g;
+        mi.store(m + i);
+        vi.store(v + i);
+        // beta1 * m_hat / (1 - beta1^t) + (1 - beta1) * g
+        T numerator = T::set1(s.beta1 * s.inv_bias1 * s.inv_bias1) * mi + T::set1(1.0f - s.beta1) * g;
+        T step = T::set1(s.learning_rate) * numerator
+               / (sqrt(vi * T::set1(s.inv_bias2)) + T::set1(s.epsilon));
+        (T::load(params + i) - step).store(params + i);
+    }
+};
+
+struct AdamaxBody {
+    const AdamScalars& s;
+    float* params; const float* grads; float* m; float* u;
+    template <typename T> void operator()(size_t i) const {
+        T g = T::load(grads + i);
+        T mi = T::set1(s.beta1) * T::load(m + i) + T::set1(1.0f - s.beta1) * g;
+        T ui = max(T::set1(s.beta2) * T::load(u + i), abs(g));
+        mi.store(m + i);
+        ui.store(u + i);
+        T step = T::set1(s.learning_rate) * mi / (ui + T::set1(s.epsilon));
+        (T::load(params + i) - step).store(params + i);
+    }
+};
+
+struct SgdBody {
+    float learning_rate;
+    float* params; const float* grads;
+    template <typename T> void operator()(size_t i) const {
+        (T::load(params + i) - T::set1(learning_rate) * T::load(grads + i)).store(params + i);
+    }
+};
+
+template <typename V>
+KOKORO_FLATTEN void sgd(float learning_rate, float* params, const float* grads, size_t size) {
+    sweep<V>(size, SgdBody{learning_rate, params, grads});
+}
+
+template <typename V>
+KOKORO_FLATTEN void adam(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) {
+    sweep<V>(size, AdamBody{s, params, grads, m, v});
+}
+
+template <typename V>
+KOKORO_FLATTEN void adamw(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) {
+    sweep<V>(size, AdamWBody{s, params, grads, m, v});
+}
+
+template <typename V>
+KOKORO_FLATTEN void nadam(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) {
+    sweep<V>(size, NadamBody{s, params, grads, m, v});
+}
+
+template <typename V>
+KOKORO_FLATTEN void adamax(const AdamScalars& s, float* params, const float* grads, float* m, float* u, size_t size) {
+    sweep<V>(size, AdamaxBody{s, params, grads, m, u});
+}
+
+// Таблица ядер для типа регистра V
+template <typename V>
+KernelTable makeTable() {
+    KernelTable table;
+    table.gemm_tile = gemmTile<V>;
+    table.add = add<V>;
+    table.sub = sub<V>;
+    table.mul = mul<V>;
+    table.scale = scale<V>;
+    table.relu = relu<V>;
+    table.sigmoid = sigmoid<V>;
+    table.tanh = tanh<V>;
+    table.exp_sum = expSum<V>;
+    table.log_sum_exp = logSumExp<V>;
+    table.softmax_xent = softmaxXent<V>;
+    table.sum = sum<V>;
+    table.max = max<V>;
+    table.dot = dot<V>;
+    table.sgd = sgd<V>;
+    table.adam = adam<V>;
+    table.adamw = adamw<V>;
+    table.nadam = nadam<V>;
+    table.adamax = adamax<V>;
+    return table;
+}
+
+} // namespace impl
+} // namespace
+
+#endif // KERNEL_IMPL_H
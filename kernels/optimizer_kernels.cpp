@@ -0,0 +1,37 @@
+#include "optimizer_kernels.h"
+#include "kernels/dispatch.h"
+#include <cmath>
+
+// Вычислить скаляры шага
+AdamScalars makeAdamScalars(float learning_rate, float beta1, float beta2, float epsilon,
+                            float weight_decay, size_t t) {
+    AdamScalars s;
+    s.learning_rate = learning_rate;
+    s.beta1 = beta1;
+    s.beta2 = beta2;
+    s.epsilon = epsilon;
+    s.weight_decay = weight_decay;
+    s.inv_bias1 = static_cast<float>(1.0 / (1.0 - std::pow(static_cast<double>(beta1), static_cast<double>(t))));
+    s.inv_bias2 = static_cast<float>(1.0 / (1.0 - std::pow(static_cast<double>(beta2), static_cast<double>(t))));
+    return s;
+}
+
+void sgdKernel(float learning_rate, float* params, const float* grads, size_t size) {
+    kernels().sgd(learning_rate, params, grads, size);
+}
+
+void adamKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) {
+    kernels().adam(s, params, grads, m, v, size);
+}
+
+void adamwKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) {
+    kernels().adamw(s, params, grads, m, v, size);
+}
+
+void nadamKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size) {
+    kernels().nadam(s, params, grads, m, v, size);
+}
+
+void adamaxKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* u, size_t size) {
+    kernels().adamax(s, params, grads, m, u, size);
+}
@@ -0,0 +1,31 @@
+#ifndef OPTIMIZER_KERNELS_H
+#define OPTIMIZER_KERNELS_H
+
+#include <cstddef>
+
+// Скаляры шага Adam-подобных оптимизаторов.
+// Коррекция смещения вычисляется один раз на шаг, а не для каждого элемента.
+struct AdamScalars {
+    float learning_rate;
+    float beta1;
+    float beta2;
+    float epsilon;
+    float weight_decay; // Только для AdamW
+    float inv_bias1;    // 1 / (1 - beta1^t)
+    float inv_bias2;    // 1 / (1 - beta2^t)
+};
+
+// Вычислить скаляры шага t (t >= 1)
+AdamScalars makeAdamScalars(float learning_rate, float beta1, float beta2, float epsilon,
+                            float weight_decay, size_t t);
+
+// Ядра за один проход читают и пишут параметры, градиент и моменты каждого элемента.
+// Формулы совпадают с исходными поэлементными реализациями оптимизаторов.
+// Вариант под набор инструкций процессора выбирает реестр ядер (kernels/dispatch.h).
+void sgdKernel(float learning_rate, float* params, const float* grads, size_t size);
+void adamKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size);
+void adamwKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size);
+void nadamKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* v, size_t size);
+void adamaxKernel(const AdamScalars& s, float* params, const float* grads, float* m, float* u, size_t size);
+
+#endif // OPTIMIZER_KERNELS_H
@@ -0,0 +1,138 @@
+#include "random.h"
+#include "kernels/simd.h"
+#include "kernels/vmath.h"
+#include <cmath>
+
+namespace {
+constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+constexpr size_t LANES = 16;          // Счетчиков в блоке
+constexpr size_t BLOCK = 4 * LANES;   // Значений в блоке
+constexpr float INV_2_24 = 1.0f / 16777216.0f;
+
+// Раунды Philox для LANES счетчиков подряд: out[4 * j + w] — слово w счетчика counter + j
+void philoxBlock(uint64_t seed, uint64_t counter, uint32_t* out) {
+    uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+    for (size_t j = 0; j < LANES; ++j) {
+        uint64_t c = counter + j;
+        c0[j] = static_cast<uint32_t>(c);
+        c1[j] = static_cast<uint32_t>(c >> 32);
+        c2[j] = 0;
+        c3[j] = 0;
+    }
+    uint32_t k0 = static_cast<uint32_t>(seed);
+    uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+    for (int round = 0; round < 10; ++round) {
+        for (size_t j = 0; j < LANES; ++j) {
+            uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0[j];
+            uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2[j];
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[j] ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[j] ^ k1;
+            c1[j] = static_cast<uint32_t>(p1);
+            c3[j] = static_cast<uint32_t>(p0);
+            c0[j] = n0;
+            c2[j] = n2;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    for (size_t j = 0; j < LANES; ++j) {
+        out[4 * j] = c0[j];
+        out[4 * j + 1] = c1[j];
+        out[4 * j + 2] = c2[j];
+        out[4 * j + 3] = c3[j];
+    }
+}
+
+// Старшие 24 бита слова — равномерное значение в [0, 1)
+inline float unitFloat(uint32_t word) {
+    return static_cast<float>(static_cast<int32_t>(word >> 8)) * INV_2_24;
+}
+
+// Пара нормальных значений из пары слов (Бокс — Мюллер)
+inline void boxMuller(uint32_t a, uint32_t b, float& z0, float& z1) {
+    float u1 = static_cast<float>(static_cast<int32_t>((a >> 8) + 1)) * INV_2_24; // (0, 1]: логарифм конечен
+    float r = std::sqrt(-2.0f * vlog(u1));
+    float s, c;
+    vsincos2pi(unitFloat(b), s, c);
+    z0 = r * c;
+    z1 = r * s;
+}
+}
+
+// Четыре слова для одного счетчика
+void philox4x32(uint64_t seed, uint64_t counter, uint32_t out[4]) {
+    uint32_t c0 = static_cast<uint32_t>(counter), c1 = static_cast<uint32_t>(counter >> 32), c2 = 0, c3 = 0;
+    uint32_t k0 = static_cast<uint32_t>(seed);
+    uint32_t k1 = static_cast<uint32_t>(seed >> 32);
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+        uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+        uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<uint32_t>(p1);
+        c3 = static_cast<uint32_t>(p0);
+        c0 = n0;
+        c2 = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// Равномерные значения: целые блоки по BLOCK значений, края — по одному значению
+void uniformKernel(float* dst, size_t size, uint64_t seed, uint64_t offset, float low, float high) {
+    float range = high - low;
+    uint32_t words[BLOCK];
+    size_t i = 0;
+    while (i < size) {
+        uint64_t p = offset + i;
+        if (p % 4 == 0 && size - i >= BLOCK) {
+            philoxBlock(seed, p / 4, words);
+            for (size_t k = 0; k < BLOCK; ++k) {
+                dst[i + k] = low + range * unitFloat(words[k]);
+            }
+            i += BLOCK;
+        } else {
+            philox4x32(seed, p / 4, words);
+            dst[i++] = low + range * unitFloat(words[p % 4]);
+        }
+    }
+}
+
+// Нормальные значения: слова (0, 1) и (2, 3) каждого счетчика дают по паре значений
+void normalKernel(float* dst, size_t size, uint64_t seed, uint64_t offset, float mean, float stddev) {
+    uint32_t words[BLOCK];
+    size_t i = 0;
+    while (i < size) {
+        uint64_t p = offset + i;
+        if (p % 4 == 0 && size - i >= BLOCK) {
+            // Проходы без ветвлений; корень — через simd, т.к. std::sqrt с проверкой errno не векторизуется
+            philoxBlock(seed, p / 4, words);
+            float radius[BLOCK / 2], sine[BLOCK / 2], cosine[BLOCK / 2];
+            for (size_t k = 0; k < BLOCK / 2; ++k) {
+                radius[k] = -2.0f * vlog(static_cast<float>(static_cast<int32_t>((words[2 * k] >> 8) + 1)) * INV_2_24);
+                vsincos2pi(unitFloat(words[2 * k + 1]), sine[k], cosine[k]);
+            }
+            for (size_t k = 0; k < BLOCK / 2; k += simd::Native::width) {
+                sqrt(simd::Native::load(radius + k)).store(radius + k);
+            }
+            for (size_t k = 0; k < BLOCK / 2; ++k) {
+                dst[i + 2 * k] = mean + stddev * (radius[k] * cosine[k]);
+                dst[i + 2 * k + 1] = mean + stddev * (radius[k] * sine[k]);
+            }
+            i += BLOCK;
+        } else {
+            philox4x32(seed, p / 4, words);
+            size_t pair = p % 4 & ~uint64_t(1);
+            float z0, z1;
+            boxMuller(words[pair], words[pair + 1], z0, z1);
+            dst[i++] = mean + stddev * (p % 2 == 0 ? z0 : z1);
+        }
+    }
+}
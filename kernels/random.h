@@ -0,0 +1,21 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Счетчиковый генератор Philox4x32-10: значение с номером p потока seed — функция только (seed, p).
+// Поэтому массив можно заполнять кусками в любом порядке и любым числом потоков,
+// а результат не зависит от разбиения. Блоки по 16 счетчиков считаются независимыми
+// дорожками и разворачиваются компилятором в SIMD-инструкции.
+
+// Четыре 32-битных слова для счетчика counter
+void philox4x32(uint64_t seed, uint64_t counter, uint32_t out[4]);
+
+// dst[i] — равномерное значение в [low, high) с номером offset + i в потоке seed
+void uniformKernel(float* dst, size_t size, uint64_t seed, uint64_t offset, float low, float high);
+
+// dst[i] — нормальное значение N(mean, stddev²) с номером offset + i в потоке seed (Бокс — Мюллер)
+void normalKernel(float* dst, size_t size, uint64_t seed, uint64_t offset, float mean, float stddev);
+
+#endif // RANDOM_H
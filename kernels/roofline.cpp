@@ -0,0 +1,121 @@
+#include "roofline.h"
+#include "kernels/dispatch.h"
+#include "utils/aligned_buffer.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+constexpr size_t TILE_KC = 256;                      // Глубина панелей: A и B вместе ~22 КиБ, в L1
+constexpr size_t BANDWIDTH_FLOATS = 16 * 1024 * 1024; // 64 МиБ
+constexpr int REPEATS = 3;                           // Берется лучший из повторов
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// body(i) для каждого исполнителя i < executors; один исполнитель — вызывающий поток без пула
+template <typename Body>
+void onExecutors(size_t executors, Body body) {
+    if (executors == 1) {
+        body(0);
+        return;
+    }
+    ThreadPool::global().parallelFor(0, executors, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            body(i);
+        }
+    });
+}
+
+// Пиковая скорость микроядра GEMM на executors исполнителях, GFLOP/s
+double measurePeak(size_t executors) {
+    const KernelTable& table = kernels();
+    AlignedBuffer a(TILE_KC * GEMM_MR);
+    AlignedBuffer b(TILE_KC * GEMM_NR);
+    std::fill(a.data(), a.data() + a.size(), 1e-3f);
+    std::fill(b.data(), b.data() + b.size(), 1e-3f);
+    const double flops_per_call = 2.0 * GEMM_MR * GEMM_NR * TILE_KC;
+    std::atomic<float> sink{0.0f};
+
+    // calls вызовов на одном исполнителе
+    auto run = [&](size_t calls) {
+        alignas(64) float acc[GEMM_MR * GEMM_NR] = {};
+        for (size_t c = 0; c < calls; ++c) {
+            table.gemm_tile(TILE_KC, a.data(), b.data(), acc);
+        }
+        sink.store(sink.load(std::memory_order_relaxed) + acc[0], std::memory_order_relaxed);
+    };
+
+    // Число вызовов на ~20 мс одного исполнителя
+    auto start = std::chrono::steady_clock::now();
+    run(64);
+    double per_call = std::max(secondsSince(start) / 64.0, 1e-9);
+    size_t calls = std::max<size_t>(64, static_cast<size_t>(0.02 / per_call));
+
+    double best = 0.0;
+    for (int r = 0; r < REPEATS; ++r) {
+        start = std::chrono::steady_clock::now();
+        onExecutors(executors, [&](size_t) { run(calls); });
+        double seconds = secondsSince(start);
+        best = std::max(best, flops_per_call * calls * executors / seconds * 1e-9);
+    }
+    return best;
+}
+
+// Полоса чтения памяти executors исполнителями (каждый читает свою часть буфера), GB/s
+double measureBandwidth(size_t executors) {
+    const KernelTable& table = kernels();
+    AlignedBuffer buffer(BANDWIDTH_FLOATS); // Выделение обнуляет буфер: страницы уже отображены
+    size_t slice = BANDWIDTH_FLOATS / executors;
+    std::atomic<float> sink{0.0f};
+    double best = 0.0;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        onExecutors(executors, [&](size_t i) {
+            size_t begin = i * slice;
+            size_t end = i + 1 == executors ? BANDWIDTH_FLOATS : begin + slice;
+            float sum = table.sum(buffer.data() + begin, end - begin);
+            sink.store(sink.load(std::memory_order_relaxed) + sum, std::memory_order_relaxed);
+        });
+        double seconds = secondsSince(start);
+        best = std::max(best, BANDWIDTH_FLOATS * sizeof(float) / seconds * 1e-9);
+    }
+    return best;
+}
+
+} // namespace
+
+// Точка перегиба
+double Roofline::ridge() const {
+    return bandwidth_gbs > 0.0 ? peak_gflops / bandwidth_gbs : 0.0;
+}
+
+// Время по модели roofline
+double Roofline::predictSeconds(double flops, double bytes) const {
+    double compute = peak_gflops > 0.0 ? flops / (peak_gflops * 1e9) : 0.0;
+    double memory = bandwidth_gbs > 0.0 ? bytes / (bandwidth_gbs * 1e9) : 0.0;
+    return std::max(compute, memory);
+}
+
+// Упирается ли работа в память
+bool Roofline::memoryBound(double flops, double bytes) const {
+    return bytes > 0.0 && flops / bytes < ridge();
+}
+
+// Измерить потолки машины на executors исполнителях
+Roofline measureRoofline(size_t executors) {
+    Roofline roofline;
+    roofline.executors = std::min(std::max<size_t>(executors, 1), ThreadPool::global().concurrency());
+    roofline.peak_gflops = measurePeak(roofline.executors);
+    roofline.bandwidth_gbs = measureBandwidth(roofline.executors);
+    return roofline;
+}
+
+// Потолки одного исполнителя (измеряются один раз)
+const Roofline& machineRoofline() {
+    static const Roofline roofline = measureRoofline(1);
+    return roofline;
+}
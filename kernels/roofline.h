@@ -0,0 +1,34 @@
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include <cstddef>
+
+// Потолки машины для модели roofline: время работы не меньше времени вычислений на пиковой
+// скорости и не меньше времени передачи ее байтов из памяти
+struct Roofline {
+    double peak_gflops = 0.0;   // Пиковая скорость вычислений, GFLOP/s
+    double bandwidth_gbs = 0.0; // Пропускная способность памяти, GB/s
+    size_t executors = 1;       // Число исполнителей, на которых измерены потолки
+
+    // Точка перегиба: интенсивность (FLOP/байт), начиная с которой работа упирается в вычисления
+    double ridge() const;
+
+    // Предсказанное время работы: max(flops / пик, bytes / полоса), в секундах
+    double predictSeconds(double flops, double bytes) const;
+
+    // Упирается ли работа в память (ее интенсивность ниже точки перегиба)
+    bool memoryBound(double flops, double bytes) const;
+};
+
+// Измерить потолки на executors исполнителях общего пула потоков (не больше их числа; 1 —
+// только вызывающий поток): пик — микроядро GEMM выбранного набора инструкций на данных
+// из L1, полоса — сумма буфера в 64 МиБ (больше кэша последнего уровня), поделенного между
+// исполнителями. Занимает около десятой доли секунды.
+Roofline measureRoofline(size_t executors = 1);
+
+// Потолки одного исполнителя этой машины, измеренные один раз при первом обращении.
+// Прямой и обратный проходы модели выполняются одним потоком, поэтому их время
+// предсказывается по этим потолкам, а не по потолкам всего пула.
+const Roofline& machineRoofline();
+
+#endif // ROOFLINE_H
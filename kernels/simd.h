@@ -0,0 +1,161 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#if defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__) || defined(KOKORO_SIMD_AVX2) || \
+    defined(KOKORO_SIMD_AVX512)
+#include <immintrin.h>
+#endif
+
+// Тонкие обертки над SIMD-регистрами float для ядер с явной векторизацией.
+// Каждый тип предоставляет одинаковый набор операций, поэтому ядро пишется один раз
+// как шаблон и инстанцируется для нужного набора инструкций. Операции — свободные
+// функции, а не друзья класса: GCC не применяет #pragma GCC target к друзьям,
+// определенным внутри класса.
+//
+// Типы доступны, если набор инструкций включен флагами компиляции, или если файл
+// включил его через #pragma GCC target и определил KOKORO_SIMD_AVX2 / KOKORO_SIMD_AVX512
+// (прагма не определяет макросы __AVX2__ и т.п.; так собираются ядра kernels/isa_*.cpp).
+namespace simd {
+
+// Скалярная реализация (используется для хвостов и на платформах без SIMD)
+struct Scalar {
+    static constexpr size_t width = 1;
+    float v;
+    static Scalar load(const float* p) { return {*p}; }
+    static Scalar set1(float x) { return {x}; }
+    void store(float* p) const { *p = v; }
+};
+
+inline Scalar operator+(Scalar a, Scalar b) { return {a.v + b.v}; }
+inline Scalar operator-(Scalar a, Scalar b) { return {a.v - b.v}; }
+inline Scalar operator*(Scalar a, Scalar b) { return {a.v * b.v}; }
+inline Scalar operator/(Scalar a, Scalar b) { return {a.v / b.v}; }
+inline Scalar sqrt(Scalar a) { return {std::sqrt(a.v)}; }
+inline Scalar max(Scalar a, Scalar b) { return {std::max(a.v, b.v)}; }
+inline Scalar min(Scalar a, Scalar b) { return {std::min(a.v, b.v)}; }
+inline Scalar abs(Scalar a) { return {std::fabs(a.v)}; }
+inline Scalar fmadd(Scalar a, Scalar b, Scalar c) { return {a.v * b.v + c.v}; }
+inline Scalar floor(Scalar a) { return {std::floor(a.v)}; }
+// 2^n для целого n в [-126, 127], записанного как float
+inline Scalar pow2(Scalar n) {
+    int32_t bits = (static_cast<int32_t>(n.v) + 127) << 23;
+    float r;
+    std::memcpy(&r, &bits, sizeof(r));
+    return {r};
+}
+
+#if defined(__SSE2__)
+struct Sse2 {
+    static constexpr size_t width = 4;
+    __m128 v;
+    static Sse2 load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static Sse2 set1(float x) { return {_mm_set1_ps(x)}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+};
+
+inline Sse2 operator+(Sse2 a, Sse2 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Sse2 operator-(Sse2 a, Sse2 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Sse2 operator*(Sse2 a, Sse2 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Sse2 operator/(Sse2 a, Sse2 b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Sse2 sqrt(Sse2 a) { return {_mm_sqrt_ps(a.v)}; }
+inline Sse2 max(Sse2 a, Sse2 b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Sse2 min(Sse2 a, Sse2 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Sse2 abs(Sse2 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+inline Sse2 fmadd(Sse2 a, Sse2 b, Sse2 c) { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+// Без SSE4.1: отбрасывание дробной части и поправка для отрицательных (|a| < 2^31)
+inline Sse2 floor(Sse2 a) {
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    return {_mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)))};
+}
+inline Sse2 pow2(Sse2 n) {
+    __m128i e = _mm_add_epi32(_mm_cvttps_epi32(n.v), _mm_set1_epi32(127));
+    return {_mm_castsi128_ps(_mm_slli_epi32(e, 23))};
+}
+#endif
+
+#if defined(__AVX__) || defined(KOKORO_SIMD_AVX2)
+struct Avx {
+    static constexpr size_t width = 8;
+    __m256 v;
+    static Avx load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static Avx set1(float x) { return {_mm256_set1_ps(x)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+
+inline Avx operator+(Avx a, Avx b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline Avx operator-(Avx a, Avx b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline Avx operator*(Avx a, Avx b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline Avx operator/(Avx a, Avx b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline Avx sqrt(Avx a) { return {_mm256_sqrt_ps(a.v)}; }
+inline Avx max(Avx a, Avx b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline Avx min(Avx a, Avx b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline Avx abs(Avx a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+inline Avx floor(Avx a) { return {_mm256_floor_ps(a.v)}; }
+#if defined(__FMA__) || defined(KOKORO_SIMD_AVX2)
+inline Avx fmadd(Avx a, Avx b, Avx c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+#else
+inline Avx fmadd(Avx a, Avx b, Avx c) { return {_mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v)}; }
+#endif
+#if defined(__AVX2__) || defined(KOKORO_SIMD_AVX2)
+inline Avx pow2(Avx n) {
+    __m256i e = _mm256_add_epi32(_mm256_cvttps_epi32(n.v), _mm256_set1_epi32(127));
+    return {_mm256_castsi256_ps(_mm256_slli_epi32(e, 23))};
+}
+#else
+// AVX без AVX2 не имеет 256-битных целочисленных операций: по половинам
+inline Avx pow2(Avx n) {
+    __m256i i = _mm256_cvttps_epi32(n.v);
+    __m128i lo = _mm_slli_epi32(_mm_add_epi32(_mm256_castsi256_si128(i), _mm_set1_epi32(127)), 23);
+    __m128i hi = _mm_slli_epi32(_mm_add_epi32(_mm256_extractf128_si256(i, 1), _mm_set1_epi32(127)), 23);
+    return {_mm256_castsi256_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(lo), hi, 1))};
+}
+#endif
+#endif
+
+#if defined(__AVX512F__) || defined(KOKORO_SIMD_AVX512)
+struct Avx512 {
+    static constexpr size_t width = 16;
+    __m512 v;
+    static Avx512 load(const float* p) { return {_mm512_loadu_ps(p)}; }
+    static Avx512 set1(float x) { return {_mm512_set1_ps(x)}; }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+};
+
+inline Avx512 operator+(Avx512 a, Avx512 b) { return {_mm512_add_ps(a.v, b.v)}; }
+inline Avx512 operator-(Avx512 a, Avx512 b) { return {_mm512_sub_ps(a.v, b.v)}; }
+inline Avx512 operator*(Avx512 a, Avx512 b) { return {_mm512_mul_ps(a.v, b.v)}; }
+inline Avx512 operator/(Avx512 a, Avx512 b) { return {_mm512_div_ps(a.v, b.v)}; }
+// Формы с маской: немаскированные sqrt/max/min/cvtt/slli в GCC 12 дают ложное -Wmaybe-uninitialized
+inline Avx512 sqrt(Avx512 a) { return {_mm512_maskz_sqrt_ps(0xFFFF, a.v)}; }
+inline Avx512 max(Avx512 a, Avx512 b) { return {_mm512_maskz_max_ps(0xFFFF, a.v, b.v)}; }
+inline Avx512 min(Avx512 a, Avx512 b) { return {_mm512_maskz_min_ps(0xFFFF, a.v, b.v)}; }
+inline Avx512 abs(Avx512 a) { return {_mm512_abs_ps(a.v)}; }
+inline Avx512 fmadd(Avx512 a, Avx512 b, Avx512 c) { return {_mm512_fmadd_ps(a.v, b.v, c.v)}; }
+inline Avx512 floor(Avx512 a) {
+    return {_mm512_maskz_roundscale_ps(0xFFFF, a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC)};
+}
+inline Avx512 pow2(Avx512 n) {
+    __m512i e = _mm512_add_epi32(_mm512_maskz_cvttps_epi32(0xFFFF, n.v), _mm512_set1_epi32(127));
+    return {_mm512_castsi512_ps(_mm512_maskz_slli_epi32(0xFFFF, e, 23))};
+}
+#endif
+
+// Самый широкий набор инструкций, доступный при компиляции
+#if defined(__AVX512F__)
+using Native = Avx512;
+#elif defined(__AVX__)
+using Native = Avx;
+#elif defined(__SSE2__)
+using Native = Sse2;
+#else
+using Native = Scalar;
+#endif
+
+} // namespace simd
+
+#endif // SIMD_H
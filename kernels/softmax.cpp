@@ -0,0 +1,21 @@
+#include "softmax.h"
+#include "kernels/dispatch.h"
+#include <limits>
+
+// log-sum-exp одним проходом онлайн-ядра из реестра
+float logSumExp(const float* x, size_t size) {
+    if (size == 0) {
+        return -std::numeric_limits<float>::infinity();
+    }
+    return kernels().log_sum_exp(x, size);
+}
+
+// Построчный softmax: проход для log-sum-exp и проход записи exp(x - lse)
+void softmaxRows(const float* input, float* output, size_t rows, size_t cols) {
+    const KernelTable& table = kernels();
+    for (size_t r = 0; r < rows; ++r) {
+        const float* x = input + r * cols;
+        float* y = output + r * cols;
+        table.exp_sum(x, table.log_sum_exp(x, cols), y, cols);
+    }
+}
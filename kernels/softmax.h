@@ -0,0 +1,12 @@
+#ifndef SOFTMAX_KERNELS_H
+#define SOFTMAX_KERNELS_H
+
+#include <cstddef>
+
+// Устойчивый log(sum(exp(x))) за один проход с бегущим максимумом
+float logSumExp(const float* x, size_t size);
+
+// Построчный softmax матрицы (rows x cols); output может совпадать с input
+void softmaxRows(const float* input, float* output, size_t rows, size_t cols);
+
+#endif // SOFTMAX_KERNELS_H
@@ -0,0 +1,84 @@
+#ifndef VMATH_H
+#define VMATH_H
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+// Векторизуемые версии трансцендентных функций для float.
+// Написаны без ветвлений и вызовов libm, чтобы компилятор мог развернуть
+// циклы над массивами в SIMD-инструкции.
+
+// Экспонента (полином Cephes, относительная погрешность ~1e-7)
+inline float vexp(float x) {
+    x = std::fmin(std::fmax(x, -87.3f), 88.7f);
+    float n = std::floor(x * 1.44269504088896341f + 0.5f);
+    float r = x - n * 0.693359375f + n * 2.12194440e-4f;
+    float p = 1.9875691500E-4f;
+    p = p * r + 1.3981999507E-3f;
+    p = p * r + 8.3334519073E-3f;
+    p = p * r + 4.1665795894E-2f;
+    p = p * r + 1.6666665459E-1f;
+    p = p * r + 5.0000001201E-1f;
+    p = p * r * r + r + 1.0f;
+    int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// Сигмоида
+inline float vsigmoid(float x) {
+    return 1.0f / (1.0f + vexp(-x));
+}
+
+// Гиперболический тангенс через сигмоиду: tanh(x) = 2·σ(2x) − 1
+inline float vtanh(float x) {
+    return 2.0f / (1.0f + vexp(-2.0f * x)) - 1.0f;
+}
+
+// Натуральный логарифм для x > 0 (полином Cephes, относительная погрешность ~1e-7)
+inline float vlog(float x) {
+    int32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    // x = m * 2^e, m в [0.5, 1)
+    float e = static_cast<float>(((bits >> 23) & 0xff) - 126);
+    bits = (bits & 0x807fffff) | 0x3f000000;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    // Сдвиг m в [sqrt(0.5), sqrt(2)), чтобы аргумент полинома был близок к нулю
+    bool small = m < 0.707106781186547524f;
+    e = small ? e - 1.0f : e;
+    m = small ? m + m - 1.0f : m - 1.0f;
+    float z = m * m;
+    float y = 7.0376836292E-2f;
+    y = y * m - 1.1514610310E-1f;
+    y = y * m + 1.1676998740E-1f;
+    y = y * m - 1.2420140846E-1f;
+    y = y * m + 1.4249322787E-1f;
+    y = y * m - 1.6668057665E-1f;
+    y = y * m + 2.0000714765E-1f;
+    y = y * m - 2.4999993993E-1f;
+    y = y * m + 3.3333331174E-1f;
+    y = y * m * z;
+    y += e * -2.12194440e-4f;
+    y += -0.5f * z;
+    return m + y + e * 0.693359375f;
+}
+
+// Синус и косинус 2πu для u в [0, 1): ряды Тейлора для π·t, t в [-0.5, 0.5],
+// затем формулы двойного угла (погрешность ~1e-7)
+inline void vsincos2pi(float u, float& s, float& c) {
+    // Округление через int: std::floor без -ffast-math не векторизуется
+    float t = u - static_cast<float>(static_cast<int32_t>(u + 0.5f));
+    float x = t * 3.14159265358979324f;
+    float x2 = x * x;
+    float sh = x * (1.0f + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880 +
+                    x2 * (-1.0f / 39916800))))));
+    float ch = 1.0f + x2 * (-0.5f + x2 * (1.0f / 24 + x2 * (-1.0f / 720 + x2 * (1.0f / 40320 +
+               x2 * (-1.0f / 3628800 + x2 * (1.0f / 479001600))))));
+    s = 2.0f * sh * ch;
+    c = 1.0f - 2.0f * sh * sh;
+}
+
+#endif // VMATH_H
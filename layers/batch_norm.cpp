@@ -1,12 +1,19 @@
 #include "batch_norm.h"
+#include "serialization.h"
+#include <algorithm>
 #include <cmath>
 
+namespace {
+const uint32_t batch_norm_version = 1; // Версия записи слоя
+}
+
 // Конструктор
 BatchNorm::BatchNorm(size_t num_features, float epsilon, float momentum)
     : num_features(num_features), epsilon(epsilon), momentum(momentum),
       gamma({num_features}), beta({num_features}),
+      grad_gamma({num_features}), grad_beta({num_features}),
       running_mean({num_features}), running_var({num_features}),
-      input_cache({}), normalized({}) {
+      input_cache({}), batch_mean({}), inv_std({}), shape{num_features} {
     // Инициализируем параметры
     gamma.fill(1.0f); // Начальное значение gamma = 1
     beta.fill(0.0f);  // Начальное значение beta = 0
@@ -25,86 +32,282 @@ Tensor BatchNorm::forward(const Tensor& input) {
 
     // Кэшируем входные данные для backward pass
     input_cache = input;
+    Tensor output(input.shape());
+    normalize(input_cache, output);
+    return output;
+}
 
-    // Вычисляем среднее значение и дисперсию по мини-батчу
-    Tensor mean({num_features});
-    Tensor var({num_features});
+// Прямой проход в буфер модели: кэш входа — вид на буфер входа
+void BatchNorm::forwardInto(Tensor& input, Tensor& output) {
+    if (input.shape().size() != 2 || input.shape()[1] != num_features) {
+        throw std::invalid_argument("Input tensor must have shape (batch_size, num_features).");
+    }
+    if (output.size() != input.size()) {
+        throw std::invalid_argument("Output buffer must match the layer output shape.");
+    }
+    input_cache.alias(input);
+    normalize(input, output);
+}
 
-    for (size_t i = 0; i < num_features; ++i) {
-        float sum = 0.0f;
-        float sum_sq = 0.0f;
+// Статистики батча, обновление скользящих средних и output = gamma * x_hat + beta,
+// x_hat = (x - mean) / sqrt(var + eps). Буферы статистик выделяются один раз.
+void BatchNorm::normalize(const Tensor& input, Tensor& output) {
+    size_t batch = input.shape()[0];
+    if (batch_mean.size() != num_features) {
+        batch_mean = Tensor({num_features});
+        inv_std = Tensor({num_features});
+    }
+    float* mean = batch_mean.data();
+    float* scale = inv_std.data();
+    const float* x = input.data();
 
-        for (size_t j = 0; j < input.shape()[0]; ++j) {
-            sum += input({j, i});
-            sum_sq += input({j, i}) * input({j, i});
+    // Среднее, затем дисперсия относительно него (точнее, чем E[x^2] - E[x]^2)
+    std::fill(mean, mean + num_features, 0.0f);
+    std::fill(scale, scale + num_features, 0.0f);
+    for (size_t i = 0; i < batch; ++i) {
+        const float* row = x + i * num_features;
+        for (size_t j = 0; j < num_features; ++j) {
+            mean[j] += row[j];
         }
-
-        mean({i}) = sum / input.shape()[0];
-        var({i}) = (sum_sq / input.shape()[0]) - (mean({i}) * mean({i}));
     }
-
-    // Обновляем скользящие средние
-    for (size_t i = 0; i < num_features; ++i) {
-        running_mean({i}) = momentum * running_mean({i}) + (1 - momentum) * mean({i});
-        running_var({i}) = momentum * running_var({i}) + (1 - momentum) * var({i});
+    for (size_t j = 0; j < num_features; ++j) {
+        mean[j] /= batch;
     }
-
-    // Нормализуем данные
-    normalized = Tensor(input.shape());
-    for (size_t i = 0; i < input.shape()[0]; ++i) {
+    for (size_t i = 0; i < batch; ++i) {
+        const float* row = x + i * num_features;
         for (size_t j = 0; j < num_features; ++j) {
-            normalized({i, j}) = (input({i, j}) - mean({j})) / std::sqrt(var({j}) + epsilon);
+            float d = row[j] - mean[j];
+            scale[j] += d * d;
         }
     }
 
-    // Применяем масштабирование и смещение
-    Tensor output(input.shape());
-    for (size_t i = 0; i < input.shape()[0]; ++i) {
+    // Обновляем скользящие средние; scale становится 1 / sqrt(var + eps)
+    for (size_t j = 0; j < num_features; ++j) {
+        float var = scale[j] / batch;
+        running_mean[j] = momentum * running_mean[j] + (1 - momentum) * mean[j];
+        running_var[j] = momentum * running_var[j] + (1 - momentum) * var;
+        scale[j] = 1.0f / std::sqrt(var + epsilon);
+    }
+
+    // Нормализуем данные, масштабируем и сдвигаем
+    float* y = output.data();
+    for (size_t i = 0; i < batch; ++i) {
+        const float* row = x + i * num_features;
+        float* out = y + i * num_features;
         for (size_t j = 0; j < num_features; ++j) {
-            output({i, j}) = gamma({j}) * normalized({i, j}) + beta({j});
+            out[j] = gamma[j] * (row[j] - mean[j]) * scale[j] + beta[j];
         }
     }
+}
 
+// Вывод: нормировка скользящими статистиками, которые не изменяются
+Tensor BatchNorm::infer(const Tensor& input, LayerState* state) const {
+    Tensor output = input;
+    inferInPlace(output, state);
     return output;
 }
 
+// Вывод на месте: y = x * scale + shift, scale = gamma / sqrt(running_var + eps)
+void BatchNorm::inferInPlace(Tensor& data, LayerState* state) const {
+    if (data.shape().size() != 2 || data.shape()[1] != num_features) {
+        throw std::invalid_argument("Input tensor must have shape (batch_size, num_features).");
+    }
+    std::vector<float> scale(num_features);
+    std::vector<float> shift(num_features);
+    for (size_t j = 0; j < num_features; ++j) {
+        scale[j] = gamma[j] / std::sqrt(running_var[j] + epsilon);
+        shift[j] = beta[j] - running_mean[j] * scale[j];
+    }
+    float* x = data.data();
+    for (size_t i = 0; i < data.shape()[0]; ++i) {
+        float* row = x + i * num_features;
+        for (size_t j = 0; j < num_features; ++j) {
+            row[j] = row[j] * scale[j] + shift[j];
+        }
+    }
+}
+
 // Обратный проход
-Tensor BatchNorm::backward(const Tensor& grad_output, float learning_rate) {
+Tensor BatchNorm::backward(const Tensor& grad_output) {
     // Проверка формы градиента
     if (grad_output.shape() != input_cache.shape()) {
         throw std::invalid_argument("Gradient tensor must have the same shape as input tensor.");
     }
+    Tensor grad_input(input_cache.shape());
+    backpropagate(grad_output, grad_input);
+    return grad_input;
+}
+
+// Обратный проход в буфер модели
+void BatchNorm::backwardInto(Tensor& grad_output, Tensor& grad_input) {
+    if (grad_output.size() != input_cache.size() || grad_input.size() != input_cache.size()) {
+        throw std::invalid_argument("Gradient tensor must have the same shape as input tensor.");
+    }
+    backpropagate(grad_output, grad_input);
+}
 
-    // Вычисляем градиенты для gamma и beta
-    Tensor grad_gamma({num_features});
-    Tensor grad_beta({num_features});
+// Градиенты gamma и beta накапливаются; градиент по входу учитывает, что среднее и дисперсия
+// батча зависят от входа: dx = gamma / sigma * (g - mean(g) - x_hat * mean(g * x_hat)).
+// x_hat пересчитывается по кэшу входа и статистикам батча.
+void BatchNorm::backpropagate(const Tensor& grad_output, Tensor& grad_input) {
+    size_t batch = input_cache.shape()[0];
+    const float* x = input_cache.data();
+    const float* g = grad_output.data();
+    const float* mean = batch_mean.data();
+    const float* scale = inv_std.data();
 
+    // Суммы g и g * x_hat по батчу
+    feature_sums.assign(2 * num_features, 0.0f);
+    float* sum_g = feature_sums.data();
+    float* sum_gx = sum_g + num_features;
+    for (size_t i = 0; i < batch; ++i) {
+        const float* row = x + i * num_features;
+        const float* grad = g + i * num_features;
+        for (size_t j = 0; j < num_features; ++j) {
+            sum_g[j] += grad[j];
+            sum_gx[j] += grad[j] * (row[j] - mean[j]) * scale[j];
+        }
+    }
     for (size_t j = 0; j < num_features; ++j) {
-        float sum_gamma = 0.0f;
-        float sum_beta = 0.0f;
+        grad_gamma[j] += sum_gx[j];
+        grad_beta[j] += sum_g[j];
+    }
 
-        for (size_t i = 0; i < grad_output.shape()[0]; ++i) {
-            sum_gamma += grad_output({i, j}) * normalized({i, j});
-            sum_beta += grad_output({i, j});
+    float* dx = grad_input.data();
+    for (size_t i = 0; i < batch; ++i) {
+        const float* row = x + i * num_features;
+        const float* grad = g + i * num_features;
+        float* out = dx + i * num_features;
+        for (size_t j = 0; j < num_features; ++j) {
+            float x_hat = (row[j] - mean[j]) * scale[j];
+            out[j] = gamma[j] * scale[j] * (grad[j] - sum_g[j] / batch - x_hat * sum_gx[j] / batch);
         }
+    }
+}
+
+// Обратному проходу нужен вход
+bool BatchNorm::backwardNeedsInput() const {
+    return true;
+}
 
-        grad_gamma({j}) = sum_gamma;
-        grad_beta({j}) = sum_beta;
+// Форма выхода
+std::vector<size_t> BatchNorm::inferShape(const std::vector<size_t>& input_shape) {
+    if (input_shape.size() != 2 || input_shape[1] != num_features) {
+        throw std::invalid_argument("Input tensor must have shape (batch_size, num_features).");
     }
+    shape = input_shape;
+    return shape;
+}
 
-    // Обновляем параметры gamma и beta
-    for (size_t j = 0; j < num_features; ++j) {
-        gamma({j}) -= learning_rate * grad_gamma({j});
-        beta({j}) -= learning_rate * grad_beta({j});
+// Форма входа
+std::vector<size_t> BatchNorm::getInputShape() const {
+    return shape;
+}
+
+// Форма выхода
+std::vector<size_t> BatchNorm::getOutputShape() const {
+    return shape;
+}
+
+// Параметры слоя
+std::vector<Parameter> BatchNorm::parameters() {
+    return {{"gamma", &gamma, &grad_gamma}, {"beta", &beta, &grad_beta}};
+}
+
+// Количество параметров: gamma и beta
+size_t BatchNorm::getNumParameters() const {
+    return gamma.size() + beta.size();
+}
+
+// Копия слоя
+std::shared_ptr<Layer> BatchNorm::clone() const {
+    return std::make_shared<BatchNorm>(*this);
+}
+
+// Освободить кэши прямого прохода
+void BatchNorm::releaseCache() {
+    input_cache = Tensor({0});
+    batch_mean = Tensor({0});
+    inv_std = Tensor({0});
+}
+
+// Байты кэшей прямого прохода
+size_t BatchNorm::cacheBytes() const {
+    return (input_cache.size() + batch_mean.size() + inv_std.size()) * sizeof(float);
+}
+
+// Повторный прямой проход не идентичен первому
+bool BatchNorm::isRecomputable() const {
+    return false;
+}
+
+// Байты скользящих статистик и сумм обратного прохода
+size_t BatchNorm::scratchBytes() const {
+    return (running_mean.size() + running_var.size() + feature_sums.capacity()) * sizeof(float);
+}
+
+// Имя типа слоя
+std::string BatchNorm::getName() const {
+    return "BatchNorm";
+}
+
+// Сохранение: гиперпараметры, gamma, beta и скользящие статистики
+void BatchNorm::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, batch_norm_version);
+    writeU64(file, num_features);
+    writeF32(file, epsilon);
+    writeF32(file, momentum);
+    for (const Tensor* tensor : {&gamma, &beta, &running_mean, &running_var}) {
+        writeTensor(file, *tensor);
     }
+}
 
-    // Вычисляем градиент по входным данным
-    Tensor grad_input(input_cache.shape());
-    for (size_t i = 0; i < grad_input.shape()[0]; ++i) {
-        for (size_t j = 0; j < num_features; ++j) {
-            grad_input({i, j}) = grad_output({i, j}) * gamma({j}) / std::sqrt(running_var({j}) + epsilon);
+// Загрузка записи слоя
+std::shared_ptr<Layer> BatchNorm::load(std::ifstream& file) {
+    checkLayerVersion("BatchNorm", readU32(file), batch_norm_version);
+    size_t features = readU64(file);
+    float epsilon = readF32(file);
+    float momentum = readF32(file);
+    std::shared_ptr<BatchNorm> layer = std::make_shared<BatchNorm>(features, epsilon, momentum);
+    for (Tensor* tensor : {&layer->gamma, &layer->beta, &layer->running_mean, &layer->running_var}) {
+        *tensor = readTensor(file);
+        if (tensor->size() != features) {
+            throw std::runtime_error("Model file is corrupted: BatchNorm parameters do not match its size.");
         }
     }
+    return layer;
+}
 
-    return grad_input;
+// Сохранить скользящие статистики
+void BatchNorm::saveTrainingState(std::ostream& out) const {
+    writeTensor(out, running_mean);
+    writeTensor(out, running_var);
+}
+
+// Восстановить скользящие статистики
+void BatchNorm::loadTrainingState(std::istream& in) {
+    for (Tensor* tensor : {&running_mean, &running_var}) {
+        Tensor value = readTensor(in);
+        if (value.size() != num_features) {
+            throw std::runtime_error("Checkpoint does not match the model: BatchNorm statistics size.");
+        }
+        tensor->copyFrom(value);
+    }
+}
+
+// Оценка работы
+LayerCost BatchNorm::cost(const std::vector<size_t>& input_shape) const {
+    double elements = 1.0;
+    for (size_t dim : input_shape) {
+        elements *= static_cast<double>(dim);
+    }
+    double features = static_cast<double>(num_features);
+    LayerCost cost;
+    // Среднее, дисперсия, нормировка, масштаб и сдвиг
+    cost.forward_flops = 7.0 * elements;
+    cost.forward_bytes = (3.0 * elements + 6.0 * features) * sizeof(float);
+    cost.backward_flops = 10.0 * elements;
+    cost.backward_bytes = (4.0 * elements + 6.0 * features) * sizeof(float);
+    return cost;
 }
@@ -13,7 +13,47 @@ public:
     Tensor forward(const Tensor& input) override;
 
     // Обратный проход
-    Tensor backward(const Tensor& grad_output, float learning_rate) override;
+    Tensor backward(const Tensor& grad_output) override;
+
+    // Вывод без кэшей
+    Tensor infer(const Tensor& input, LayerState* state) const override;
+    void inferInPlace(Tensor& data, LayerState* state) const override;
+
+    // Форма выхода совпадает с формой входа (batch_size, num_features).
+    // Проходы в буферы модели не выделяют память: кэш входа — вид на буфер входа.
+    std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) override;
+    std::vector<size_t> getInputShape() const override;
+    std::vector<size_t> getOutputShape() const override;
+    void forwardInto(Tensor& input, Tensor& output) override;
+    void backwardInto(Tensor& grad_output, Tensor& grad_input) override;
+    bool backwardNeedsInput() const override;
+
+    // Оценка работы: статистики батча, нормировка и масштаб
+    LayerCost cost(const std::vector<size_t>& input_shape) const override;
+
+    // Копия слоя с собственными параметрами и кэшами
+    std::shared_ptr<Layer> clone() const override;
+
+    // Кэши прямого прохода; повторный проход изменил бы скользящие средние
+    void releaseCache() override;
+    size_t cacheBytes() const override;
+    bool isRecomputable() const override;
+
+    // Скользящие статистики и суммы обратного прохода
+    size_t scratchBytes() const override;
+
+    // Параметры: gamma и beta
+    std::vector<Parameter> parameters() override;
+    size_t getNumParameters() const override;
+
+    // Сохранение и загрузка записи слоя (см. layers/serialization.h)
+    void save(std::ofstream& file) const override;
+    static std::shared_ptr<Layer> load(std::ifstream& file);
+    std::string getName() const override;
+
+    // Скользящие статистики для контрольных точек обучения
+    void saveTrainingState(std::ostream& out) const override;
+    void loadTrainingState(std::istream& in) override;
 
 private:
     size_t num_features; // Количество признаков (каналов)
@@ -22,12 +62,23 @@ private:
 
     Tensor gamma;        // Параметр масштабирования
     Tensor beta;         // Параметр смещения
+    Tensor grad_gamma;   // Накопленный градиент gamma
+    Tensor grad_beta;    // Накопленный градиент beta
 
     Tensor running_mean; // Скользящее среднее для среднего значения
     Tensor running_var;  // Скользящее среднее для дисперсии
 
     Tensor input_cache;  // Кэш входных данных для backward pass
-    Tensor normalized;   // Нормализованные данные
+    Tensor batch_mean;   // Среднее батча прямого прохода
+    Tensor inv_std;      // 1 / sqrt(var + epsilon) по статистикам батча
+    std::vector<float> feature_sums; // Суммы g и g * x_hat обратного прохода (2 * num_features)
+    std::vector<size_t> shape; // Форма входа и выхода, выведенная inferShape
+
+    // Статистики батча и нормировка со сдвигом в output
+    void normalize(const Tensor& input, Tensor& output);
+
+    // Градиенты параметров и градиент по входу в grad_input
+    void backpropagate(const Tensor& grad_output, Tensor& grad_input);
 };
 
 #endif // BATCH_NORM_H
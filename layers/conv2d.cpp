@@ -1,164 +1,380 @@
 #include "conv2d.h"
-#include <random>
-#include <iostream>
+#include "kernels/gemm.h"
+#include "initializers/he.h"
+#include "initializers/xavier.h"
+#include "serialization.h"
 #include <stdexcept>
 
+namespace {
+const uint32_t conv2d_version = 1; // Версия записи слоя
+}
+
 // Конструктор
-Conv2D::Conv2D(size_t input_channels, size_t output_channels, size_t kernel_size, size_t stride, size_t padding)
+Conv2D::Conv2D(size_t input_channels, size_t output_channels, size_t kernel_size, size_t stride, size_t padding,
+               Activation activation, std::shared_ptr<Initializer> initializer)
     : input_channels(input_channels), output_channels(output_channels), kernel_size(kernel_size), stride(stride), padding(padding),
-      kernels({output_channels, input_channels, kernel_size, kernel_size}), biases({output_channels}), input_cache({}) {
-    // Инициализируем ядра случайными значениями
-    kernels.randomize(-0.5f, 0.5f);
+      activation(activation), kernels({output_channels, input_channels, kernel_size, kernel_size}), biases({output_channels}),
+      grad_kernels(kernels.shape()), grad_biases({output_channels}), input_cache({}), output_cache({}) {
+    // Инициализируем ядра: на нейрон приходится input_channels * k * k входов
+    if (!initializer) {
+        initializer = activation == Activation::ReLU ? std::shared_ptr<Initializer>(std::make_shared<He>())
+                                                     : std::make_shared<Xavier>();
+    }
+    size_t window = kernel_size * kernel_size;
+    initializer->initialize(kernels, input_channels * window, output_channels * window);
 
     // Инициализируем смещения нулями
     biases.fill(0.0f);
 }
 
+// Конструктор загруженного слоя
+Conv2D::Conv2D(size_t stride, size_t padding, Activation activation, Tensor kernels, Tensor biases)
+    : input_channels(kernels.shape()[1]), output_channels(kernels.shape()[0]), kernel_size(kernels.shape()[2]),
+      stride(stride), padding(padding), activation(activation), kernels(std::move(kernels)), biases(std::move(biases)),
+      grad_kernels({0}), grad_biases({0}), input_cache({}), output_cache({}) {
+}
+
+// Форма выхода: ([batch,] output_channels, output_height, output_width)
+std::vector<size_t> Conv2D::outputShape(const std::vector<size_t>& shape) const {
+    bool batched = shape.size() == 4;
+    if ((shape.size() != 3 && !batched) || shape[shape.size() - 3] != input_channels) {
+        throw std::invalid_argument("Input tensor must have shape ([batch,] input_channels, height, width).");
+    }
+    size_t height = shape[shape.size() - 2];
+    size_t width = shape[shape.size() - 1];
+    if (height + 2 * padding < kernel_size || width + 2 * padding < kernel_size) {
+        throw std::invalid_argument("Input image is smaller than the convolution kernel.");
+    }
+    size_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    size_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    return batched ? std::vector<size_t>{shape[0], output_channels, output_height, output_width}
+                   : std::vector<size_t>{output_channels, output_height, output_width};
+}
+
+// Вывести и запомнить форму выхода
+std::vector<size_t> Conv2D::inferShape(const std::vector<size_t>& shape) {
+    output_shape = outputShape(shape);
+    input_shape = shape;
+    return output_shape;
+}
+
+// Свертка как GEMM: output = activation(kernels * im2col(input) + biases)
+void Conv2D::convolve(const Tensor& input, Tensor& output, std::vector<float>& cols) const {
+    const std::vector<size_t>& shape = input.shape();
+    size_t batch = shape.size() == 4 ? shape[0] : 1;
+    size_t height = shape[shape.size() - 2];
+    size_t width = shape[shape.size() - 1];
+    size_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    size_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    size_t patch = input_channels * kernel_size * kernel_size;
+    size_t pixels = output_height * output_width;
+    if (output.size() != batch * output_channels * pixels) {
+        throw std::invalid_argument("Output buffer must match the layer output shape.");
+    }
+    cols.resize(patch * pixels);
+
+    GemmEpilogue epilogue;
+    epilogue.row_bias = biases.data();
+    epilogue.activation = activation;
+    for (size_t n = 0; n < batch; ++n) {
+        im2col(input.data() + n * input_channels * height * width, height, width,
+               output_height, output_width, cols.data());
+        gemm(false, false, output_channels, pixels, patch,
+             kernels.data(), patch, cols.data(), pixels,
+             output.data() + n * output_channels * pixels, pixels, false, epilogue);
+    }
+}
+
 // Прямой проход
 Tensor Conv2D::forward(const Tensor& input) {
     // Проверка формы входных данных
-    if (input.shape().size() != 3 || input.shape()[0] != input_channels) {
-        throw std::invalid_argument("Input tensor must have shape (input_channels, height, width).");
+    const std::vector<size_t>& shape = input.shape();
+    bool batched = shape.size() == 4;
+    if ((shape.size() != 3 && !batched) || shape[shape.size() - 3] != input_channels) {
+        throw std::invalid_argument("Input tensor must have shape ([batch,] input_channels, height, width).");
     }
 
     // Кэшируем входные данные для использования в backward pass
     input_cache = input;
 
-    // Применяем padding к входным данным
-    Tensor padded_input = pad(input);
+    size_t batch = batched ? shape[0] : 1;
+    size_t height = shape[shape.size() - 2];
+    size_t width = shape[shape.size() - 1];
 
     // Вычисляем размеры выходного тензора
-    size_t output_height = (padded_input.shape()[1] - kernel_size) / stride + 1;
-    size_t output_width = (padded_input.shape()[2] - kernel_size) / stride + 1;
-    Tensor output({output_channels, output_height, output_width});
-
-    // Применяем свертку
-    for (size_t oc = 0; oc < output_channels; ++oc) { // По каждому выходному каналу
-        for (size_t oh = 0; oh < output_height; ++oh) { // По высоте выходного тензора
-            for (size_t ow = 0; ow < output_width; ++ow) { // По ширине выходного тензора
-                float sum = 0.0f;
-
-                // Применяем ядро свертки
-                for (size_t ic = 0; ic < input_channels; ++ic) { // По каждому входному каналу
-                    for (size_t kh = 0; kh < kernel_size; ++kh) { // По высоте ядра
-                        for (size_t kw = 0; kw < kernel_size; ++kw) { // По ширине ядра
-                            size_t ih = oh * stride + kh;
-                            size_t iw = ow * stride + kw;
-                            sum += padded_input({ic, ih, iw}) * kernels({oc, ic, kh, kw});
-                        }
-                    }
-                }
+    size_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    size_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    Tensor output(batched ? std::vector<size_t>{batch, output_channels, output_height, output_width}
+                          : std::vector<size_t>{output_channels, output_height, output_width});
+    convolve(input, output, columns);
 
-                // Добавляем смещение
-                output({oc, oh, ow}) = sum + biases({oc});
-            }
-        }
+    // Для производной активации достаточно ее выхода
+    if (activation != Activation::None) {
+        output_cache = output;
     }
 
     return output;
 }
 
+// Состояние потока вывода
+std::unique_ptr<LayerState> Conv2D::createState() const {
+    return std::unique_ptr<LayerState>(new InferenceState());
+}
+
+// Вывод: вход и выход не кэшируются, im2col пишется в буфер потока
+Tensor Conv2D::infer(const Tensor& input, LayerState* state) const {
+    std::vector<float> local;
+    std::vector<float>& cols = state ? static_cast<InferenceState*>(state)->columns : local;
+    Tensor output(outputShape(input.shape()));
+    convolve(input, output, cols);
+    return output;
+}
+
+// Прямой проход в буфер модели: вход и выход не копируются в кэши
+void Conv2D::forwardInto(Tensor& input, Tensor& output) {
+    const std::vector<size_t>& shape = input.shape();
+    if ((shape.size() != 3 && shape.size() != 4) || shape[shape.size() - 3] != input_channels) {
+        throw std::invalid_argument("Input tensor must have shape ([batch,] input_channels, height, width).");
+    }
+    input_cache.alias(input);
+    convolve(input, output, columns);
+    if (activation != Activation::None) {
+        output_cache.alias(output);
+    }
+}
+
 // Обратный проход
-Tensor Conv2D::backward(const Tensor& grad_output, float learning_rate) {
+Tensor Conv2D::backward(const Tensor& grad_output) {
+    Tensor grad = grad_output;
+    Tensor grad_input(input_cache.shape());
+    backwardInto(grad, grad_input);
+    return grad_input;
+}
+
+// Обратный проход в буфер модели; grad становится градиентом линейного выхода свертки
+void Conv2D::backwardInto(Tensor& grad, Tensor& grad_input) {
+    allocateGradients();
+    const std::vector<size_t>& shape = input_cache.shape();
+    bool batched = shape.size() == 4;
+    size_t batch = batched ? shape[0] : 1;
+    size_t height = shape[shape.size() - 2];
+    size_t width = shape[shape.size() - 1];
+    size_t output_height = (height + 2 * padding - kernel_size) / stride + 1;
+    size_t output_width = (width + 2 * padding - kernel_size) / stride + 1;
+    size_t patch = input_channels * kernel_size * kernel_size;
+    size_t pixels = output_height * output_width;
+
     // Проверка формы градиента
-    if (grad_output.shape().size() != 3 || grad_output.shape()[0] != output_channels) {
-        throw std::invalid_argument("Gradient tensor must have shape (output_channels, height, width).");
+    if (grad.size() != batch * output_channels * pixels) {
+        throw std::invalid_argument("Gradient tensor must have shape ([batch,] output_channels, height, width).");
     }
 
-    // Инициализируем градиенты для ядер и смещений
-    Tensor grad_kernels(kernels.shape());
-    Tensor grad_biases(biases.shape());
+    // Градиент по линейному выходу свертки
+    activationBackward(activation, output_cache.data(), grad.data(), grad.size());
 
-    // Вычисляем градиенты для смещений
-    for (size_t oc = 0; oc < output_channels; ++oc) {
-        float sum = 0.0f;
-        for (size_t oh = 0; oh < grad_output.shape()[1]; ++oh) {
-            for (size_t ow = 0; ow < grad_output.shape()[2]; ++ow) {
-                sum += grad_output({oc, oh, ow});
-            }
-        }
-        grad_biases({oc}) = sum;
-    }
-
-    // Вычисляем градиенты для ядер
-    Tensor padded_input = pad(input_cache);
-    for (size_t oc = 0; oc < output_channels; ++oc) {
-        for (size_t ic = 0; ic < input_channels; ++ic) {
-            for (size_t kh = 0; kh < kernel_size; ++kh) {
-                for (size_t kw = 0; kw < kernel_size; ++kw) {
-                    float sum = 0.0f;
-                    for (size_t oh = 0; oh < grad_output.shape()[1]; ++oh) {
-                        for (size_t ow = 0; ow < grad_output.shape()[2]; ++ow) {
-                            size_t ih = oh * stride + kh;
-                            size_t iw = ow * stride + kw;
-                            sum += padded_input({ic, ih, iw}) * grad_output({oc, oh, ow});
-                        }
-                    }
-                    grad_kernels({oc, ic, kh, kw}) = sum;
-                }
+    // col2im накапливает сумму, а буфер модели может хранить старые значения
+    grad_input.fill(0.0f);
+    grad_columns.resize(patch * pixels);
+    columns.resize(patch * pixels);
+
+    for (size_t n = 0; n < batch; ++n) {
+        const float* g = grad.data() + n * output_channels * pixels;
+
+        // Градиенты для смещений
+        for (size_t oc = 0; oc < output_channels; ++oc) {
+            float sum = 0.0f;
+            for (size_t p = 0; p < pixels; ++p) {
+                sum += g[oc * pixels + p];
             }
+            grad_biases[oc] += sum;
         }
+
+        // Градиенты для ядер: grad_kernels += grad * im2col(input)^T
+        im2col(input_cache.data() + n * input_channels * height * width, height, width,
+               output_height, output_width, columns.data());
+        gemm(false, true, output_channels, patch, pixels,
+             g, pixels, columns.data(), pixels,
+             grad_kernels.data(), patch, true);
+
+        // Градиент по входным данным: col2im(kernels^T * grad)
+        gemm(true, false, patch, pixels, output_channels,
+             kernels.data(), patch, g, pixels,
+             grad_columns.data(), pixels);
+        col2im(grad_columns.data(), height, width, output_height, output_width,
+               grad_input.data() + n * input_channels * height * width);
+    }
+}
+
+// Обратному проходу нужен вход
+bool Conv2D::backwardNeedsInput() const {
+    return true;
+}
+
+// И выход, если активация встроена
+bool Conv2D::backwardNeedsOutput() const {
+    return activation != Activation::None;
+}
+
+// Форма входа
+std::vector<size_t> Conv2D::getInputShape() const {
+    return input_shape;
+}
+
+// Форма выхода
+std::vector<size_t> Conv2D::getOutputShape() const {
+    return output_shape;
+}
+
+// Параметры слоя
+std::vector<Parameter> Conv2D::parameters() {
+    allocateGradients();
+    return {{"kernels", &kernels, &grad_kernels}, {"biases", &biases, &grad_biases}};
+}
+
+// Количество параметров: ядра и смещения
+size_t Conv2D::getNumParameters() const {
+    return kernels.size() + biases.size();
+}
+
+// Встроить активацию в эпилог (возможно только поверх линейного выхода)
+bool Conv2D::fuseActivation(Activation new_activation) {
+    if (activation != Activation::None || new_activation == Activation::None) {
+        return false;
     }
+    activation = new_activation;
+    return true;
+}
 
-    // Обновляем ядра и смещения
-    for (size_t oc = 0; oc < output_channels; ++oc) {
-        for (size_t ic = 0; ic < input_channels; ++ic) {
-            for (size_t kh = 0; kh < kernel_size; ++kh) {
-                for (size_t kw = 0; kw < kernel_size; ++kw) {
-                    kernels({oc, ic, kh, kw}) -= learning_rate * grad_kernels({oc, ic, kh, kw});
+// Вспомогательная функция: развертка окон изображения в столбцы (padding учитывается нулями)
+void Conv2D::im2col(const float* image, size_t height, size_t width, size_t out_h, size_t out_w, float* cols) const {
+    for (size_t c = 0; c < input_channels; ++c) {
+        for (size_t kh = 0; kh < kernel_size; ++kh) {
+            for (size_t kw = 0; kw < kernel_size; ++kw) {
+                float* row = cols + ((c * kernel_size + kh) * kernel_size + kw) * out_h * out_w;
+                for (size_t oh = 0; oh < out_h; ++oh) {
+                    // Индексы в исходном изображении с учетом padding
+                    long ih = static_cast<long>(oh * stride + kh) - static_cast<long>(padding);
+                    float* dst = row + oh * out_w;
+                    if (ih < 0 || ih >= static_cast<long>(height)) {
+                        for (size_t ow = 0; ow < out_w; ++ow) dst[ow] = 0.0f;
+                        continue;
+                    }
+                    const float* src = image + (c * height + ih) * width;
+                    for (size_t ow = 0; ow < out_w; ++ow) {
+                        long iw = static_cast<long>(ow * stride + kw) - static_cast<long>(padding);
+                        dst[ow] = (iw >= 0 && iw < static_cast<long>(width)) ? src[iw] : 0.0f;
+                    }
                 }
             }
         }
-        biases({oc}) -= learning_rate * grad_biases({oc});
     }
+}
 
-    // Вычисляем градиент по входным данным (обратная свертка)
-    Tensor grad_input(input_cache.shape());
-    grad_input.fill(0.0f); // Инициализируем нулями
-
-    // Применяем обратную свертку
-    for (size_t oc = 0; oc < output_channels; ++oc) {
-        for (size_t oh = 0; oh < grad_output.shape()[1]; ++oh) {
-            for (size_t ow = 0; ow < grad_output.shape()[2]; ++ow) {
-                for (size_t ic = 0; ic < input_channels; ++ic) {
-                    for (size_t kh = 0; kh < kernel_size; ++kh) {
-                        for (size_t kw = 0; kw < kernel_size; ++kw) {
-                            size_t ih = oh * stride + kh;
-                            size_t iw = ow * stride + kw;
-
-                            // Проверяем, что индексы находятся в пределах границ
-                            if (ih < grad_input.shape()[1] && iw < grad_input.shape()[2]) {
-                                grad_input({ic, ih, iw}) += kernels({oc, ic, kh, kw}) * grad_output({oc, oh, ow});
-                            }
+// Вспомогательная функция: сложение столбцов обратно в изображение (обратная к im2col)
+void Conv2D::col2im(const float* cols, size_t height, size_t width, size_t out_h, size_t out_w, float* image) const {
+    for (size_t c = 0; c < input_channels; ++c) {
+        for (size_t kh = 0; kh < kernel_size; ++kh) {
+            for (size_t kw = 0; kw < kernel_size; ++kw) {
+                const float* row = cols + ((c * kernel_size + kh) * kernel_size + kw) * out_h * out_w;
+                for (size_t oh = 0; oh < out_h; ++oh) {
+                    long ih = static_cast<long>(oh * stride + kh) - static_cast<long>(padding);
+                    if (ih < 0 || ih >= static_cast<long>(height)) {
+                        continue;
+                    }
+                    float* dst = image + (c * height + ih) * width;
+                    for (size_t ow = 0; ow < out_w; ++ow) {
+                        long iw = static_cast<long>(ow * stride + kw) - static_cast<long>(padding);
+                        if (iw >= 0 && iw < static_cast<long>(width)) {
+                            dst[iw] += row[oh * out_w + ow];
                         }
                     }
                 }
             }
         }
     }
+}
 
-    return grad_input;
+// Копия слоя
+std::shared_ptr<Layer> Conv2D::clone() const {
+    return std::make_shared<Conv2D>(*this);
+}
+
+// Освободить кэши прямого прохода
+void Conv2D::releaseCache() {
+    input_cache = Tensor({0});
+    output_cache = Tensor({0});
+}
+
+// Байты кэшей прямого прохода
+size_t Conv2D::cacheBytes() const {
+    return (input_cache.size() + output_cache.size()) * sizeof(float);
 }
 
+// Байты рабочих буферов (векторы не сжимаются, поэтому считается их емкость)
+size_t Conv2D::scratchBytes() const {
+    return (columns.capacity() + grad_columns.capacity()) * sizeof(float);
+}
 
-// Вспомогательная функция: добавление padding к входным данным
-Tensor Conv2D::pad(const Tensor& input) const {
-    if (padding == 0) {
-        return input;
+// Выделить градиенты, если слой загружен без них
+void Conv2D::allocateGradients() {
+    if (grad_kernels.size() != kernels.size()) {
+        grad_kernels = Tensor(kernels.shape());
+        grad_biases = Tensor(biases.shape());
     }
+}
 
-    // Создаем тензор с padding
-    Tensor padded_input({input.shape()[0], input.shape()[1] + 2 * padding, input.shape()[2] + 2 * padding});
-    padded_input.fill(0.0f);
+// Имя типа слоя
+std::string Conv2D::getName() const {
+    return "Conv2D";
+}
 
-    // Копируем данные в центр тензора
-    for (size_t c = 0; c < input.shape()[0]; ++c) {
-        for (size_t h = 0; h < input.shape()[1]; ++h) {
-            for (size_t w = 0; w < input.shape()[2]; ++w) {
-                padded_input({c, h + padding, w + padding}) = input({c, h, w});
-            }
-        }
+// Сохранение: шаг, отступ, активация, ядра и смещения (размеры следуют из формы ядер)
+void Conv2D::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, conv2d_version);
+    writeU64(file, stride);
+    writeU64(file, padding);
+    writeActivation(file, activation);
+    writeTensor(file, kernels);
+    writeTensor(file, biases);
+}
+
+// Загрузка записи слоя
+std::shared_ptr<Layer> Conv2D::load(std::ifstream& file) {
+    checkLayerVersion("Conv2D", readU32(file), conv2d_version);
+    size_t stride = readU64(file);
+    size_t padding = readU64(file);
+    Activation activation = readActivation(file);
+    Tensor kernels = readTensor(file);
+    Tensor biases = readTensor(file);
+    const std::vector<size_t>& shape = kernels.shape();
+    if (stride == 0 || shape.size() != 4 || shape[2] != shape[3] || biases.size() != shape[0]) {
+        throw std::runtime_error("Model file is corrupted: Conv2D parameters are inconsistent.");
     }
+    return std::shared_ptr<Layer>(new Conv2D(stride, padding, activation, std::move(kernels), std::move(biases)));
+}
 
-    return padded_input;
+// Оценка работы
+LayerCost Conv2D::cost(const std::vector<size_t>& input_shape) const {
+    std::vector<size_t> output = outputShape(input_shape);
+    double batch = input_shape.size() == 4 ? static_cast<double>(input_shape[0]) : 1.0;
+    double input_elements = 1.0;
+    for (size_t dim : input_shape) {
+        input_elements *= static_cast<double>(dim);
+    }
+    double positions = static_cast<double>(output[output.size() - 2] * output[output.size() - 1]);
+    double patch = static_cast<double>(input_channels * kernel_size * kernel_size);
+    double filters = static_cast<double>(output_channels);
+    double output_elements = batch * filters * positions;
+    double columns = batch * patch * positions; // Элементы буфера im2col
+    double epilogue = activation == Activation::None ? 1.0 : 2.0;
+    LayerCost cost;
+    cost.forward_flops = 2.0 * output_elements * patch + epilogue * output_elements;
+    cost.forward_bytes = (input_elements + 2.0 * columns + filters * patch + filters + output_elements) * sizeof(float);
+    // Градиент ядер по заново построенным столбцам, градиент столбцов и col2im
+    cost.backward_flops = 4.0 * output_elements * patch + epilogue * output_elements;
+    cost.backward_bytes =
+        (output_elements + 2.0 * input_elements + 4.0 * columns + 3.0 * filters * patch + 2.0 * filters) *
+        sizeof(float);
+    return cost;
 }
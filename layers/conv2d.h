@@ -3,26 +3,87 @@
 
 #include "tensor.h"
 #include "layer.h"
+#include "initializers/initializer.h"
 
 class Conv2D : public Layer {
 public:
-    Conv2D(size_t input_channels, size_t output_channels, size_t kernel_size, size_t stride = 1, size_t padding = 0);
+    // Без initializer ядра заполняются He для ReLU и Xavier для остальных активаций
+    Conv2D(size_t input_channels, size_t output_channels, size_t kernel_size, size_t stride = 1, size_t padding = 0,
+           Activation activation = Activation::None, std::shared_ptr<Initializer> initializer = nullptr);
 
-    // Прямой проход
+    // Прямой проход: вход (channels, height, width) или (batch, channels, height, width)
     Tensor forward(const Tensor& input) override;
 
     // Обратный проход
-    Tensor backward(const Tensor& grad_output, float learning_rate) override;
+    Tensor backward(const Tensor& grad_output) override;
+
+    // Вывод без кэшей; рабочий буфер im2col хранится в состоянии потока
+    std::unique_ptr<LayerState> createState() const override;
+    Tensor infer(const Tensor& input, LayerState* state) const override;
+
+    // Форма выхода и проходы в буферы модели (кэши — виды на вход и выход)
+    std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) override;
+    void forwardInto(Tensor& input, Tensor& output) override;
+    void backwardInto(Tensor& grad_output, Tensor& grad_input) override;
+    bool backwardNeedsInput() const override;
+    bool backwardNeedsOutput() const override;
+    std::vector<size_t> getInputShape() const override;
+    std::vector<size_t> getOutputShape() const override;
+
+    // Оценка работы: GEMM по столбцам im2col и трафик рабочего буфера столбцов
+    LayerCost cost(const std::vector<size_t>& input_shape) const override;
+
+    // Копия слоя с собственными параметрами и кэшами
+    std::shared_ptr<Layer> clone() const override;
+
+    // Кэши прямого прохода
+    void releaseCache() override;
+    size_t cacheBytes() const override;
+
+    // Рабочие буферы im2col и градиента столбцов
+    size_t scratchBytes() const override;
+
+    // Параметры: kernels и biases
+    std::vector<Parameter> parameters() override;
+    size_t getNumParameters() const override;
+
+    // Встроить активацию в эпилог
+    bool fuseActivation(Activation activation) override;
+
+    // Сохранение и загрузка записи слоя (см. layers/serialization.h)
+    void save(std::ofstream& file) const override;
+    static std::shared_ptr<Layer> load(std::ifstream& file);
+    std::string getName() const override;
 
 private:
+    // Загруженный слой: параметры готовы (могут быть видами на отображенный файл),
+    // градиенты выделяются при первом обратном проходе
+    Conv2D(size_t stride, size_t padding, Activation activation, Tensor kernels, Tensor biases);
+
     size_t input_channels, output_channels, kernel_size, stride, padding;
+    Activation activation; // Активация, выполняемая в эпилоге
     Tensor kernels; // Ядра свертки (фильтры)
     Tensor biases;  // Смещения
+    Tensor grad_kernels; // Накопленный градиент ядер
+    Tensor grad_biases;  // Накопленный градиент смещений
     Tensor input_cache; // Кэш входных данных для использования в backward pass
+    Tensor output_cache; // Кэш выхода активации (только если activation != None)
+    std::vector<float> columns; // Рабочий буфер im2col
+    std::vector<float> grad_columns; // Рабочий буфер градиента столбцов
+    std::vector<size_t> input_shape;  // Форма входа, выведенная inferShape
+    std::vector<size_t> output_shape; // Форма выхода, выведенная inferShape
+
+    // Состояние потока вывода
+    struct InferenceState : LayerState {
+        std::vector<float> columns; // Рабочий буфер im2col
+    };
 
     // Вспомогательные функции
-    Tensor pad(const Tensor& input) const;
-    Tensor convolve(const Tensor& input, const Tensor& kernel) const;
+    void allocateGradients();
+    std::vector<size_t> outputShape(const std::vector<size_t>& input_shape) const;
+    void convolve(const Tensor& input, Tensor& output, std::vector<float>& cols) const;
+    void im2col(const float* image, size_t height, size_t width, size_t out_h, size_t out_w, float* cols) const;
+    void col2im(const float* cols, size_t height, size_t width, size_t out_h, size_t out_w, float* image) const;
 };
 
 #endif // CONV2D_H
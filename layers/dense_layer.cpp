@@ -1,76 +1,194 @@
 #include "dense_layer.h"
-#include <random>
-#include <iostream>
+#include "kernels/gemm.h"
+#include "initializers/he.h"
+#include "initializers/xavier.h"
+#include "serialization.h"
+#include <stdexcept>
+
+namespace {
+const uint32_t dense_version = 1; // Версия записи слоя
+}
 
 // Конструктор
-DenseLayer::DenseLayer(size_t input_size, size_t output_size)
-    : input_size(input_size), output_size(output_size),
-      weights({input_size, output_size}), biases({output_size}), input_cache({input_size}) {
-    // Инициализируем веса случайными значениями
-    weights.randomize(-0.5f, 0.5f);
+DenseLayer::DenseLayer(size_t input_size, size_t output_size, Activation activation,
+                       std::shared_ptr<Initializer> initializer)
+    : input_size(input_size), output_size(output_size), activation(activation),
+      weights({input_size, output_size}), biases({output_size}),
+      grad_weights({input_size, output_size}), grad_biases({output_size}), input_cache({input_size}),
+      output_cache({}), input_shape{input_size}, output_shape{output_size} {
+    // Инициализируем веса
+    if (!initializer) {
+        initializer = activation == Activation::ReLU ? std::shared_ptr<Initializer>(std::make_shared<He>())
+                                                     : std::make_shared<Xavier>();
+    }
+    initializer->initialize(weights, input_size, output_size);
     // Инициализируем смещения нулями
     biases.fill(0.0f);
 }
 
+// Конструктор загруженного слоя
+DenseLayer::DenseLayer(Activation activation, Tensor weights, Tensor biases)
+    : input_size(weights.shape()[0]), output_size(weights.shape().back()), activation(activation),
+      weights(std::move(weights)), biases(std::move(biases)), grad_weights({0}), grad_biases({0}),
+      input_cache({0}), output_cache({}), input_shape{input_size}, output_shape{output_size} {
+}
+
+// Размер батча: одиночный вектор или батч строк (лишние оси сплющиваются)
+size_t DenseLayer::batchSize(const std::vector<size_t>& shape) const {
+    size_t size = 1;
+    for (size_t dim : shape) {
+        size *= dim;
+    }
+    if (size == input_size) {
+        return 1;
+    }
+    if (shape.size() >= 2 && shape[0] * input_size == size) {
+        return shape[0];
+    }
+    throw std::invalid_argument("Input tensor must have shape (input_size) or (batch_size, input_size).");
+}
+
+// Форма выхода (как в forward: один пример дает вектор, батч — матрицу)
+std::vector<size_t> DenseLayer::inferShape(const std::vector<size_t>& shape) {
+    size_t batch = batchSize(shape);
+    input_shape = shape;
+    output_shape = batch == 1 ? std::vector<size_t>{output_size} : std::vector<size_t>{batch, output_size};
+    return output_shape;
+}
+
+// output = activation(input * weights + biases) за один проход по тайлам
+void DenseLayer::compute(const Tensor& input, Tensor& output, size_t batch) const {
+    GemmEpilogue epilogue;
+    epilogue.col_bias = biases.data();
+    epilogue.activation = activation;
+    gemm(false, false, batch, output_size, input_size,
+         input.data(), input_size, weights.data(), output_size,
+         output.data(), output_size, false, epilogue);
+}
+
 // Прямой проход
 Tensor DenseLayer::forward(const Tensor& input) {
+    size_t batch = batchSize(input.shape());
+
     // Кэшируем входные данные для использования в backward pass
     input_cache = input;
 
-    // Создаем тензор для выходных данных
-    Tensor output({output_size});
+    // Одиночный вектор дает вектор, батч — матрицу (batch_size, output_size)
+    Tensor output(input.size() == input_size ? std::vector<size_t>{output_size}
+                                             : std::vector<size_t>{batch, output_size});
+    compute(input, output, batch);
 
-    // Вычисляем выходные данные: output = input * weights + biases
-    for (size_t i = 0; i < output_size; ++i) {
-        float sum = 0.0f;
-        for (size_t j = 0; j < input_size; ++j) {
-            sum += input({j}) * weights({j, i});
-        }
-        output({i}) = sum + biases({i});
+    // Для производной активации достаточно ее выхода
+    if (activation != Activation::None) {
+        output_cache = output;
     }
 
     return output;
 }
 
-// Обратный проход
-Tensor DenseLayer::backward(const Tensor& grad_output, float learning_rate) {
-    // Вычисляем градиенты для весов и смещений
-    Tensor grad_input({input_size});
-    Tensor grad_weights(weights.shape());
-    Tensor grad_biases(biases.shape());
-
-    // Градиент по входным данным: grad_input = grad_output * weights^T
-    for (size_t i = 0; i < input_size; ++i) {
-        float sum = 0.0f;
-        for (size_t j = 0; j < output_size; ++j) {
-            sum += grad_output({j}) * weights({i, j});
-        }
-        grad_input({i}) = sum;
-    }
+// Вывод: вход и выход не кэшируются
+Tensor DenseLayer::infer(const Tensor& input, LayerState* state) const {
+    size_t batch = batchSize(input.shape());
+    Tensor output(input.size() == input_size ? std::vector<size_t>{output_size}
+                                             : std::vector<size_t>{batch, output_size});
+    compute(input, output, batch);
+    return output;
+}
 
-    // Градиент по весам: grad_weights = input^T * grad_output
-    for (size_t i = 0; i < input_size; ++i) {
-        for (size_t j = 0; j < output_size; ++j) {
-            grad_weights({i, j}) = input_cache({i}) * grad_output({j});
-        }
+// Прямой проход в буфер модели: вход и выход не копируются в кэши
+void DenseLayer::forwardInto(Tensor& input, Tensor& output) {
+    size_t batch = batchSize(input.shape());
+    if (output.size() != batch * output_size) {
+        throw std::invalid_argument("Output buffer must match the layer output shape.");
+    }
+    input_cache.alias(input);
+    compute(input, output, batch);
+    if (activation != Activation::None) {
+        output_cache.alias(output);
     }
+}
+
+// Обратный проход
+Tensor DenseLayer::backward(const Tensor& grad_output) {
+    Tensor grad = grad_output;
+    Tensor grad_input(input_cache.shape());
+    backwardInto(grad, grad_input);
+    return grad_input;
+}
 
-    // Градиент по смещениям: grad_biases = grad_output
-    for (size_t i = 0; i < output_size; ++i) {
-        grad_biases({i}) = grad_output({i});
+// Обратный проход в буфер модели; grad_output становится градиентом линейной части
+void DenseLayer::backwardInto(Tensor& grad, Tensor& grad_input) {
+    allocateGradients();
+    size_t batch = batchSize(input_cache.shape());
+    if (grad.size() != batch * output_size) {
+        throw std::invalid_argument("Gradient tensor must match the layer output shape.");
     }
 
-    // Обновляем веса и смещения
-    for (size_t i = 0; i < input_size; ++i) {
-        for (size_t j = 0; j < output_size; ++j) {
-            weights({i, j}) -= learning_rate * grad_weights({i, j});
+    // Градиент по выходу линейной части
+    activationBackward(activation, output_cache.data(), grad.data(), grad.size());
+
+    // Градиент по входным данным: grad_input = grad * weights^T
+    gemm(false, true, batch, input_size, output_size,
+         grad.data(), output_size, weights.data(), output_size,
+         grad_input.data(), input_size);
+
+    // Градиент по весам: grad_weights += input^T * grad
+    gemm(true, false, input_size, output_size, batch,
+         input_cache.data(), input_size, grad.data(), output_size,
+         grad_weights.data(), output_size, true);
+
+    // Градиент по смещениям: сумма grad по батчу
+    for (size_t b = 0; b < batch; ++b) {
+        const float* row = grad.data() + b * output_size;
+        for (size_t i = 0; i < output_size; ++i) {
+            grad_biases[i] += row[i];
         }
     }
-    for (size_t i = 0; i < output_size; ++i) {
-        biases({i}) -= learning_rate * grad_biases({i});
+}
+
+// Обратному проходу нужен вход
+bool DenseLayer::backwardNeedsInput() const {
+    return true;
+}
+
+// И выход, если активация встроена
+bool DenseLayer::backwardNeedsOutput() const {
+    return activation != Activation::None;
+}
+
+// Форма входа
+std::vector<size_t> DenseLayer::getInputShape() const {
+    return input_shape;
+}
+
+// Форма выхода
+std::vector<size_t> DenseLayer::getOutputShape() const {
+    return output_shape;
+}
+
+// Параметры слоя
+std::vector<Parameter> DenseLayer::parameters() {
+    allocateGradients();
+    return {{"weights", &weights, &grad_weights}, {"biases", &biases, &grad_biases}};
+}
+
+// Количество параметров: веса и смещения
+size_t DenseLayer::getNumParameters() const {
+    return weights.size() + biases.size();
+}
+
+// Встроить активацию в эпилог (возможно только поверх линейного выхода)
+bool DenseLayer::fuseActivation(Activation new_activation) {
+    if (activation != Activation::None || new_activation == Activation::None) {
+        return false;
     }
+    activation = new_activation;
+    return true;
+}
 
-    return grad_input;
+// Получить встроенную активацию
+Activation DenseLayer::getActivation() const {
+    return activation;
 }
 
 // Получить веса (для отладки)
@@ -82,3 +200,77 @@ Tensor DenseLayer::getWeights() const {
 Tensor DenseLayer::getBiases() const {
     return biases;
 }
+
+// Копия слоя
+std::shared_ptr<Layer> DenseLayer::clone() const {
+    return std::make_shared<DenseLayer>(*this);
+}
+
+// Освободить кэши прямого прохода
+void DenseLayer::releaseCache() {
+    input_cache = Tensor({0});
+    output_cache = Tensor({0});
+}
+
+// Байты кэшей прямого прохода
+size_t DenseLayer::cacheBytes() const {
+    return (input_cache.size() + output_cache.size()) * sizeof(float);
+}
+
+// Выделить градиенты, если слой загружен без них
+void DenseLayer::allocateGradients() {
+    if (grad_weights.size() != weights.size()) {
+        grad_weights = Tensor(weights.shape());
+        grad_biases = Tensor(biases.shape());
+    }
+}
+
+// Имя типа слоя
+std::string DenseLayer::getName() const {
+    return "Dense";
+}
+
+// Сохранение: размеры, активация, веса и смещения
+void DenseLayer::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, dense_version);
+    writeU64(file, input_size);
+    writeU64(file, output_size);
+    writeActivation(file, activation);
+    writeTensor(file, weights);
+    writeTensor(file, biases);
+}
+
+// Загрузка записи слоя (имя типа уже прочитано Layer::load)
+std::shared_ptr<Layer> DenseLayer::load(std::ifstream& file) {
+    checkLayerVersion("Dense", readU32(file), dense_version);
+    size_t input = readU64(file);
+    size_t output = readU64(file);
+    Activation activation = readActivation(file);
+    Tensor weights = readTensor(file);
+    Tensor biases = readTensor(file);
+    if (weights.shape() != std::vector<size_t>{input, output} || biases.size() != output) {
+        throw std::runtime_error("Model file is corrupted: Dense parameters do not match its sizes.");
+    }
+    return std::shared_ptr<Layer>(new DenseLayer(activation, std::move(weights), std::move(biases)));
+}
+
+// Оценка работы
+LayerCost DenseLayer::cost(const std::vector<size_t>& input_shape) const {
+    // Вход любой формы разворачивается в строки по input_size признаков
+    double elements = 1.0;
+    for (size_t dim : input_shape) {
+        elements *= static_cast<double>(dim);
+    }
+    double in = static_cast<double>(input_size);
+    double rows = elements / in;
+    double out = static_cast<double>(output_size);
+    double epilogue = activation == Activation::None ? 1.0 : 2.0; // Смещение и активация
+    LayerCost cost;
+    cost.forward_flops = 2.0 * rows * in * out + epilogue * rows * out;
+    cost.forward_bytes = (rows * in + in * out + out + rows * out) * sizeof(float);
+    // dX = dY * W^T, dW += X^T * dY, db += sum(dY)
+    cost.backward_flops = 4.0 * rows * in * out + epilogue * rows * out;
+    cost.backward_bytes = (rows * out + 2.0 * rows * in + 3.0 * in * out + 2.0 * out) * sizeof(float);
+    return cost;
+}
@@ -3,29 +3,88 @@
 
 #include "layer.h"
 #include "tensor.h"
+#include "initializers/initializer.h"
 
 // Полносвязный слой
 class DenseLayer : public Layer {
 public:
-    // Конструктор
-    DenseLayer(size_t input_size, size_t output_size);
+    // Конструктор (activation выполняется в эпилоге матричного умножения).
+    // Без initializer веса заполняются He для ReLU и Xavier для остальных активаций.
+    DenseLayer(size_t input_size, size_t output_size, Activation activation = Activation::None,
+               std::shared_ptr<Initializer> initializer = nullptr);
 
-    // Прямой проход
+    // Прямой проход: вход (input_size) или (batch_size, input_size)
     Tensor forward(const Tensor& input) override;
 
     // Обратный проход
-    Tensor backward(const Tensor& grad_output, float learning_rate) override;
+    Tensor backward(const Tensor& grad_output) override;
+
+    // Вывод без кэшей
+    Tensor infer(const Tensor& input, LayerState* state) const override;
+
+    // Форма выхода и проходы в буферы модели (кэши — виды на вход и выход)
+    std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) override;
+    void forwardInto(Tensor& input, Tensor& output) override;
+    void backwardInto(Tensor& grad_output, Tensor& grad_input) override;
+    bool backwardNeedsInput() const override;
+    bool backwardNeedsOutput() const override;
+    std::vector<size_t> getInputShape() const override;
+    std::vector<size_t> getOutputShape() const override;
+
+    // Оценка работы: GEMM (batch x input_size x output_size) и чтение весов
+    LayerCost cost(const std::vector<size_t>& input_shape) const override;
+
+    // Копия слоя с собственными параметрами и кэшами
+    std::shared_ptr<Layer> clone() const override;
+
+    // Кэши прямого прохода
+    void releaseCache() override;
+    size_t cacheBytes() const override;
+
+    // Параметры: weights и biases
+    std::vector<Parameter> parameters() override;
+    size_t getNumParameters() const override;
+
+    // Встроить активацию в эпилог
+    bool fuseActivation(Activation activation) override;
+
+    // Получить встроенную активацию
+    Activation getActivation() const;
 
     // Получить веса и смещения (для отладки)
     Tensor getWeights() const;
     Tensor getBiases() const;
 
+    // Сохранение и загрузка записи слоя (см. layers/serialization.h)
+    void save(std::ofstream& file) const override;
+    static std::shared_ptr<Layer> load(std::ifstream& file);
+    std::string getName() const override;
+
 private:
-    size_t input_size;  // Размер входных данных
-    size_t output_size; // Размер выходных данных
-    Tensor weights;     // Матрица весов (input_size x output_size)
-    Tensor biases;      // Вектор смещений (output_size)
-    Tensor input_cache; // Кэш входных данных для использования в backward pass
+    // Загруженный слой: параметры готовы (могут быть видами на отображенный файл),
+    // градиенты выделяются при первом обратном проходе
+    DenseLayer(Activation activation, Tensor weights, Tensor biases);
+
+    size_t input_size;     // Размер входных данных
+    size_t output_size;    // Размер выходных данных
+    Activation activation; // Активация, выполняемая в эпилоге
+    Tensor weights;        // Матрица весов (input_size x output_size)
+    Tensor biases;         // Вектор смещений (output_size)
+    Tensor grad_weights;   // Накопленный градиент весов
+    Tensor grad_biases;    // Накопленный градиент смещений
+    Tensor input_cache;    // Кэш входных данных для использования в backward pass
+    Tensor output_cache;   // Кэш выхода активации (только если activation != None)
+    std::vector<size_t> input_shape;  // Форма входа, выведенная inferShape
+    std::vector<size_t> output_shape; // Форма выхода, выведенная inferShape
+
+    // Размер батча для входа заданной формы
+    size_t batchSize(const std::vector<size_t>& shape) const;
+
+    // Выделить градиенты загруженного слоя
+    void allocateGradients();
+
+    // output = activation(input * weights + biases)
+    void compute(const Tensor& input, Tensor& output, size_t batch) const;
 };
 
 #endif // DENSE_LAYER_H
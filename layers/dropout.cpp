@@ -1,4 +1,9 @@
 #include "dropout.h"
+#include "serialization.h"
+
+namespace {
+const uint32_t dropout_version = 1; // Версия записи слоя
+}
 
 // Конструктор
 Dropout::Dropout(float rate)
@@ -13,25 +18,139 @@ Tensor Dropout::forward(const Tensor& input) {
     // Генерируем маску для отключения нейронов
     mask = Tensor(input.shape());
     for (size_t i = 0; i < mask.size(); ++i) {
-        mask({i}) = (dist(gen) < rate) ? 0.0f : 1.0f / (1.0f - rate);
+        mask[i] = (dist(gen) < rate) ? 0.0f : 1.0f / (1.0f - rate);
     }
 
     // Применяем маску к входным данным
     Tensor output(input.shape());
     for (size_t i = 0; i < input.size(); ++i) {
-        output({i}) = input({i}) * mask({i});
+        output[i] = input[i] * mask[i];
     }
 
     return output;
 }
 
+// Вывод: маска не применяется (масштаб 1 / (1 - rate) уже учтен при обучении)
+Tensor Dropout::infer(const Tensor& input, LayerState* state) const {
+    return input;
+}
+
+// Вывод на месте
+void Dropout::inferInPlace(Tensor& data, LayerState* state) const {}
+
 // Обратный проход
-Tensor Dropout::backward(const Tensor& grad_output, float learning_rate) {
+Tensor Dropout::backward(const Tensor& grad_output) {
     // Применяем маску к градиенту
     Tensor grad_input(grad_output.shape());
     for (size_t i = 0; i < grad_output.size(); ++i) {
-        grad_input({i}) = grad_output({i}) * mask({i});
+        grad_input[i] = grad_output[i] * mask[i];
     }
 
     return grad_input;
 }
+
+// Форма выхода совпадает с формой входа
+std::vector<size_t> Dropout::inferShape(const std::vector<size_t>& input_shape) {
+    shape = input_shape;
+    return shape;
+}
+
+// Прямой проход в буфер модели (маска переиспользуется, если форма не изменилась)
+void Dropout::forwardInto(Tensor& input, Tensor& output) {
+    if (output.size() != input.size()) {
+        throw std::invalid_argument("Output buffer must have the same size as the input.");
+    }
+    if (mask.shape() != input.shape()) {
+        mask = Tensor(input.shape());
+    }
+    float scale = 1.0f / (1.0f - rate);
+    for (size_t i = 0; i < input.size(); ++i) {
+        mask[i] = (dist(gen) < rate) ? 0.0f : scale;
+        output[i] = input[i] * mask[i];
+    }
+}
+
+// Обратный проход в буфер модели (grad_input может совпадать с grad_output)
+void Dropout::backwardInto(Tensor& grad_output, Tensor& grad_input) {
+    if (grad_output.size() != mask.size() || grad_input.size() != mask.size()) {
+        throw std::invalid_argument("Gradient tensor must have the same size as the last input.");
+    }
+    for (size_t i = 0; i < mask.size(); ++i) {
+        grad_input[i] = grad_output[i] * mask[i];
+    }
+}
+
+// Маска хранится в слое, поэтому выход можно писать поверх входа
+bool Dropout::supportsInPlace() const {
+    return true;
+}
+
+// Форма входа
+std::vector<size_t> Dropout::getInputShape() const {
+    return shape;
+}
+
+// Форма выхода
+std::vector<size_t> Dropout::getOutputShape() const {
+    return shape;
+}
+
+// Копия слоя
+std::shared_ptr<Layer> Dropout::clone() const {
+    return std::make_shared<Dropout>(*this);
+}
+
+// Освободить кэши прямого прохода
+void Dropout::releaseCache() {
+    mask = Tensor({0});
+}
+
+// Байты кэшей прямого прохода
+size_t Dropout::cacheBytes() const {
+    return mask.size() * sizeof(float);
+}
+
+// Повторный прямой проход не идентичен первому
+bool Dropout::isRecomputable() const {
+    return false;
+}
+
+// Имя типа слоя
+std::string Dropout::getName() const {
+    return "Dropout";
+}
+
+// Обучаемых параметров нет
+size_t Dropout::getNumParameters() const {
+    return 0;
+}
+
+// Сохранение: вероятность отключения (генератор при загрузке получает новое зерно)
+void Dropout::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, dropout_version);
+    writeF32(file, rate);
+}
+
+// Загрузка записи слоя
+std::shared_ptr<Layer> Dropout::load(std::ifstream& file) {
+    checkLayerVersion("Dropout", readU32(file), dropout_version);
+    return std::make_shared<Dropout>(readF32(file));
+}
+
+// Сохранить состояние генератора
+void Dropout::saveTrainingState(std::ostream& out) const {
+    writeGenerator(out, gen);
+}
+
+// Восстановить состояние генератора
+void Dropout::loadTrainingState(std::istream& in) {
+    readGenerator(in, gen);
+}
+
+// Новое состояние генератора из следующего числа текущего и номера потока
+void Dropout::reseed(uint64_t stream) {
+    std::seed_seq seq{static_cast<uint32_t>(gen()), static_cast<uint32_t>(stream),
+                      static_cast<uint32_t>(stream >> 32)};
+    gen.seed(seq);
+}
@@ -13,13 +13,49 @@ public:
     Tensor forward(const Tensor& input) override;
 
     // Обратный проход
-    Tensor backward(const Tensor& grad_output, float learning_rate) override;
+    Tensor backward(const Tensor& grad_output) override;
+
+    // Вывод: слой пропускает вход без изменений
+    Tensor infer(const Tensor& input, LayerState* state) const override;
+    void inferInPlace(Tensor& data, LayerState* state) const override;
+
+    // Форма выхода и проходы в буферы модели (выход может совпадать со входом)
+    std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) override;
+    void forwardInto(Tensor& input, Tensor& output) override;
+    void backwardInto(Tensor& grad_output, Tensor& grad_input) override;
+    bool supportsInPlace() const override;
+    std::vector<size_t> getInputShape() const override;
+    std::vector<size_t> getOutputShape() const override;
+
+    // Копия слоя с собственными параметрами и кэшами
+    std::shared_ptr<Layer> clone() const override;
+
+    // Кэши прямого прохода; повторный проход изменил бы маску
+    void releaseCache() override;
+    size_t cacheBytes() const override;
+    bool isRecomputable() const override;
+
+    // Независимый поток генератора для реплики
+    void reseed(uint64_t stream) override;
+
+    // Сохранение и загрузка записи слоя (см. layers/serialization.h)
+    void save(std::ofstream& file) const override;
+    static std::shared_ptr<Layer> load(std::ifstream& file);
+    std::string getName() const override;
+
+    // Обучаемых параметров нет
+    size_t getNumParameters() const override;
+
+    // Состояние генератора для контрольных точек обучения
+    void saveTrainingState(std::ostream& out) const override;
+    void loadTrainingState(std::istream& in) override;
 
 private:
     float rate; // Вероятность отключения нейронов
     Tensor mask; // Маска для отключения нейронов
     std::mt19937 gen; // Генератор случайных чисел
     std::uniform_real_distribution<float> dist; // Распределение для генерации случайных чисел
+    std::vector<size_t> shape; // Форма входа и выхода, выведенная inferShape
 };
 
 #endif // DROPOUT_H
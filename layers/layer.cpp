@@ -0,0 +1,59 @@
+#include "layer.h"
+#include "serialization.h"
+#include "dense_layer.h"
+#include "conv2d.h"
+#include "lstm.h"
+#include "batch_norm.h"
+#include "dropout.h"
+#include "max_pooling2d.h"
+#include "activations/relu.h"
+#include "activations/sigmoid.h"
+#include "activations/softmax.h"
+#include <stdexcept>
+
+// Загрузка слоя: имя типа из записи выбирает загрузчик слоя
+std::shared_ptr<Layer> Layer::load(std::ifstream& file) {
+    std::string name = readString(file);
+    if (name == "Dense") {
+        return DenseLayer::load(file);
+    }
+    if (name == "Conv2D") {
+        return Conv2D::load(file);
+    }
+    if (name == "LSTM") {
+        return LSTM::load(file);
+    }
+    if (name == "BatchNorm") {
+        return BatchNorm::load(file);
+    }
+    if (name == "Dropout") {
+        return Dropout::load(file);
+    }
+    if (name == "MaxPooling2D") {
+        return MaxPooling2D::load(file);
+    }
+    if (name == "ReLU") {
+        return ReLU::load(file);
+    }
+    if (name == "Sigmoid") {
+        return Sigmoid::load(file);
+    }
+    if (name == "Softmax") {
+        return Softmax::load(file);
+    }
+    throw std::runtime_error("Unknown layer type in model file: " + name);
+}
+
+// Оценка работы поэлементного слоя
+LayerCost Layer::cost(const std::vector<size_t>& input_shape) const {
+    double elements = 1.0;
+    for (size_t dim : input_shape) {
+        elements *= static_cast<double>(dim);
+    }
+    LayerCost cost;
+    cost.forward_flops = elements;
+    cost.forward_bytes = 2.0 * elements * sizeof(float);
+    cost.backward_flops = elements;
+    cost.backward_bytes = 3.0 * elements * sizeof(float); // Градиент выхода, кэш, градиент входа
+    return cost;
+}
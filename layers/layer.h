@@ -2,9 +2,29 @@
 #define LAYER_H
 
 #include "tensor.h"
+#include "activations/activation.h"
+#include "parameter.h"
+#include <cstdint>
 #include <memory>
 #include <fstream>
 
+// Состояние слоя, принадлежащее одному потоку вывода
+struct LayerState {
+    virtual ~LayerState() = default;
+
+    // Сбросить рекуррентное состояние (начало новой последовательности)
+    virtual void reset() {}
+};
+
+// Оценка работы слоя: операции с плавающей точкой и байты, которые проход читает и пишет
+// в память (вход, выход, параметры, рабочие буферы; повторные чтения из кэша не учитываются)
+struct LayerCost {
+    double forward_flops = 0.0;
+    double forward_bytes = 0.0;
+    double backward_flops = 0.0;
+    double backward_bytes = 0.0;
+};
+
 class Layer {
 public:
     virtual ~Layer() = default;
@@ -12,16 +32,105 @@ public:
     // Прямой проход
     virtual Tensor forward(const Tensor& input) = 0;
 
-    // Обратный проход
-    virtual Tensor backward(const Tensor& grad_output, float learning_rate) = 0;
+    // Обратный проход: возвращает градиент по входу и прибавляет градиенты
+    // параметров к их накопителям (сами параметры не изменяются)
+    virtual Tensor backward(const Tensor& grad_output) = 0;
+
+    // Прямой проход на месте: результат записывается в буфер входа.
+    // Слои, которым не нужна отдельная память под выход, переопределяют этот метод.
+    virtual void forwardInPlace(Tensor& data) { data = forward(data); }
+
+    // Обратный проход на месте: градиент по выходу заменяется градиентом по входу
+    virtual void backwardInPlace(Tensor& grad) { grad = backward(grad); }
+
+    // Изменяемое состояние слоя для вывода (рабочие буферы, рекуррентное состояние).
+    // nullptr — слою состояние не нужно.
+    virtual std::unique_ptr<LayerState> createState() const { return nullptr; }
+
+    // Прямой проход для вывода: без кэшей для обратного прохода и без случайности
+    // (Dropout пропускает вход, BatchNorm нормирует скользящими статистиками).
+    // Слой не изменяется: все изменяемое хранится в state из createState(), поэтому
+    // один слой может одновременно выполнять вывод в разных потоках с разными state.
+    virtual Tensor infer(const Tensor& input, LayerState* state) const = 0;
+
+    // Вывод на месте
+    virtual void inferInPlace(Tensor& data, LayerState* state) const { data = infer(data, state); }
+
+    // Вывести форму выхода по форме входа (первая ось — батч, если она есть) и проверить их
+    // совместимость; бросает std::invalid_argument. Обе формы запоминаются и возвращаются
+    // getInputShape и getOutputShape.
+    virtual std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) = 0;
+
+    // Прямой проход в буфер output, заранее выделенный моделью по выведенной форме.
+    // Слой, сообщивший backwardNeedsInput() или backwardNeedsOutput(), может кэшировать вид
+    // на input или output (Tensor::alias) вместо копии: модель держит эти буферы до его
+    // обратного прохода. По умолчанию — forward с копированием результата.
+    virtual void forwardInto(Tensor& input, Tensor& output) { output.copyFrom(forward(input)); }
+
+    // Обратный проход в заранее выделенный буфер grad_input; grad_output после вызова
+    // не нужен, и слой может использовать его как рабочую память
+    virtual void backwardInto(Tensor& grad_output, Tensor& grad_input) { grad_input.copyFrom(backward(grad_output)); }
 
-    // Сохранение слоя в файл
+    // Оценка работы прямого и обратного проходов для входа формы input_shape (с осью батча).
+    // По умолчанию — поэлементный слой: операция на элемент, чтение входа и запись выхода.
+    virtual LayerCost cost(const std::vector<size_t>& input_shape) const;
+
+    // Может ли forwardInto писать выход поверх входа, а backwardInto — градиент по входу
+    // поверх градиента по выходу (буферы output и input совпадают)
+    virtual bool supportsInPlace() const { return false; }
+
+    // Читает ли обратный проход буферы входа или выхода, переданные в forwardInto
+    virtual bool backwardNeedsInput() const { return false; }
+    virtual bool backwardNeedsOutput() const { return false; }
+
+    // Копия слоя с собственными параметрами, градиентами и кэшами.
+    // Используется для реплик модели, работающих в разных потоках.
+    virtual std::shared_ptr<Layer> clone() const = 0;
+
+    // Обучаемые параметры слоя и их градиенты
+    virtual std::vector<Parameter> parameters() { return {}; }
+
+    // Освободить кэши прямого прохода (входы, выходы, маски), нужные только для backward
+    virtual void releaseCache() {}
+
+    // Байты, занятые кэшами прямого прохода
+    virtual size_t cacheBytes() const { return 0; }
+
+    // Байты прочих буферов слоя помимо параметров, градиентов и кэшей: рабочие буферы
+    // (im2col), рекуррентное состояние, скользящие статистики
+    virtual size_t scratchBytes() const { return 0; }
+
+    // Можно ли повторить прямой проход без побочных эффектов (для контрольных точек модели).
+    // Слои со случайностью или изменяемым состоянием возвращают false.
+    virtual bool isRecomputable() const { return true; }
+
+    // Перевести генератор случайных чисел слоя на независимый поток номер stream: реплики
+    // модели (копии clone с тем же состоянием генератора) иначе тянули бы одинаковые маски.
+    // Новое состояние выводится из текущего и stream, поэтому повторяемо. Слои без случайности
+    // ничего не делают.
+    virtual void reseed(uint64_t stream) {}
+
+    // Активация, которую слой вычисляет и которую можно встроить в эпилог предыдущего слоя
+    virtual Activation fusableActivation() const { return Activation::None; }
+
+    // Встроить активацию в эпилог слоя; возвращает false, если слой этого не поддерживает
+    virtual bool fuseActivation(Activation activation) { return false; }
+
+    // Сохранение записи слоя в файл модели (формат — layers/serialization.h).
+    // Блобы параметров выравниваются от начала потока, поэтому file пишет файл с начала.
     virtual void save(std::ofstream& file) const = 0;
 
-    // Загрузка слоя из файла
+    // Загрузка записи слоя, сохраненной save: имя типа выбирает загрузчик слоя.
+    // Неизвестный тип, неподдерживаемая версия или поврежденная запись — std::runtime_error.
     static std::shared_ptr<Layer> load(std::ifstream& file);
 
-    // Получить имя слоя
+    // Необучаемое состояние слоя для контрольных точек обучения (скользящие статистики,
+    // состояние генератора): вместе с параметрами и состоянием оптимизатора позволяет
+    // продолжить обучение с точно того же места. По умолчанию состояния нет.
+    virtual void saveTrainingState(std::ostream& out) const {}
+    virtual void loadTrainingState(std::istream& in) {}
+
+    // Получить имя слоя (имя типа в файле модели)
     virtual std::string getName() const = 0;
 
     // Получить форму входных данных
@@ -30,7 +139,7 @@ public:
     // Получить форму выходных данных
     virtual std::vector<size_t> getOutputShape() const = 0;
 
-    // Получить количество параметров
+    // Получить количество обучаемых параметров (элементов весов, без градиентов)
     virtual size_t getNumParameters() const = 0;
 };
 
@@ -1,23 +1,33 @@
 #include "lstm.h"
+#include "kernels/gemm.h"
+#include "initializers/xavier.h"
+#include "serialization.h"
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 
+namespace {
+const uint32_t lstm_version = 1; // Версия записи слоя
+}
+
 // Конструктор
-LSTM::LSTM(size_t input_size, size_t hidden_size)
+LSTM::LSTM(size_t input_size, size_t hidden_size, std::shared_ptr<Initializer> initializer)
     : input_size(input_size), hidden_size(hidden_size),
       Wf({input_size + hidden_size, hidden_size}), Wi({input_size + hidden_size, hidden_size}),
       Wo({input_size + hidden_size, hidden_size}), Wc({input_size + hidden_size, hidden_size}),
       bf({hidden_size}), bi({hidden_size}), bo({hidden_size}), bc({hidden_size}),
-      h_prev({hidden_size}), c_prev({hidden_size}), input_cache({}) {
-    // Инициализируем веса случайными значениями
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
-
-    for (size_t i = 0; i < Wf.size(); ++i) Wf({i}) = dist(gen);
-    for (size_t i = 0; i < Wi.size(); ++i) Wi({i}) = dist(gen);
-    for (size_t i = 0; i < Wo.size(); ++i) Wo({i}) = dist(gen);
-    for (size_t i = 0; i < Wc.size(); ++i) Wc({i}) = dist(gen);
+      grad_Wf(Wf.shape()), grad_Wi(Wi.shape()), grad_Wo(Wo.shape()), grad_Wc(Wc.shape()),
+      grad_bf({hidden_size}), grad_bi({hidden_size}), grad_bo({hidden_size}), grad_bc({hidden_size}),
+      h_prev({1, hidden_size}), c_prev({1, hidden_size}),
+      input_cache({}), combined_cache({}), c_prev_cache({}),
+      ft({}), it({}), ot({}), ct({}), c_tanh({}), input_shape{input_size}, output_shape{hidden_size} {
+    // Инициализируем веса гейтов, у каждого свое зерно
+    if (!initializer) {
+        initializer = std::make_shared<Xavier>();
+    }
+    for (Tensor* W : {&Wf, &Wi, &Wo, &Wc}) {
+        initializer->initialize(*W, input_size + hidden_size, hidden_size);
+    }
 
     // Инициализируем смещения нулями
     bf.fill(0.0f);
@@ -30,160 +40,308 @@ LSTM::LSTM(size_t input_size, size_t hidden_size)
     c_prev.fill(0.0f);
 }
 
+// Конструктор загруженного слоя
+LSTM::LSTM(size_t input_size, size_t hidden_size, std::vector<Tensor> weights)
+    : input_size(input_size), hidden_size(hidden_size),
+      Wf(std::move(weights[0])), Wi(std::move(weights[1])), Wo(std::move(weights[2])), Wc(std::move(weights[3])),
+      bf(std::move(weights[4])), bi(std::move(weights[5])), bo(std::move(weights[6])), bc(std::move(weights[7])),
+      grad_Wf({0}), grad_Wi({0}), grad_Wo({0}), grad_Wc({0}),
+      grad_bf({0}), grad_bi({0}), grad_bo({0}), grad_bc({0}),
+      h_prev({1, hidden_size}), c_prev({1, hidden_size}),
+      input_cache({}), combined_cache({}), c_prev_cache({}),
+      ft({}), it({}), ot({}), ct({}), c_tanh({}), input_shape{input_size}, output_shape{hidden_size} {
+    h_prev.fill(0.0f);
+    c_prev.fill(0.0f);
+}
+
+// Обнулить состояния
+void LSTM::resetState() {
+    h_prev.fill(0.0f);
+    c_prev.fill(0.0f);
+}
+
 // Прямой проход
 Tensor LSTM::forward(const Tensor& input) {
     // Проверка формы входных данных
-    if (input.shape().size() != 1 || input.shape()[0] != input_size) {
-        throw std::invalid_argument("Input tensor must have shape (input_size).");
+    if (input.size() % input_size != 0 || input.size() == 0 || input.shape().back() != input_size) {
+        throw std::invalid_argument("Input tensor must have shape (input_size) or (batch_size, input_size).");
+    }
+    size_t batch = input.size() / input_size;
+    size_t width = input_size + hidden_size;
+
+    // При смене размера батча начинаем с нулевого состояния
+    if (h_prev.shape()[0] != batch) {
+        h_prev = Tensor({batch, hidden_size});
+        c_prev = Tensor({batch, hidden_size});
     }
 
     // Кэшируем входные данные для backward pass
     input_cache = input;
 
-    // Объединяем входные данные и предыдущее скрытое состояние
-    Tensor combined({input_size + hidden_size});
-    for (size_t i = 0; i < input_size; ++i) combined({i}) = input({i});
-    for (size_t i = 0; i < hidden_size; ++i) combined({input_size + i}) = h_prev({i});
+    // Объединяем входные данные и предыдущее скрытое состояние: combined = [x, h_prev]
+    combined_cache = Tensor({batch, width});
+    for (size_t b = 0; b < batch; ++b) {
+        std::memcpy(combined_cache.data() + b * width, input.data() + b * input_size, input_size * sizeof(float));
+        std::memcpy(combined_cache.data() + b * width + input_size, h_prev.data() + b * hidden_size,
+                    hidden_size * sizeof(float));
+    }
+
+    // Вычисляем значения гейтов: смещение и активация выполняются в эпилоге GEMM
+    gates(combined_cache, batch, ft, it, ot, ct);
 
-    // Вычисляем значения гейтов
-    Tensor ft = sigmoid(combined.dot(Wf) + bf); // Forget gate
-    Tensor it = sigmoid(combined.dot(Wi) + bi); // Input gate
-    Tensor ot = sigmoid(combined.dot(Wo) + bo); // Output gate
-    Tensor ct = tanh(combined.dot(Wc) + bc);    // Cell state candidate
+    // Обновляем состояние ячейки и скрытое состояние
+    c_prev_cache = c_prev;
+    c_tanh = Tensor({batch, hidden_size});
+    for (size_t i = 0; i < batch * hidden_size; ++i) {
+        c_prev[i] = ft[i] * c_prev_cache[i] + it[i] * ct[i];
+        c_tanh[i] = std::tanh(c_prev[i]);
+        h_prev[i] = ot[i] * c_tanh[i];
+    }
 
-    // Обновляем состояние ячейки
-    Tensor c_next = ft * c_prev + it * ct;
+    Tensor h_next = h_prev;
+    h_next.reshape(input.shape().size() == 1 ? std::vector<size_t>{hidden_size}
+                                             : std::vector<size_t>{batch, hidden_size});
+    return h_next;
+}
 
-    // Обновляем скрытое состояние
-    Tensor h_next = ot * tanh(c_next);
+// Значения четырех гейтов для объединенного входа [x, h_prev]
+void LSTM::gates(const Tensor& combined, size_t batch, Tensor& f, Tensor& i, Tensor& o, Tensor& c) const {
+    size_t width = input_size + hidden_size;
+    auto gate = [&](const Tensor& W, const Tensor& bias, Activation activation, Tensor& out) {
+        out = Tensor({batch, hidden_size});
+        GemmEpilogue epilogue;
+        epilogue.col_bias = bias.data();
+        epilogue.activation = activation;
+        gemm(false, false, batch, hidden_size, width, combined.data(), width,
+             W.data(), hidden_size, out.data(), hidden_size, false, epilogue);
+    };
+    gate(Wf, bf, Activation::Sigmoid, f); // Forget gate
+    gate(Wi, bi, Activation::Sigmoid, i); // Input gate
+    gate(Wo, bo, Activation::Sigmoid, o); // Output gate
+    gate(Wc, bc, Activation::Tanh, c);    // Cell state candidate
+}
 
-    // Обновляем предыдущие состояния
-    c_prev = c_next;
-    h_prev = h_next;
+// Состояние потока вывода
+std::unique_ptr<LayerState> LSTM::createState() const {
+    return std::unique_ptr<LayerState>(new InferenceState());
+}
 
+// Новая последовательность начинается с нулевого состояния
+void LSTM::InferenceState::reset() {
+    h.fill(0.0f);
+    c.fill(0.0f);
+}
+
+// Вывод: шаг обновляет состояние потока, кэши для обратного прохода не заполняются
+Tensor LSTM::infer(const Tensor& input, LayerState* state) const {
+    if (!state) {
+        throw std::invalid_argument("LSTM inference requires the state created by createState().");
+    }
+    if (input.size() % input_size != 0 || input.size() == 0 || input.shape().back() != input_size) {
+        throw std::invalid_argument("Input tensor must have shape (input_size) or (batch_size, input_size).");
+    }
+    size_t batch = input.size() / input_size;
+    size_t width = input_size + hidden_size;
+    InferenceState& s = *static_cast<InferenceState*>(state);
+    if (s.h.size() != batch * hidden_size) {
+        s.h = Tensor({batch, hidden_size});
+        s.c = Tensor({batch, hidden_size});
+    }
+
+    Tensor combined({batch, width});
+    for (size_t b = 0; b < batch; ++b) {
+        std::memcpy(combined.data() + b * width, input.data() + b * input_size, input_size * sizeof(float));
+        std::memcpy(combined.data() + b * width + input_size, s.h.data() + b * hidden_size,
+                    hidden_size * sizeof(float));
+    }
+    Tensor f({0}), i({0}), o({0}), c({0});
+    gates(combined, batch, f, i, o, c);
+    for (size_t k = 0; k < batch * hidden_size; ++k) {
+        s.c[k] = f[k] * s.c[k] + i[k] * c[k];
+        s.h[k] = o[k] * std::tanh(s.c[k]);
+    }
+
+    Tensor h_next = s.h;
+    h_next.reshape(input.shape().size() == 1 ? std::vector<size_t>{hidden_size}
+                                             : std::vector<size_t>{batch, hidden_size});
     return h_next;
 }
 
 // Обратный проход
-Tensor LSTM::backward(const Tensor& grad_output, float learning_rate) {
+Tensor LSTM::backward(const Tensor& grad_output) {
+    allocateGradients();
+    size_t batch = combined_cache.shape()[0];
+    size_t width = input_size + hidden_size;
+
     // Проверка формы градиента
-    if (grad_output.shape().size() != 1 || grad_output.shape()[0] != hidden_size) {
-        throw std::invalid_argument("Gradient tensor must have shape (hidden_size).");
+    if (grad_output.size() != batch * hidden_size) {
+        throw std::invalid_argument("Gradient tensor must have shape ([batch_size,] hidden_size).");
     }
 
-    // Градиенты для параметров
-    Tensor grad_Wf(Wf.shape());
-    Tensor grad_Wi(Wi.shape());
-    Tensor grad_Wo(Wo.shape());
-    Tensor grad_Wc(Wc.shape());
+    // Градиенты по предактивациям гейтов
+    Tensor grad_f({batch, hidden_size}), grad_i({batch, hidden_size});
+    Tensor grad_o({batch, hidden_size}), grad_c({batch, hidden_size});
+    for (size_t k = 0; k < batch * hidden_size; ++k) {
+        float gh = grad_output[k];
+        float grad_c_next = gh * ot[k] * (1.0f - c_tanh[k] * c_tanh[k]);
+        grad_o[k] = gh * c_tanh[k] * ot[k] * (1.0f - ot[k]);
+        grad_c[k] = grad_c_next * it[k] * (1.0f - ct[k] * ct[k]);
+        grad_i[k] = grad_c_next * ct[k] * it[k] * (1.0f - it[k]);
+        grad_f[k] = grad_c_next * c_prev_cache[k] * ft[k] * (1.0f - ft[k]);
+    }
 
-    Tensor grad_bf(bf.shape());
-    Tensor grad_bi(bi.shape());
-    Tensor grad_bo(bo.shape());
-    Tensor grad_bc(bc.shape());
+    Tensor grad_combined({batch, width});
+    auto accumulate = [&](const Tensor& grad_gate, const Tensor& W, Tensor& grad_W, Tensor& grad_b) {
+        // grad_W += combined^T * grad_gate
+        gemm(true, false, width, hidden_size, batch, combined_cache.data(), width,
+             grad_gate.data(), hidden_size, grad_W.data(), hidden_size, true);
+        for (size_t b = 0; b < batch; ++b) {
+            for (size_t i = 0; i < hidden_size; ++i) grad_b[i] += grad_gate[b * hidden_size + i];
+        }
+        // grad_combined += grad_gate * W^T
+        gemm(false, true, batch, width, hidden_size, grad_gate.data(), hidden_size,
+             W.data(), hidden_size, grad_combined.data(), width, true);
+    };
+    accumulate(grad_f, Wf, grad_Wf, grad_bf);
+    accumulate(grad_i, Wi, grad_Wi, grad_bi);
+    accumulate(grad_o, Wo, grad_Wo, grad_bo);
+    accumulate(grad_c, Wc, grad_Wc, grad_bc);
+
+    // Градиент по входным данным — первые input_size столбцов grad_combined
+    Tensor grad_input(input_cache.shape());
+    for (size_t b = 0; b < batch; ++b) {
+        std::memcpy(grad_input.data() + b * input_size, grad_combined.data() + b * width,
+                    input_size * sizeof(float));
+    }
 
-    // Градиент по скрытому состоянию
-    Tensor grad_h_prev(h_prev.shape());
-    grad_h_prev.fill(0.0f);
+    return grad_input;
+}
 
-    // Градиент по состоянию ячейки
-    Tensor grad_c_prev(c_prev.shape());
-    grad_c_prev.fill(0.0f);
+// Форма выхода
+std::vector<size_t> LSTM::inferShape(const std::vector<size_t>& shape) {
+    size_t size = 1;
+    for (size_t dim : shape) {
+        size *= dim;
+    }
+    if (shape.empty() || size == 0 || shape.back() != input_size) {
+        throw std::invalid_argument("Input tensor must have shape (input_size) or (batch_size, input_size).");
+    }
+    input_shape = shape;
+    output_shape = shape.size() == 1 ? std::vector<size_t>{hidden_size}
+                                     : std::vector<size_t>{size / input_size, hidden_size};
+    return output_shape;
+}
 
-    // Объединяем входные данные и предыдущее скрытое состояние
-    Tensor combined({input_size + hidden_size});
-    for (size_t i = 0; i < input_size; ++i) combined({i}) = input_cache({i});
-    for (size_t i = 0; i < hidden_size; ++i) combined({input_size + i}) = h_prev({i});
+// Форма входа
+std::vector<size_t> LSTM::getInputShape() const {
+    return input_shape;
+}
 
-    // Вычисляем значения гейтов (повторно, как в forward pass)
-    Tensor ft = sigmoid(combined.dot(Wf) + bf); // Forget gate
-    Tensor it = sigmoid(combined.dot(Wi) + bi); // Input gate
-    Tensor ot = sigmoid(combined.dot(Wo) + bo); // Output gate
-    Tensor ct = tanh(combined.dot(Wc) + bc);    // Cell state candidate
+// Форма выхода
+std::vector<size_t> LSTM::getOutputShape() const {
+    return output_shape;
+}
 
-    // Градиент по выходу (переданный из следующего слоя)
-    Tensor grad_h_next = grad_output;
+// Параметры слоя
+std::vector<Parameter> LSTM::parameters() {
+    allocateGradients();
+    return {{"Wf", &Wf, &grad_Wf}, {"Wi", &Wi, &grad_Wi}, {"Wo", &Wo, &grad_Wo}, {"Wc", &Wc, &grad_Wc},
+            {"bf", &bf, &grad_bf}, {"bi", &bi, &grad_bi}, {"bo", &bo, &grad_bo}, {"bc", &bc, &grad_bc}};
+}
+
+// Количество параметров: веса и смещения четырех гейтов
+size_t LSTM::getNumParameters() const {
+    return Wf.size() + Wi.size() + Wo.size() + Wc.size() + bf.size() + bi.size() + bo.size() + bc.size();
+}
 
-    // Градиент по состоянию ячейки
-    Tensor grad_c_next = grad_h_next * ot * (1 - tanh(c_prev) * tanh(c_prev));
-    // Градиент по output gate
-    Tensor grad_ot = grad_h_next * tanh(c_prev) * ot * (1 - ot);
+// Копия слоя
+std::shared_ptr<Layer> LSTM::clone() const {
+    return std::make_shared<LSTM>(*this);
+}
 
-    // Градиент по cell state candidate
-    Tensor grad_ct = grad_c_next * it * (1 - ct * ct);
+// Освободить кэши прямого прохода
+void LSTM::releaseCache() {
+    for (Tensor* cache : {&input_cache, &combined_cache, &c_prev_cache, &ft, &it, &ot, &ct, &c_tanh}) {
+        *cache = Tensor({0});
+    }
+}
 
-    // Градиент по input gate
-    Tensor grad_it = grad_c_next * ct * it * (1 - it);
+// Байты кэшей прямого прохода
+size_t LSTM::cacheBytes() const {
+    return (input_cache.size() + combined_cache.size() + c_prev_cache.size() + ft.size() + it.size() + ot.size() +
+            ct.size() + c_tanh.size()) * sizeof(float);
+}
 
-    // Градиент по forget gate
-    Tensor grad_ft = grad_c_next * c_prev * ft * (1 - ft);
+// Повторный прямой проход не идентичен первому
+bool LSTM::isRecomputable() const {
+    return false;
+}
 
-    // Градиент по combined input
-    Tensor grad_combined = grad_ft.dot(Wf.transpose()) +
-                           grad_it.dot(Wi.transpose()) +
-                           grad_ot.dot(Wo.transpose()) +
-                           grad_ct.dot(Wc.transpose());
+// Байты состояния между шагами
+size_t LSTM::scratchBytes() const {
+    return (h_prev.size() + c_prev.size()) * sizeof(float);
+}
 
-    // Градиент по входным данным
-    Tensor grad_input({input_size});
-    for (size_t i = 0; i < input_size; ++i) {
-        grad_input({i}) = grad_combined({i});
+// Выделить градиенты, если слой загружен без них
+void LSTM::allocateGradients() {
+    if (grad_Wf.size() == Wf.size()) {
+        return;
     }
-
-    // Градиент по предыдущему скрытому состоянию
-    for (size_t i = 0; i < hidden_size; ++i) {
-        grad_h_prev({i}) = grad_combined({input_size + i});
+    Tensor* grads[] = {&grad_Wf, &grad_Wi, &grad_Wo, &grad_Wc, &grad_bf, &grad_bi, &grad_bo, &grad_bc};
+    const Tensor* values[] = {&Wf, &Wi, &Wo, &Wc, &bf, &bi, &bo, &bc};
+    for (size_t k = 0; k < 8; ++k) {
+        *grads[k] = Tensor(values[k]->shape());
     }
+}
 
-    // Градиент по предыдущему состоянию ячейки
-    grad_c_prev = grad_c_next * ft;
+// Имя типа слоя
+std::string LSTM::getName() const {
+    return "LSTM";
+}
 
-    // Обновляем параметры
-    for (size_t i = 0; i < hidden_size; ++i) {
-        for (size_t j = 0; j < input_size + hidden_size; ++j) {
-            grad_Wf({j, i}) += grad_ft({i}) * combined({j});
-            grad_Wi({j, i}) += grad_it({i}) * combined({j});
-            grad_Wo({j, i}) += grad_ot({i}) * combined({j});
-            grad_Wc({j, i}) += grad_ct({i}) * combined({j});
-        }
-        grad_bf({i}) += grad_ft({i});
-        grad_bi({i}) += grad_it({i});
-        grad_bo({i}) += grad_ot({i});
-        grad_bc({i}) += grad_ct({i});
-    }
-
-    // Обновляем веса и смещения
-    for (size_t i = 0; i < hidden_size; ++i) {
-        for (size_t j = 0; j < input_size + hidden_size; ++j) {
-            Wf({j, i}) -= learning_rate * grad_Wf({j, i});
-            Wi({j, i}) -= learning_rate * grad_Wi({j, i});
-            Wo({j, i}) -= learning_rate * grad_Wo({j, i});
-            Wc({j, i}) -= learning_rate * grad_Wc({j, i});
-        }
-        bf({i}) -= learning_rate * grad_bf({i});
-        bi({i}) -= learning_rate * grad_bi({i});
-        bo({i}) -= learning_rate * grad_bo({i});
-        bc({i}) -= learning_rate * grad_bc({i});
+// Сохранение: размеры, веса и смещения гейтов (скрытое состояние не сохраняется)
+void LSTM::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, lstm_version);
+    writeU64(file, input_size);
+    writeU64(file, hidden_size);
+    for (const Tensor* tensor : {&Wf, &Wi, &Wo, &Wc, &bf, &bi, &bo, &bc}) {
+        writeTensor(file, *tensor);
     }
-
-    return grad_input;
 }
 
-// Вспомогательная функция: сигмоида
-Tensor LSTM::sigmoid(const Tensor& x) const {
-    Tensor result(x.shape());
-    for (size_t i = 0; i < x.size(); ++i) {
-        result({i}) = 1.0f / (1.0f + std::exp(-x({i})));
+// Загрузка записи слоя
+std::shared_ptr<Layer> LSTM::load(std::ifstream& file) {
+    checkLayerVersion("LSTM", readU32(file), lstm_version);
+    size_t input = readU64(file);
+    size_t hidden = readU64(file);
+    std::vector<Tensor> weights;
+    for (size_t k = 0; k < 8; ++k) {
+        weights.push_back(readTensor(file));
+        std::vector<size_t> expected = k < 4 ? std::vector<size_t>{input + hidden, hidden} : std::vector<size_t>{hidden};
+        if (weights.back().shape() != expected) {
+            throw std::runtime_error("Model file is corrupted: LSTM parameters do not match its sizes.");
+        }
     }
-    return result;
+    return std::shared_ptr<Layer>(new LSTM(input, hidden, std::move(weights)));
 }
 
-// Вспомогательная функция: гиперболический тангенс
-Tensor LSTM::tanh(const Tensor& x) const {
-    Tensor result(x.shape());
-    for (size_t i = 0; i < x.size(); ++i) {
-        result({i}) = std::tanh(x({i}));
+// Оценка работы одного шага
+LayerCost LSTM::cost(const std::vector<size_t>& input_shape) const {
+    double elements = 1.0;
+    for (size_t dim : input_shape) {
+        elements *= static_cast<double>(dim);
     }
-    return result;
+    double batch = elements / static_cast<double>(input_size);
+    double width = static_cast<double>(input_size + hidden_size);
+    double gates = 4.0 * static_cast<double>(hidden_size);
+    double hidden = batch * static_cast<double>(hidden_size);
+    LayerCost cost;
+    // Гейты: GEMM и смещение с активацией; состояние ячейки и выход — около 6 операций на элемент
+    cost.forward_flops = 2.0 * batch * width * gates + 2.0 * batch * gates + 6.0 * hidden;
+    cost.forward_bytes = (batch * width + width * gates + gates + 4.0 * batch * gates + 4.0 * hidden) * sizeof(float);
+    cost.backward_flops = 4.0 * batch * width * gates + 4.0 * batch * gates + 12.0 * hidden;
+    cost.backward_bytes =
+        (2.0 * batch * width + 3.0 * width * gates + 2.0 * gates + 6.0 * batch * gates + 4.0 * hidden) * sizeof(float);
+    return cost;
 }
-
@@ -3,20 +3,63 @@
 
 #include "tensor.h"
 #include "layer.h"
+#include "initializers/initializer.h"
 #include <vector>
-#include <random>
 
+// Один шаг LSTM: вход (input_size) или (batch_size, input_size).
+// Скрытое состояние сохраняется между вызовами forward; градиент считается за один шаг.
 class LSTM : public Layer {
 public:
-    LSTM(size_t input_size, size_t hidden_size);
+    // Без initializer веса гейтов заполняются Xavier
+    LSTM(size_t input_size, size_t hidden_size, std::shared_ptr<Initializer> initializer = nullptr);
 
     // Прямой проход
     Tensor forward(const Tensor& input) override;
 
     // Обратный проход
-    Tensor backward(const Tensor& grad_output, float learning_rate) override;
+    Tensor backward(const Tensor& grad_output) override;
+
+    // Вывод без кэшей; скрытое состояние и состояние ячейки хранятся в состоянии потока,
+    // а не в слое, поэтому независимые последовательности не смешиваются
+    std::unique_ptr<LayerState> createState() const override;
+    Tensor infer(const Tensor& input, LayerState* state) const override;
+
+    // Форма выхода: (hidden_size) или (batch_size, hidden_size)
+    std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) override;
+    std::vector<size_t> getInputShape() const override;
+    std::vector<size_t> getOutputShape() const override;
+
+    // Оценка работы одного шага: GEMM по [x, h] для четырех гейтов и поэлементные гейты
+    LayerCost cost(const std::vector<size_t>& input_shape) const override;
+
+    // Копия слоя с собственными параметрами и кэшами
+    std::shared_ptr<Layer> clone() const override;
+
+    // Кэши прямого прохода; повторный проход изменил бы скрытое состояние
+    void releaseCache() override;
+    size_t cacheBytes() const override;
+    bool isRecomputable() const override;
+
+    // Скрытое состояние и состояние ячейки между шагами
+    size_t scratchBytes() const override;
+
+    // Параметры: веса и смещения четырех гейтов
+    std::vector<Parameter> parameters() override;
+    size_t getNumParameters() const override;
+
+    // Обнулить скрытое состояние и состояние ячейки
+    void resetState();
+
+    // Сохранение и загрузка записи слоя (см. layers/serialization.h)
+    void save(std::ofstream& file) const override;
+    static std::shared_ptr<Layer> load(std::ifstream& file);
+    std::string getName() const override;
 
 private:
+    // Загруженный слой: weights — Wf, Wi, Wo, Wc, bf, bi, bo, bc (могут быть видами на
+    // отображенный файл), градиенты выделяются при первом обратном проходе
+    LSTM(size_t input_size, size_t hidden_size, std::vector<Tensor> weights);
+
     size_t input_size;  // Размер входных данных
     size_t hidden_size; // Размер скрытого состояния
 
@@ -24,14 +67,37 @@ private:
     Tensor Wf, Wi, Wo, Wc; // Веса для forget, input, output и cell gate
     Tensor bf, bi, bo, bc; // Смещения
 
-    // Кэши для обратного прохода
-    Tensor input_cache; // Кэш входных данных
+    // Накопленные градиенты параметров
+    Tensor grad_Wf, grad_Wi, grad_Wo, grad_Wc;
+    Tensor grad_bf, grad_bi, grad_bo, grad_bc;
+
+    // Состояние между шагами
     Tensor h_prev;      // Предыдущее скрытое состояние
     Tensor c_prev;      // Предыдущее состояние ячейки
 
-    // Вспомогательные функции
-    Tensor sigmoid(const Tensor& x) const;
-    Tensor tanh(const Tensor& x) const;
+    // Кэши для обратного прохода
+    Tensor input_cache;    // Кэш входных данных (для формы градиента)
+    Tensor combined_cache; // [input, h_prev] на момент прямого прохода
+    Tensor c_prev_cache;   // Состояние ячейки до шага
+    Tensor ft, it, ot, ct; // Значения гейтов
+    Tensor c_tanh;         // tanh(c_next)
+
+    std::vector<size_t> input_shape;  // Форма входа, выведенная inferShape
+    std::vector<size_t> output_shape; // Форма выхода, выведенная inferShape
+
+    // Состояние потока вывода
+    struct InferenceState : LayerState {
+        Tensor h;
+        Tensor c;
+        InferenceState() : h({0}), c({0}) {}
+        void reset() override;
+    };
+
+    // Выделить градиенты загруженного слоя
+    void allocateGradients();
+
+    // Значения гейтов для объединенного входа [x, h_prev] (batch, input_size + hidden_size)
+    void gates(const Tensor& combined, size_t batch, Tensor& f, Tensor& i, Tensor& o, Tensor& c) const;
 };
 
 #endif // LSTM_H
@@ -0,0 +1,206 @@
+#include "max_pooling2d.h"
+#include "serialization.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+const uint32_t max_pooling2d_version = 1; // Версия записи слоя
+}
+
+// Конструктор
+MaxPooling2D::MaxPooling2D(size_t pool_size, size_t stride) : pool_size(pool_size), stride(stride) {
+    if (pool_size == 0 || stride == 0) {
+        throw std::invalid_argument("Pool size and stride must be positive.");
+    }
+}
+
+// Форма выхода: ([batch,] channels, output_height, output_width)
+std::vector<size_t> MaxPooling2D::outputShape(const std::vector<size_t>& shape) const {
+    if (shape.size() != 3 && shape.size() != 4) {
+        throw std::invalid_argument("Input tensor must have shape ([batch,] channels, height, width).");
+    }
+    size_t height = shape[shape.size() - 2];
+    size_t width = shape[shape.size() - 1];
+    if (height < pool_size || width < pool_size) {
+        throw std::invalid_argument("Input image is smaller than the pooling window.");
+    }
+    std::vector<size_t> result = shape;
+    result[shape.size() - 2] = (height - pool_size) / stride + 1;
+    result[shape.size() - 1] = (width - pool_size) / stride + 1;
+    return result;
+}
+
+// Вывести и запомнить форму выхода
+std::vector<size_t> MaxPooling2D::inferShape(const std::vector<size_t>& shape) {
+    output_shape = outputShape(shape);
+    input_shape = shape;
+    return output_shape;
+}
+
+// Максимум по каждому окну; при indices != nullptr туда пишутся номера максимумов во входе
+void MaxPooling2D::pool(const Tensor& input, Tensor& output, size_t* indices) const {
+    const std::vector<size_t>& shape = input.shape();
+    if ((shape.size() != 3 && shape.size() != 4) || shape[shape.size() - 2] < pool_size ||
+        shape[shape.size() - 1] < pool_size) {
+        throw std::invalid_argument("Input tensor must have shape ([batch,] channels, height, width) "
+                                    "no smaller than the pooling window.");
+    }
+    size_t height = shape[shape.size() - 2];
+    size_t width = shape[shape.size() - 1];
+    size_t out_h = (height - pool_size) / stride + 1;
+    size_t out_w = (width - pool_size) / stride + 1;
+    size_t planes = input.size() / (height * width);
+    if (output.size() != planes * out_h * out_w) {
+        throw std::invalid_argument("Output buffer must match the layer output shape.");
+    }
+
+    const float* in = input.data();
+    float* out = output.data();
+    for (size_t p = 0; p < planes; ++p) {
+        size_t plane = p * height * width;
+        for (size_t oy = 0; oy < out_h; ++oy) {
+            for (size_t ox = 0; ox < out_w; ++ox) {
+                size_t best = plane + oy * stride * width + ox * stride;
+                for (size_t ky = 0; ky < pool_size; ++ky) {
+                    size_t row = plane + (oy * stride + ky) * width + ox * stride;
+                    for (size_t kx = 0; kx < pool_size; ++kx) {
+                        if (in[row + kx] > in[best]) {
+                            best = row + kx;
+                        }
+                    }
+                }
+                size_t o = (p * out_h + oy) * out_w + ox;
+                out[o] = in[best];
+                if (indices) {
+                    indices[o] = best;
+                }
+            }
+        }
+    }
+}
+
+// Градиент по входу: нули, кроме позиций максимумов (окна могут перекрываться)
+void MaxPooling2D::scatter(const Tensor& grad_output, Tensor& grad_input) const {
+    if (grad_output.size() != argmax.size()) {
+        throw std::invalid_argument("Gradient tensor must match the shape of the last output.");
+    }
+    const float* g = grad_output.data();
+    float* dx = grad_input.data();
+    std::fill(dx, dx + grad_input.size(), 0.0f);
+    for (size_t o = 0; o < argmax.size(); ++o) {
+        dx[argmax[o]] += g[o];
+    }
+}
+
+// Прямой проход
+Tensor MaxPooling2D::forward(const Tensor& input) {
+    Tensor output(outputShape(input.shape()));
+    argmax.resize(output.size());
+    input_dims = input.shape();
+    pool(input, output, argmax.data());
+    return output;
+}
+
+// Вывод
+Tensor MaxPooling2D::infer(const Tensor& input, LayerState* state) const {
+    Tensor output(outputShape(input.shape()));
+    pool(input, output, nullptr);
+    return output;
+}
+
+// Обратный проход
+Tensor MaxPooling2D::backward(const Tensor& grad_output) {
+    Tensor grad_input(input_dims);
+    scatter(grad_output, grad_input);
+    return grad_input;
+}
+
+// Прямой проход в буфер модели (кэш позиций переиспользуется при том же размере)
+void MaxPooling2D::forwardInto(Tensor& input, Tensor& output) {
+    argmax.resize(output.size());
+    input_dims = input.shape();
+    pool(input, output, argmax.data());
+}
+
+// Обратный проход в буфер модели
+void MaxPooling2D::backwardInto(Tensor& grad_output, Tensor& grad_input) {
+    size_t expected = 1;
+    for (size_t dim : input_dims) {
+        expected *= dim;
+    }
+    if (grad_input.size() != expected) {
+        throw std::invalid_argument("Gradient buffer must match the shape of the last input.");
+    }
+    scatter(grad_output, grad_input);
+}
+
+// Форма входа
+std::vector<size_t> MaxPooling2D::getInputShape() const {
+    return input_shape;
+}
+
+// Форма выхода
+std::vector<size_t> MaxPooling2D::getOutputShape() const {
+    return output_shape;
+}
+
+// Оценка работы: сравнения по окнам, чтение входа и запись выхода с позициями;
+// обратный проход обнуляет градиент входа и разносит по нему градиент выхода
+LayerCost MaxPooling2D::cost(const std::vector<size_t>& input_shape) const {
+    std::vector<size_t> shape = outputShape(input_shape);
+    double inputs = 1.0;
+    for (size_t dim : input_shape) {
+        inputs *= static_cast<double>(dim);
+    }
+    double outputs = 1.0;
+    for (size_t dim : shape) {
+        outputs *= static_cast<double>(dim);
+    }
+    LayerCost cost;
+    cost.forward_flops = outputs * pool_size * pool_size;
+    cost.forward_bytes = inputs * sizeof(float) + outputs * (sizeof(float) + sizeof(size_t));
+    cost.backward_flops = outputs;
+    cost.backward_bytes = outputs * (sizeof(float) + sizeof(size_t)) + inputs * sizeof(float);
+    return cost;
+}
+
+// Копия слоя
+std::shared_ptr<Layer> MaxPooling2D::clone() const {
+    return std::make_shared<MaxPooling2D>(*this);
+}
+
+// Освободить кэши прямого прохода
+void MaxPooling2D::releaseCache() {
+    std::vector<size_t>().swap(argmax);
+}
+
+// Байты кэшей прямого прохода
+size_t MaxPooling2D::cacheBytes() const {
+    return argmax.size() * sizeof(size_t);
+}
+
+// Имя типа слоя
+std::string MaxPooling2D::getName() const {
+    return "MaxPooling2D";
+}
+
+// Обучаемых параметров нет
+size_t MaxPooling2D::getNumParameters() const {
+    return 0;
+}
+
+// Сохранение: размер окна и шаг
+void MaxPooling2D::save(std::ofstream& file) const {
+    writeString(file, getName());
+    writeU32(file, max_pooling2d_version);
+    writeU64(file, pool_size);
+    writeU64(file, stride);
+}
+
+// Загрузка записи слоя
+std::shared_ptr<Layer> MaxPooling2D::load(std::ifstream& file) {
+    checkLayerVersion("MaxPooling2D", readU32(file), max_pooling2d_version);
+    size_t pool_size = readU64(file);
+    size_t stride = readU64(file);
+    return std::make_shared<MaxPooling2D>(pool_size, stride);
+}
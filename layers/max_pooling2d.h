@@ -8,15 +8,51 @@ class MaxPooling2D : public Layer {
 public:
     MaxPooling2D(size_t pool_size, size_t stride = 2);
 
-    // Прямой проход
+    // Прямой проход: вход (channels, height, width) или (batch, channels, height, width)
     Tensor forward(const Tensor& input) override;
 
-    // Обратный проход
-    Tensor backward(const Tensor& grad_output, float learning_rate) override;
+    // Обратный проход: градиент выхода попадает в позицию максимума своего окна
+    Tensor backward(const Tensor& grad_output) override;
+
+    // Вывод без кэша позиций максимумов
+    Tensor infer(const Tensor& input, LayerState* state) const override;
+
+    // Форма выхода и проходы в буферы модели
+    std::vector<size_t> inferShape(const std::vector<size_t>& input_shape) override;
+    void forwardInto(Tensor& input, Tensor& output) override;
+    void backwardInto(Tensor& grad_output, Tensor& grad_input) override;
+    std::vector<size_t> getInputShape() const override;
+    std::vector<size_t> getOutputShape() const override;
+
+    // Оценка работы: pool_size^2 сравнений на элемент выхода
+    LayerCost cost(const std::vector<size_t>& input_shape) const override;
+
+    // Копия слоя с собственными параметрами и кэшами
+    std::shared_ptr<Layer> clone() const override;
+
+    // Кэш позиций максимумов
+    void releaseCache() override;
+    size_t cacheBytes() const override;
+
+    // Сохранение и загрузка записи слоя (см. layers/serialization.h)
+    void save(std::ofstream& file) const override;
+    static std::shared_ptr<Layer> load(std::ifstream& file);
+    std::string getName() const override;
+
+    // Обучаемых параметров нет
+    size_t getNumParameters() const override;
 
 private:
     size_t pool_size, stride;
-    Tensor input_cache; // Кэш входных данных для использования в backward pass
+    std::vector<size_t> argmax; // Номер элемента входа, давшего каждый элемент выхода
+    std::vector<size_t> input_dims; // Форма последнего входа для обратного прохода
+    std::vector<size_t> input_shape;  // Форма входа, выведенная inferShape
+    std::vector<size_t> output_shape; // Форма выхода, выведенная inferShape
+
+    // Вспомогательные функции
+    std::vector<size_t> outputShape(const std::vector<size_t>& input_shape) const;
+    void pool(const Tensor& input, Tensor& output, size_t* indices) const;
+    void scatter(const Tensor& grad_output, Tensor& grad_input) const;
 };
 
 #endif // MAX_POOLING2D_H
@@ -0,0 +1,107 @@
+#include "parameter.h"
+#include "layer.h"
+#include <cstring>
+#include <stdexcept>
+
+// Деструктор: тензоры слоев не должны ссылаться на освобожденную память
+ParameterRegistry::~ParameterRegistry() {
+    clear();
+}
+
+// Собрать параметры слоев в общие буферы
+void ParameterRegistry::build(const std::vector<std::shared_ptr<Layer>>& layers) {
+    clear();
+
+    // Раскладка: каждый параметр начинается с новой кэш-линии
+    size_t total = 0;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        for (const Parameter& param : layers[i]->parameters()) {
+            if (param.value->size() != param.grad->size()) {
+                throw std::logic_error("Parameter and gradient sizes differ: " + param.name);
+            }
+            entry_list.push_back({std::to_string(i) + "." + param.name, total, param.value->size(),
+                                  param.value, param.grad, i});
+            total += AlignedBuffer::alignedCount(param.value->size());
+        }
+    }
+
+    value_buffer.resize(total);
+    grad_buffer.resize(total);
+    for (const Entry& entry : entry_list) {
+        entry.value->bindStorage(value_buffer.data() + entry.offset, true);
+        entry.grad->bindStorage(grad_buffer.data() + entry.offset, true);
+    }
+    owners = layers;
+}
+
+// Вернуть параметры в собственные хранилища
+void ParameterRegistry::clear() {
+    for (const Entry& entry : entry_list) {
+        entry.value->detach();
+        entry.grad->detach();
+    }
+    entry_list.clear();
+    owners.clear();
+    shared_values = nullptr;
+    value_buffer.resize(0);
+    grad_buffer.resize(0);
+}
+
+// Перевести значения на общий буфер
+void ParameterRegistry::shareValues(ParameterRegistry& source) {
+    if (source.entry_list.size() != entry_list.size()) {
+        throw std::invalid_argument("Parameter layouts differ.");
+    }
+    for (size_t i = 0; i < entry_list.size(); ++i) {
+        if (source.entry_list[i].offset != entry_list[i].offset || source.entry_list[i].size != entry_list[i].size) {
+            throw std::invalid_argument("Parameter layouts differ: " + entry_list[i].name);
+        }
+    }
+
+    shared_values = source.values();
+    for (const Entry& entry : entry_list) {
+        entry.value->bindStorage(shared_values + entry.offset, false);
+    }
+    value_buffer.resize(0);
+}
+
+// Обнулить все градиенты одним проходом
+void ParameterRegistry::zeroGrad() {
+    if (grad_buffer.size() > 0) {
+        std::memset(grad_buffer.data(), 0, grad_buffer.size() * sizeof(float));
+    }
+}
+
+float* ParameterRegistry::values() { return shared_values ? shared_values : value_buffer.data(); }
+const float* ParameterRegistry::values() const { return shared_values ? shared_values : value_buffer.data(); }
+float* ParameterRegistry::grads() { return grad_buffer.data(); }
+const float* ParameterRegistry::grads() const { return grad_buffer.data(); }
+
+// Размер буферов
+size_t ParameterRegistry::size() const {
+    return grad_buffer.size();
+}
+
+// Количество обучаемых элементов
+size_t ParameterRegistry::numParameters() const {
+    size_t total = 0;
+    for (const Entry& entry : entry_list) {
+        total += entry.size;
+    }
+    return total;
+}
+
+// Описание параметров
+const std::vector<ParameterRegistry::Entry>& ParameterRegistry::entries() const {
+    return entry_list;
+}
+
+// Найти параметр по полному имени
+const ParameterRegistry::Entry* ParameterRegistry::find(const std::string& name) const {
+    for (const Entry& entry : entry_list) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,80 @@
+#ifndef PARAMETER_H
+#define PARAMETER_H
+
+#include "tensor.h"
+#include "utils/aligned_buffer.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class Layer;
+
+// Именованный обучаемый параметр слоя и его градиент
+struct Parameter {
+    std::string name; // Имя внутри слоя (например, "weights")
+    Tensor* value;    // Значения параметра
+    Tensor* grad;     // Накопленный градиент той же формы
+};
+
+// Реестр параметров модели: значения и градиенты всех слоев хранятся
+// в двух непрерывных выровненных буферах, а тензоры слоев становятся видами на них.
+// Это позволяет оптимизатору обновлять всю модель одним линейным проходом.
+class ParameterRegistry {
+public:
+    // Параметр в общем буфере
+    struct Entry {
+        std::string name; // Полное имя: "<номер слоя>.<имя параметра>"
+        size_t offset;    // Смещение в буферах (кратно 64 байтам)
+        size_t size;      // Количество элементов
+        Tensor* value;
+        Tensor* grad;
+        size_t layer;     // Номер слоя в модели
+    };
+
+    ParameterRegistry() = default;
+    ~ParameterRegistry();
+
+    ParameterRegistry(const ParameterRegistry&) = delete;
+    ParameterRegistry& operator=(const ParameterRegistry&) = delete;
+
+    // Собрать параметры слоев в общие буферы (текущие значения и градиенты переносятся)
+    void build(const std::vector<std::shared_ptr<Layer>>& layers);
+
+    // Вернуть параметры в собственные хранилища тензоров и очистить реестр
+    void clear();
+
+    // Перевести значения параметров на буфер значений source (раскладка должна совпадать).
+    // Градиенты остаются собственными: так реплики модели делят веса, но накапливают
+    // градиенты независимо. source должен жить дольше этого реестра.
+    void shareValues(ParameterRegistry& source);
+
+    // Обнулить все градиенты
+    void zeroGrad();
+
+    // Непрерывные буферы значений и градиентов (включая выравнивающие промежутки, всегда нулевые)
+    float* values();
+    const float* values() const;
+    float* grads();
+    const float* grads() const;
+
+    // Размер буферов в элементах
+    size_t size() const;
+
+    // Количество обучаемых элементов (без выравнивания)
+    size_t numParameters() const;
+
+    // Описание параметров
+    const std::vector<Entry>& entries() const;
+
+    // Найти параметр по полному имени (nullptr, если не найден)
+    const Entry* find(const std::string& name) const;
+
+private:
+    AlignedBuffer value_buffer;                 // Значения всех параметров
+    AlignedBuffer grad_buffer;                  // Градиенты всех параметров
+    float* shared_values = nullptr;             // Чужой буфер значений (после shareValues)
+    std::vector<Entry> entry_list;              // Описание параметров
+    std::vector<std::shared_ptr<Layer>> owners; // Слои, чьи тензоры ссылаются на буферы
+};
+
+#endif // PARAMETER_H
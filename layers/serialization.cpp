@@ -0,0 +1,266 @@
+#include "serialization.h"
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+// Отображение, из которого readTensor текущего потока берет блобы
+thread_local const ModelMapping* active_mapping = nullptr;
+
+// Наибольший ранг тензора в блобе
+const uint32_t max_rank = 8;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void readBytes(std::istream& in, void* data, size_t size) {
+    in.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    if (static_cast<size_t>(in.gcount()) != size) {
+        throw std::runtime_error("Model file is truncated.");
+    }
+}
+
+// Таблицы CRC-32 для вычисления по 8 байт за шаг (slicing-by-8): tables[k][b] — вклад
+// байта b, за которым следуют k нулевых байтов
+std::array<std::array<uint32_t, 256>, 8> crcTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+        }
+        tables[0][i] = value;
+    }
+    for (size_t k = 1; k < 8; ++k) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+}
+
+// Запись значений
+void writeU32(std::ostream& out, uint32_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeU64(std::ostream& out, uint64_t value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeF32(std::ostream& out, float value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::ostream& out, const std::string& value) {
+    writeU32(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+// Чтение значений
+uint32_t readU32(std::istream& in) {
+    uint32_t value;
+    readBytes(in, &value, sizeof(value));
+    return value;
+}
+
+uint64_t readU64(std::istream& in) {
+    uint64_t value;
+    readBytes(in, &value, sizeof(value));
+    return value;
+}
+
+float readF32(std::istream& in) {
+    float value;
+    readBytes(in, &value, sizeof(value));
+    return value;
+}
+
+std::string readString(std::istream& in) {
+    uint32_t size = readU32(in);
+    if (size > 4096) {
+        throw std::runtime_error("Model file is corrupted: string is too long.");
+    }
+    std::string value(size, '\0');
+    readBytes(in, &value[0], size);
+    return value;
+}
+
+// Встроенная активация слоя
+void writeActivation(std::ostream& out, Activation activation) {
+    writeU32(out, static_cast<uint32_t>(activation));
+}
+
+Activation readActivation(std::istream& in) {
+    uint32_t code = readU32(in);
+    if (code > static_cast<uint32_t>(Activation::Tanh)) {
+        throw std::runtime_error("Model file is corrupted: unknown activation.");
+    }
+    return static_cast<Activation>(code);
+}
+
+// Проверить версию записи слоя
+void checkLayerVersion(const std::string& layer, uint32_t version, uint32_t supported) {
+    if (version == 0 || version > supported) {
+        throw std::runtime_error("Unsupported " + layer + " record version " + std::to_string(version) + ".");
+    }
+}
+
+// Состояние генератора
+void writeGenerator(std::ostream& out, const std::mt19937& generator) {
+    std::ostringstream text;
+    text << generator;
+    std::string state = text.str();
+    writeU32(out, static_cast<uint32_t>(state.size()));
+    out.write(state.data(), static_cast<std::streamsize>(state.size()));
+}
+
+void readGenerator(std::istream& in, std::mt19937& generator) {
+    uint32_t size = readU32(in);
+    if (size > (1u << 16)) {
+        throw std::runtime_error("Model file is corrupted: generator state is too long.");
+    }
+    std::string state(size, '\0');
+    readBytes(in, &state[0], size);
+    std::istringstream text(state);
+    text >> generator;
+    if (!text) {
+        throw std::runtime_error("Model file is corrupted: invalid generator state.");
+    }
+}
+
+// CRC-32
+uint32_t crc32(const void* data, size_t size) {
+    static const std::array<std::array<uint32_t, 256>, 8> table = crcTables();
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint32_t low, high;
+        std::memcpy(&low, bytes + i, 4);
+        std::memcpy(&high, bytes + i + 4, 4);
+        low ^= crc;
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^
+              table[4][low >> 24] ^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^
+              table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+    }
+    for (; i < size; ++i) {
+        crc = table[0][(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Записать тензор блобом
+void writeTensor(std::ostream& out, const Tensor& tensor) {
+    const std::vector<size_t>& shape = tensor.shape();
+    writeU32(out, static_cast<uint32_t>(shape.size()));
+    for (size_t dim : shape) {
+        writeU64(out, dim);
+    }
+    size_t bytes = tensor.size() * sizeof(float);
+    writeU64(out, tensor.size());
+    writeU32(out, crc32(tensor.data(), bytes));
+
+    static const char zeros[MODEL_ALIGNMENT] = {};
+    size_t position = static_cast<size_t>(out.tellp());
+    out.write(zeros, static_cast<std::streamsize>(alignUp(position, MODEL_ALIGNMENT) - position));
+    out.write(reinterpret_cast<const char*>(tensor.data()), static_cast<std::streamsize>(bytes));
+}
+
+// Прочитать блоб
+Tensor readTensor(std::istream& in) {
+    uint32_t rank = readU32(in);
+    if (rank == 0 || rank > max_rank) {
+        throw std::runtime_error("Model file is corrupted: invalid tensor rank.");
+    }
+    std::vector<size_t> shape(rank);
+    size_t size = 1;
+    for (uint32_t i = 0; i < rank; ++i) {
+        shape[i] = readU64(in);
+        size *= shape[i];
+    }
+    if (readU64(in) != size) {
+        throw std::runtime_error("Model file is corrupted: tensor size does not match its shape.");
+    }
+    uint32_t checksum = readU32(in);
+    size_t bytes = size * sizeof(float);
+    size_t offset = alignUp(static_cast<size_t>(in.tellg()), MODEL_ALIGNMENT);
+
+    const ModelMapping* mapping = active_mapping;
+    if (mapping) {
+        if (offset + bytes > mapping->length) {
+            throw std::runtime_error("Model file is truncated.");
+        }
+        // Отображение создано с PROT_WRITE | MAP_PRIVATE, поэтому снятие const безопасно
+        float* data = reinterpret_cast<float*>(static_cast<unsigned char*>(mapping->base) + offset);
+        if (mapping->verify && crc32(data, bytes) != checksum) {
+            throw std::runtime_error("Model file is corrupted: tensor checksum mismatch.");
+        }
+        in.seekg(static_cast<std::streamoff>(offset + bytes));
+        return Tensor::view(data, shape);
+    }
+
+    in.seekg(static_cast<std::streamoff>(offset));
+    Tensor tensor(shape);
+    readBytes(in, tensor.data(), bytes);
+    if (crc32(tensor.data(), bytes) != checksum) {
+        throw std::runtime_error("Model file is corrupted: tensor checksum mismatch.");
+    }
+    return tensor;
+}
+
+// Отобразить файл модели
+ModelMapping::ModelMapping(const std::string& path, bool verify) : base(nullptr), length(0), verify(verify) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open model file: " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ModelFileHeader)) {
+        close(fd);
+        throw std::runtime_error("Model file is truncated: " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+
+    // MAP_PRIVATE с правом записи: веса можно передавать слоям как обычные тензоры,
+    // случайная запись (например, шаг оптимизатора) изменит только копию страницы
+    base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Cannot map model file: " + path);
+    }
+}
+
+// Снять отображение
+ModelMapping::~ModelMapping() {
+    if (active_mapping == this) {
+        active_mapping = nullptr;
+    }
+    munmap(base, length);
+}
+
+// Источник блобов текущего потока
+void ModelMapping::activate(const ModelMapping* mapping) {
+    active_mapping = mapping;
+}
+
+const unsigned char* ModelMapping::data() const {
+    return static_cast<const unsigned char*>(base);
+}
+
+size_t ModelMapping::size() const {
+    return length;
+}
+
+// Заранее прочитать страницы
+void ModelMapping::prefetch() const {
+    madvise(base, length, MADV_WILLNEED);
+}
@@ -0,0 +1,97 @@
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include "tensor.h"
+#include "activations/activation.h"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <string>
+
+// Двоичный формат модели (*.kkm).
+//
+// Файл: заголовок (64 байта) | записи слоев по порядку.
+// Запись слоя (Layer::save): имя типа слоя, версия записи слоя, параметры конфигурации
+// и блобы тензоров. Блоб: ранг, форма, количество значений, CRC-32 данных, нули до
+// границы 64 байт от начала файла и данные float32. Выравнивание позволяет отобразить
+// файл в память и сделать тензоры видами прямо на страницы блобов.
+// Все числа — little-endian.
+
+// Заголовок файла модели
+struct ModelFileHeader {
+    char magic[4];       // "KKMD"
+    uint32_t version;    // Версия формата файла
+    uint32_t num_layers; // Количество записей слоев
+    uint32_t alignment;  // Выравнивание блобов
+    uint64_t file_bytes; // Размер файла (проверка на обрезку)
+    uint8_t reserved[40];
+};
+
+static_assert(sizeof(ModelFileHeader) == 64, "Model file header must be 64 bytes.");
+
+constexpr char MODEL_MAGIC[4] = {'K', 'K', 'M', 'D'};
+constexpr uint32_t MODEL_VERSION = 1;
+constexpr size_t MODEL_ALIGNMENT = 64;
+
+// Запись и чтение значений (ошибка чтения — std::runtime_error)
+void writeU32(std::ostream& out, uint32_t value);
+void writeU64(std::ostream& out, uint64_t value);
+void writeF32(std::ostream& out, float value);
+void writeString(std::ostream& out, const std::string& value);
+uint32_t readU32(std::istream& in);
+uint64_t readU64(std::istream& in);
+float readF32(std::istream& in);
+std::string readString(std::istream& in);
+
+// Встроенная активация слоя
+void writeActivation(std::ostream& out, Activation activation);
+Activation readActivation(std::istream& in);
+
+// Проверить версию записи слоя: версии новее поддерживаемой не читаются
+void checkLayerVersion(const std::string& layer, uint32_t version, uint32_t supported);
+
+// Записать тензор блобом
+void writeTensor(std::ostream& out, const Tensor& tensor);
+
+// Прочитать блоб. Если поток читает файл, отображенный в этом потоке через ModelMapping,
+// тензор становится видом на отображенные данные, иначе данные копируются и проверяются.
+Tensor readTensor(std::istream& in);
+
+// Состояние генератора std::mt19937 (текстовая форма стандартной библиотеки с длиной)
+void writeGenerator(std::ostream& out, const std::mt19937& generator);
+void readGenerator(std::istream& in, std::mt19937& generator);
+
+// CRC-32 (полином IEEE 802.3)
+uint32_t crc32(const void* data, size_t size);
+
+// Отображение файла модели в память (MAP_PRIVATE): страницы весов общие для всех процессов,
+// отобразивших файл, пока в них не пишут; запись создает частную копию страницы.
+// Пока объект активен (activate), readTensor в этом потоке возвращает виды на отображение.
+class ModelMapping {
+public:
+    // verify — проверять контрольные суммы блобов (читает все страницы весов)
+    ModelMapping(const std::string& path, bool verify);
+    ~ModelMapping();
+
+    ModelMapping(const ModelMapping&) = delete;
+    ModelMapping& operator=(const ModelMapping&) = delete;
+
+    // Сделать отображение источником блобов readTensor в текущем потоке (nullptr — отключить)
+    static void activate(const ModelMapping* mapping);
+
+    const unsigned char* data() const;
+    size_t size() const;
+
+    // Подсказка ядру заранее прочитать все страницы (madvise WILLNEED)
+    void prefetch() const;
+
+private:
+    friend Tensor readTensor(std::istream& in);
+    void* base;
+    size_t length;
+    bool verify;
+};
+
+#endif // SERIALIZATION_H
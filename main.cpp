@@ -9,6 +9,28 @@
 #include "metrics/accuracy.h"
 #include "metrics/cross_entropy.h"
 
+// Пример: многослойный перцептрон учится определять четверть плоскости, в которой лежит точка
 int main() {
+    const size_t samples = 512;
+    const size_t classes = 4;
+    Tensor inputs({samples, 2});
+    inputs.randomize(-1.0f, 1.0f);
+    Tensor targets({samples, classes});
+    for (size_t n = 0; n < samples; ++n) {
+        size_t quadrant = (inputs[2 * n] < 0.0f ? 1 : 0) + (inputs[2 * n + 1] < 0.0f ? 2 : 0);
+        targets[n * classes + quadrant] = 1.0f;
+    }
+
+    Model model;
+    model.addLayer(std::make_shared<DenseLayer>(2, 32));
+    model.addLayer(std::make_shared<ReLU>());
+    model.addLayer(std::make_shared<DenseLayer>(32, classes));
+    model.summary({samples, 2});
+
+    SGD optimizer(0.5f);
+    SoftmaxCrossEntropy loss;
+    model.train(inputs, targets, 200, optimizer, loss);
+
+    std::cout << "Accuracy: " << accuracy(model.infer(inputs), targets) << std::endl;
     return 0;
 }
@@ -0,0 +1,21 @@
+#include "accuracy.h"
+#include <algorithm>
+#include <stdexcept>
+
+// Доля верных предсказаний
+float accuracy(const Tensor& predictions, const Tensor& targets) {
+    if (predictions.size() != targets.size() || predictions.shape().empty() || predictions.size() == 0) {
+        throw std::invalid_argument("Predictions and targets must have the same non-empty shape.");
+    }
+    size_t classes = predictions.shape().back();
+    size_t rows = predictions.size() / classes;
+    size_t correct = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        const float* p = predictions.data() + r * classes;
+        const float* t = targets.data() + r * classes;
+        if (std::max_element(p, p + classes) - p == std::max_element(t, t + classes) - t) {
+            ++correct;
+        }
+    }
+    return static_cast<float>(correct) / static_cast<float>(rows);
+}
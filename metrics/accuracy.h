@@ -0,0 +1,11 @@
+#ifndef ACCURACY_H
+#define ACCURACY_H
+
+#include "tensor.h"
+
+// Доля верных предсказаний классификатора: пример засчитывается, если индекс наибольшего
+// значения предсказания (логиты или вероятности) совпадает с индексом наибольшего значения
+// цели (one-hot или распределение). Формы (classes) или (batch_size, classes).
+float accuracy(const Tensor& predictions, const Tensor& targets);
+
+#endif // ACCURACY_H
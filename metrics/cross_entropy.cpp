@@ -0,0 +1,67 @@
+#include "cross_entropy.h"
+#include "kernels/softmax.h"
+#include "kernels/dispatch.h"
+#include <stdexcept>
+
+// Конструктор
+SoftmaxCrossEntropy::SoftmaxCrossEntropy() : probabilities({}), target_cache({}) {}
+
+// Вычислить значение функции потерь
+float SoftmaxCrossEntropy::forward(const Tensor& logits, const Tensor& target) {
+    if (logits.size() != target.size() || logits.shape().empty()) {
+        throw std::invalid_argument("Logits and target must have the same shape.");
+    }
+
+    size_t classes = logits.shape().back();
+    size_t rows = logits.size() / classes;
+    probabilities = Tensor(logits.shape());
+    target_cache = target;
+
+    // loss = lse * sum(t) - sum(t * x); softmax получается из того же lse без второй нормировки.
+    // Два прохода по строке: онлайн log-sum-exp и запись softmax вместе с sum(t) и sum(t * x)
+    const float* x = logits.data();
+    const float* t = target.data();
+    float* y = probabilities.data();
+    const KernelTable& table = kernels();
+    double loss = 0.0;
+    for (size_t r = 0; r < rows; ++r) {
+        const float* xr = x + r * classes;
+        const float* tr = t + r * classes;
+        float* yr = y + r * classes;
+        loss += table.softmax_xent(xr, tr, logSumExp(xr, classes), yr, classes);
+    }
+
+    return static_cast<float>(loss / rows);
+}
+
+// Градиент по логитам
+Tensor SoftmaxCrossEntropy::backward() {
+    size_t classes = probabilities.shape().back();
+    size_t rows = probabilities.size() / classes;
+    float scale = 1.0f / rows;
+
+    Tensor grad(probabilities.shape());
+    const float* y = probabilities.data();
+    const float* t = target_cache.data();
+    float* g = grad.data();
+    for (size_t r = 0; r < rows; ++r) {
+        // Для целей, не нормированных к 1, градиент равен y * sum(t) - t
+        float target_sum = 0.0f;
+        for (size_t c = 0; c < classes; ++c) target_sum += t[r * classes + c];
+        for (size_t c = 0; c < classes; ++c) {
+            size_t i = r * classes + c;
+            g[i] = (y[i] * target_sum - t[i]) * scale;
+        }
+    }
+    return grad;
+}
+
+// Вероятности классов
+const Tensor& SoftmaxCrossEntropy::getProbabilities() const {
+    return probabilities;
+}
+
+// Копия функции потерь
+std::unique_ptr<Loss> SoftmaxCrossEntropy::clone() const {
+    return std::unique_ptr<Loss>(new SoftmaxCrossEntropy(*this));
+}
@@ -0,0 +1,30 @@
+#ifndef CROSS_ENTROPY_H
+#define CROSS_ENTROPY_H
+
+#include "loss.h"
+
+// Softmax, совмещенный с перекрестной энтропией.
+// Принимает логиты (classes) или (batch_size, classes) и цели той же формы
+// (one-hot или распределение вероятностей). Модель не должна заканчиваться слоем Softmax.
+class SoftmaxCrossEntropy : public Loss {
+public:
+    SoftmaxCrossEntropy();
+
+    // Среднее по батчу -sum(target * log_softmax(logits))
+    float forward(const Tensor& logits, const Tensor& target) override;
+
+    // Градиент по логитам: (softmax(logits) - target) / batch_size
+    Tensor backward() override;
+
+    // Копия функции потерь
+    std::unique_ptr<Loss> clone() const override;
+
+    // Вероятности классов, вычисленные последним вызовом forward
+    const Tensor& getProbabilities() const;
+
+private:
+    Tensor probabilities; // Кэш softmax(logits)
+    Tensor target_cache;  // Кэш целей
+};
+
+#endif // CROSS_ENTROPY_H
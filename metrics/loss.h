@@ -0,0 +1,23 @@
+#ifndef LOSS_H
+#define LOSS_H
+
+#include "tensor.h"
+#include <memory>
+
+// Базовый класс для функций потерь.
+// Предсказания и цели имеют форму (size) или (batch_size, ...); потери усредняются по батчу.
+class Loss {
+public:
+    virtual ~Loss() = default;
+
+    // Вычислить значение функции потерь
+    virtual float forward(const Tensor& prediction, const Tensor& target) = 0;
+
+    // Градиент по предсказаниям для последнего вызова forward
+    virtual Tensor backward() = 0;
+
+    // Копия функции потерь с собственными кэшами (для параллельного обучения)
+    virtual std::unique_ptr<Loss> clone() const = 0;
+};
+
+#endif // LOSS_H
@@ -0,0 +1,40 @@
+#include "mse.h"
+#include <stdexcept>
+
+// Конструктор
+MeanSquaredError::MeanSquaredError() : error_cache({}) {}
+
+// Вычислить значение функции потерь
+float MeanSquaredError::forward(const Tensor& prediction, const Tensor& target) {
+    if (prediction.size() != target.size()) {
+        throw std::invalid_argument("Prediction and target must have the same size.");
+    }
+
+    error_cache = prediction;
+    float* e = error_cache.data();
+    const float* t = target.data();
+    float loss = 0.0f;
+    for (size_t i = 0; i < error_cache.size(); ++i) {
+        e[i] -= t[i];
+        loss += e[i] * e[i];
+    }
+
+    return loss / error_cache.size();
+}
+
+// Градиент по предсказаниям: производная mean(e^2) по каждому элементу, 2 * e / (B * K),
+// поэтому шаг соответствует значению, которое возвращает forward
+Tensor MeanSquaredError::backward() {
+    Tensor grad = error_cache;
+    float scale = 2.0f / grad.size();
+    float* g = grad.data();
+    for (size_t i = 0; i < grad.size(); ++i) {
+        g[i] *= scale;
+    }
+    return grad;
+}
+
+// Копия функции потерь
+std::unique_ptr<Loss> MeanSquaredError::clone() const {
+    return std::unique_ptr<Loss>(new MeanSquaredError(*this));
+}
@@ -0,0 +1,24 @@
+#ifndef MSE_H
+#define MSE_H
+
+#include "loss.h"
+
+// Среднеквадратичная ошибка
+class MeanSquaredError : public Loss {
+public:
+    MeanSquaredError();
+
+    // Среднее (prediction - target)^2 по всем элементам
+    float forward(const Tensor& prediction, const Tensor& target) override;
+
+    // Точная производная среднего: 2 * (prediction - target) / число элементов
+    Tensor backward() override;
+
+    // Копия функции потерь
+    std::unique_ptr<Loss> clone() const override;
+
+private:
+    Tensor error_cache; // Кэш ошибки (prediction - target)
+};
+
+#endif // MSE_H
@@ -1,44 +1,1130 @@
 #include "model.h"
+#include "metrics/mse.h"
+#include "optimizers/sgd.h"
+#include "layers/serialization.h"
+#include "utils/memory_planner.h"
+#include "utils/profiler.h"
+#include "utils/thread_pool.h"
+#include "kernels/dispatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+// Количество элементов тензора заданной формы
+size_t shapeSize(const std::vector<size_t>& shape) {
+    size_t size = 1;
+    for (size_t dim : shape) {
+        size *= dim;
+    }
+    return size;
+}
+
+// Количество с десятичной приставкой: "950", "1.20 K", "3.4 G"
+std::string formatCount(double count) {
+    static const char* units[] = {"", " K", " M", " G", " T", " P"};
+    size_t unit = 0;
+    while (count >= 1000.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        count /= 1000.0;
+        ++unit;
+    }
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(unit == 0 || count >= 100.0 ? 0 : count >= 10.0 ? 1 : 2) << count
+         << units[unit];
+    return text.str();
+}
+
+// Форма тензора: "(128, 64)"
+std::string formatShape(const std::vector<size_t>& shape) {
+    std::string text = "(";
+    for (size_t i = 0; i < shape.size(); ++i) {
+        text += (i ? ", " : "") + std::to_string(shape[i]);
+    }
+    return text + ")";
+}
+
+// Размер в байтах с двоичной приставкой: "512 B", "1.50 KiB", "12.0 MiB"
+std::string formatBytes(size_t bytes) {
+    static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        value /= 1024.0;
+        ++unit;
+    }
+    std::ostringstream text;
+    if (unit == 0) {
+        text << bytes << " B";
+    } else {
+        text << std::fixed << std::setprecision(value < 10.0 ? 2 : value < 100.0 ? 1 : 0) << value << " " << units[unit];
+    }
+    return text.str();
+}
+
+// Открыть файл модели и проверить заголовок
+std::ifstream openModelFile(const std::string& path, ModelFileHeader& header) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Cannot open model file: " + path);
+    }
+    size_t length = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    if (length < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Model file is truncated: " + path);
+    }
+    if (std::memcmp(header.magic, MODEL_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a model file: " + path);
+    }
+    if (header.version == 0 || header.version > MODEL_VERSION) {
+        throw std::runtime_error("Unsupported model file version " + std::to_string(header.version) + ": " + path);
+    }
+    if (header.alignment != MODEL_ALIGNMENT || header.file_bytes != length) {
+        throw std::runtime_error("Model file is truncated or corrupted: " + path);
+    }
+    return file;
+}
+
+// Разделить вход по оси батча на части не больше rows примеров
+std::vector<Tensor> splitRows(const Tensor& input, size_t rows) {
+    const std::vector<size_t>& shape = input.shape();
+    if (rows == 0 || shape.size() < 2 || shape[0] <= rows) {
+        return {input};
+    }
+    size_t row_size = input.size() / shape[0];
+    std::vector<Tensor> parts;
+    for (size_t begin = 0; begin < shape[0]; begin += rows) {
+        std::vector<size_t> part_shape = shape;
+        part_shape[0] = std::min(rows, shape[0] - begin);
+        parts.emplace_back(part_shape);
+        std::memcpy(parts.back().data(), input.data() + begin * row_size,
+                    parts.back().size() * sizeof(float));
+    }
+    return parts;
+}
+
+// Собрать выходы частей по оси батча (слой может опустить ось у части из одного примера)
+Tensor concatRows(std::vector<Tensor>& parts, const std::vector<size_t>& part_rows) {
+    if (parts.size() == 1) {
+        return std::move(parts.front());
+    }
+    size_t total_rows = 0;
+    for (size_t rows : part_rows) {
+        total_rows += rows;
+    }
+    const Tensor& first = parts.front();
+    std::vector<size_t> shape = first.shape();
+    if (shape.size() > 1 && shape[0] == part_rows.front()) {
+        shape[0] = total_rows;
+    } else {
+        shape.insert(shape.begin(), total_rows);
+    }
+    Tensor output(shape);
+    size_t offset = 0;
+    for (const Tensor& part : parts) {
+        std::memcpy(output.data() + offset, part.data(), part.size() * sizeof(float));
+        offset += part.size();
+    }
+    if (offset != output.size()) {
+        throw std::runtime_error("Pipeline micro-batch outputs have inconsistent shapes.");
+    }
+    return output;
+}
+
+// Разбить последовательность стоимостей на count отрезков с наименьшим наибольшим отрезком;
+// возвращает начала отрезков
+std::vector<size_t> balancedBoundaries(const std::vector<double>& cost, size_t count) {
+    size_t n = cost.size();
+    count = std::max<size_t>(1, std::min(count, n));
+    std::vector<double> prefix(n + 1, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        prefix[i + 1] = prefix[i] + cost[i];
+    }
+    // best[k][i] — наименьший наибольший отрезок для первых i слоев в k отрезках
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<std::vector<double>> best(count + 1, std::vector<double>(n + 1, inf));
+    std::vector<std::vector<size_t>> split(count + 1, std::vector<size_t>(n + 1, 0));
+    best[0][0] = 0.0;
+    for (size_t k = 1; k <= count; ++k) {
+        for (size_t i = k; i <= n; ++i) {
+            for (size_t j = k - 1; j < i; ++j) {
+                double value = std::max(best[k - 1][j], prefix[i] - prefix[j]);
+                if (value < best[k][i]) {
+                    best[k][i] = value;
+                    split[k][i] = j;
+                }
+            }
+        }
+    }
+    std::vector<size_t> starts(count);
+    for (size_t k = count, i = n; k > 0; --k) {
+        i = split[k][i];
+        starts[k - 1] = i;
+    }
+    return starts;
+}
+}
 
 // Добавить слой в модель
 void Model::addLayer(std::shared_ptr<Layer> layer) {
+    resetPipeline();
     layers.push_back(layer);
+    parameters_dirty = true;
+    profile_ids.clear();
+    resetPlan();
 }
 
 // Прямой проход
 Tensor Model::predict(const Tensor& input) {
-    Tensor output = input;
+    if (layers.empty()) {
+        return input;
+    }
+    if (timing_enabled) {
+        layer_timings.resize(layers.size());
+    }
+    if (compiled && input.shape() == compiled_input_shape) {
+        return predictCompiled(input);
+    }
+    compiled_pass = false;
+    if (layer_cache_bytes.size() != layers.size()) {
+        layer_cache_bytes.assign(layers.size(), 0);
+        layer_peak_cache_bytes.assign(layers.size(), 0);
+        cache_bytes = 0;
+    }
+    if (checkpointing) {
+        return predictCheckpointed(input);
+    }
+
+    // Первый слой читает вход вызывающего, остальные могут работать на месте
+    auto start = std::chrono::steady_clock::now();
+    Tensor output = layers.front()->forward(input);
+    if (timing_enabled || Profiler::enabled()) {
+        recordLayer(0, true, input.shape(), start);
+    }
+    noteCache(0);
+    notePeak(output.size() * sizeof(float));
+    for (size_t i = 1; i < layers.size(); ++i) {
+        forwardLayer(i, output);
+    }
+    return output;
+}
+
+// Вывод без кэшей с внутренним контекстом
+Tensor Model::infer(const Tensor& input) {
+    if (infer_context.owner != this || infer_context.states.size() != layers.size()) {
+        infer_context = createContext();
+    }
+    return infer(input, infer_context);
+}
+
+// Вывод без кэшей с контекстом потока
+Tensor Model::infer(const Tensor& input, ExecutionContext& context) const {
+    if (context.owner != this || context.states.size() != layers.size()) {
+        throw std::invalid_argument("Execution context was created for a different model or layer list.");
+    }
+    if (layers.empty()) {
+        return input;
+    }
+    Tensor output = layers.front()->infer(input, context.states.front().get());
+    for (size_t i = 1; i < layers.size(); ++i) {
+        layers[i]->inferInPlace(output, context.states[i].get());
+    }
+    return output;
+}
+
+// Создать контекст вывода
+ExecutionContext Model::createContext() const {
+    ExecutionContext context;
+    context.owner = this;
     for (const auto& layer : layers) {
-        output = layer->forward(output);
+        context.states.push_back(layer->createState());
+    }
+    return context;
+}
+
+// Сбросить рекуррентное состояние слоев
+void ExecutionContext::reset() {
+    for (const auto& state : states) {
+        if (state) {
+            state->reset();
+        }
+    }
+}
+
+// Асинхронный вывод
+std::future<Tensor> Model::predictAsync(const Tensor& input) {
+    std::vector<Tensor> parts = splitRows(input, micro_batch_size);
+    // Запуск и постановка под одной блокировкой: исполнитель создается один раз, а
+    // микробатчи одного запроса идут в очередь подряд
+    std::lock_guard<std::mutex> lock(pipeline_mutex);
+    if (!pipeline) {
+        startPipeline(parts.front());
+    }
+
+    // Общий результат частей; части завершаются по порядку в потоке последней стадии
+    struct Job {
+        std::promise<Tensor> result;
+        std::vector<Tensor> outputs;
+        std::vector<size_t> rows;
+        std::exception_ptr error;
+        size_t remaining;
+    };
+    auto job = std::make_shared<Job>();
+    job->remaining = parts.size();
+    for (const Tensor& part : parts) {
+        job->rows.push_back(part.shape().empty() ? 1 : part.shape()[0]);
+        job->outputs.push_back(Tensor({0}));
+    }
+    std::future<Tensor> future = job->result.get_future();
+    for (size_t k = 0; k < parts.size(); ++k) {
+        pipeline->push(std::move(parts[k]), [job, k](Tensor&& output, std::exception_ptr error) {
+            if (error && !job->error) {
+                job->error = error;
+            }
+            job->outputs[k] = std::move(output);
+            if (--job->remaining > 0) {
+                return;
+            }
+            if (job->error) {
+                job->result.set_exception(job->error);
+                return;
+            }
+            try {
+                job->result.set_value(concatRows(job->outputs, job->rows));
+            } catch (...) {
+                job->result.set_exception(std::current_exception());
+            }
+        });
+    }
+    return future;
+}
+
+// Конвейер с автоматическими границами
+void Model::enablePipeline(size_t num_stages, size_t micro_batch) {
+    resetPipeline();
+    pipeline_stages = std::max<size_t>(1, num_stages);
+    pipeline_explicit = false;
+    pipeline_boundaries.clear();
+    micro_batch_size = micro_batch;
+}
+
+// Конвейер с явными границами
+void Model::setPipelineStages(std::vector<size_t> boundaries, size_t micro_batch) {
+    resetPipeline();
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+    if (boundaries.empty() || boundaries.front() != 0) {
+        boundaries.insert(boundaries.begin(), 0);
+    }
+    pipeline_stages = boundaries.size();
+    pipeline_explicit = true;
+    pipeline_boundaries = std::move(boundaries);
+    micro_batch_size = micro_batch;
+}
+
+// Один фоновый поток
+void Model::disablePipeline() {
+    enablePipeline(1, 0);
+}
+
+// Границы стадий работающего конвейера
+std::vector<size_t> Model::getPipelineStages() const {
+    std::lock_guard<std::mutex> lock(pipeline_mutex);
+    return pipeline ? pipeline_boundaries : std::vector<size_t>();
+}
+
+// Запустить конвейер
+void Model::startPipeline(const Tensor& sample) {
+    pipeline_context = createContext();
+    size_t n = layers.size();
+    std::vector<size_t> starts = pipeline_boundaries;
+    if (!pipeline_explicit) {
+        starts = {0};
+        if (pipeline_stages > 1 && n > 1) {
+            // Замер каждого слоя на примере; первый проход прогревает буферы и кэши
+            std::vector<double> cost(n, 0.0);
+            for (size_t pass = 0; pass < 2; ++pass) {
+                pipeline_context.reset();
+                Tensor data = sample;
+                for (size_t i = 0; i < n; ++i) {
+                    auto start = std::chrono::steady_clock::now();
+                    layers[i]->inferInPlace(data, pipeline_context.states[i].get());
+                    cost[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                }
+            }
+            starts = balancedBoundaries(cost, pipeline_stages);
+        }
+    }
+    starts.erase(std::lower_bound(starts.begin(), starts.end(), std::max<size_t>(n, 1)), starts.end());
+    if (starts.empty()) {
+        starts.push_back(0);
+    }
+    pipeline_boundaries = starts;
+
+    std::vector<StagePipeline::Stage> stages;
+    for (size_t k = 0; k < starts.size(); ++k) {
+        size_t begin = starts[k];
+        size_t end = k + 1 < starts.size() ? starts[k + 1] : n;
+        // Стадия использует только состояния своих слоев, поэтому общий контекст безопасен
+        stages.push_back([this, begin, end](Tensor& data) {
+            for (size_t i = begin; i < end; ++i) {
+                LayerState* state = pipeline_context.states[i].get();
+                if (state) {
+                    state->reset();
+                }
+                layers[i]->inferInPlace(data, state);
+            }
+        });
+    }
+    pipeline.reset(new StagePipeline(std::move(stages)));
+}
+
+// Остановить конвейер
+void Model::resetPipeline() {
+    std::lock_guard<std::mutex> lock(pipeline_mutex);
+    pipeline.reset();
+    if (!pipeline_explicit) {
+        pipeline_boundaries.clear();
+    }
+}
+
+// Обратный проход
+Tensor Model::backward(Tensor grad_output) {
+    if (timing_enabled) {
+        layer_timings.resize(layers.size());
+    }
+    if (compiled_pass) {
+        return backwardCompiled(grad_output);
+    }
+    if (!segments.empty()) {
+        return backwardCheckpointed(std::move(grad_output));
+    }
+    for (size_t i = layers.size(); i-- > 0;) {
+        backwardLayer(i, grad_output);
+    }
+    return grad_output;
+}
+
+// Прямой проход слоя на месте
+void Model::forwardLayer(size_t i, Tensor& data) {
+    if (!timing_enabled && !Profiler::enabled()) {
+        layers[i]->forwardInPlace(data);
+    } else {
+        std::vector<size_t> input_shape = data.shape(); // Проход на месте меняет форму данных
+        auto start = std::chrono::steady_clock::now();
+        layers[i]->forwardInPlace(data);
+        recordLayer(i, true, input_shape, start);
+    }
+    noteCache(i);
+    notePeak(data.size() * sizeof(float));
+}
+
+// Обратный проход слоя на месте
+void Model::backwardLayer(size_t i, Tensor& grad) {
+    if (!timing_enabled && !Profiler::enabled()) {
+        layers[i]->backwardInPlace(grad);
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        layers[i]->backwardInPlace(grad);
+        recordLayer(i, false, grad.shape(), start); // Градиент по входу имеет форму входа
+    }
+    notePeak(grad.size() * sizeof(float));
+    if (backward_hook) {
+        backward_hook(i);
+    }
+}
+
+// Учесть время прохода слоя и записать его в профилировщик
+void Model::recordLayer(size_t i, bool forward, const std::vector<size_t>& input_shape,
+                        std::chrono::steady_clock::time_point start) {
+    auto end = std::chrono::steady_clock::now();
+    if (timing_enabled && i < layer_timings.size()) {
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (forward) {
+            layer_timings[i].forward_seconds += seconds;
+            layer_timings[i].calls += 1;
+        } else {
+            layer_timings[i].backward_seconds += seconds;
+        }
+    }
+    if (Profiler::enabled()) {
+        // Имена областей: "<номер>.<тип слоя>.forward" и ".backward"
+        if (profile_ids.size() != 2 * layers.size()) {
+            profile_ids.clear();
+            for (size_t l = 0; l < layers.size(); ++l) {
+                std::string name = std::to_string(l) + "." + layers[l]->getName();
+                profile_ids.push_back(Profiler::global().intern(name + ".forward", "forward"));
+                profile_ids.push_back(Profiler::global().intern(name + ".backward", "backward"));
+            }
+        }
+        LayerCost cost = layers[i]->cost(input_shape);
+        Profiler::global().record(profile_ids[2 * i + (forward ? 0 : 1)], start, end,
+                                  forward ? cost.forward_flops : cost.backward_flops,
+                                  forward ? cost.forward_bytes : cost.backward_bytes);
+    }
+}
+
+// Обновить учтенный объем кэша слоя
+void Model::noteCache(size_t i) {
+    size_t bytes = layers[i]->cacheBytes();
+    cache_bytes = cache_bytes - layer_cache_bytes[i] + bytes;
+    layer_cache_bytes[i] = bytes;
+    layer_peak_cache_bytes[i] = std::max(layer_peak_cache_bytes[i], bytes);
+}
+
+// Освободить кэш слоя
+void Model::releaseLayerCache(size_t i) {
+    layers[i]->releaseCache();
+    noteCache(i);
+}
+
+// Обновить пик: кэши, контрольные точки и живые тензоры прохода
+void Model::notePeak(size_t live_bytes) {
+    peak_bytes = std::max(peak_bytes, cache_bytes + checkpoint_bytes + live_bytes);
+}
+
+// Вывести формы по цепочке слоев
+std::vector<std::vector<size_t>> Model::inferShapes(const std::vector<size_t>& input_shape) {
+    std::vector<std::vector<size_t>> shapes{input_shape};
+    for (size_t i = 0; i < layers.size(); ++i) {
+        try {
+            shapes.push_back(layers[i]->inferShape(shapes.back()));
+        } catch (const std::invalid_argument& error) {
+            throw std::invalid_argument("Layer " + std::to_string(i) + ": " + error.what());
+        }
+    }
+    return shapes;
+}
+
+// Разбить слои на сегменты
+std::vector<Model::Segment> Model::planSegments() const {
+    size_t n = layers.size();
+    std::vector<size_t> starts = checkpoint_boundaries;
+    if (starts.empty()) {
+        size_t count = checkpoint_segments ? checkpoint_segments
+                                           : static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+        count = std::max<size_t>(1, std::min(count, n));
+        for (size_t k = 0; k < count; ++k) {
+            starts.push_back(k * n / count);
+        }
+    }
+    starts.push_back(0);
+
+    // Слои с побочными эффектами прямого прохода (случайность, скользящие статистики, состояние)
+    // нельзя пересчитать: они выделяются в отдельные сегменты, кэши которых хранятся
+    for (size_t i = 0; i < n; ++i) {
+        if (!layers[i]->isRecomputable()) {
+            starts.push_back(i);
+            starts.push_back(i + 1);
+        }
+    }
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    starts.erase(std::lower_bound(starts.begin(), starts.end(), n), starts.end());
+
+    std::vector<Segment> plan;
+    for (size_t k = 0; k < starts.size(); ++k) {
+        Segment segment{starts[k], k + 1 < starts.size() ? starts[k + 1] : n, true};
+        // Последний сегмент сразу используется обратным проходом, пересчитывать его незачем
+        segment.recompute = segment.end != n;
+        for (size_t i = segment.begin; i < segment.end && segment.recompute; ++i) {
+            segment.recompute = layers[i]->isRecomputable();
+        }
+        plan.push_back(segment);
+    }
+    return plan;
+}
+
+// Прямой проход с контрольными точками
+Tensor Model::predictCheckpointed(const Tensor& input) {
+    segments = planSegments();
+    checkpoints.clear();
+    checkpoint_bytes = 0;
+
+    Tensor output = input;
+    for (const Segment& segment : segments) {
+        if (segment.recompute) {
+            checkpoints.push_back(output);
+            checkpoint_bytes += output.size() * sizeof(float);
+        } else {
+            checkpoints.push_back(Tensor({0}));
+        }
+        for (size_t i = segment.begin; i < segment.end; ++i) {
+            forwardLayer(i, output);
+        }
+        if (segment.recompute) {
+            for (size_t i = segment.begin; i < segment.end; ++i) {
+                releaseLayerCache(i);
+            }
+        }
     }
     return output;
 }
 
+// Обратный проход с пересчетом сегментов
+Tensor Model::backwardCheckpointed(Tensor grad_output) {
+    for (size_t s = segments.size(); s-- > 0;) {
+        const Segment& segment = segments[s];
+        if (segment.recompute) {
+            // Повторный прямой проход восстанавливает кэши слоев сегмента
+            auto start = std::chrono::steady_clock::now();
+            Tensor data = std::move(checkpoints[s]);
+            checkpoint_bytes -= data.size() * sizeof(float);
+            for (size_t i = segment.begin; i < segment.end; ++i) {
+                layers[i]->forwardInPlace(data);
+                noteCache(i);
+                notePeak((data.size() + grad_output.size()) * sizeof(float));
+            }
+            recompute_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        for (size_t i = segment.end; i-- > segment.begin;) {
+            backwardLayer(i, grad_output);
+        }
+        for (size_t i = segment.begin; i < segment.end; ++i) {
+            releaseLayerCache(i);
+        }
+    }
+    segments.clear();
+    checkpoints.clear();
+    checkpoint_bytes = 0;
+    return grad_output;
+}
+
+// Включить контрольные точки с автоматическими или равными сегментами
+void Model::enableCheckpointing(size_t num_segments) {
+    if (compiled) {
+        throw std::logic_error("Checkpointing cannot be enabled for a compiled model.");
+    }
+    checkpointing = true;
+    checkpoint_segments = num_segments;
+    checkpoint_boundaries.clear();
+}
+
+// Включить контрольные точки с явными границами
+void Model::setCheckpoints(std::vector<size_t> boundaries) {
+    if (compiled) {
+        throw std::logic_error("Checkpointing cannot be enabled for a compiled model.");
+    }
+    checkpointing = true;
+    checkpoint_segments = 0;
+    checkpoint_boundaries = std::move(boundaries);
+    if (checkpoint_boundaries.empty()) {
+        checkpoint_boundaries.push_back(0);
+    }
+}
+
+// Выключить контрольные точки
+void Model::disableCheckpointing() {
+    checkpointing = false;
+    segments.clear();
+    checkpoints.clear();
+    checkpoint_bytes = 0;
+}
+
+// Пиковый объем активаций
+size_t Model::getPeakActivationBytes() const {
+    return peak_bytes;
+}
+
+// Сбросить пик (учитываются кэши, которые слои держат сейчас)
+void Model::resetPeakActivationBytes() {
+    layer_cache_bytes.assign(layers.size(), 0);
+    layer_peak_cache_bytes.assign(layers.size(), 0);
+    cache_bytes = 0;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        noteCache(i);
+    }
+    peak_bytes = cache_bytes + checkpoint_bytes;
+}
+
+// Время повторных прямых проходов
+double Model::getRecomputeSeconds() const {
+    return recompute_seconds;
+}
+
+// Учет памяти обучения
+MemoryUsage Model::getMemoryUsage(const Optimizer* optimizer) const {
+    MemoryUsage usage;
+    size_t state_size = optimizer ? optimizer->stateSizePerParameter() : 0;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        LayerMemory memory;
+        memory.name = std::to_string(i) + "." + layers[i]->getName();
+        size_t count = layers[i]->getNumParameters();
+        memory.parameters = count * sizeof(float);
+        memory.gradients = count * sizeof(float);
+        memory.optimizer = count * state_size * sizeof(float);
+        if (!compiled && i < layer_peak_cache_bytes.size()) {
+            memory.cache = layer_peak_cache_bytes[i];
+        }
+        memory.scratch = layers[i]->scratchBytes();
+        usage.persistent += memory.parameters + memory.gradients + memory.optimizer + memory.scratch;
+        usage.layers.push_back(std::move(memory));
+    }
+    usage.activations = compiled ? planned_bytes : cache_bytes + checkpoint_bytes;
+    usage.peak_activations = std::max(peak_bytes, usage.activations);
+    usage.live = usage.persistent + usage.activations;
+    usage.peak = usage.persistent + usage.peak_activations;
+    return usage;
+}
+
+// Напечатать учет памяти
+void Model::reportMemory(std::ostream& out, const Optimizer* optimizer) const {
+    MemoryUsage usage = getMemoryUsage(optimizer);
+    // Таблица собирается в своем потоке: манипуляторы ширины и выравнивания не меняют out
+    std::ostringstream text;
+    size_t width = 8;
+    for (const LayerMemory& memory : usage.layers) {
+        width = std::max(width, memory.name.size() + 2);
+    }
+    text << std::left << std::setw(static_cast<int>(width)) << "layer" << std::right << std::setw(12) << "params"
+        << std::setw(12) << "grads" << std::setw(12) << "optimizer" << std::setw(12) << "cache" << std::setw(12)
+        << "scratch" << std::setw(12) << "total" << "\n";
+    LayerMemory sum;
+    sum.name = "total";
+    for (const LayerMemory& memory : usage.layers) {
+        sum.parameters += memory.parameters;
+        sum.gradients += memory.gradients;
+        sum.optimizer += memory.optimizer;
+        sum.cache += memory.cache;
+        sum.scratch += memory.scratch;
+    }
+    usage.layers.push_back(sum);
+    for (const LayerMemory& memory : usage.layers) {
+        text << std::left << std::setw(static_cast<int>(width)) << memory.name << std::right << std::setw(12)
+            << formatBytes(memory.parameters) << std::setw(12) << formatBytes(memory.gradients) << std::setw(12)
+            << formatBytes(memory.optimizer) << std::setw(12) << formatBytes(memory.cache) << std::setw(12)
+            << formatBytes(memory.scratch) << std::setw(12) << formatBytes(memory.total()) << "\n";
+    }
+    text << "persistent: " << formatBytes(usage.persistent) << "\n";
+    text << "activations: " << formatBytes(usage.activations) << " live, " << formatBytes(usage.peak_activations)
+        << " peak\n";
+    text << "memory: " << formatBytes(usage.live) << " live, " << formatBytes(usage.peak) << " peak\n";
+    out << text.str();
+}
+
+// Сводка по слоям
+std::vector<LayerSummary> Model::summarize(const std::vector<size_t>& input_shape, const Roofline& roofline) {
+    std::vector<std::vector<size_t>> shapes = inferShapes(input_shape);
+    std::vector<LayerSummary> rows;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        LayerSummary row;
+        row.name = std::to_string(i) + "." + layers[i]->getName();
+        row.input_shape = shapes[i];
+        row.output_shape = shapes[i + 1];
+        row.parameters = layers[i]->getNumParameters();
+        row.cost = layers[i]->cost(shapes[i]);
+        row.forward_seconds = roofline.predictSeconds(row.cost.forward_flops, row.cost.forward_bytes);
+        row.backward_seconds = roofline.predictSeconds(row.cost.backward_flops, row.cost.backward_bytes);
+        row.forward_memory_bound = roofline.memoryBound(row.cost.forward_flops, row.cost.forward_bytes);
+        row.backward_memory_bound = roofline.memoryBound(row.cost.backward_flops, row.cost.backward_bytes);
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+// Напечатать сводку
+void Model::summary(const std::vector<size_t>& input_shape, std::ostream& out) {
+    if (layers.empty()) {
+        out << "empty model\n";
+        return;
+    }
+    std::vector<size_t> shape = input_shape.empty() ? layers.front()->getInputShape() : input_shape;
+    if (shape.empty()) {
+        throw std::invalid_argument("Model summary needs an input shape: the first layer does not know it yet.");
+    }
+    const Roofline& roofline = machineRoofline();
+    std::vector<LayerSummary> rows = summarize(shape, roofline);
+
+    size_t width = 8;
+    size_t shape_width = 8;
+    for (const LayerSummary& row : rows) {
+        width = std::max(width, row.name.size() + 2);
+        shape_width = std::max(shape_width, formatShape(row.output_shape).size() + 2);
+    }
+    // Сводка собирается в своем потоке: точность и формат чисел не меняют out
+    std::ostringstream text;
+    const CpuFeatures& cpu = cpuFeatures();
+    text << "machine: " << (cpu.brand.empty() ? "unknown cpu" : cpu.brand) << ", "
+        << isaName(KernelRegistry::global().getIsa()) << " kernels, " << ThreadPool::global().concurrency()
+        << " threads\n";
+    // Проходы выполняются одним потоком, поэтому потолки — одного исполнителя, а не всего пула
+    text << std::fixed << std::setprecision(1) << "roofline (" << roofline.executors
+        << (roofline.executors == 1 ? " thread): " : " threads): ") << roofline.peak_gflops << " GFLOP/s, "
+        << roofline.bandwidth_gbs << " GB/s, ridge " << std::setprecision(2) << roofline.ridge() << " FLOP/B\n"
+        << std::defaultfloat;
+    text << "input: " << formatShape(shape) << "\n";
+    text << std::left << std::setw(static_cast<int>(width)) << "layer" << std::setw(static_cast<int>(shape_width))
+        << "output" << std::right << std::setw(10) << "params" << std::setw(10) << "fwd FLOP" << std::setw(10)
+        << "bwd FLOP" << std::setw(11) << "fwd bytes" << std::setw(11) << "bwd bytes" << std::setw(8) << "fwd AI"
+        << std::setw(8) << "bwd AI" << std::setw(10) << "fwd us" << std::setw(10) << "bwd us" << "  bound\n";
+    size_t parameters = 0;
+    LayerCost total;
+    double forward_seconds = 0.0;
+    double backward_seconds = 0.0;
+    for (const LayerSummary& row : rows) {
+        parameters += row.parameters;
+        total.forward_flops += row.cost.forward_flops;
+        total.forward_bytes += row.cost.forward_bytes;
+        total.backward_flops += row.cost.backward_flops;
+        total.backward_bytes += row.cost.backward_bytes;
+        forward_seconds += row.forward_seconds;
+        backward_seconds += row.backward_seconds;
+        text << std::left << std::setw(static_cast<int>(width)) << row.name
+            << std::setw(static_cast<int>(shape_width)) << formatShape(row.output_shape) << std::right
+            << std::setw(10) << row.parameters << std::setw(10) << formatCount(row.cost.forward_flops)
+            << std::setw(10) << formatCount(row.cost.backward_flops) << std::setw(11)
+            << formatBytes(static_cast<size_t>(row.cost.forward_bytes)) << std::setw(11)
+            << formatBytes(static_cast<size_t>(row.cost.backward_bytes)) << std::fixed << std::setprecision(2)
+            << std::setw(8) << row.forwardIntensity() << std::setw(8) << row.backwardIntensity()
+            << std::setprecision(1) << std::setw(10) << row.forward_seconds * 1e6 << std::setw(10)
+            << row.backward_seconds * 1e6 << std::defaultfloat << "  "
+            << (row.forward_memory_bound ? "memory" : "compute") << "/"
+            << (row.backward_memory_bound ? "memory" : "compute") << "\n";
+    }
+    text << std::left << std::setw(static_cast<int>(width + shape_width)) << "total" << std::right << std::setw(10)
+        << parameters << std::setw(10) << formatCount(total.forward_flops) << std::setw(10)
+        << formatCount(total.backward_flops) << std::setw(11) << formatBytes(static_cast<size_t>(total.forward_bytes))
+        << std::setw(11) << formatBytes(static_cast<size_t>(total.backward_bytes)) << "\n";
+    text << "parameters: " << parameters << " (" << formatBytes(parameters * sizeof(float)) << ")\n";
+
+    // Время шага обучения по потолкам: прямой и обратный проходы всех слоев
+    double step_seconds = forward_seconds + backward_seconds;
+    double batch = shape.size() > 1 ? static_cast<double>(shape[0]) : 1.0;
+    text << std::fixed << std::setprecision(3) << "predicted: forward " << forward_seconds * 1e3 << " ms, train step "
+        << step_seconds * 1e3 << " ms" << std::setprecision(0);
+    if (step_seconds > 0.0) {
+        text << " (" << batch / step_seconds << " samples/s)";
+    }
+    text << "\n";
+    out << text.str();
+}
+
+// Скомпилировать план памяти под форму входа
+std::vector<size_t> Model::compile(const std::vector<size_t>& input_shape, bool training) {
+    if (checkpointing) {
+        throw std::logic_error("A model with checkpointing cannot be compiled.");
+    }
+    if (layers.empty()) {
+        throw std::logic_error("Cannot compile a model without layers.");
+    }
+    resetPlan();
+
+    // Формы: shapes[i] — вход слоя i, shapes[n] — выход модели
+    size_t n = layers.size();
+    std::vector<std::vector<size_t>> shapes = inferShapes(input_shape);
+
+    // Шаги: прямой проход слоя i — шаг i, обратный — шаг 2n - 1 - i; выход модели
+    // (и градиент по входу) живут до конца плана, пока ими пользуется вызывающий
+    size_t end = training ? 2 * n : n;
+    MemoryPlanner planner;
+    std::vector<size_t> activation_buffer(n + 1);
+    std::vector<size_t> gradient_buffer(n + 1);
+    activation_buffer[0] = planner.add(shapeSize(shapes[0]), 0, 0);
+    if (training && layers[0]->backwardNeedsInput()) {
+        planner.extend(activation_buffer[0], 2 * n - 1);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        // Вход можно затереть, если его больше никто не прочитает
+        bool input_dead = !training || (!layers[i]->backwardNeedsInput() &&
+                                        (i == 0 || !layers[i - 1]->backwardNeedsOutput()));
+        size_t last = i + 1 == n ? end : i + 1;
+        if (layers[i]->supportsInPlace() && input_dead && shapeSize(shapes[i + 1]) == shapeSize(shapes[i])) {
+            activation_buffer[i + 1] = activation_buffer[i];
+            planner.extend(activation_buffer[i + 1], last);
+        } else {
+            activation_buffer[i + 1] = planner.add(shapeSize(shapes[i + 1]), i, last);
+        }
+        if (training && layers[i]->backwardNeedsOutput()) {
+            planner.extend(activation_buffer[i + 1], 2 * n - 1 - i);
+        }
+        if (training && i + 1 < n && layers[i + 1]->backwardNeedsInput()) {
+            planner.extend(activation_buffer[i + 1], 2 * n - 2 - i);
+        }
+    }
+    if (training) {
+        gradient_buffer[n] = planner.add(shapeSize(shapes[n]), n, n);
+        for (size_t i = n; i-- > 0;) {
+            size_t step = 2 * n - 1 - i;
+            size_t last = i == 0 ? end : step + 1;
+            if (layers[i]->supportsInPlace() && shapeSize(shapes[i]) == shapeSize(shapes[i + 1])) {
+                gradient_buffer[i] = gradient_buffer[i + 1];
+                planner.extend(gradient_buffer[i], last);
+            } else {
+                gradient_buffer[i] = planner.add(shapeSize(shapes[i]), step, last);
+            }
+        }
+    }
+
+    arena.resize(planner.plan());
+    planned_bytes = planner.totalSize() * sizeof(float);
+    unplanned_bytes = 0;
+    for (size_t i = 0; i <= n; ++i) {
+        activations.push_back(Tensor::view(arena.data() + planner.offset(activation_buffer[i]), shapes[i]));
+        unplanned_bytes += AlignedBuffer::alignedCount(shapeSize(shapes[i])) * sizeof(float);
+        if (training) {
+            gradients.push_back(Tensor::view(arena.data() + planner.offset(gradient_buffer[i]), shapes[i]));
+            unplanned_bytes += AlignedBuffer::alignedCount(shapeSize(shapes[i])) * sizeof(float);
+        }
+    }
+
+    compiled = true;
+    compiled_training = training;
+    compiled_input_shape = input_shape;
+    return shapes.back();
+}
+
+// Есть ли скомпилированный план
+bool Model::isCompiled() const {
+    return compiled;
+}
+
+// Размер области плана
+size_t Model::getPlannedBytes() const {
+    return planned_bytes;
+}
+
+// Размер тензоров плана без повторного использования памяти
+size_t Model::getUnplannedBytes() const {
+    return unplanned_bytes;
+}
+
+// Сбросить план
+void Model::resetPlan() {
+    if (compiled) {
+        for (const auto& layer : layers) {
+            layer->releaseCache();
+        }
+    }
+    compiled = false;
+    compiled_pass = false;
+    activations.clear();
+    gradients.clear();
+    arena = AlignedBuffer();
+    planned_bytes = 0;
+    unplanned_bytes = 0;
+}
+
+// Прямой проход слоя по буферам плана
+void Model::forwardLayerInto(size_t i) {
+    if (!timing_enabled && !Profiler::enabled()) {
+        layers[i]->forwardInto(activations[i], activations[i + 1]);
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        layers[i]->forwardInto(activations[i], activations[i + 1]);
+        recordLayer(i, true, activations[i].shape(), start);
+    }
+}
+
+// Обратный проход слоя по буферам плана
+void Model::backwardLayerInto(size_t i) {
+    if (!timing_enabled && !Profiler::enabled()) {
+        layers[i]->backwardInto(gradients[i + 1], gradients[i]);
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        layers[i]->backwardInto(gradients[i + 1], gradients[i]);
+        recordLayer(i, false, gradients[i].shape(), start);
+    }
+    if (backward_hook) {
+        backward_hook(i);
+    }
+}
+
+// Прямой проход по плану
+Tensor Model::predictCompiled(const Tensor& input) {
+    activations.front().copyFrom(input);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        forwardLayerInto(i);
+    }
+    compiled_pass = true;
+    peak_bytes = std::max(peak_bytes, planned_bytes);
+    Tensor& output = activations.back();
+    return Tensor::view(output.data(), output.shape());
+}
+
+// Обратный проход по плану
+Tensor Model::backwardCompiled(const Tensor& grad_output) {
+    if (!compiled_training) {
+        throw std::logic_error("The model was compiled for inference only.");
+    }
+    gradients.back().copyFrom(grad_output);
+    for (size_t i = layers.size(); i-- > 0;) {
+        backwardLayerInto(i);
+    }
+    compiled_pass = false;
+    Tensor& grad_input = gradients.front();
+    return Tensor::view(grad_input.data(), grad_input.shape());
+}
+
+// Уведомление о готовности градиентов слоя
+void Model::setBackwardHook(std::function<void(size_t)> hook) {
+    backward_hook = std::move(hook);
+}
+
+// Реестр параметров модели
+ParameterRegistry& Model::getParameters() {
+    if (parameters_dirty) {
+        parameters.build(layers);
+        parameters_dirty = false;
+    }
+    return parameters;
+}
+
+// Обнулить градиенты всех параметров
+void Model::zeroGrad() {
+    getParameters().zeroGrad();
+}
+
+// Создать реплику модели с общими весами
+std::unique_ptr<Model> Model::replicate(size_t index) {
+    ParameterRegistry& source = getParameters();
+    std::unique_ptr<Model> replica(new Model());
+    for (const auto& layer : layers) {
+        std::shared_ptr<Layer> copy = layer->clone();
+        copy->reseed(index);
+        replica->addLayer(copy);
+    }
+    replica->getParameters().shareValues(source);
+    replica->checkpointing = checkpointing;
+    replica->checkpoint_segments = checkpoint_segments;
+    replica->checkpoint_boundaries = checkpoint_boundaries;
+    if (compiled) {
+        replica->compile(compiled_input_shape, compiled_training);
+    }
+    return replica;
+}
+
 // Обучение модели
 void Model::train(const Tensor& input, const Tensor& target, size_t epochs, float learning_rate) {
+    MeanSquaredError loss;
+    train(input, target, epochs, learning_rate, loss);
+}
+
+// Обучение модели с заданной функцией потерь
+void Model::train(const Tensor& input, const Tensor& target, size_t epochs, float learning_rate, Loss& loss) {
+    SGD optimizer(learning_rate);
+    train(input, target, epochs, optimizer, loss);
+}
+
+// Обучение модели с заданными оптимизатором и функцией потерь
+void Model::train(const Tensor& input, const Tensor& target, size_t epochs, Optimizer& optimizer, Loss& loss) {
+    ParameterRegistry& registry = getParameters();
     for (size_t epoch = 0; epoch < epochs; ++epoch) {
         // Прямой проход
         Tensor output = predict(input);
 
         // Вычисление ошибки
-        Tensor error = output - target;
-        float loss = 0.0f;
-        for (size_t i = 0; i < error.size(); ++i) {
-            loss += error({i}) * error({i});
-        }
-        loss /= error.size();
+        float loss_value = loss.forward(output, target);
 
-        // Обратный проход
-        Tensor grad_output = error;
-        for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
-            grad_output = (*it)->backward(grad_output, learning_rate);
-        }
+        // Обратный проход накапливает градиенты, затем один шаг по всей модели
+        registry.zeroGrad();
+        backward(loss.backward());
+        optimizer.step(registry);
+
+        std::cout << "Epoch " << epoch << ", Loss: " << loss_value << '\n';
+    }
+    std::cout.flush();
+}
 
-        std::cout << "Epoch " << epoch << ", Loss: " << loss << std::endl;
+// Встроить активации в эпилог предшествующих слоев
+size_t Model::fuseActivations() {
+    resetPipeline();
+    size_t fused = 0;
+    for (size_t i = 0; i + 1 < layers.size();) {
+        Activation activation = layers[i + 1]->fusableActivation();
+        if (activation != Activation::None && layers[i]->fuseActivation(activation)) {
+            layers.erase(layers.begin() + i + 1);
+            parameters_dirty = true;
+            profile_ids.clear();
+            resetPlan();
+            ++fused;
+        } else {
+            ++i;
+        }
     }
+    return fused;
 }
 
 // Получить слои модели
 const std::vector<std::shared_ptr<Layer>>& Model::getLayers() const {
     return layers;
 }
+
+// Сохранить модель
+void Model::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot create model file: " + path);
+    }
+    ModelFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MODEL_MAGIC, sizeof(header.magic));
+    header.version = MODEL_VERSION;
+    header.num_layers = static_cast<uint32_t>(layers.size());
+    header.alignment = MODEL_ALIGNMENT;
+
+    // Размер файла известен после записи слоев: заголовок перезаписывается в конце
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& layer : layers) {
+        layer->save(file);
+    }
+    header.file_bytes = static_cast<uint64_t>(file.tellp());
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Cannot write model file: " + path);
+    }
+}
+
+// Загрузить модель с копированием весов
+std::unique_ptr<Model> Model::load(const std::string& path) {
+    ModelFileHeader header;
+    std::ifstream file = openModelFile(path, header);
+    std::unique_ptr<Model> model(new Model());
+    for (uint32_t i = 0; i < header.num_layers; ++i) {
+        model->addLayer(Layer::load(file));
+    }
+    return model;
+}
+
+// Загрузить модель с отображением файла
+std::unique_ptr<Model> Model::loadMapped(const std::string& path, bool verify) {
+    ModelFileHeader header;
+    std::ifstream file = openModelFile(path, header);
+    std::unique_ptr<Model> model(new Model());
+    model->mapping = std::make_shared<ModelMapping>(path, verify);
+
+    // Пока отображение активно, блобы читаются как виды на его страницы
+    struct MappingScope {
+        explicit MappingScope(const ModelMapping* mapping) { ModelMapping::activate(mapping); }
+        ~MappingScope() { ModelMapping::activate(nullptr); }
+    } scope(model->mapping.get());
+    if (model->mapping->size() != header.file_bytes) {
+        throw std::runtime_error("Model file changed while loading: " + path);
+    }
+    for (uint32_t i = 0; i < header.num_layers; ++i) {
+        model->addLayer(Layer::load(file));
+    }
+    return model;
+}
+
+// Включить измерение времени каждого слоя
+void Model::setLayerTiming(bool enabled) {
+    timing_enabled = enabled;
+}
+
+// Накопленное время по слоям
+const std::vector<LayerTiming>& Model::getLayerTimings() const {
+    return layer_timings;
+}
+
+// Сбросить накопленное время
+void Model::resetLayerTimings() {
+    layer_timings.assign(layers.size(), LayerTiming());
+}
@@ -1,10 +1,89 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <chrono>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <iostream>
+#include <string>
 #include "tensor.h"
 #include "layers/layer.h"
+#include "layers/parameter.h"
+#include "metrics/loss.h"
+#include "optimizers/optimizer.h"
+#include "kernels/roofline.h"
+#include "utils/aligned_buffer.h"
+#include "utils/stage_pipeline.h"
+
+// Время, затраченное слоем на прямой и обратный проходы
+struct LayerTiming {
+    double forward_seconds = 0.0;
+    double backward_seconds = 0.0;
+    size_t calls = 0;
+};
+
+// Память слоя при обучении, в байтах
+struct LayerMemory {
+    std::string name;          // "<номер>.<тип слоя>"
+    size_t parameters = 0;     // Значения параметров
+    size_t gradients = 0;      // Градиенты (по одному float на параметр)
+    size_t optimizer = 0;      // Состояние оптимизатора (моменты)
+    size_t cache = 0;          // Наибольшие кэши прямого прохода с последнего сброса пика
+    size_t scratch = 0;        // Прочие буферы слоя (Layer::scratchBytes)
+
+    size_t total() const { return parameters + gradients + optimizer + cache + scratch; }
+};
+
+// Учет памяти модели при обучении, в байтах
+struct MemoryUsage {
+    std::vector<LayerMemory> layers;  // По слоям
+    size_t persistent = 0;            // Параметры, градиенты, состояние оптимизатора и буферы слоев
+    size_t activations = 0;           // Активации сейчас: кэши слоев, контрольные точки, область плана
+    size_t peak_activations = 0;      // Пик активаций с последнего сброса (getPeakActivationBytes)
+    size_t live = 0;                  // persistent + activations
+    size_t peak = 0;                  // persistent + peak_activations
+};
+
+// Строка сводки модели: формы, параметры, оценка работы слоя и время по модели roofline
+struct LayerSummary {
+    std::string name;                  // "<номер>.<тип слоя>"
+    std::vector<size_t> input_shape;
+    std::vector<size_t> output_shape;
+    size_t parameters = 0;             // Layer::getNumParameters
+    LayerCost cost;                    // Layer::cost для input_shape
+    double forward_seconds = 0.0;      // Предсказанное время прямого прохода (нижняя граница roofline)
+    double backward_seconds = 0.0;     // Предсказанное время обратного прохода
+    bool forward_memory_bound = false; // Интенсивность ниже точки перегиба roofline
+    bool backward_memory_bound = false;
+
+    // Арифметическая интенсивность проходов, FLOP на байт
+    double forwardIntensity() const {
+        return cost.forward_bytes > 0.0 ? cost.forward_flops / cost.forward_bytes : 0.0;
+    }
+    double backwardIntensity() const {
+        return cost.backward_bytes > 0.0 ? cost.backward_flops / cost.backward_bytes : 0.0;
+    }
+};
+
+class Model;
+class ModelMapping;
+
+// Контекст вывода одного потока: изменяемые состояния слоев (рабочие буферы,
+// рекуррентное состояние LSTM). Веса остаются в модели, поэтому контекст легкий,
+// а одна модель обслуживает столько потоков, сколько создано контекстов.
+class ExecutionContext {
+public:
+    // Сбросить рекуррентное состояние слоев (начало новой последовательности)
+    void reset();
+
+private:
+    friend class Model;
+    const Model* owner = nullptr;                    // Модель, для которой создан контекст
+    std::vector<std::unique_ptr<LayerState>> states; // Состояние каждого слоя (или nullptr)
+};
 
 class Model {
 public:
@@ -14,14 +93,255 @@ public:
     // Прямой проход: вычисляет выходные данные на основе входных
     Tensor predict(const Tensor& input);
 
-    // Обучение модели
+    // Вывод: слои не сохраняют кэши для обратного прохода, Dropout пропускает вход,
+    // BatchNorm нормирует скользящими статистиками, активации считаются на месте.
+    // После infer обратный проход невозможен. Использует внутренний контекст модели.
+    Tensor infer(const Tensor& input);
+
+    // Потокобезопасный вывод: модель не изменяется, все изменяемое хранится в context.
+    // Несколько потоков могут одновременно вызывать его у одной модели, каждый со своим
+    // контекстом, пока слои и веса модели не меняются.
+    Tensor infer(const Tensor& input, ExecutionContext& context) const;
+
+    // Создать контекст вывода для этой модели
+    ExecutionContext createContext() const;
+
+    // Асинхронный вывод: ставит вход в очередь фонового исполнителя и сразу возвращает
+    // future результата. Запросы независимы (состояние LSTM сбрасывается для каждого) и
+    // завершаются в порядке поступления. Можно вызывать из нескольких потоков: исполнитель
+    // запускается при первом запросе под блокировкой. Слои и веса не должны меняться, пока
+    // есть незавершенные запросы; addLayer и fuseActivations дожидаются их.
+    std::future<Tensor> predictAsync(const Tensor& input);
+
+    // Конвейерный режим predictAsync: слои делятся на num_stages последовательных групп,
+    // каждая выполняется своим потоком, и несколько запросов одновременно находятся
+    // на разных стадиях. Границы групп выбираются по замеру времени слоев на первом
+    // запросе так, чтобы самая медленная стадия была как можно короче. Вход с осью батча
+    // больше micro_batch_size делится на микробатчи по micro_batch_size примеров
+    // (0 — не делить), которые проходят конвейер друг за другом.
+    void enablePipeline(size_t num_stages, size_t micro_batch_size = 0);
+
+    // Конвейер с явными границами: номера первых слоев стадий
+    void setPipelineStages(std::vector<size_t> boundaries, size_t micro_batch_size = 0);
+
+    // Выполнять predictAsync одним фоновым потоком
+    void disablePipeline();
+
+    // Номера первых слоев стадий работающего конвейера (пусто, пока он не запущен)
+    std::vector<size_t> getPipelineStages() const;
+
+    // Обратный проход по всем слоям; возвращает градиент по входу модели.
+    // Градиент принимается по значению, чтобы слои могли работать в его буфере.
+    // Градиенты параметров накапливаются в реестре параметров.
+    Tensor backward(Tensor grad_output);
+
+    // Функция, вызываемая после обратного прохода каждого слоя с его номером
+    // (градиенты параметров слоя к этому моменту готовы). nullptr — отключить.
+    void setBackwardHook(std::function<void(size_t)> hook);
+
+    // Контрольные точки активаций: прямой проход сохраняет только входы сегментов слоев,
+    // а кэши внутренних слоев освобождает; обратный проход пересчитывает сегмент перед
+    // его градиентом. Пиковая память активаций падает с N слоев до ~2√N ценой одного
+    // лишнего прямого прохода. num_segments = 0 — автоматически ceil(√N) сегментов.
+    void enableCheckpointing(size_t num_segments = 0);
+
+    // Контрольные точки с явными границами: номера первых слоев сегментов
+    void setCheckpoints(std::vector<size_t> boundaries);
+
+    // Выключить контрольные точки (кэши всех слоев хранятся до обратного прохода)
+    void disableCheckpointing();
+
+    // Пиковый объем активаций (кэши слоев, контрольные точки, текущий выход или градиент)
+    // с последнего сброса, в байтах
+    size_t getPeakActivationBytes() const;
+    void resetPeakActivationBytes();
+
+    // Время повторных прямых проходов сегментов
+    double getRecomputeSeconds() const;
+
+    // Учет памяти обучения: по слоям — параметры, градиенты, состояние optimizer (nullptr —
+    // оптимизатор без состояния), кэши и буферы слоев; для модели — живой объем и пик за
+    // проходы с последнего resetPeakActivationBytes (обычно один шаг обучения). Кэши растут
+    // линейно с батчем, остальное от батча не зависит: этого хватает, чтобы подобрать батч
+    // и контрольные точки под бюджет памяти. Кэши скомпилированной модели — ее область плана.
+    MemoryUsage getMemoryUsage(const Optimizer* optimizer = nullptr) const;
+
+    // Напечатать учет памяти: таблица по слоям, живой объем и пик
+    void reportMemory(std::ostream& out, const Optimizer* optimizer = nullptr) const;
+
+    // Сводка по слоям для входа формы input_shape (с осью батча): формы выводятся по цепочке
+    // слоев (несовместимость — std::invalid_argument), для каждого слоя — параметры, оценка
+    // работы (Layer::cost), арифметическая интенсивность и время по потолкам roofline
+    std::vector<LayerSummary> summarize(const std::vector<size_t>& input_shape, const Roofline& roofline);
+
+    // Напечатать сводку с потолками одного исполнителя этой машины (machineRoofline, измеряются
+    // при первом вызове; проходы модели однопоточные, число исполнителей печатается в строке
+    // roofline) и предсказанное время шага обучения без шага оптимизатора. Пустая форма — форма входа,
+    // которую помнит первый слой (последний compile или summary; Dense и LSTM знают ее сразу).
+    void summary(const std::vector<size_t>& input_shape = {}, std::ostream& out = std::cout);
+
+    // Компиляция под форму входа (с осью батча): формы выводятся по цепочке слоев и
+    // проверяются заранее, а все активации (и градиенты при training) получают смещения
+    // в одной заранее выделенной области. Буферы с непересекающимся временем жизни делят
+    // память, активации пишутся на место входа, где слой это допускает. После компиляции
+    // predict и backward для этой формы не выделяют память под тензоры: predict возвращает
+    // вид на выход, действительный до следующего прохода. Вход другой формы выполняется
+    // обычным путем. Исключение — LSTM: у него нет проходов в буферы плана, и его шаг
+    // по-прежнему выделяет свои тензоры. Возвращает форму выхода; несовместимость слоев —
+    // std::invalid_argument.
+    // addLayer и fuseActivations сбрасывают план.
+    std::vector<size_t> compile(const std::vector<size_t>& input_shape, bool training = true);
+    bool isCompiled() const;
+
+    // Размер области скомпилированного плана и сумма размеров всех его тензоров без
+    // повторного использования памяти, в байтах
+    size_t getPlannedBytes() const;
+    size_t getUnplannedBytes() const;
+
+    // Реестр параметров модели (собирается при первом обращении после изменения слоев)
+    ParameterRegistry& getParameters();
+
+    // Обнулить градиенты всех параметров
+    void zeroGrad();
+
+    // Создать реплику модели: копии слоев с собственными кэшами и градиентами,
+    // значения параметров которых ссылаются на параметры этой модели.
+    // Реплика действительна, пока эта модель жива и ее слои не меняются.
+    // index — номер реплики (не 0 и разный у реплик одной модели): генераторы слоев
+    // переводятся на поток index, чтобы маски Dropout реплик были независимы.
+    std::unique_ptr<Model> replicate(size_t index);
+
+    // Обучение модели (среднеквадратичная ошибка, SGD). Градиент — точная производная средней
+    // ошибки, 2 * (output - target) / число элементов выхода, а не (output - target), как раньше:
+    // при той же learning_rate шаг меньше в (batch * outputs) / 2 раз.
     void train(const Tensor& input, const Tensor& target, size_t epochs, float learning_rate);
 
+    // Обучение модели с заданной функцией потерь (SGD)
+    void train(const Tensor& input, const Tensor& target, size_t epochs, float learning_rate, Loss& loss);
+
+    // Обучение модели с заданными оптимизатором и функцией потерь
+    void train(const Tensor& input, const Tensor& target, size_t epochs, Optimizer& optimizer, Loss& loss);
+
+    // Встроить активации (ReLU, Sigmoid) в эпилог предшествующих Dense/Conv2D.
+    // Возвращает количество удаленных слоев активации.
+    size_t fuseActivations();
+
     // Получить слои модели
     const std::vector<std::shared_ptr<Layer>>& getLayers() const;
 
+    // Сохранить модель в двоичный файл (layers/serialization.h): заголовок и записи слоев
+    // с выровненными по 64 байтам блобами весов и их контрольными суммами
+    void save(const std::string& path) const;
+
+    // Загрузить модель, скопировав веса и проверив контрольные суммы
+    static std::unique_ptr<Model> load(const std::string& path);
+
+    // Загрузить модель без копирования: файл отображается в память (MAP_PRIVATE), и тензоры
+    // весов становятся видами на его страницы, поэтому загрузка не зависит от размера весов,
+    // а процессы, загрузившие один файл, делят одну копию весов в страничном кэше.
+    // verify — проверить контрольные суммы (читает все веса). Отображение живет, пока жива
+    // модель: слои, полученные из нее, действительны, пока она существует. Изменение весов
+    // (обучение) меняет только частные копии страниц, а не файл.
+    static std::unique_ptr<Model> loadMapped(const std::string& path, bool verify = false);
+
+    // Включить измерение времени каждого слоя
+    void setLayerTiming(bool enabled);
+
+    // Накопленное время по слоям (в порядке слоев) и его сброс
+    const std::vector<LayerTiming>& getLayerTimings() const;
+    void resetLayerTimings();
+
 private:
+    std::shared_ptr<ModelMapping> mapping;      // Отображенный файл весов (loadMapped)
     std::vector<std::shared_ptr<Layer>> layers; // Слои модели
+    bool timing_enabled = false;                // Измерять ли время слоев
+    std::vector<LayerTiming> layer_timings;     // Накопленное время по слоям
+    std::function<void(size_t)> backward_hook;  // Уведомление о готовности градиентов слоя
+    ParameterRegistry parameters;               // Общие буферы параметров и градиентов
+    bool parameters_dirty = true;               // Нужно ли пересобрать реестр
+    ExecutionContext infer_context;             // Контекст infer без явного контекста
+    std::vector<uint32_t> profile_ids;          // Области профилировщика: проходы слоев
+
+    // Сегмент слоев [begin, end) для контрольных точек
+    struct Segment {
+        size_t begin;
+        size_t end;
+        bool recompute; // Кэши освобождаются в прямом проходе и пересчитываются в обратном
+    };
+
+    bool checkpointing = false;                 // Включены ли контрольные точки
+    size_t checkpoint_segments = 0;             // Запрошенное число сегментов (0 — √N)
+    std::vector<size_t> checkpoint_boundaries;  // Явные границы сегментов
+    std::vector<Segment> segments;              // Сегменты последнего прямого прохода
+    std::vector<Tensor> checkpoints;            // Входы сегментов последнего прямого прохода
+
+    std::vector<size_t> layer_cache_bytes;      // Байты кэшей каждого слоя
+    std::vector<size_t> layer_peak_cache_bytes; // Наибольшие кэши каждого слоя с последнего сброса
+    size_t cache_bytes = 0;                     // Сумма по слоям
+    size_t checkpoint_bytes = 0;                // Байты контрольных точек
+    size_t peak_bytes = 0;                      // Пиковый объем активаций
+    double recompute_seconds = 0.0;             // Время повторных прямых проходов
+
+    // Разбить слои на сегменты
+    std::vector<Segment> planSegments() const;
+
+    // Вывести формы по цепочке слоев: [i] — вход слоя i, последняя — выход модели
+    std::vector<std::vector<size_t>> inferShapes(const std::vector<size_t>& input_shape);
+
+    // Прямой и обратный проходы слоя на месте (с замером времени, если он включен)
+    void forwardLayer(size_t i, Tensor& data);
+    void backwardLayer(size_t i, Tensor& grad);
+
+    // Учесть время прохода слоя (setLayerTiming) и записать его в профилировщик с оценкой
+    // работы слоя для входа формы input_shape
+    void recordLayer(size_t i, bool forward, const std::vector<size_t>& input_shape,
+                     std::chrono::steady_clock::time_point start);
+
+    // Учет памяти: обновить кэш слоя i и пик с учетом живых тензоров прохода
+    void noteCache(size_t i);
+    void releaseLayerCache(size_t i);
+    void notePeak(size_t live_bytes);
+
+    // Прямой и обратный проходы с контрольными точками
+    Tensor predictCheckpointed(const Tensor& input);
+    Tensor backwardCheckpointed(Tensor grad_output);
+
+    bool compiled = false;                      // Есть ли план памяти
+    bool compiled_training = false;             // Размещены ли градиенты
+    bool compiled_pass = false;                 // Прошел ли последний прямой проход по плану
+    std::vector<size_t> compiled_input_shape;   // Форма входа плана
+    AlignedBuffer arena;                        // Общая область активаций и градиентов
+    std::vector<Tensor> activations;            // Вход слоя i; последний — выход модели (виды на arena)
+    std::vector<Tensor> gradients;              // Градиент по входу слоя i; последний — по выходу модели
+    size_t planned_bytes = 0;                   // Размер области
+    size_t unplanned_bytes = 0;                 // Сумма размеров тензоров плана
+
+    // Сбросить план (слои могли сохранить виды на область)
+    void resetPlan();
+
+    // Проходы слоя по буферам плана (с замером времени, если он включен)
+    void forwardLayerInto(size_t i);
+    void backwardLayerInto(size_t i);
+
+    // Прямой и обратный проходы по плану
+    Tensor predictCompiled(const Tensor& input);
+    Tensor backwardCompiled(const Tensor& grad_output);
+
+    size_t pipeline_stages = 1;                 // Запрошенное число стадий
+    std::vector<size_t> pipeline_boundaries;    // Явные или выбранные границы стадий
+    bool pipeline_explicit = false;             // Заданы ли границы явно
+    size_t micro_batch_size = 0;                // Размер микробатча (0 — не делить)
+    ExecutionContext pipeline_context;          // Состояния слоев; стадии используют свои слои
+    mutable std::mutex pipeline_mutex;          // Защищает запуск, остановку и очередь исполнителя
+
+    // Исполнитель predictAsync; объявлен последним, чтобы остановиться раньше слоев
+    std::unique_ptr<StagePipeline> pipeline;
+
+    // Запустить конвейер (с замером слоев на примере, если границы не заданы)
+    void startPipeline(const Tensor& sample);
+
+    // Остановить конвейер, дождавшись незавершенных запросов
+    void resetPipeline();
 };
 
 #endif // MODEL_H
@@ -33,25 +33,35 @@ public:
         return dist(get_rng());
     }
 
-    // Нормализация в диапазон [0, 1]
+    // Нормализация в диапазон [0, 1]. Постоянные данные переводятся в 0.
+    // Для наборов данных по признакам см. FeatureStats::minMaxScaler (data/feature_stats.h).
     static void normalize(std::vector<double>& data) {
-        double min_val = *std::min_element(data.begin(), data.end());
-        double max_val = *std::max_element(data.begin(), data.end());
+        if (data.empty()) return;
+        auto range = std::minmax_element(data.begin(), data.end());
+        double min_val = *range.first;
+        double span = *range.second - min_val;
+        double scale = span > 0.0 ? 1.0 / span : 0.0;
         for (double& x : data) {
-            x = (x - min_val) / (max_val - min_val);
+            x = (x - min_val) * scale;
         }
     }
 
-    // Стандартизация (Z-score)
+    // Стандартизация (Z-score). Среднее и дисперсия считаются за один проход (Велфорд),
+    // постоянные данные переводятся в 0.
+    // Для наборов данных по признакам см. FeatureStats::standardizer (data/feature_stats.h).
     static void standardize(std::vector<double>& data) {
-        double mean = 0.0, stddev = 0.0;
-        for (double x : data) mean += x;
-        mean /= data.size();
-
-        for (double x : data) stddev += (x - mean) * (x - mean);
-        stddev = std::sqrt(stddev / data.size());
+        if (data.empty()) return;
+        double mean = 0.0, m2 = 0.0;
+        size_t n = 0;
+        for (double x : data) {
+            double delta = x - mean;
+            mean += delta / ++n;
+            m2 += delta * (x - mean);
+        }
+        double stddev = std::sqrt(m2 / n);
+        double scale = stddev > 0.0 ? 1.0 / stddev : 0.0;
 
-        for (double& x : data) x = (x - mean) / stddev;
+        for (double& x : data) x = (x - mean) * scale;
     }
 
     // Вычисление сигмоиды
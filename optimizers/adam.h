@@ -8,12 +8,19 @@ public:
     Adam(float learning_rate, float beta1 = 0.9f, float beta2 = 0.999f, float epsilon = 1e-8f);
 
     // Обновление параметров
-    void update(Tensor& param, const Tensor& grad) override;
+    using Optimizer::update;
+    void update(const std::vector<ParameterSpan>& spans) override;
+
+    // Состояние для контрольных точек: t и буферы m, v
+    size_t getStep() const override;
+    void setStep(size_t step) override;
+    std::vector<AlignedBuffer*> stateBuffers() override;
+    size_t stateSizePerParameter() const override;
 
 private:
     float beta1, beta2, epsilon;
-    std::vector<Tensor> m; // Скользящее среднее градиента
-    std::vector<Tensor> v; // Скользящее среднее квадрата градиента
+    AlignedBuffer m; // Скользящее среднее градиента
+    AlignedBuffer v; // Скользящее среднее квадрата градиента
     size_t t; // Счетчик шагов
 };
 
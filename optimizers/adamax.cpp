@@ -1,25 +1,43 @@
 #include "adamax.h"
-#include <cmath>
+#include "kernels/optimizer_kernels.h"
 
 // Конструктор
 Adamax::Adamax(float learning_rate, float beta1, float beta2, float epsilon)
     : Optimizer(learning_rate), beta1(beta1), beta2(beta2), epsilon(epsilon), t(0) {}
 
-// Обновление параметров
-void Adamax::update(Tensor& param, const Tensor& grad) {
-    // Инициализация m и u при первом вызове
-    if (m.empty()) {
-        m.push_back(Tensor(param.shape()));
-        u.push_back(Tensor(param.shape()));
+// Обновление параметров: один проход по каждому элементу, куски обрабатываются параллельно
+void Adamax::update(const std::vector<ParameterSpan>& spans) {
+    // Инициализация m и u при первом вызове (состояние на каждый элемент всех массивов)
+    size_t total = totalSize(spans);
+    if (m.size() != total) {
+        m.resize(total);
+        u.resize(total);
     }
 
     t += 1;
 
-    for (size_t i = 0; i < param.size(); ++i) {
-        m[0]({i}) = beta1 * m[0]({i}) + (1 - beta1) * grad({i});
-        u[0]({i}) = std::max(beta2 * u[0]({i}), std::abs(grad({i})));
+    // Adamax не использует коррекцию смещения; скаляры шага общие с Adam
+    AdamScalars s = makeAdamScalars(learning_rate, beta1, beta2, epsilon, 0.0f, t);
+    forEachChunk(spans, [&](const ParameterSpan& span, size_t begin, size_t end, size_t offset) {
+        adamaxKernel(s, span.params + begin, span.grads + begin, m.data() + offset, u.data() + offset, end - begin);
+    });
+}
 
-        param({i}) -= learning_rate * m[0]({i}) / (u[0]({i}) + epsilon);
-    }
+// Счетчик шагов
+size_t Adamax::getStep() const {
+    return t;
+}
+
+void Adamax::setStep(size_t step) {
+    t = step;
 }
 
+// Буферы состояния
+std::vector<AlignedBuffer*> Adamax::stateBuffers() {
+    return {&m, &u};
+}
+
+// Состояние на параметр: m и u
+size_t Adamax::stateSizePerParameter() const {
+    return 2;
+}
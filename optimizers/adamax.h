@@ -8,12 +8,19 @@ public:
     Adamax(float learning_rate, float beta1 = 0.9f, float beta2 = 0.999f, float epsilon = 1e-8f);
 
     // Обновление параметров
-    void update(Tensor& param, const Tensor& grad) override;
+    using Optimizer::update;
+    void update(const std::vector<ParameterSpan>& spans) override;
+
+    // Состояние для контрольных точек: t и буферы m, u
+    size_t getStep() const override;
+    void setStep(size_t step) override;
+    std::vector<AlignedBuffer*> stateBuffers() override;
+    size_t stateSizePerParameter() const override;
 
 private:
     float beta1, beta2, epsilon;
-    std::vector<Tensor> m; // Скользящее среднее градиента
-    std::vector<Tensor> u; // Максимум абсолютных значений градиента
+    AlignedBuffer m; // Скользящее среднее градиента
+    AlignedBuffer u; // Максимум абсолютных значений градиента
     size_t t; // Счетчик шагов
 };
 
@@ -1,30 +1,43 @@
 #include "adamw.h"
-#include <cmath>
+#include "kernels/optimizer_kernels.h"
 
 // Конструктор
 AdamW::AdamW(float learning_rate, float beta1, float beta2, float epsilon, float weight_decay)
     : Optimizer(learning_rate), beta1(beta1), beta2(beta2), epsilon(epsilon), weight_decay(weight_decay), t(0) {}
 
-// Обновление параметров
-void AdamW::update(Tensor& param, const Tensor& grad) {
-    // Инициализация m и v при первом вызове
-    if (m.empty()) {
-        m.push_back(Tensor(param.shape()));
-        v.push_back(Tensor(param.shape()));
+// Обновление параметров: один проход по каждому элементу, куски обрабатываются параллельно
+void AdamW::update(const std::vector<ParameterSpan>& spans) {
+    // Инициализация m и v при первом вызове (состояние на каждый элемент всех массивов)
+    size_t total = totalSize(spans);
+    if (m.size() != total) {
+        m.resize(total);
+        v.resize(total);
     }
 
     t += 1;
 
-    for (size_t i = 0; i < param.size(); ++i) {
-        m[0]({i}) = beta1 * m[0]({i}) + (1 - beta1) * grad({i});
-        v[0]({i}) = beta2 * v[0]({i}) + (1 - beta2) * grad({i}) * grad({i});
+    // Коррекция смещения вычисляется один раз на шаг
+    AdamScalars s = makeAdamScalars(learning_rate, beta1, beta2, epsilon, weight_decay, t);
+    forEachChunk(spans, [&](const ParameterSpan& span, size_t begin, size_t end, size_t offset) {
+        adamwKernel(s, span.params + begin, span.grads + begin, m.data() + offset, v.data() + offset, end - begin);
+    });
+}
+
+// Счетчик шагов
+size_t AdamW::getStep() const {
+    return t;
+}
 
-        float m_hat = m[0]({i}) / (1 - std::pow(beta1, t));
-        float v_hat = v[0]({i}) / (1 - std::pow(beta2, t));
+void AdamW::setStep(size_t step) {
+    t = step;
+}
 
-        param({i}) -= learning_rate * m_hat / (std::sqrt(v_hat) + epsilon);
+// Буферы состояния
+std::vector<AlignedBuffer*> AdamW::stateBuffers() {
+    return {&m, &v};
+}
 
-        // Применение L2-регуляризации
-        param({i}) -= learning_rate * weight_decay * param({i});
-    }
+// Состояние на параметр: m и v
+size_t AdamW::stateSizePerParameter() const {
+    return 2;
 }
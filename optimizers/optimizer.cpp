@@ -1,4 +1,71 @@
 #include "optimizer.h"
+#include "utils/profiler.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+
+namespace {
+// Размер куска для одного потока: 64K элементов (256 КБ на массив)
+constexpr size_t CHUNK = size_t(1) << 16;
+
+// Кусок массива с его смещением в состоянии оптимизатора
+struct Chunk {
+    size_t span;
+    size_t begin;
+    size_t end;
+    size_t state_offset;
+};
+}
 
 // Конструктор
 Optimizer::Optimizer(float learning_rate) : learning_rate(learning_rate) {}
+
+// Шаг оптимизации по всем параметрам модели
+void Optimizer::step(ParameterRegistry& parameters) {
+    static const uint32_t profile_id = Profiler::global().intern("optimizer.step", "optimizer");
+    double flops = 0.0;
+    double bytes = 0.0;
+    if (Profiler::enabled()) {
+        // Оценка: чтение градиента, чтение и запись параметров и каждого буфера состояния;
+        // около 2 операций на элемент у SGD и 5 на каждый буфер моментов
+        double elements = static_cast<double>(parameters.size());
+        double buffers = static_cast<double>(stateBuffers().size());
+        flops = (2.0 + 5.0 * buffers) * elements;
+        bytes = (3.0 + 2.0 * buffers) * elements * sizeof(float);
+    }
+    ProfileScope scope(profile_id, flops, bytes);
+    update(parameters.values(), parameters.grads(), parameters.size());
+}
+
+// Обновить один непрерывный массив
+void Optimizer::update(float* params, const float* grads, size_t size) {
+    update(std::vector<ParameterSpan>{{params, grads, size}});
+}
+
+// Общее количество элементов
+size_t Optimizer::totalSize(const std::vector<ParameterSpan>& spans) {
+    size_t total = 0;
+    for (const ParameterSpan& span : spans) {
+        total += span.size;
+    }
+    return total;
+}
+
+// Разбить массивы на куски и обработать их параллельно
+void Optimizer::forEachChunk(const std::vector<ParameterSpan>& spans,
+                             const std::function<void(const ParameterSpan&, size_t, size_t, size_t)>& fn) {
+    std::vector<Chunk> chunks;
+    size_t offset = 0;
+    for (size_t s = 0; s < spans.size(); ++s) {
+        for (size_t begin = 0; begin < spans[s].size; begin += CHUNK) {
+            size_t end = std::min(spans[s].size, begin + CHUNK);
+            chunks.push_back({s, begin, end, offset + begin});
+        }
+        offset += spans[s].size;
+    }
+
+    ThreadPool::global().parallelFor(0, chunks.size(), 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            fn(spans[chunks[c].span], chunks[c].begin, chunks[c].end, chunks[c].state_offset);
+        }
+    });
+}
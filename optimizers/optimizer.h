@@ -2,9 +2,19 @@
 #define OPTIMIZER_H
 
 #include "tensor.h"
+#include "layers/parameter.h"
+#include "utils/aligned_buffer.h"
+#include <functional>
 #include <vector>
 #include <memory>
 
+// Непрерывный массив параметров и его градиент
+struct ParameterSpan {
+    float* params;
+    const float* grads;
+    size_t size;
+};
+
 class Optimizer {
 public:
     // Конструктор
@@ -13,10 +23,38 @@ public:
     // Виртуальный деструктор
     virtual ~Optimizer() = default;
 
-    // Обновление параметров
-    virtual void update(Tensor& param, const Tensor& grad) = 0;
+    // Шаг оптимизации: обновить все параметры реестра одним линейным проходом
+    void step(ParameterRegistry& parameters);
+
+    // Обновить один непрерывный массив параметров по его градиенту
+    void update(float* params, const float* grads, size_t size);
+
+    // Обновить несколько массивов за один запуск.
+    // Состояние оптимизатора (моменты) раскладывается по массивам в порядке перечисления,
+    // поэтому при следующих шагах массивы должны передаваться в том же порядке.
+    virtual void update(const std::vector<ParameterSpan>& spans) = 0;
+
+    // Состояние для контрольных точек обучения: счетчик шагов и буферы состояния
+    // (моменты) в порядке, не зависящем от запуска. У оптимизаторов без состояния буферов нет.
+    // Восстановленные буферы должны иметь размер реестра параметров, тогда следующий шаг
+    // продолжит с них, а не начнет с нулей.
+    virtual size_t getStep() const { return 0; }
+    virtual void setStep(size_t step) {}
+    virtual std::vector<AlignedBuffer*> stateBuffers() { return {}; }
+
+    // Количество float состояния на один параметр (для учета памяти до первого шага)
+    virtual size_t stateSizePerParameter() const { return 0; }
 
     float learning_rate; // Скорость обучения
+
+protected:
+    // Общее количество элементов во всех массивах
+    static size_t totalSize(const std::vector<ParameterSpan>& spans);
+
+    // Разбить массивы на куски и обработать их в общем пуле потоков.
+    // fn(span, begin, end, state_offset): state_offset — смещение элемента begin в состоянии.
+    static void forEachChunk(const std::vector<ParameterSpan>& spans,
+                             const std::function<void(const ParameterSpan&, size_t, size_t, size_t)>& fn);
 };
 
 #endif // OPTIMIZER_H
@@ -1,11 +1,12 @@
 #include "sgd.h"
+#include "kernels/optimizer_kernels.h"
 
 // Конструктор
 SGD::SGD(float learning_rate) : Optimizer(learning_rate) {}
 
 // Обновление параметров
-void SGD::update(Tensor& param, const Tensor& grad) {
-    for (size_t i = 0; i < param.size(); ++i) {
-        param({i}) -= learning_rate * grad({i});
-    }
+void SGD::update(const std::vector<ParameterSpan>& spans) {
+    forEachChunk(spans, [&](const ParameterSpan& span, size_t begin, size_t end, size_t) {
+        sgdKernel(learning_rate, span.params + begin, span.grads + begin, end - begin);
+    });
 }
@@ -8,7 +8,8 @@ public:
     SGD(float learning_rate);
 
     // Обновление параметров
-    void update(Tensor& param, const Tensor& grad) override;
+    using Optimizer::update;
+    void update(const std::vector<ParameterSpan>& spans) override;
 };
 
 #endif // SGD_H
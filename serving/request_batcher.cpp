@@ -0,0 +1,196 @@
+#include "request_batcher.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+// Запросов в секунду
+double BatcherMetrics::throughput() const {
+    return wall_seconds > 0.0 ? requests / wall_seconds : 0.0;
+}
+
+// Средний размер батча
+double BatcherMetrics::meanBatchSize() const {
+    return batches ? static_cast<double>(requests) / batches : 0.0;
+}
+
+// Конструктор: запустить исполнителей
+RequestBatcher::RequestBatcher(const Model& model, const std::vector<size_t>& sample_shape,
+                               const BatcherConfig& config)
+    : model(model), sample_shape(sample_shape), sample_size(1), config(config) {
+    if (config.max_batch_size == 0) {
+        throw std::invalid_argument("Batch size must be positive.");
+    }
+    for (size_t dim : sample_shape) {
+        sample_size *= dim;
+    }
+    if (sample_size == 0) {
+        throw std::invalid_argument("Sample shape must not be empty.");
+    }
+    metrics.batch_sizes.assign(config.max_batch_size + 1, 0);
+
+    size_t num_executors = std::max<size_t>(1, config.num_executors);
+    for (size_t i = 0; i < num_executors; ++i) {
+        executors.emplace_back(&RequestBatcher::executorLoop, this);
+    }
+}
+
+// Деструктор: исполнители дорабатывают очередь и завершаются
+RequestBatcher::~RequestBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    arrived.notify_all();
+    for (std::thread& executor : executors) {
+        executor.join();
+    }
+}
+
+// Поставить пример в очередь
+std::future<Tensor> RequestBatcher::submit(const Tensor& sample) {
+    if (sample.size() != sample_size) {
+        throw std::invalid_argument("Sample size does not match the batcher sample shape.");
+    }
+    Request request{sample, std::promise<Tensor>(), clock_type::now()};
+    std::future<Tensor> future = request.result.get_future();
+    {
+        std::lock_guard<std::mutex> metrics_lock(metrics_mutex);
+        if (!measuring) {
+            first_arrival = request.arrival;
+            measuring = true;
+        }
+    }
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(request));
+        // Первый запрос батча будит исполнителя, чтобы тот засек срок; полный батч — чтобы запустил
+        wake = queue.size() == 1 || queue.size() >= config.max_batch_size;
+    }
+    if (wake) {
+        arrived.notify_one();
+    }
+    return future;
+}
+
+// Запросы в очереди
+size_t RequestBatcher::pending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
+
+// Показатели
+BatcherMetrics RequestBatcher::getMetrics() const {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    BatcherMetrics result = metrics;
+    if (measuring && last_completion > first_arrival) {
+        result.wall_seconds = std::chrono::duration<double>(last_completion - first_arrival).count();
+    }
+    return result;
+}
+
+// Сбросить показатели (отсчет времени начнется со следующего запроса)
+void RequestBatcher::resetMetrics() {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    metrics = BatcherMetrics();
+    metrics.batch_sizes.assign(config.max_batch_size + 1, 0);
+    measuring = false;
+}
+
+// Цикл исполнителя
+void RequestBatcher::executorLoop() {
+    ExecutionContext context = model.createContext();
+    std::vector<Request> batch;
+    batch.reserve(config.max_batch_size);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            arrived.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            // Батч собирается до заполнения или до срока самого старого запроса;
+            // при остановке оставшиеся запросы выполняются без ожидания
+            auto deadline = queue.front().arrival + std::chrono::duration_cast<clock_type::duration>(
+                                                        std::chrono::duration<double, std::milli>(config.max_delay_ms));
+            arrived.wait_until(lock, deadline, [this] {
+                return stopping || queue.size() >= config.max_batch_size;
+            });
+            if (queue.empty()) {
+                // Очередь забрал другой исполнитель
+                continue;
+            }
+            size_t count = std::min(queue.size(), config.max_batch_size);
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            // Оставшиеся запросы начинают следующий батч
+            if (!queue.empty()) {
+                arrived.notify_one();
+            }
+        }
+        run(batch, context);
+        batch.clear();
+    }
+}
+
+// Выполнить батч и раздать строки выхода
+void RequestBatcher::run(std::vector<Request>& batch, ExecutionContext& context) {
+    size_t count = batch.size();
+    clock_type::time_point start = clock_type::now();
+
+    std::vector<size_t> batch_shape = sample_shape;
+    batch_shape.insert(batch_shape.begin(), count);
+    Tensor input(batch_shape);
+    for (size_t i = 0; i < count; ++i) {
+        std::memcpy(input.data() + i * sample_size, batch[i].input.data(), sample_size * sizeof(float));
+    }
+
+    // Строки выхода собираются до учета показателей, чтобы после get() последнего
+    // запроса показатели уже включали его батч
+    std::vector<Tensor> rows;
+    std::exception_ptr error;
+    try {
+        context.reset();
+        Tensor output = model.infer(input, context);
+
+        // Форма строки: без оси батча (слой может опустить ось у батча из одного примера)
+        std::vector<size_t> row_shape = output.shape();
+        if (row_shape.size() > 1 && row_shape[0] == count) {
+            row_shape.erase(row_shape.begin());
+        } else if (count > 1) {
+            throw std::runtime_error("Model output has no batch axis.");
+        }
+        size_t row_size = output.size() / count;
+        rows.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            rows.emplace_back(row_shape);
+            std::memcpy(rows.back().data(), output.data() + i * row_size, row_size * sizeof(float));
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    clock_type::time_point end = clock_type::now();
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex);
+        metrics.requests += count;
+        metrics.batches += 1;
+        metrics.batch_sizes[count] += 1;
+        for (const Request& request : batch) {
+            metrics.latency.record(std::chrono::duration<double>(end - request.arrival).count());
+            metrics.queue_wait.record(std::chrono::duration<double>(start - request.arrival).count());
+        }
+        last_completion = std::max(last_completion, end);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (error) {
+            batch[i].result.set_exception(error);
+        } else {
+            batch[i].result.set_value(std::move(rows[i]));
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef REQUEST_BATCHER_H
+#define REQUEST_BATCHER_H
+
+#include "model.h"
+#include "utils/latency_histogram.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Параметры пакетирования запросов
+struct BatcherConfig {
+    size_t max_batch_size = 32; // Наибольший батч
+    double max_delay_ms = 2.0;  // Наибольшее ожидание самого старого запроса до запуска батча
+    size_t num_executors = 1;   // Потоки, выполняющие батчи (у каждого свой ExecutionContext)
+};
+
+// Показатели пакетирования
+struct BatcherMetrics {
+    size_t requests = 0;                  // Выполненные запросы
+    size_t batches = 0;                   // Выполненные батчи
+    double wall_seconds = 0.0;            // От первого поступления до последнего ответа
+    LatencyHistogram latency;             // От submit до готовности результата
+    LatencyHistogram queue_wait;          // От submit до запуска батча
+    std::vector<size_t> batch_sizes;      // batch_sizes[n] — количество батчей из n запросов
+
+    // Запросов в секунду за wall_seconds и средний размер батча
+    double throughput() const;
+    double meanBatchSize() const;
+};
+
+// Динамическое пакетирование запросов для обслуживания модели.
+// Запросы по одному примеру ставятся в очередь и собираются в батч, пока он не достигнет
+// max_batch_size или самый старый запрос не прождет max_delay_ms; затем исполнитель
+// выполняет один Model::infer на весь батч и завершает future каждого запроса своей
+// строкой выхода. Модель не должна меняться, пока существует пакетировщик.
+// Состояние LSTM сбрасывается перед каждым батчем: запросы независимы.
+class RequestBatcher {
+public:
+    // sample_shape — форма одного примера (без оси батча)
+    RequestBatcher(const Model& model, const std::vector<size_t>& sample_shape,
+                   const BatcherConfig& config = BatcherConfig());
+    // Дожидается выполнения всех поставленных запросов
+    ~RequestBatcher();
+
+    RequestBatcher(const RequestBatcher&) = delete;
+    RequestBatcher& operator=(const RequestBatcher&) = delete;
+
+    // Поставить пример в очередь; форма — sample_shape (или любая с тем же числом элементов).
+    // Ошибка вывода передается через future.
+    std::future<Tensor> submit(const Tensor& sample);
+
+    // Запросы в очереди
+    size_t pending() const;
+
+    // Показатели и их сброс
+    BatcherMetrics getMetrics() const;
+    void resetMetrics();
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    struct Request {
+        Tensor input;
+        std::promise<Tensor> result;
+        clock_type::time_point arrival;
+    };
+
+    const Model& model;
+    std::vector<size_t> sample_shape;
+    size_t sample_size;
+    BatcherConfig config;
+
+    mutable std::mutex mutex;
+    std::condition_variable arrived;
+    std::deque<Request> queue;
+    bool stopping = false;
+    std::vector<std::thread> executors;
+
+    mutable std::mutex metrics_mutex;
+    BatcherMetrics metrics;
+    clock_type::time_point first_arrival;
+    clock_type::time_point last_completion;
+    bool measuring = false;
+
+    void executorLoop();
+    void run(std::vector<Request>& batch, ExecutionContext& context);
+};
+
+#endif // REQUEST_BATCHER_H
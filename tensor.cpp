@@ -2,6 +2,9 @@
 #include <random>
 #include <numeric>
 #include <functional>
+#include <algorithm>
+#include "kernels/gemm.h"
+#include "kernels/dispatch.h"
 // Конструктор
 Tensor::Tensor(const std::vector<size_t>& shape) : _shape(shape) {
     // Вычисляем общее количество элементов в тензоре
@@ -10,6 +13,104 @@ Tensor::Tensor(const std::vector<size_t>& shape) : _shape(shape) {
         total_size *= dim;
     }
     _data.resize(total_size, 0.0f); // Инициализируем данные нулями
+    _ptr = _data.data();
+    _size = total_size;
+}
+
+// Конструктор копирования: всегда собственная копия данных
+Tensor::Tensor(const Tensor& other)
+    : _shape(other._shape), _data(other._ptr, other._ptr + other._size), _size(other._size) {
+    _ptr = _data.data();
+}
+
+// Конструктор перемещения
+Tensor::Tensor(Tensor&& other) noexcept
+    : _shape(std::move(other._shape)), _data(std::move(other._data)), _ptr(other._ptr), _size(other._size) {
+    if (!_data.empty()) {
+        _ptr = _data.data();
+    }
+    other._ptr = other._data.data();
+    other._size = 0;
+}
+
+// Присваивание копированием (собственное хранилище переиспользуется, если его хватает)
+Tensor& Tensor::operator=(const Tensor& other) {
+    if (this != &other) {
+        _shape = other._shape;
+        _data.assign(other._ptr, other._ptr + other._size);
+        _ptr = _data.data();
+        _size = other._size;
+    }
+    return *this;
+}
+
+// Присваивание перемещением
+Tensor& Tensor::operator=(Tensor&& other) noexcept {
+    if (this != &other) {
+        _shape = std::move(other._shape);
+        _data = std::move(other._data);
+        _ptr = _data.empty() ? other._ptr : _data.data();
+        _size = other._size;
+        other._ptr = other._data.data();
+        other._size = 0;
+    }
+    return *this;
+}
+
+// Вид на внешнюю память
+Tensor::Tensor(std::vector<size_t>&& shape, float* data) : _shape(std::move(shape)), _ptr(data) {
+    _size = 1;
+    for (size_t dim : _shape) {
+        _size *= dim;
+    }
+}
+
+// Тензор-вид на внешнюю память
+Tensor Tensor::view(float* data, const std::vector<size_t>& shape) {
+    return Tensor(std::vector<size_t>(shape), data);
+}
+
+// Перенести данные во внешнюю память
+void Tensor::bindStorage(float* storage, bool copy_values) {
+    if (copy_values && storage != _ptr) {
+        std::copy(_ptr, _ptr + _size, storage);
+    }
+    _ptr = storage;
+    _data.clear();
+    _data.shrink_to_fit();
+}
+
+// Вернуть данные в собственное хранилище
+void Tensor::detach() {
+    if (isView()) {
+        _data.assign(_ptr, _ptr + _size);
+        _ptr = _data.data();
+    }
+}
+
+// Стать видом на данные другого тензора
+void Tensor::alias(Tensor& other) {
+    if (this == &other) {
+        return;
+    }
+    _shape = other._shape;
+    _data.clear();
+    _data.shrink_to_fit();
+    _ptr = other._ptr;
+    _size = other._size;
+}
+
+// Является ли тензор видом на внешнюю память
+bool Tensor::isView() const {
+    return _size > 0 && _data.empty();
+}
+
+// Скопировать значения, сохраняя текущее хранилище
+void Tensor::copyFrom(const Tensor& other) {
+    if (other._size != _size) {
+        throw std::invalid_argument("Tensors must have the same size for copyFrom.");
+    }
+    std::copy(other._ptr, other._ptr + _size, _ptr);
 }
 
 // Доступ к элементам тензора по индексам (неконстантная версия)
@@ -21,7 +122,7 @@ float& Tensor::operator()(const std::vector<size_t>& indices) {
         index += indices[i] * stride;
         stride *= _shape[i];
     }
-    return _data[index];
+    return _ptr[index];
 }
 
 // Доступ к элементам тензора по индексам (константная версия)
@@ -33,22 +134,34 @@ const float& Tensor::operator()(const std::vector<size_t>& indices) const {
         index += indices[i] * stride;
         stride *= _shape[i];
     }
-    return _data[index];
+    return _ptr[index];
 }
 
 // Получить форму тензора
-std::vector<size_t> Tensor::shape() const {
+const std::vector<size_t>& Tensor::shape() const {
     return _shape;
 }
 
+// Изменить форму без копирования данных
+void Tensor::reshape(const std::vector<size_t>& new_shape) {
+    size_t total_size = 1;
+    for (size_t dim : new_shape) {
+        total_size *= dim;
+    }
+    if (total_size != _size) {
+        throw std::invalid_argument("Reshape must preserve the number of elements.");
+    }
+    _shape = new_shape;
+}
+
 // Получить общее количество элементов в тензоре
 size_t Tensor::size() const {
-    return _data.size();
+    return _size;
 }
 
 // Заполнить тензор значением
 void Tensor::fill(float value) {
-    std::fill(_data.begin(), _data.end(), value);
+    std::fill(_ptr, _ptr + _size, value);
 }
 
 // Заполнить тензор случайными значениями
@@ -56,8 +169,8 @@ void Tensor::randomize(float min, float max) {
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_real_distribution<float> dist(min, max);
-    for (float& val : _data) {
-        val = dist(gen);
+    for (size_t i = 0; i < _size; ++i) {
+        _ptr[i] = dist(gen);
     }
 }
 
@@ -96,17 +209,17 @@ Tensor Tensor::operator-(const Tensor& other) const {
     }
 
     Tensor result(shape());
-    for (size_t i = 0; i < size(); ++i) {
-        result({i}) = _data[i] - other({i});
-    }
+    kernels().sub(_ptr, other.data(), result.data(), size());
     return result;
 }
 
 // Перегрузка оператора вычитания (int - Tensor)
 Tensor operator-(int value, const Tensor& tensor) {
     Tensor result(tensor.shape());
+    const float* t = tensor.data();
+    float* r = result.data();
     for (size_t i = 0; i < tensor.size(); ++i) {
-        result({i}) = value - tensor({i});
+        r[i] = value - t[i];
     }
     return result;
 }
@@ -119,15 +232,9 @@ Tensor Tensor::dot(const Tensor& other) const {
     }
 
     Tensor result({shape()[0], other.shape()[1]});
-    for (size_t i = 0; i < shape()[0]; ++i) {
-        for (size_t j = 0; j < other.shape()[1]; ++j) {
-            float sum = 0.0f;
-            for (size_t k = 0; k < shape()[1]; ++k) {
-                sum += (*this)({i, k}) * other({k, j});
-            }
-            result({i, j}) = sum;
-        }
-    }
+    gemm(false, false, shape()[0], other.shape()[1], shape()[1],
+         data(), shape()[1], other.data(), other.shape()[1],
+         result.data(), other.shape()[1]);
     return result;
 }
 
@@ -153,9 +260,7 @@ Tensor Tensor::operator*(const Tensor& other) const {
     }
 
     Tensor result(shape());
-    for (size_t i = 0; i < size(); ++i) {
-        result({i}) = _data[i] * other({i});
-    }
+    kernels().mul(_ptr, other.data(), result.data(), size());
     return result;
 }
 
@@ -166,9 +271,7 @@ Tensor Tensor::operator+(const Tensor& other) const {
     }
 
     Tensor result(shape());
-    for (size_t i = 0; i < size(); ++i) {
-        result({i}) = _data[i] + other({i});
-    }
+    kernels().add(_ptr, other.data(), result.data(), size());
     return result;
 }
 
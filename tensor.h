@@ -11,12 +11,49 @@ public:
     // Конструктор
     Tensor(const std::vector<size_t>& shape);
 
+    // Копирование всегда создает тензор с собственными данными;
+    // перемещение сохраняет привязку к внешней памяти
+    Tensor(const Tensor& other);
+    Tensor(Tensor&& other) noexcept;
+    Tensor& operator=(const Tensor& other);
+    Tensor& operator=(Tensor&& other) noexcept;
+
+    // Тензор-вид на внешнюю память (память не копируется и не освобождается)
+    static Tensor view(float* data, const std::vector<size_t>& shape);
+
     // Доступ к элементам тензора по индексам
     float& operator()(const std::vector<size_t>& indices);
     const float& operator()(const std::vector<size_t>& indices) const;
 
+    // Доступ к элементу по плоскому индексу
+    float& operator[](size_t index) { return _ptr[index]; }
+    const float& operator[](size_t index) const { return _ptr[index]; }
+
+    // Указатель на непрерывные данные тензора
+    float* data() { return _ptr; }
+    const float* data() const { return _ptr; }
+
+    // Перенести данные во внешнюю память (copy_values — скопировать текущие значения)
+    void bindStorage(float* storage, bool copy_values);
+
+    // Вернуть данные в собственное хранилище тензора
+    void detach();
+
+    // Стать видом на данные other с его формой (без копирования данных и, если места
+    // под форму хватает, без выделения памяти)
+    void alias(Tensor& other);
+
+    // Является ли тензор видом на внешнюю память
+    bool isView() const;
+
+    // Скопировать значения из тензора того же размера, сохраняя текущее хранилище
+    void copyFrom(const Tensor& other);
+
     // Получить форму тензора
-    std::vector<size_t> shape() const;
+    const std::vector<size_t>& shape() const;
+
+    // Изменить форму без копирования данных (общее число элементов сохраняется)
+    void reshape(const std::vector<size_t>& new_shape);
 
     // Получить общее количество элементов в тензоре
     size_t size() const;
@@ -49,8 +86,13 @@ public:
     Tensor operator*(const Tensor& other) const;
 
 private:
+    // Вид на внешнюю память без выделения собственного хранилища
+    Tensor(std::vector<size_t>&& shape, float* data);
+
     std::vector<size_t> _shape; // Форма тензора (например, {2, 3} для матрицы 2x3)
-    std::vector<float> _data;   // Данные тензора (хранятся в одномерном массиве)
+    std::vector<float> _data;   // Собственные данные тензора (пусты, если тензор — вид)
+    float* _ptr;                // Начало данных: _data.data() или внешняя память
+    size_t _size;               // Общее количество элементов
 };
 
 #endif // TENSOR_H
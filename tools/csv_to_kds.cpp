@@ -0,0 +1,153 @@
+// Преобразование CSV в шарды двоичного формата KKDS (см. data/dataset_format.h).
+// Каждая строка CSV — пример: сначала признаки, затем метки (последние --label-columns столбцов).
+//
+// Сборка (из корня репозитория):
+//   g++ -std=c++17 -O2 -I. tools/csv_to_kds.cpp data/dataset_writer.cpp -o csv_to_kds
+// Запуск:
+//   ./csv_to_kds input.csv output_prefix [--label-columns N] [--classes K] [--uint8 SCALE]
+//                [--shard-records N] [--skip-header]
+//
+//   --label-columns N  количество столбцов меток в конце строки (по умолчанию 1)
+//   --classes K        одна метка-номер класса, записывается как one-hot длины K
+//   --uint8 SCALE      хранить признаки как uint8: байт = round(x / SCALE)
+//   --shard-records N  примеров в шарде (по умолчанию 1048576)
+//   --skip-header      пропустить первую строку
+
+#include "data/dataset_writer.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+// Разобрать строку CSV в значения
+bool parseLine(const std::string& line, std::vector<float>& values) {
+    values.clear();
+    const char* p = line.c_str();
+    while (*p) {
+        char* end;
+        float value = std::strtof(p, &end);
+        if (end == p) {
+            return false;
+        }
+        values.push_back(value);
+        p = end;
+        while (*p == ' ' || *p == '\t' || *p == '\r') {
+            ++p;
+        }
+        if (*p == ',') {
+            ++p;
+        } else if (*p) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void usage() {
+    std::cerr << "Usage: csv_to_kds input.csv output_prefix [--label-columns N] [--classes K] "
+                 "[--uint8 SCALE] [--shard-records N] [--skip-header]\n";
+}
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    std::string input_path = argv[1];
+    std::string prefix = argv[2];
+    size_t label_columns = 1;
+    size_t classes = 0;
+    RecordType type = RecordType::Float32;
+    float scale = 1.0f;
+    size_t shard_records = 1 << 20;
+    bool skip_header = false;
+
+    for (int i = 3; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (!std::strcmp(argv[i], "--label-columns") && has_value) {
+            label_columns = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--classes") && has_value) {
+            classes = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--uint8") && has_value) {
+            type = RecordType::UInt8;
+            scale = std::strtof(argv[++i], nullptr);
+        } else if (!std::strcmp(argv[i], "--shard-records") && has_value) {
+            shard_records = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--skip-header")) {
+            skip_header = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (classes > 0 && label_columns != 1) {
+        std::cerr << "--classes requires a single label column.\n";
+        return 1;
+    }
+
+    std::ifstream input(input_path);
+    if (!input) {
+        std::cerr << "Cannot open " << input_path << "\n";
+        return 1;
+    }
+
+    try {
+        std::unique_ptr<DatasetWriter> writer;
+        std::vector<float> values;
+        std::vector<float> label;
+        size_t num_features = 0;
+        size_t line_number = 0;
+        std::string line;
+        while (std::getline(input, line)) {
+            ++line_number;
+            if ((skip_header && line_number == 1) || line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            if (!parseLine(line, values) || values.size() <= label_columns) {
+                std::cerr << input_path << ":" << line_number << ": malformed row\n";
+                return 1;
+            }
+
+            // Количество признаков определяется по первой строке данных
+            if (!writer) {
+                num_features = values.size() - label_columns;
+                writer.reset(new DatasetWriter(prefix, {num_features}, classes ? classes : label_columns, type,
+                                               scale, shard_records));
+            } else if (values.size() != num_features + label_columns) {
+                std::cerr << input_path << ":" << line_number << ": expected " << num_features + label_columns
+                          << " columns, got " << values.size() << "\n";
+                return 1;
+            }
+
+            if (classes) {
+                size_t cls = static_cast<size_t>(values[num_features]);
+                if (values[num_features] < 0.0f || cls >= classes) {
+                    std::cerr << input_path << ":" << line_number << ": class out of range\n";
+                    return 1;
+                }
+                label.assign(classes, 0.0f);
+                label[cls] = 1.0f;
+            } else {
+                label.assign(values.begin() + num_features, values.end());
+            }
+            writer->write(values.data(), label.data());
+        }
+
+        if (!writer) {
+            std::cerr << "No data rows in " << input_path << "\n";
+            return 1;
+        }
+        writer->close();
+        std::cout << "Wrote " << writer->getNumRecords() << " records (" << num_features << " features) to "
+                  << writer->getShardPaths().size() << " shard(s)\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
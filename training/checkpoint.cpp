@@ -0,0 +1,298 @@
+#include "checkpoint.h"
+#include "layers/serialization.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+constexpr char CHECKPOINT_MAGIC[4] = {'K', 'K', 'C', 'K'};
+constexpr uint32_t CHECKPOINT_VERSION = 1;
+
+// Записать буфер блобом
+void writeBuffer(std::ostream& out, const AlignedBuffer& buffer) {
+    writeTensor(out, Tensor::view(const_cast<float*>(buffer.data()), {buffer.size()}));
+}
+
+// Прочитать блоб в буфер (буфер перевыделяется, только если размер изменился)
+void readBuffer(std::istream& in, AlignedBuffer& buffer) {
+    Tensor value = readTensor(in);
+    if (value.shape().size() != 1) {
+        throw std::runtime_error("Checkpoint is corrupted: buffer must be one-dimensional.");
+    }
+    if (buffer.size() != value.size()) {
+        buffer.resize(value.size());
+    }
+    std::memcpy(buffer.data(), value.data(), value.size() * sizeof(float));
+}
+
+void writeF64(std::ostream& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU64(out, bits);
+}
+
+double readF64(std::istream& in) {
+    uint64_t bits = readU64(in);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Байты произвольной длины (состояния слоев)
+void writeBytes(std::ostream& out, const std::string& bytes) {
+    writeU64(out, bytes.size());
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::string readBytes(std::istream& in) {
+    uint64_t size = readU64(in);
+    if (size > (uint64_t(1) << 32)) {
+        throw std::runtime_error("Checkpoint is corrupted: layer state is too long.");
+    }
+    std::string bytes(size, '\0');
+    in.read(&bytes[0], static_cast<std::streamsize>(size));
+    if (static_cast<uint64_t>(in.gcount()) != size) {
+        throw std::runtime_error("Checkpoint is truncated.");
+    }
+    return bytes;
+}
+
+// Сбросить данные файла на диск
+void syncFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+}
+
+// Записать контрольную точку
+void writeCheckpoint(const std::string& path, const TrainingSnapshot& snapshot) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Cannot create checkpoint file: " + temporary);
+        }
+        file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+        writeU32(file, CHECKPOINT_VERSION);
+
+        // Параметры
+        writeU32(file, static_cast<uint32_t>(snapshot.parameter_names.size()));
+        for (size_t i = 0; i < snapshot.parameter_names.size(); ++i) {
+            writeString(file, snapshot.parameter_names[i]);
+            writeU64(file, snapshot.parameter_offsets[i]);
+            writeU64(file, snapshot.parameter_sizes[i]);
+        }
+        writeBuffer(file, snapshot.parameters);
+
+        // Состояние слоев
+        writeU32(file, static_cast<uint32_t>(snapshot.layer_states.size()));
+        for (const std::string& state : snapshot.layer_states) {
+            writeBytes(file, state);
+        }
+
+        // Оптимизатор
+        writeF32(file, snapshot.learning_rate);
+        writeU64(file, snapshot.optimizer_step);
+        writeU32(file, static_cast<uint32_t>(snapshot.optimizer_buffers.size()));
+        for (const AlignedBuffer& buffer : snapshot.optimizer_buffers) {
+            writeBuffer(file, buffer);
+        }
+
+        // Положение цикла обучения
+        const TrainingPosition& position = snapshot.position;
+        writeU64(file, position.epoch);
+        writeU64(file, position.step);
+        writeU64(file, position.total_steps);
+        writeF64(file, position.epoch_loss);
+        writeU64(file, position.epoch_samples);
+        writeU64(file, position.order.size());
+        for (size_t index : position.order) {
+            writeU64(file, index);
+        }
+        writeGenerator(file, position.generator);
+
+        file.close();
+        if (!file) {
+            throw std::runtime_error("Cannot write checkpoint file: " + temporary);
+        }
+    }
+    syncFile(temporary);
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace checkpoint file: " + path);
+    }
+}
+
+// Прочитать контрольную точку
+void readCheckpoint(const std::string& path, TrainingSnapshot& snapshot) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    char magic[4];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a checkpoint file: " + path);
+    }
+    uint32_t version = readU32(file);
+    if (version == 0 || version > CHECKPOINT_VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(version) + ": " + path);
+    }
+
+    // Параметры
+    uint32_t num_parameters = readU32(file);
+    snapshot.parameter_names.resize(num_parameters);
+    snapshot.parameter_offsets.resize(num_parameters);
+    snapshot.parameter_sizes.resize(num_parameters);
+    for (uint32_t i = 0; i < num_parameters; ++i) {
+        snapshot.parameter_names[i] = readString(file);
+        snapshot.parameter_offsets[i] = readU64(file);
+        snapshot.parameter_sizes[i] = readU64(file);
+    }
+    readBuffer(file, snapshot.parameters);
+
+    // Состояние слоев
+    snapshot.layer_states.resize(readU32(file));
+    for (std::string& state : snapshot.layer_states) {
+        state = readBytes(file);
+    }
+
+    // Оптимизатор
+    snapshot.learning_rate = readF32(file);
+    snapshot.optimizer_step = readU64(file);
+    uint32_t num_buffers = readU32(file);
+    if (num_buffers > 16) {
+        throw std::runtime_error("Checkpoint is corrupted: too many optimizer buffers.");
+    }
+    snapshot.optimizer_buffers.resize(num_buffers);
+    for (AlignedBuffer& buffer : snapshot.optimizer_buffers) {
+        readBuffer(file, buffer);
+    }
+
+    // Положение цикла обучения
+    TrainingPosition& position = snapshot.position;
+    position.epoch = readU64(file);
+    position.step = readU64(file);
+    position.total_steps = readU64(file);
+    position.epoch_loss = readF64(file);
+    position.epoch_samples = readU64(file);
+    uint64_t order_size = readU64(file);
+    if (order_size > (uint64_t(1) << 40)) {
+        throw std::runtime_error("Checkpoint is corrupted: invalid sample order.");
+    }
+    position.order.resize(order_size);
+    for (size_t& index : position.order) {
+        index = readU64(file);
+    }
+    readGenerator(file, position.generator);
+}
+
+// Запустить фоновый поток записи
+CheckpointWriter::CheckpointWriter() : worker(&CheckpointWriter::workerLoop, this) {}
+
+// Дождаться записи и остановить поток
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return !pending && !writing; });
+        stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+// Снимок для заполнения
+TrainingSnapshot& CheckpointWriter::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (pending) {
+        auto start = std::chrono::steady_clock::now();
+        changed.wait(lock, [this] { return !pending; });
+        stall_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    rethrow();
+    return snapshots[back];
+}
+
+// Поставить снимок в очередь записи
+void CheckpointWriter::submit(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_path = path;
+        pending = true;
+    }
+    changed.notify_all();
+}
+
+// Дождаться записи всех снимков
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return !pending && !writing; });
+    rethrow();
+}
+
+// Показатели
+size_t CheckpointWriter::getWritten() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+double CheckpointWriter::getWriteSeconds() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return write_seconds;
+}
+
+double CheckpointWriter::getStallSeconds() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stall_seconds;
+}
+
+// Цикл фонового потока: взять поставленный снимок, отдать второй буфер на заполнение и записать
+void CheckpointWriter::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return pending || stopping; });
+        if (!pending) {
+            return;
+        }
+        size_t front = back;
+        std::string path = pending_path;
+        back = 1 - back;
+        pending = false;
+        writing = true;
+        lock.unlock();
+        changed.notify_all();
+
+        auto start = std::chrono::steady_clock::now();
+        std::exception_ptr failure;
+        try {
+            writeCheckpoint(path, snapshots[front]);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        writing = false;
+        write_seconds += seconds;
+        if (failure) {
+            error = failure;
+        } else {
+            written += 1;
+        }
+        changed.notify_all();
+    }
+}
+
+// Пробросить ошибку записи
+void CheckpointWriter::rethrow() {
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "utils/aligned_buffer.h"
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Контрольная точка обучения (*.kkc): все, что нужно, чтобы продолжить обучение
+// бит в бит с того же шага — значения параметров, необучаемое состояние слоев
+// (скользящие статистики, генераторы Dropout), состояние оптимизатора (t, моменты)
+// и положение цикла обучения (эпоха, шаг, порядок перемешивания и его генератор).
+//
+// Файл: магия "KKCK", версия формата, затем разделы в порядке полей TrainingSnapshot.
+// Большие массивы пишутся блобами layers/serialization.h (выравнивание 64 байта, CRC-32).
+// Архитектура модели в файл не входит: точка восстанавливается в такую же модель,
+// а совпадение проверяется по именам и размерам параметров.
+
+// Положение цикла обучения
+struct TrainingPosition {
+    size_t epoch = 0;              // Текущая эпоха
+    size_t step = 0;               // Шагов, выполненных в текущей эпохе
+    size_t total_steps = 0;        // Шагов с начала обучения
+    double epoch_loss = 0.0;       // Сумма потерь эпохи, взвешенная размерами батчей
+    size_t epoch_samples = 0;      // Примеров, обработанных в эпохе
+    std::vector<size_t> order;     // Порядок примеров до перемешивания в начале эпохи
+    std::mt19937 generator;        // Генератор перемешивания до начала эпохи
+};
+
+// Снимок состояния обучения в памяти
+struct TrainingSnapshot {
+    // Параметры: буфер значений реестра (вместе с выравнивающими промежутками)
+    // и описание параметров для проверки совпадения моделей
+    AlignedBuffer parameters;
+    std::vector<std::string> parameter_names;
+    std::vector<size_t> parameter_offsets;
+    std::vector<size_t> parameter_sizes;
+
+    // Необучаемое состояние каждого слоя (Layer::saveTrainingState)
+    std::vector<std::string> layer_states;
+
+    // Оптимизатор
+    float learning_rate = 0.0f;
+    size_t optimizer_step = 0;
+    std::vector<AlignedBuffer> optimizer_buffers;
+
+    TrainingPosition position;
+};
+
+// Записать контрольную точку: во временный файл и переименованием в path,
+// поэтому в path всегда лежит целая точка. Ошибка — std::runtime_error.
+void writeCheckpoint(const std::string& path, const TrainingSnapshot& snapshot);
+
+// Прочитать контрольную точку с проверкой контрольных сумм
+void readCheckpoint(const std::string& path, TrainingSnapshot& snapshot);
+
+// Фоновая запись контрольных точек с двойной буферизацией.
+// Поток обучения заполняет свободный снимок (копирование в память) и сразу продолжает,
+// а запись на диск идет в фоновом потоке из второго снимка. Обучение ждет, только если
+// предыдущий снимок еще не взят в запись, то есть точки сохраняются чаще, чем пишутся.
+class CheckpointWriter {
+public:
+    CheckpointWriter();
+
+    // Дожидается записи поставленных снимков
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    // Снимок для заполнения. Буферы снимка переиспользуются между точками.
+    // Ошибка предыдущей записи пробрасывается здесь.
+    TrainingSnapshot& acquire();
+
+    // Поставить заполненный снимок в очередь записи в path
+    void submit(const std::string& path);
+
+    // Дождаться записи всех поставленных снимков (с пробросом ошибки записи)
+    void flush();
+
+    // Показатели: записанные точки, время записи в фоне и ожидания потока обучения
+    size_t getWritten() const;
+    double getWriteSeconds() const;
+    double getStallSeconds() const;
+
+private:
+    TrainingSnapshot snapshots[2];
+    size_t back = 0;              // Снимок, который заполняет поток обучения
+    std::string pending_path;     // Куда писать поставленный снимок
+    bool pending = false;         // Снимок back поставлен и еще не взят в запись
+    bool writing = false;         // Фоновый поток пишет снимок 1 - back
+    bool stopping = false;
+    std::exception_ptr error;
+
+    size_t written = 0;
+    double write_seconds = 0.0;
+    double stall_seconds = 0.0;
+
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::thread worker; // Объявлен последним: запускается после остальных полей
+
+    void workerLoop();
+
+    // Пробросить ошибку записи (под блокировкой)
+    void rethrow();
+};
+
+#endif // CHECKPOINT_H
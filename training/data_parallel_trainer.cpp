@@ -0,0 +1,151 @@
+#include "data_parallel_trainer.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// Элементов градиента в одном куске редукции
+constexpr size_t REDUCE_CHUNK = size_t(1) << 14;
+
+// Количество реплик по умолчанию
+size_t resolveReplicas(size_t num_replicas) {
+    if (num_replicas > 0) {
+        return num_replicas;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+// Конструктор (SGD по умолчанию)
+DataParallelTrainer::DataParallelTrainer(Model& model, Loss& loss, const TrainerConfig& config, size_t num_replicas)
+    : Trainer(model, loss, config), pool(resolveReplicas(num_replicas) - 1) {
+    createReplicas(resolveReplicas(num_replicas));
+}
+
+// Конструктор с заданным оптимизатором
+DataParallelTrainer::DataParallelTrainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config,
+                                         size_t num_replicas)
+    : Trainer(model, loss, optimizer, config), pool(resolveReplicas(num_replicas) - 1) {
+    createReplicas(resolveReplicas(num_replicas));
+}
+
+// Создать реплики
+void DataParallelTrainer::createReplicas(size_t num_replicas) {
+    for (size_t r = 1; r < num_replicas; ++r) {
+        replicas.push_back(model.replicate(r));
+        losses.push_back(loss.clone());
+    }
+    shard_losses.assign(num_replicas, 0.0f);
+}
+
+// Модель реплики
+Model& DataParallelTrainer::replica(size_t r) {
+    return r == 0 ? model : *replicas[r - 1];
+}
+
+// Функция потерь реплики
+Loss& DataParallelTrainer::replicaLoss(size_t r) {
+    return r == 0 ? loss : *losses[r - 1];
+}
+
+// Один шаг обучения
+float DataParallelTrainer::trainStep(const Tensor& inputs, const Tensor& targets) {
+    if (inputs.shape().size() < 2) {
+        return Trainer::trainStep(inputs, targets);
+    }
+    if (targets.shape().empty() || targets.shape()[0] != inputs.shape()[0]) {
+        throw std::invalid_argument("Inputs and targets must have the same batch size.");
+    }
+
+    ParameterRegistry& parameters = model.getParameters();
+    size_t rows = inputs.shape()[0];
+    size_t active = std::min(getNumReplicas(), rows);
+
+    // Прямой и обратный проход частей батча. Градиент потерь части масштабируется
+    // долей части в батче, чтобы сумма градиентов реплик равнялась градиенту всего батча.
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(0, active, 1, [&](size_t lo, size_t hi) {
+        for (size_t r = lo; r < hi; ++r) {
+            size_t begin = rows * r / active;
+            size_t count = rows * (r + 1) / active - begin;
+            float weight = static_cast<float>(count) / rows;
+
+            Model& replica_model = replica(r);
+            Loss& replica_loss = replicaLoss(r);
+            replica_model.zeroGrad();
+            Tensor output = replica_model.predict(batchRows(inputs, begin, count));
+            shard_losses[r] = weight * replica_loss.forward(output, batchRows(targets, begin, count));
+
+            Tensor grad = replica_loss.backward();
+            float* g = grad.data();
+            for (size_t i = 0; i < grad.size(); ++i) {
+                g[i] *= weight;
+            }
+            replica_model.backward(std::move(grad));
+        }
+    });
+    compute_seconds += secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    allReduce(active);
+    reduce_seconds += secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    optimizer->step(parameters);
+    optimizer_seconds += secondsSince(start);
+
+    float value = 0.0f;
+    for (size_t r = 0; r < active; ++r) {
+        value += shard_losses[r];
+    }
+    return value;
+}
+
+// Древовидная редукция градиентов: на шаге stride реплика r прибавляет градиент реплики
+// r + stride. Буфер разбит на куски, которые обрабатываются параллельно, поэтому каждый
+// поток работает со своим участком памяти всех реплик.
+void DataParallelTrainer::allReduce(size_t count) {
+    size_t size = model.getParameters().size();
+    std::vector<float*> grads(count);
+    for (size_t r = 0; r < count; ++r) {
+        grads[r] = replica(r).getParameters().grads();
+    }
+
+    size_t num_chunks = (size + REDUCE_CHUNK - 1) / REDUCE_CHUNK;
+    pool.parallelFor(0, num_chunks, 1, [&](size_t lo, size_t hi) {
+        size_t begin = lo * REDUCE_CHUNK;
+        size_t end = std::min(size, hi * REDUCE_CHUNK);
+        for (size_t stride = 1; stride < count; stride *= 2) {
+            for (size_t r = 0; r + stride < count; r += 2 * stride) {
+                float* __restrict dst = grads[r];
+                const float* __restrict src = grads[r + stride];
+                for (size_t i = begin; i < end; ++i) {
+                    dst[i] += src[i];
+                }
+            }
+        }
+    });
+}
+
+// Количество реплик
+size_t DataParallelTrainer::getNumReplicas() const {
+    return replicas.size() + 1;
+}
+
+// Накопленное время фаз шага
+double DataParallelTrainer::getComputeSeconds() const {
+    return compute_seconds;
+}
+
+double DataParallelTrainer::getReduceSeconds() const {
+    return reduce_seconds;
+}
+
+double DataParallelTrainer::getOptimizerSeconds() const {
+    return optimizer_seconds;
+}
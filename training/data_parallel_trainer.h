@@ -0,0 +1,52 @@
+#ifndef DATA_PARALLEL_TRAINER_H
+#define DATA_PARALLEL_TRAINER_H
+
+#include "trainer.h"
+#include "utils/thread_pool.h"
+#include <memory>
+#include <vector>
+
+// Синхронное обучение с параллелизмом по данным.
+// Мини-батч делится на части по числу реплик; каждая реплика (копия слоев с собственными
+// кэшами и градиентами, веса общие с исходной моделью) выполняет прямой и обратный проход
+// в своем потоке. Градиенты суммируются древовидной редукцией в общей памяти в буфер
+// исходной модели, после чего оптимизатор делает один шаг.
+class DataParallelTrainer : public Trainer {
+public:
+    // num_replicas = 0 — по числу аппаратных потоков
+    DataParallelTrainer(Model& model, Loss& loss, const TrainerConfig& config, size_t num_replicas = 0);
+    DataParallelTrainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config,
+                        size_t num_replicas = 0);
+
+    // Один шаг обучения на батче (batch_size, ...); возвращает потери по всему батчу
+    float trainStep(const Tensor& inputs, const Tensor& targets) override;
+
+    // Количество реплик (включая исходную модель)
+    size_t getNumReplicas() const;
+
+    // Накопленное время фаз шага: прямой/обратный проход, редукция градиентов, шаг оптимизатора
+    double getComputeSeconds() const;
+    double getReduceSeconds() const;
+    double getOptimizerSeconds() const;
+
+private:
+    std::vector<std::unique_ptr<Model>> replicas; // Реплики 1..N-1 (реплика 0 — исходная модель)
+    std::vector<std::unique_ptr<Loss>> losses;    // Функции потерь реплик 1..N-1
+    std::vector<float> shard_losses;              // Взвешенные потери частей последнего шага
+    ThreadPool pool;                              // N-1 рабочих потоков + вызывающий
+    double compute_seconds = 0.0;
+    double reduce_seconds = 0.0;
+    double optimizer_seconds = 0.0;
+
+    // Создать реплики
+    void createReplicas(size_t num_replicas);
+
+    // Модель и функция потерь реплики r
+    Model& replica(size_t r);
+    Loss& replicaLoss(size_t r);
+
+    // Сложить градиенты первых count реплик в буфер исходной модели
+    void allReduce(size_t count);
+};
+
+#endif // DATA_PARALLEL_TRAINER_H
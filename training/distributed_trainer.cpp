@@ -0,0 +1,163 @@
+#include "distributed_trainer.h"
+#include "utils/aligned_buffer.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+// Конструктор
+DistributedTrainer::DistributedTrainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config,
+                                       Communicator& communicator)
+    : Trainer(model, loss, optimizer, config), communicator(communicator) {
+    ParameterRegistry& parameters = model.getParameters();
+
+    // Одинаковые начальные веса на всех процессах
+    communicator.broadcast(parameters.values(), parameters.size());
+
+    // Параметры слоя лежат в буфере подряд, поэтому его градиенты — один непрерывный диапазон
+    layer_ranges.assign(model.getLayers().size(), {0, 0});
+    for (const ParameterRegistry::Entry& entry : parameters.entries()) {
+        std::pair<size_t, size_t>& range = layer_ranges[entry.layer];
+        size_t end = entry.offset + AlignedBuffer::alignedCount(entry.size);
+        if (range.first == range.second) {
+            range = {entry.offset, end};
+        } else {
+            range.first = std::min(range.first, entry.offset);
+            range.second = std::max(range.second, end);
+        }
+    }
+
+    model.setBackwardHook([this](size_t layer) { enqueue(layer); });
+    comm_thread = std::thread(&DistributedTrainer::commLoop, this);
+}
+
+// Деструктор: остановить фоновый поток
+DistributedTrainer::~DistributedTrainer() {
+    model.setBackwardHook(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    comm_thread.join();
+}
+
+// Поставить градиенты слоя в очередь
+void DistributedTrainer::enqueue(size_t layer) {
+    if (layer_ranges[layer].first == layer_ranges[layer].second) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(layer);
+        in_flight += 1;
+    }
+    work_ready.notify_one();
+}
+
+// Дождаться завершения редукций
+void DistributedTrainer::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [this] { return in_flight == 0; });
+}
+
+// Цикл фонового потока: слои редуцируются в порядке готовности, одинаковом на всех процессах
+void DistributedTrainer::commLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_ready.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;
+        }
+        size_t layer = pending.front();
+        pending.pop_front();
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        const std::pair<size_t, size_t>& range = layer_ranges[layer];
+        communicator.allReduce(grad_data + range.first, range.second - range.first);
+        double seconds = secondsSince(start);
+
+        lock.lock();
+        comm_seconds += seconds;
+        in_flight -= 1;
+        if (in_flight == 0) {
+            work_done.notify_all();
+        }
+    }
+}
+
+// Один шаг обучения
+float DistributedTrainer::trainStep(const Tensor& inputs, const Tensor& targets) {
+    if (inputs.shape().size() < 2 || targets.shape().empty() || targets.shape()[0] != inputs.shape()[0]) {
+        throw std::invalid_argument("Distributed training expects batches (batch_size, ...) of equal size.");
+    }
+
+    ParameterRegistry& parameters = model.getParameters();
+    grad_data = parameters.grads();
+
+    // Часть строк батча этого процесса; градиент масштабируется долей части в батче,
+    // чтобы сумма по процессам равнялась градиенту всего батча
+    size_t rows = inputs.shape()[0];
+    size_t world_size = communicator.getWorldSize();
+    size_t rank = communicator.getRank();
+    size_t begin = rows * rank / world_size;
+    size_t count = rows * (rank + 1) / world_size - begin;
+    float weight = static_cast<float>(count) / rows;
+
+    auto start = std::chrono::steady_clock::now();
+    parameters.zeroGrad();
+    float value = 0.0f;
+    if (count > 0) {
+        Tensor output = model.predict(batchRows(inputs, begin, count));
+        value = weight * loss.forward(output, batchRows(targets, begin, count));
+
+        Tensor grad = loss.backward();
+        float* g = grad.data();
+        for (size_t i = 0; i < grad.size(); ++i) {
+            g[i] *= weight;
+        }
+        model.backward(std::move(grad)); // Слои ставятся в очередь на редукцию по мере готовности
+    } else {
+        // Строк не досталось: процесс все равно участвует в редукции с нулевыми градиентами
+        for (size_t i = layer_ranges.size(); i-- > 0;) {
+            enqueue(i);
+        }
+    }
+    compute_seconds += secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    wait();
+    exposed_seconds += secondsSince(start);
+
+    communicator.allReduce(&value, 1);
+    optimizer->step(parameters);
+    return value;
+}
+
+// Время вычислений
+double DistributedTrainer::getComputeSeconds() const {
+    return compute_seconds;
+}
+
+// Время редукции
+double DistributedTrainer::getCommSeconds() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return comm_seconds;
+}
+
+// Неперекрытое время обмена
+double DistributedTrainer::getExposedCommSeconds() const {
+    return exposed_seconds;
+}
+
+// Доля скрытого обмена
+double DistributedTrainer::getOverlap() const {
+    double comm = getCommSeconds();
+    return comm > 0.0 ? std::max(0.0, 1.0 - exposed_seconds / comm) : 0.0;
+}
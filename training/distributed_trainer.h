@@ -0,0 +1,65 @@
+#ifndef DISTRIBUTED_TRAINER_H
+#define DISTRIBUTED_TRAINER_H
+
+#include "trainer.h"
+#include "distributed/communicator.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Синхронное обучение с параллелизмом по данным между процессами.
+// Все процессы перемешивают данные одинаково (config.seed), и каждый обрабатывает свою
+// часть строк каждого батча. Градиенты суммируются кольцевым all-reduce; редукция градиентов
+// слоя запускается в фоновом потоке сразу после его обратного прохода, поэтому обмен
+// перекрывается с обратным проходом следующих (более ранних) слоев.
+class DistributedTrainer : public Trainer {
+public:
+    // Параметры модели процесса 0 рассылаются остальным при создании
+    DistributedTrainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config,
+                       Communicator& communicator);
+    ~DistributedTrainer() override;
+
+    // Один шаг обучения на батче (batch_size, ...); возвращает потери по всему батчу
+    float trainStep(const Tensor& inputs, const Tensor& targets) override;
+
+    // Накопленное время: прямой и обратный проход; редукция градиентов (в фоновом потоке);
+    // ожидание редукции после окончания обратного прохода (неперекрытый обмен)
+    double getComputeSeconds() const;
+    double getCommSeconds() const;
+    double getExposedCommSeconds() const;
+
+    // Доля времени обмена, скрытая за вычислениями
+    double getOverlap() const;
+
+private:
+    Communicator& communicator;
+    std::vector<std::pair<size_t, size_t>> layer_ranges; // Диапазон градиентов слоя в буфере реестра
+    float* grad_data = nullptr;                          // Буфер градиентов текущего шага
+
+    // Очередь слоев, готовых к редукции (обрабатывается фоновым потоком по порядку)
+    std::thread comm_thread;
+    mutable std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    std::deque<size_t> pending;
+    size_t in_flight = 0;
+    bool stopping = false;
+
+    double compute_seconds = 0.0;
+    double comm_seconds = 0.0;
+    double exposed_seconds = 0.0;
+
+    // Поставить градиенты слоя в очередь на редукцию
+    void enqueue(size_t layer);
+
+    // Дождаться завершения всех редукций
+    void wait();
+
+    // Цикл фонового потока
+    void commLoop();
+};
+
+#endif // DISTRIBUTED_TRAINER_H
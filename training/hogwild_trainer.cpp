@@ -0,0 +1,214 @@
+#include "hogwild_trainer.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// Блок весов, проверяемый на нулевой градиент: одна кэш-линия
+constexpr size_t BLOCK = 16;
+
+// Количество потоков по умолчанию
+size_t resolveWorkers(size_t num_workers) {
+    if (num_workers > 0) {
+        return num_workers;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Поэлементный доступ к общим весам без упорядочивания (на x86 — обычные mov)
+inline float relaxedLoad(const float* p) {
+    float value;
+    __atomic_load(p, &value, __ATOMIC_RELAXED);
+    return value;
+}
+
+inline void relaxedStore(float* p, float value) {
+    __atomic_store(p, &value, __ATOMIC_RELAXED);
+}
+
+// Атомарный максимум
+void atomicMax(std::atomic<size_t>& target, size_t value) {
+    size_t current = target.load(std::memory_order_relaxed);
+    while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+}
+
+// Конструктор
+HogwildTrainer::HogwildTrainer(Model& model, Loss& loss, const TrainerConfig& config, size_t num_workers)
+    : model(model), loss(loss), config(config), rng(config.seed), pool(resolveWorkers(num_workers) - 1) {
+    if (config.batch_size == 0) {
+        throw std::invalid_argument("Batch size must be positive.");
+    }
+    for (size_t w = 1; w < resolveWorkers(num_workers); ++w) {
+        replicas.push_back(model.replicate(w));
+        losses.push_back(loss.clone());
+    }
+}
+
+// Модель потока
+Model& HogwildTrainer::worker(size_t w) {
+    return w == 0 ? model : *replicas[w - 1];
+}
+
+// Функция потерь потока
+Loss& HogwildTrainer::workerLoss(size_t w) {
+    return w == 0 ? loss : *losses[w - 1];
+}
+
+// Применить шаг SGD к общим весам
+void HogwildTrainer::applyUpdate(ParameterRegistry& gradients, float* shared_values) {
+    float* grads = gradients.grads();
+    size_t size = gradients.size();
+    float learning_rate = config.learning_rate;
+    size_t skipped = 0;
+
+    // Буфер выровнен по 64 байтам и дополнен до кратного размера, поэтому блоки не пересекают параметры
+    for (size_t begin = 0; begin < size; begin += BLOCK) {
+        size_t end = std::min(size, begin + BLOCK);
+        bool nonzero = false;
+        for (size_t i = begin; i < end; ++i) {
+            nonzero |= grads[i] != 0.0f;
+        }
+        if (!nonzero) {
+            ++skipped;
+            continue;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            relaxedStore(shared_values + i, relaxedLoad(shared_values + i) - learning_rate * grads[i]);
+            grads[i] = 0.0f;
+        }
+    }
+
+    blocks_total.fetch_add((size + BLOCK - 1) / BLOCK, std::memory_order_relaxed);
+    blocks_skipped.fetch_add(skipped, std::memory_order_relaxed);
+}
+
+// Обучить модель на наборе данных
+TrainingStats HogwildTrainer::fit(const Dataset& dataset) {
+    using clock = std::chrono::steady_clock;
+
+    size_t num_samples = dataset.size();
+    size_t batch_size = std::min(config.batch_size, num_samples);
+    if (batch_size == 0) {
+        throw std::invalid_argument("Dataset is empty.");
+    }
+    size_t tail = num_samples % batch_size;
+    size_t steps_per_epoch = num_samples / batch_size + ((tail && !config.drop_last) ? 1 : 0);
+
+    float* shared_values = model.getParameters().values();
+    size_t num_workers = getNumWorkers();
+    for (size_t w = 0; w < num_workers; ++w) {
+        worker(w).zeroGrad();
+    }
+
+    std::vector<size_t> indices(num_samples);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    // Батчи каждого потока (полный и неполный последний)
+    auto batchShape = [](size_t count, std::vector<size_t> shape) {
+        shape.insert(shape.begin(), count);
+        return shape;
+    };
+    std::vector<Tensor> batch_inputs, batch_targets, tail_inputs, tail_targets;
+    for (size_t w = 0; w < num_workers; ++w) {
+        batch_inputs.emplace_back(batchShape(batch_size, dataset.inputShape()));
+        batch_targets.emplace_back(batchShape(batch_size, dataset.targetShape()));
+        tail_inputs.emplace_back(batchShape(tail, dataset.inputShape()));
+        tail_targets.emplace_back(batchShape(tail, dataset.targetShape()));
+    }
+
+    TrainingStats stats;
+    auto fit_start = clock::now();
+    for (size_t epoch = 0; epoch < config.epochs; ++epoch) {
+        if (config.shuffle) {
+            std::shuffle(indices.begin(), indices.end(), rng);
+        }
+
+        auto epoch_start = clock::now();
+        std::atomic<size_t> next_step{0};
+        std::vector<double> worker_loss(num_workers, 0.0);
+
+        pool.parallelFor(0, num_workers, 1, [&](size_t lo, size_t hi) {
+            for (size_t w = lo; w < hi; ++w) {
+                Model& worker_model = worker(w);
+                Loss& worker_loss_fn = workerLoss(w);
+                ParameterRegistry& gradients = worker_model.getParameters();
+
+                for (size_t step = next_step.fetch_add(1); step < steps_per_epoch; step = next_step.fetch_add(1)) {
+                    size_t start = step * batch_size;
+                    size_t count = std::min(batch_size, num_samples - start);
+                    Tensor& inputs = count == batch_size ? batch_inputs[w] : tail_inputs[w];
+                    Tensor& targets = count == batch_size ? batch_targets[w] : tail_targets[w];
+                    dataset.getBatch(indices.data() + start, count, inputs, targets);
+
+                    // Веса читаются без синхронизации: шаг вычисляется по версии весов на момент чтения
+                    size_t read_version = version.load(std::memory_order_relaxed);
+                    Tensor output = worker_model.predict(inputs);
+                    worker_loss[w] += static_cast<double>(worker_loss_fn.forward(output, targets)) * count;
+                    worker_model.backward(worker_loss_fn.backward());
+                    applyUpdate(gradients, shared_values);
+
+                    size_t staleness = version.fetch_add(1, std::memory_order_relaxed) - read_version;
+                    staleness_sum.fetch_add(staleness, std::memory_order_relaxed);
+                    atomicMax(staleness_max, staleness);
+                }
+            }
+        });
+
+        size_t epoch_samples = config.drop_last ? num_samples - tail : num_samples;
+        double epoch_seconds = std::chrono::duration<double>(clock::now() - epoch_start).count();
+        stats.epochs += 1;
+        stats.steps += steps_per_epoch;
+        stats.samples += epoch_samples;
+        stats.loss = static_cast<float>(std::accumulate(worker_loss.begin(), worker_loss.end(), 0.0) /
+                                        std::max<size_t>(1, epoch_samples));
+
+        if (config.log) {
+            // Строка собирается отдельно, чтобы формат чисел не оставался в config.log
+            std::ostringstream line;
+            line << "Epoch " << epoch << ", Loss: " << stats.loss
+                 << ", " << std::fixed << std::setprecision(1) << epoch_samples / epoch_seconds << " samples/s"
+                 << ", staleness " << std::setprecision(2) << getMeanStaleness()
+                 << " (max " << getMaxStaleness() << ")\n";
+            *config.log << line.str();
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(clock::now() - fit_start).count();
+
+    if (config.log) {
+        config.log->flush();
+    }
+    return stats;
+}
+
+// Количество рабочих потоков
+size_t HogwildTrainer::getNumWorkers() const {
+    return replicas.size() + 1;
+}
+
+// Примененные обновления
+size_t HogwildTrainer::getUpdates() const {
+    return version.load();
+}
+
+// Средняя задержка обновления
+double HogwildTrainer::getMeanStaleness() const {
+    size_t updates = version.load();
+    return updates > 0 ? static_cast<double>(staleness_sum.load()) / updates : 0.0;
+}
+
+// Максимальная задержка обновления
+size_t HogwildTrainer::getMaxStaleness() const {
+    return staleness_max.load();
+}
+
+// Доля пропущенных блоков
+double HogwildTrainer::getSkippedFraction() const {
+    size_t total = blocks_total.load();
+    return total > 0 ? static_cast<double>(blocks_skipped.load()) / total : 0.0;
+}
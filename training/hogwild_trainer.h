@@ -0,0 +1,59 @@
+#ifndef HOGWILD_TRAINER_H
+#define HOGWILD_TRAINER_H
+
+#include "trainer.h"
+#include "utils/thread_pool.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Асинхронное обучение без блокировок (Hogwild).
+// Каждый рабочий поток берет очередной мини-батч, выполняет прямой и обратный проход на своей
+// реплике модели и сразу применяет шаг SGD к общим весам, не дожидаясь остальных потоков.
+// Чтение весов не синхронизируется, запись выполняется поэлементно relaxed-атомиками;
+// блоки весов с нулевым градиентом (строки DenseLayer для нулевых входов) пропускаются,
+// поэтому для разреженных данных потоки редко пишут в одну и ту же память.
+class HogwildTrainer {
+public:
+    // num_workers = 0 — по числу аппаратных потоков. Используется learning_rate из config.
+    HogwildTrainer(Model& model, Loss& loss, const TrainerConfig& config, size_t num_workers = 0);
+
+    // Обучить модель на наборе данных
+    TrainingStats fit(const Dataset& dataset);
+
+    // Количество рабочих потоков
+    size_t getNumWorkers() const;
+
+    // Счетчики: примененные обновления, средняя и максимальная задержка обновления
+    // (сколько обновлений других потоков произошло между чтением весов и записью шага)
+    size_t getUpdates() const;
+    double getMeanStaleness() const;
+    size_t getMaxStaleness() const;
+
+    // Доля пропущенных блоков весов (нулевой градиент) среди всех просмотренных
+    double getSkippedFraction() const;
+
+private:
+    Model& model;
+    Loss& loss;
+    TrainerConfig config;
+    std::mt19937 rng;                             // Генератор для перемешивания
+    std::vector<std::unique_ptr<Model>> replicas; // Реплики 1..N-1 (реплика 0 — исходная модель)
+    std::vector<std::unique_ptr<Loss>> losses;    // Функции потерь реплик 1..N-1
+    ThreadPool pool;                              // N-1 рабочих потоков + вызывающий
+
+    std::atomic<size_t> version{0};        // Количество примененных обновлений
+    std::atomic<size_t> staleness_sum{0};  // Сумма задержек
+    std::atomic<size_t> staleness_max{0};  // Максимальная задержка
+    std::atomic<size_t> blocks_total{0};   // Просмотренные блоки весов
+    std::atomic<size_t> blocks_skipped{0}; // Блоки с нулевым градиентом
+
+    // Модель и функция потерь потока w
+    Model& worker(size_t w);
+    Loss& workerLoss(size_t w);
+
+    // Применить шаг SGD из градиентов потока к общим весам и обнулить градиенты
+    void applyUpdate(ParameterRegistry& gradients, float* shared_values);
+};
+
+#endif // HOGWILD_TRAINER_H
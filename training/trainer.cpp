@@ -0,0 +1,434 @@
+#include "trainer.h"
+#include "optimizers/sgd.h"
+#include "utils/profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+// Вид на строки батча
+Tensor batchRows(const Tensor& batch, size_t begin, size_t count) {
+    std::vector<size_t> shape = batch.shape();
+    size_t stride = batch.size() / shape[0];
+    shape[0] = count;
+    return Tensor::view(const_cast<float*>(batch.data()) + begin * stride, shape);
+}
+
+// Примеры в секунду
+double TrainingStats::samplesPerSecond() const {
+    return seconds > 0.0 ? samples / seconds : 0.0;
+}
+
+// Время на один шаг
+double TrainingStats::secondsPerStep() const {
+    return steps > 0 ? seconds / steps : 0.0;
+}
+
+// Конструктор (SGD по умолчанию)
+Trainer::Trainer(Model& model, Loss& loss, const TrainerConfig& config)
+    : model(model), loss(loss), owned_optimizer(new SGD(config.learning_rate)),
+      optimizer(owned_optimizer.get()), config(config), rng(config.seed) {
+    if (config.batch_size == 0) {
+        throw std::invalid_argument("Batch size must be positive.");
+    }
+}
+
+// Конструктор с заданным оптимизатором
+Trainer::Trainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config)
+    : model(model), loss(loss), optimizer(&optimizer), config(config), rng(config.seed) {
+    if (config.batch_size == 0) {
+        throw std::invalid_argument("Batch size must be positive.");
+    }
+}
+
+// Один шаг обучения
+float Trainer::trainStep(const Tensor& inputs, const Tensor& targets) {
+    ParameterRegistry& parameters = model.getParameters();
+    Tensor output = model.predict(inputs);
+    float value = loss.forward(output, targets);
+    parameters.zeroGrad();
+    model.backward(loss.backward());
+    optimizer->step(parameters);
+    return value;
+}
+
+// Обучить модель на наборе данных
+TrainingStats Trainer::fit(const Dataset& dataset) {
+    size_t num_samples = dataset.size();
+    size_t batch_size = std::min(config.batch_size, num_samples);
+    if (batch_size == 0) {
+        throw std::invalid_argument("Dataset is empty.");
+    }
+
+    // Формы батчей: (batch_size, ...форма примера)
+    auto batchShape = [](size_t count, std::vector<size_t> shape) {
+        shape.insert(shape.begin(), count);
+        return shape;
+    };
+    Tensor batch_inputs(batchShape(batch_size, dataset.inputShape()));
+    Tensor batch_targets(batchShape(batch_size, dataset.targetShape()));
+
+    // Неполный последний батч хранится отдельно, чтобы не перевыделять основной
+    size_t tail = num_samples % batch_size;
+    Tensor tail_inputs(batchShape(tail, dataset.inputShape()));
+    Tensor tail_targets(batchShape(tail, dataset.targetShape()));
+    size_t steps_per_epoch = num_samples / batch_size + ((tail && !config.drop_last) ? 1 : 0);
+
+    std::vector<size_t> indices(num_samples);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    // Без перемешивания батч — подряд идущие примеры, и набор может выдать его без копирования
+    Tensor view_inputs({0});
+    Tensor view_targets({0});
+
+    return run(
+        steps_per_epoch,
+        [&](bool restore) {
+            if (!restore) {
+                position.order = indices;
+                position.generator = rng;
+                return;
+            }
+            if (position.order.size() != num_samples) {
+                throw std::invalid_argument("Checkpoint does not match the dataset size.");
+            }
+            indices = position.order;
+            rng = position.generator;
+        },
+        [&](size_t) {
+            if (config.shuffle) {
+                std::shuffle(indices.begin(), indices.end(), rng);
+            }
+        },
+        [&](size_t step) {
+            size_t start = step * batch_size;
+            size_t count = std::min(batch_size, num_samples - start);
+            if (!config.shuffle && dataset.viewBatch(start, count, view_inputs, view_targets)) {
+                return StepBatch{&view_inputs, &view_targets, count};
+            }
+            Tensor& inputs = count == batch_size ? batch_inputs : tail_inputs;
+            Tensor& targets = count == batch_size ? batch_targets : tail_targets;
+            dataset.getBatch(indices.data() + start, count, inputs, targets);
+            return StepBatch{&inputs, &targets, count};
+        },
+        nullptr);
+}
+
+// Обучить модель на батчах конвейера данных
+TrainingStats Trainer::fit(DataPipeline& pipeline) {
+    pipeline.resetMetrics();
+    return run(
+        pipeline.stepsPerEpoch(),
+        [&](bool restore) {
+            if (restore) {
+                pipeline.setShuffleState(position.order, position.generator);
+            } else {
+                pipeline.getShuffleState(position.order, position.generator);
+            }
+        },
+        [&](size_t first_step) {
+            // Продолжение эпохи: батчи уже пройденных шагов собираются заново и пропускаются
+            pipeline.startEpoch();
+            for (size_t step = 0; step < first_step; ++step) {
+                pipeline.next();
+            }
+        },
+        [&](size_t) {
+            const PipelineBatch* batch = pipeline.next();
+            if (!batch) {
+                throw std::logic_error("Data pipeline ended the epoch early.");
+            }
+            return StepBatch{&batch->inputs, &batch->targets, batch->count};
+        },
+        [&](std::ostream& out) {
+            PipelineMetrics metrics = pipeline.getMetrics();
+            // Показатели накапливаются с начала обучения
+            std::ostringstream line;
+            line << "  input: stall " << std::fixed << std::setprecision(3) << metrics.stall_seconds << " s in "
+                 << metrics.stalls << " waits, queue depth " << std::setprecision(2) << metrics.queue_depth
+                 << ", produce " << std::setprecision(3) << metrics.produce_seconds << " s\n";
+            out << line.str();
+        });
+}
+
+// Общий цикл обучения
+TrainingStats Trainer::run(size_t steps_per_epoch, const std::function<void(bool)>& shuffle_state,
+                           const std::function<void(size_t)>& begin_epoch,
+                           const std::function<StepBatch(size_t)>& next_batch,
+                           const std::function<void(std::ostream&)>& report_epoch) {
+    using clock = std::chrono::steady_clock;
+
+    model.setLayerTiming(config.report_layers);
+    model.resetLayerTimings();
+    static const uint32_t step_profile_id = Profiler::global().intern("train.step", "train");
+    bool profiling = !config.trace_path.empty();
+    bool was_profiling = Profiler::enabled();
+    if (profiling) {
+        Profiler::global().clear();
+        Profiler::global().setEnabled(true);
+    }
+
+    // Продолжение восстановленной контрольной точки или обучение с начала
+    bool resume = resuming;
+    resuming = false;
+    if (resume) {
+        if (position.step > steps_per_epoch) {
+            throw std::invalid_argument("Checkpoint does not match the number of steps per epoch.");
+        }
+        shuffle_state(true);
+    } else {
+        position = TrainingPosition();
+        shuffle_state(false);
+    }
+
+    TrainingStats stats;
+    auto fit_start = clock::now();
+    for (size_t epoch = position.epoch; epoch < config.epochs; ++epoch) {
+        size_t first_step = resume ? position.step : 0;
+        begin_epoch(first_step);
+
+        auto epoch_start = clock::now();
+        auto interval_start = epoch_start;
+        double epoch_loss = resume ? position.epoch_loss : 0.0;
+        double interval_loss = 0.0;
+        size_t interval_steps = 0;
+        size_t interval_samples = 0;
+        size_t epoch_samples = resume ? position.epoch_samples : 0;
+        resume = false;
+
+        for (size_t step = first_step; step < steps_per_epoch; ++step) {
+            StepBatch batch = next_batch(step);
+            float value;
+            {
+                ProfileScope scope(step_profile_id);
+                value = trainStep(*batch.inputs, *batch.targets);
+            }
+            size_t count = batch.count;
+
+            epoch_loss += value * count;
+            interval_loss += value;
+            interval_steps += 1;
+            interval_samples += count;
+            epoch_samples += count;
+            stats.steps += 1;
+
+            position.step = step + 1;
+            position.total_steps += 1;
+            position.epoch_loss = epoch_loss;
+            position.epoch_samples = epoch_samples;
+            if (!config.checkpoint_path.empty() && config.checkpoint_interval &&
+                position.total_steps % config.checkpoint_interval == 0) {
+                checkpoint(stats);
+            }
+
+            if (config.log && config.log_interval && stats.steps % config.log_interval == 0) {
+                double seconds = std::chrono::duration<double>(clock::now() - interval_start).count();
+                // Строка собирается отдельно, чтобы формат чисел не оставался в config.log
+                std::ostringstream line;
+                line << "Epoch " << epoch << ", step " << step + 1 << "/" << steps_per_epoch
+                     << ", loss: " << interval_loss / interval_steps
+                     << ", " << std::fixed << std::setprecision(1) << interval_samples / seconds << " samples/s"
+                     << ", " << std::setprecision(3) << 1000.0 * seconds / interval_steps << " ms/step\n";
+                *config.log << line.str();
+                interval_start = clock::now();
+                interval_loss = 0.0;
+                interval_steps = 0;
+                interval_samples = 0;
+            }
+        }
+
+        double epoch_seconds = std::chrono::duration<double>(clock::now() - epoch_start).count();
+        stats.epochs += 1;
+        stats.samples += epoch_samples;
+        stats.loss = static_cast<float>(epoch_loss / std::max<size_t>(1, epoch_samples));
+
+        // Порядок после перемешивания этой эпохи — исходный для следующей
+        position.epoch = epoch + 1;
+        position.step = 0;
+        position.epoch_loss = 0.0;
+        position.epoch_samples = 0;
+        shuffle_state(false);
+
+        if (config.log) {
+            std::ostringstream line;
+            line << "Epoch " << epoch << ", Loss: " << stats.loss
+                 << ", " << std::fixed << std::setprecision(1) << epoch_samples / epoch_seconds << " samples/s"
+                 << ", " << std::setprecision(3) << 1000.0 * epoch_seconds / std::max<size_t>(1, steps_per_epoch)
+                 << " ms/step\n";
+            *config.log << line.str();
+            if (report_epoch) {
+                report_epoch(*config.log);
+            }
+            if (config.report_layers) {
+                reportLayers(*config.log);
+                model.resetLayerTimings();
+            }
+        }
+    }
+    // Последняя точка и ожидание фоновой записи
+    if (!config.checkpoint_path.empty()) {
+        checkpoint(stats);
+        checkpoint_writer->flush();
+        if (config.log) {
+            std::ostringstream line;
+            line << "Checkpoints: " << checkpoint_writer->getWritten() << " written to "
+                 << config.checkpoint_path << ", snapshot " << std::fixed << std::setprecision(3)
+                 << stats.checkpoint_seconds << " s, background write " << checkpoint_writer->getWriteSeconds()
+                 << " s, waited " << checkpoint_writer->getStallSeconds() << " s\n";
+            *config.log << line.str();
+        }
+    }
+    stats.seconds = std::chrono::duration<double>(clock::now() - fit_start).count();
+    model.setLayerTiming(false);
+    if (profiling) {
+        Profiler::global().setEnabled(was_profiling);
+        Profiler::global().writeChromeTrace(config.trace_path);
+        if (config.log) {
+            Profiler::global().report(*config.log);
+            *config.log << "Trace written to " << config.trace_path << '\n';
+        }
+    }
+
+    if (config.log) {
+        config.log->flush();
+    }
+    return stats;
+}
+
+// Вывести время по слоям
+void Trainer::reportLayers(std::ostream& out) const {
+    const std::vector<LayerTiming>& timings = model.getLayerTimings();
+    for (size_t i = 0; i < timings.size(); ++i) {
+        const LayerTiming& t = timings[i];
+        size_t calls = std::max<size_t>(1, t.calls);
+        std::ostringstream line;
+        line << "  layer " << i << ": forward " << std::fixed << std::setprecision(3)
+             << 1000.0 * t.forward_seconds / calls << " ms, backward "
+             << 1000.0 * t.backward_seconds / calls << " ms\n";
+        out << line.str();
+    }
+}
+
+// Получить параметры обучения
+const TrainerConfig& Trainer::getConfig() const {
+    return config;
+}
+
+// Сохранить контрольную точку синхронно
+void Trainer::saveCheckpoint(const std::string& path) {
+    if (checkpoint_writer) {
+        checkpoint_writer->flush();
+    }
+    TrainingSnapshot snapshot;
+    captureSnapshot(snapshot);
+    writeCheckpoint(path, snapshot);
+}
+
+// Восстановить контрольную точку
+void Trainer::loadCheckpoint(const std::string& path) {
+    TrainingSnapshot snapshot;
+    readCheckpoint(path, snapshot);
+    restoreSnapshot(snapshot);
+}
+
+// Положение цикла обучения
+const TrainingPosition& Trainer::getPosition() const {
+    return position;
+}
+
+// Фоновая запись контрольных точек
+const CheckpointWriter* Trainer::getCheckpointWriter() const {
+    return checkpoint_writer.get();
+}
+
+// Снимок состояния обучения: копирование в переиспользуемые буферы снимка
+void Trainer::captureSnapshot(TrainingSnapshot& snapshot) {
+    ParameterRegistry& parameters = model.getParameters();
+    if (snapshot.parameters.size() != parameters.size()) {
+        snapshot.parameters.resize(parameters.size());
+    }
+    std::memcpy(snapshot.parameters.data(), parameters.values(), parameters.size() * sizeof(float));
+    const std::vector<ParameterRegistry::Entry>& entries = parameters.entries();
+    snapshot.parameter_names.resize(entries.size());
+    snapshot.parameter_offsets.resize(entries.size());
+    snapshot.parameter_sizes.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        snapshot.parameter_names[i] = entries[i].name;
+        snapshot.parameter_offsets[i] = entries[i].offset;
+        snapshot.parameter_sizes[i] = entries[i].size;
+    }
+
+    const std::vector<std::shared_ptr<Layer>>& layers = model.getLayers();
+    snapshot.layer_states.resize(layers.size());
+    for (size_t i = 0; i < layers.size(); ++i) {
+        std::ostringstream state;
+        layers[i]->saveTrainingState(state);
+        snapshot.layer_states[i] = state.str();
+    }
+
+    snapshot.learning_rate = optimizer->learning_rate;
+    snapshot.optimizer_step = optimizer->getStep();
+    std::vector<AlignedBuffer*> buffers = optimizer->stateBuffers();
+    snapshot.optimizer_buffers.resize(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        AlignedBuffer& copy = snapshot.optimizer_buffers[i];
+        if (copy.size() != buffers[i]->size()) {
+            copy.resize(buffers[i]->size());
+        }
+        std::memcpy(copy.data(), buffers[i]->data(), buffers[i]->size() * sizeof(float));
+    }
+
+    snapshot.position = position;
+}
+
+// Восстановить состояние обучения из снимка
+void Trainer::restoreSnapshot(const TrainingSnapshot& snapshot) {
+    ParameterRegistry& parameters = model.getParameters();
+    const std::vector<ParameterRegistry::Entry>& entries = parameters.entries();
+    bool matches = snapshot.parameters.size() == parameters.size() && snapshot.parameter_names.size() == entries.size();
+    for (size_t i = 0; matches && i < entries.size(); ++i) {
+        matches = snapshot.parameter_names[i] == entries[i].name && snapshot.parameter_offsets[i] == entries[i].offset &&
+                  snapshot.parameter_sizes[i] == entries[i].size;
+    }
+    const std::vector<std::shared_ptr<Layer>>& layers = model.getLayers();
+    if (!matches || snapshot.layer_states.size() != layers.size()) {
+        throw std::invalid_argument("Checkpoint does not match the model parameters.");
+    }
+    std::vector<AlignedBuffer*> buffers = optimizer->stateBuffers();
+    if (snapshot.optimizer_buffers.size() != buffers.size()) {
+        throw std::invalid_argument("Checkpoint does not match the optimizer.");
+    }
+
+    std::memcpy(parameters.values(), snapshot.parameters.data(), parameters.size() * sizeof(float));
+    for (size_t i = 0; i < layers.size(); ++i) {
+        std::istringstream state(snapshot.layer_states[i]);
+        layers[i]->loadTrainingState(state);
+    }
+
+    optimizer->learning_rate = snapshot.learning_rate;
+    optimizer->setStep(snapshot.optimizer_step);
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        const AlignedBuffer& saved = snapshot.optimizer_buffers[i];
+        if (buffers[i]->size() != saved.size()) {
+            buffers[i]->resize(saved.size());
+        }
+        std::memcpy(buffers[i]->data(), saved.data(), saved.size() * sizeof(float));
+    }
+
+    position = snapshot.position;
+    resuming = true;
+}
+
+// Поставить контрольную точку в фоновую запись
+void Trainer::checkpoint(TrainingStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    if (!checkpoint_writer) {
+        checkpoint_writer.reset(new CheckpointWriter());
+    }
+    captureSnapshot(checkpoint_writer->acquire());
+    checkpoint_writer->submit(config.checkpoint_path);
+    stats.checkpoint_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
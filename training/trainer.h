@@ -0,0 +1,125 @@
+#ifndef TRAINER_H
+#define TRAINER_H
+
+#include "model.h"
+#include "data/dataset.h"
+#include "data/pipeline.h"
+#include "metrics/loss.h"
+#include "optimizers/optimizer.h"
+#include "training/checkpoint.h"
+#include <functional>
+#include <iostream>
+#include <random>
+
+// Вид на строки [begin, begin + count) батча (batch_size, ...) без копирования.
+// Вид предназначен только для чтения (например, как вход первого слоя).
+Tensor batchRows(const Tensor& batch, size_t begin, size_t count);
+
+// Параметры обучения мини-батчами
+struct TrainerConfig {
+    size_t epochs = 1;             // Количество эпох
+    size_t batch_size = 32;        // Размер мини-батча
+    float learning_rate = 0.01f;   // Скорость обучения (для SGD по умолчанию)
+    bool shuffle = true;           // Перемешивать примеры в каждой эпохе
+    bool drop_last = false;        // Отбрасывать неполный последний батч
+    unsigned seed = 42;            // Зерно генератора перемешивания
+    size_t log_interval = 0;       // Шагов между сообщениями (0 — только итоги эпохи)
+    bool report_layers = false;    // Печатать время по слоям в конце каждой эпохи
+    std::string checkpoint_path;   // Файл контрольной точки (пусто — не сохранять)
+    size_t checkpoint_interval = 0; // Шагов между контрольными точками (0 — только в конце fit)
+    std::string trace_path;        // Профилировать fit: таблица в log и временная шкала Chrome в файл
+    std::ostream* log = &std::cout; // Поток для сообщений (nullptr — без вывода)
+};
+
+// Итоги обучения
+struct TrainingStats {
+    size_t epochs = 0;       // Завершенные эпохи
+    size_t steps = 0;        // Выполненные шаги оптимизации
+    size_t samples = 0;      // Обработанные примеры
+    float loss = 0.0f;       // Средние потери последней эпохи
+    double seconds = 0.0;    // Общее время обучения
+    double checkpoint_seconds = 0.0; // Время снимков контрольных точек в потоке обучения
+
+    // Производительность
+    double samplesPerSecond() const;
+    double secondsPerStep() const;
+};
+
+// Цикл обучения мини-батчами с перемешиванием и отчетом о производительности
+class Trainer {
+public:
+    // Обучение с SGD и скоростью обучения из config
+    Trainer(Model& model, Loss& loss, const TrainerConfig& config);
+
+    // Обучение с заданным оптимизатором
+    Trainer(Model& model, Loss& loss, Optimizer& optimizer, const TrainerConfig& config);
+
+    virtual ~Trainer() = default;
+
+    // Обучить модель на наборе данных (батчи собираются в том же потоке)
+    TrainingStats fit(const Dataset& dataset);
+
+    // Обучить модель на батчах конвейера данных: следующий батч готовится в фоне,
+    // пока обучается текущий. Размер батча и перемешивание задаются конвейером.
+    TrainingStats fit(DataPipeline& pipeline);
+
+    // Один шаг обучения на готовом батче; возвращает значение функции потерь
+    virtual float trainStep(const Tensor& inputs, const Tensor& targets);
+
+    // Получить параметры обучения
+    const TrainerConfig& getConfig() const;
+
+    // Сохранить контрольную точку синхронно (вне fit — после последнего шага)
+    void saveCheckpoint(const std::string& path);
+
+    // Восстановить контрольную точку в модель такой же архитектуры и оптимизатор того же
+    // типа: следующий fit с тем же набором данных и параметрами продолжит обучение с шага,
+    // на котором точка была сохранена, и получит те же веса, что и обучение без перерыва
+    void loadCheckpoint(const std::string& path);
+
+    // Положение цикла обучения (эпоха и шаг последнего или восстановленного fit)
+    const TrainingPosition& getPosition() const;
+
+    // Фоновая запись контрольных точек (nullptr, пока точки не сохранялись)
+    const CheckpointWriter* getCheckpointWriter() const;
+
+protected:
+    Model& model;
+    Loss& loss;
+    std::unique_ptr<Optimizer> owned_optimizer; // SGD по умолчанию
+    Optimizer* optimizer;
+    TrainerConfig config;
+    std::mt19937 rng; // Генератор для перемешивания
+
+private:
+    // Батч для шага обучения
+    struct StepBatch {
+        const Tensor* inputs;
+        const Tensor* targets;
+        size_t count;
+    };
+
+    TrainingPosition position;                          // Положение цикла обучения
+    bool resuming = false;                              // Следующий fit продолжает position
+    std::unique_ptr<CheckpointWriter> checkpoint_writer; // Фоновая запись точек
+
+    // Общий цикл обучения: shuffle_state сохраняет порядок примеров и генератор в position
+    // (false) или восстанавливает их оттуда (true), begin_epoch готовит эпоху, начиная
+    // с шага first_step, next_batch возвращает батч шага
+    TrainingStats run(size_t steps_per_epoch, const std::function<void(bool)>& shuffle_state,
+                      const std::function<void(size_t)>& begin_epoch,
+                      const std::function<StepBatch(size_t)>& next_batch,
+                      const std::function<void(std::ostream&)>& report_epoch);
+
+    // Снимок состояния обучения и его восстановление
+    void captureSnapshot(TrainingSnapshot& snapshot);
+    void restoreSnapshot(const TrainingSnapshot& snapshot);
+
+    // Поставить контрольную точку в фоновую запись в config.checkpoint_path
+    void checkpoint(TrainingStats& stats);
+
+    // Вывести время по слоям
+    void reportLayers(std::ostream& out) const;
+};
+
+#endif // TRAINER_H
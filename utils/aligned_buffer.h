@@ -0,0 +1,68 @@
+#ifndef ALIGNED_BUFFER_H
+#define ALIGNED_BUFFER_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Непрерывный буфер float, выровненный по границе кэш-линии (64 байта) и обнуленный при выделении
+class AlignedBuffer {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    AlignedBuffer() : ptr(nullptr), count(0) {}
+    explicit AlignedBuffer(size_t size) : ptr(nullptr), count(0) { resize(size); }
+    ~AlignedBuffer() { std::free(ptr); }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept : ptr(other.ptr), count(other.count) {
+        other.ptr = nullptr;
+        other.count = 0;
+    }
+
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+        if (this != &other) {
+            std::free(ptr);
+            ptr = other.ptr;
+            count = other.count;
+            other.ptr = nullptr;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    // Перевыделить буфер (старое содержимое не сохраняется)
+    void resize(size_t size) {
+        std::free(ptr);
+        ptr = nullptr;
+        count = size;
+        if (size == 0) {
+            return;
+        }
+        size_t bytes = (size * sizeof(float) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        ptr = static_cast<float*>(std::aligned_alloc(ALIGNMENT, bytes));
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        std::memset(ptr, 0, bytes);
+    }
+
+    float* data() { return ptr; }
+    const float* data() const { return ptr; }
+    size_t size() const { return count; }
+
+    // Число float, кратное выравниванию (для размещения тензоров с выровненными началами)
+    static size_t alignedCount(size_t size) {
+        const size_t per_line = ALIGNMENT / sizeof(float);
+        return (size + per_line - 1) / per_line * per_line;
+    }
+
+private:
+    float* ptr;   // Выровненная память
+    size_t count; // Количество элементов
+};
+
+#endif // ALIGNED_BUFFER_H
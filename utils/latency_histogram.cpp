@@ -0,0 +1,89 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double min_seconds = 1e-6;  // Нижняя граница первой корзины
+const double growth = 1.04;       // Отношение границ соседних корзин
+const size_t num_buckets = 472;   // 1.04^472 * 1 мкс ≈ 110 с
+}
+
+// Конструктор
+LatencyHistogram::LatencyHistogram() : buckets(num_buckets, 0) {
+}
+
+// Номер корзины значения (значения вне диапазона попадают в крайние корзины)
+size_t LatencyHistogram::bucketOf(double seconds) {
+    if (seconds <= min_seconds) {
+        return 0;
+    }
+    size_t bucket = static_cast<size_t>(std::log(seconds / min_seconds) / std::log(growth)) + 1;
+    return std::min(bucket, num_buckets - 1);
+}
+
+// Представитель корзины: среднее геометрическое ее границ
+double LatencyHistogram::bucketValue(size_t bucket) {
+    if (bucket == 0) {
+        return min_seconds;
+    }
+    return min_seconds * std::pow(growth, static_cast<double>(bucket) - 0.5);
+}
+
+// Добавить значение
+void LatencyHistogram::record(double seconds) {
+    buckets[bucketOf(seconds)] += 1;
+    total += 1;
+    sum += seconds;
+    maximum = std::max(maximum, seconds);
+}
+
+// Перцентиль
+double LatencyHistogram::percentile(double p) const {
+    if (total == 0) {
+        return 0.0;
+    }
+    // Номер значения (с единицы), которое не меньше p% всех значений
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * total));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(bucketValue(i), maximum);
+        }
+    }
+    return maximum;
+}
+
+// Количество значений
+size_t LatencyHistogram::count() const {
+    return total;
+}
+
+// Среднее
+double LatencyHistogram::mean() const {
+    return total ? sum / total : 0.0;
+}
+
+// Максимум
+double LatencyHistogram::max() const {
+    return maximum;
+}
+
+// Объединить гистограммы
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    maximum = std::max(maximum, other.maximum);
+}
+
+// Сбросить
+void LatencyHistogram::reset() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    total = 0;
+    sum = 0.0;
+    maximum = 0.0;
+}
@@ -0,0 +1,41 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Гистограмма задержек с логарифмическими корзинами: относительная ошибка перцентилей
+// не больше ~2% на всем диапазоне от 1 мкс до ~100 с при фиксированном объеме памяти.
+// Не потокобезопасна: внешняя синхронизация на стороне владельца.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    // Добавить значение в секундах
+    void record(double seconds);
+
+    // Перцентиль (0..100) в секундах; 0, если значений нет
+    double percentile(double p) const;
+
+    // Количество значений, среднее и максимум в секундах
+    size_t count() const;
+    double mean() const;
+    double max() const;
+
+    // Добавить значения другой гистограммы
+    void merge(const LatencyHistogram& other);
+
+    void reset();
+
+private:
+    std::vector<uint64_t> buckets;
+    size_t total = 0;
+    double sum = 0.0;
+    double maximum = 0.0;
+
+    static size_t bucketOf(double seconds);
+    static double bucketValue(size_t bucket);
+};
+
+#endif // LATENCY_HISTOGRAM_H
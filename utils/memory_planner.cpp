@@ -0,0 +1,83 @@
+#include "memory_planner.h"
+#include "aligned_buffer.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+// Добавить буфер
+size_t MemoryPlanner::add(size_t size, size_t first, size_t last) {
+    if (first > last) {
+        throw std::invalid_argument("Buffer lifetime must not end before it starts.");
+    }
+    buffers.push_back({AlignedBuffer::alignedCount(size), first, last, 0});
+    return buffers.size() - 1;
+}
+
+// Продлить жизнь буфера
+void MemoryPlanner::extend(size_t id, size_t step) {
+    Buffer& buffer = buffers.at(id);
+    buffer.first = std::min(buffer.first, step);
+    buffer.last = std::max(buffer.last, step);
+}
+
+// Разместить буферы
+size_t MemoryPlanner::plan() {
+    // Большие буферы первыми; при равенстве — раньше рожденные (размещение детерминировано)
+    std::vector<size_t> order(buffers.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buffers[a].size > buffers[b].size;
+    });
+
+    total = 0;
+    std::vector<size_t> placed;
+    std::vector<std::pair<size_t, size_t>> busy; // Занятые отрезки адресов пересекающихся буферов
+    for (size_t id : order) {
+        Buffer& buffer = buffers[id];
+        busy.clear();
+        for (size_t other : placed) {
+            const Buffer& b = buffers[other];
+            if (b.first <= buffer.last && buffer.first <= b.last && b.size > 0) {
+                busy.push_back({b.offset, b.offset + b.size});
+            }
+        }
+        std::sort(busy.begin(), busy.end());
+
+        // Наименьшее смещение, с которого буфер помещается между занятыми отрезками
+        size_t offset = 0;
+        for (const auto& range : busy) {
+            if (range.first >= offset + buffer.size) {
+                break;
+            }
+            offset = std::max(offset, range.second);
+        }
+        buffer.offset = offset;
+        total = std::max(total, offset + buffer.size);
+        placed.push_back(id);
+    }
+    return total;
+}
+
+// Смещение буфера
+size_t MemoryPlanner::offset(size_t id) const {
+    return buffers.at(id).offset;
+}
+
+// Размер области
+size_t MemoryPlanner::totalSize() const {
+    return total;
+}
+
+// Сумма размеров буферов
+size_t MemoryPlanner::naiveSize() const {
+    size_t sum = 0;
+    for (const Buffer& buffer : buffers) {
+        sum += buffer.size;
+    }
+    return sum;
+}
+
+// Количество буферов
+size_t MemoryPlanner::numBuffers() const {
+    return buffers.size();
+}
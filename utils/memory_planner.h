@@ -0,0 +1,43 @@
+#ifndef MEMORY_PLANNER_H
+#define MEMORY_PLANNER_H
+
+#include <cstddef>
+#include <vector>
+
+// Размещение буферов с известным временем жизни в одной непрерывной области памяти.
+// Время жизни — отрезок шагов [first, last]; буферы, жизни которых не пересекаются,
+// могут занимать одни и те же адреса. Размещение жадное: буферы по убыванию размера
+// ставятся в наименьшее смещение, свободное от уже размещенных пересекающихся буферов.
+class MemoryPlanner {
+public:
+    // Добавить буфер из size float, живой на шагах [first, last]; возвращает номер буфера
+    size_t add(size_t size, size_t first, size_t last);
+
+    // Продлить жизнь буфера так, чтобы она включала шаг step
+    void extend(size_t id, size_t step);
+
+    // Разместить буферы; возвращает размер области в float
+    size_t plan();
+
+    // Смещение буфера в области (в float, кратно 64 байтам)
+    size_t offset(size_t id) const;
+
+    // Размер области после plan() и сумма размеров всех буферов (без повторного использования)
+    size_t totalSize() const;
+    size_t naiveSize() const;
+
+    size_t numBuffers() const;
+
+private:
+    struct Buffer {
+        size_t size;   // Выровненный размер
+        size_t first;  // Первый шаг жизни
+        size_t last;   // Последний шаг жизни
+        size_t offset; // Смещение после размещения
+    };
+
+    std::vector<Buffer> buffers;
+    size_t total = 0;
+};
+
+#endif // MEMORY_PLANNER_H
@@ -0,0 +1,246 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+std::atomic<bool> Profiler::active{false};
+
+namespace {
+// Включение по переменной окружения и запись временной шкалы при завершении процесса
+struct EnvironmentProfile {
+    std::string path;
+
+    EnvironmentProfile() {
+        if (const char* env = std::getenv("KOKORO_PROFILE")) {
+            path = env;
+            Profiler::global().setEnabled(true);
+        }
+    }
+
+    ~EnvironmentProfile() {
+        if (!path.empty()) {
+            try {
+                Profiler::global().writeChromeTrace(path);
+            } catch (...) {
+            }
+        }
+    }
+} environment_profile;
+
+// Экранировать строку для JSON
+void writeJsonString(std::ostream& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+}
+
+// Достигнутая производительность
+double ProfileSummary::gflops() const {
+    return seconds > 0.0 ? flops / seconds * 1e-9 : 0.0;
+}
+
+double ProfileSummary::gbytesPerSecond() const {
+    return seconds > 0.0 ? bytes / seconds * 1e-9 : 0.0;
+}
+
+// Конструктор
+Profiler::Profiler() : origin(clock::now()) {}
+
+// Общий профилировщик процесса
+Profiler& Profiler::global() {
+    static Profiler profiler;
+    return profiler;
+}
+
+// Включить или выключить запись
+void Profiler::setEnabled(bool enabled) {
+    active.store(enabled, std::memory_order_relaxed);
+}
+
+// Идентификатор имени области
+uint32_t Profiler::intern(const std::string& name, const std::string& category) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = ids.find(name);
+    if (found != ids.end()) {
+        return found->second;
+    }
+    uint32_t id = static_cast<uint32_t>(entries.size());
+    Entry entry;
+    entry.name = name;
+    entry.category = category;
+    entries.push_back(entry);
+    ids.emplace(name, id);
+    return id;
+}
+
+// Записать область
+void Profiler::record(uint32_t id, clock::time_point start, clock::time_point end, double flops, double bytes) {
+    int64_t start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+    int64_t duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    uint32_t thread = threadIndex();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& entry = entries[id];
+    entry.calls += 1;
+    entry.total_ns += duration_ns;
+    entry.flops += flops;
+    entry.bytes += bytes;
+    if (events.size() < max_events) {
+        events.push_back({id, thread, start_ns, duration_ns, flops, bytes});
+    } else {
+        dropped += 1;
+    }
+}
+
+// Предел количества событий
+void Profiler::setMaxEvents(size_t max_events) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->max_events = max_events;
+}
+
+// Итоги по именам
+std::vector<ProfileSummary> Profiler::summary() const {
+    std::vector<ProfileSummary> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Entry& entry : entries) {
+            if (entry.calls == 0) {
+                continue;
+            }
+            ProfileSummary item;
+            item.name = entry.name;
+            item.category = entry.category;
+            item.calls = entry.calls;
+            item.seconds = entry.total_ns * 1e-9;
+            item.flops = entry.flops;
+            item.bytes = entry.bytes;
+            result.push_back(item);
+        }
+    }
+    std::sort(result.begin(), result.end(),
+              [](const ProfileSummary& a, const ProfileSummary& b) { return a.seconds > b.seconds; });
+    return result;
+}
+
+// Напечатать таблицу итогов
+void Profiler::report(std::ostream& out) const {
+    for (const auto& item : getInfo()) {
+        out << item.first << ": " << item.second << "\n";
+    }
+    std::vector<ProfileSummary> items = summary();
+    double total = 0.0;
+    size_t width = 8;
+    for (const ProfileSummary& item : items) {
+        // Проходы слоев и шаг оптимизатора не пересекаются; объемлющие области (шаг обучения) —
+        // отдельная категория и в сумму не входят
+        if (item.category != "train") {
+            total += item.seconds;
+        }
+        width = std::max(width, item.name.size() + 2);
+    }
+    // Таблица собирается в своем потоке: точность и выравнивание не меняют out
+    std::ostringstream table;
+    table << std::left << std::setw(static_cast<int>(width)) << "region" << std::right << std::setw(9) << "calls"
+        << std::setw(12) << "total ms" << std::setw(11) << "avg us" << std::setw(8) << "%" << std::setw(10)
+        << "GFLOP/s" << std::setw(9) << "GB/s" << "\n";
+    for (const ProfileSummary& item : items) {
+        table << std::left << std::setw(static_cast<int>(width)) << item.name << std::right << std::setw(9)
+            << item.calls << std::fixed << std::setprecision(3) << std::setw(12) << item.seconds * 1e3
+            << std::setprecision(1) << std::setw(11) << item.seconds * 1e6 / item.calls << std::setw(8)
+            << (item.category != "train" && total > 0.0 ? 100.0 * item.seconds / total : 0.0) << std::setprecision(2)
+            << std::setw(10) << item.gflops() << std::setw(9) << item.gbytesPerSecond() << "\n";
+    }
+    out << table.str();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (dropped) {
+        out << dropped << " trace events dropped (limit " << max_events << ")\n";
+    }
+}
+
+// Записать временную шкалу
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Шкала может быть большой, поэтому пишется прямо в out, а формат чисел восстанавливается в конце
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{";
+    for (size_t i = 0; i < info.size(); ++i) {
+        out << (i ? "," : "");
+        writeJsonString(out, info[i].first);
+        out << ":";
+        writeJsonString(out, info[i].second);
+    }
+    out << "},\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& event = events[i];
+        const Entry& entry = entries[event.id];
+        out << (i ? ",\n" : "\n") << "{\"name\":";
+        writeJsonString(out, entry.name);
+        out << ",\"cat\":";
+        writeJsonString(out, entry.category);
+        out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << std::fixed << std::setprecision(3)
+            << ",\"ts\":" << event.start_ns * 1e-3 << ",\"dur\":" << event.duration_ns * 1e-3
+            << std::setprecision(0) << ",\"args\":{\"flops\":" << event.flops << ",\"bytes\":" << event.bytes
+            << "}}";
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot create trace file: " + path);
+    }
+    writeChromeTrace(file);
+}
+
+// Удалить события и итоги
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Entry& entry : entries) {
+        entry.calls = 0;
+        entry.total_ns = 0;
+        entry.flops = 0.0;
+        entry.bytes = 0.0;
+    }
+    events.clear();
+    dropped = 0;
+}
+
+// Сведения о запуске
+void Profiler::setInfo(const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& item : info) {
+        if (item.first == key) {
+            item.second = value;
+            return;
+        }
+    }
+    info.emplace_back(key, value);
+}
+
+std::vector<std::pair<std::string, std::string>> Profiler::getInfo() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return info;
+}
+
+// Номер текущего потока
+uint32_t Profiler::threadIndex() {
+    static std::atomic<uint32_t> next{0};
+    thread_local uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
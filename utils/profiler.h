@@ -0,0 +1,148 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Итоги профиля по одному имени области
+struct ProfileSummary {
+    std::string name;
+    std::string category;
+    size_t calls = 0;
+    double seconds = 0.0; // Суммарное время
+    double flops = 0.0;   // Суммарные операции с плавающей точкой
+    double bytes = 0.0;   // Суммарные прочитанные и записанные байты
+
+    // Достигнутая производительность
+    double gflops() const;
+    double gbytesPerSecond() const;
+};
+
+// Профилировщик процесса: замеры областей (проходы слоев, шаг оптимизатора) с оценкой
+// операций и байтов, итоговая таблица и временная шкала в формате Chrome trace_event
+// (chrome://tracing, Perfetto).
+//
+// Выключенный профилировщик стоит одну проверку флага на область; сборка с
+// KOKORO_NO_PROFILER убирает и ее. Включенный — два чтения часов и короткая запись
+// под блокировкой на область, поэтому его можно держать включенным в рабочем процессе.
+// Переменная окружения KOKORO_PROFILE=<файл> включает профилировщик при запуске
+// и записывает временную шкалу в файл при завершении процесса.
+class Profiler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Общий профилировщик процесса
+    static Profiler& global();
+
+#ifdef KOKORO_NO_PROFILER
+    static constexpr bool enabled() { return false; }
+#else
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+#endif
+
+    // Включить или выключить запись
+    void setEnabled(bool enabled);
+
+    // Идентификатор имени области (повторный вызов с тем же именем возвращает тот же)
+    uint32_t intern(const std::string& name, const std::string& category);
+
+    // Записать область: время, операции и байты
+    void record(uint32_t id, clock::time_point start, clock::time_point end, double flops, double bytes);
+
+    // Предел количества событий временной шкалы: после него события не сохраняются,
+    // а итоги продолжают накапливаться (по умолчанию 1 << 20)
+    void setMaxEvents(size_t max_events);
+
+    // Итоги по именам в порядке убывания времени
+    std::vector<ProfileSummary> summary() const;
+
+    // Напечатать таблицу итогов
+    void report(std::ostream& out) const;
+
+    // Записать временную шкалу в формате Chrome trace_event (JSON)
+    void writeChromeTrace(std::ostream& out) const;
+    void writeChromeTrace(const std::string& path) const;
+
+    // Удалить события и итоги (имена и сведения сохраняются)
+    void clear();
+
+    // Сведения о запуске (например, выбранные ядра): печатаются перед таблицей итогов
+    // и записываются во временную шкалу как otherData. Повторный вызов заменяет значение
+    void setInfo(const std::string& key, const std::string& value);
+    std::vector<std::pair<std::string, std::string>> getInfo() const;
+
+private:
+    Profiler();
+
+    // Событие временной шкалы
+    struct Event {
+        uint32_t id;
+        uint32_t thread;
+        int64_t start_ns; // От начала отсчета профилировщика
+        int64_t duration_ns;
+        double flops;
+        double bytes;
+    };
+
+    // Имя области и ее итоги
+    struct Entry {
+        std::string name;
+        std::string category;
+        size_t calls = 0;
+        int64_t total_ns = 0;
+        double flops = 0.0;
+        double bytes = 0.0;
+    };
+
+    static std::atomic<bool> active;
+
+    clock::time_point origin;
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<Event> events;
+    size_t max_events = size_t(1) << 20;
+    size_t dropped = 0; // События сверх предела
+    std::vector<std::pair<std::string, std::string>> info; // Сведения о запуске
+
+    // Номер текущего потока на временной шкале
+    static uint32_t threadIndex();
+};
+
+// Замер области видимости: запись выполняется в деструкторе, если профилировщик был
+// включен при входе в область
+class ProfileScope {
+public:
+    ProfileScope(uint32_t id, double flops = 0.0, double bytes = 0.0)
+        : id(id), flops(flops), bytes(bytes), running(Profiler::enabled()) {
+        if (running) {
+            start = Profiler::clock::now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (running) {
+            Profiler::global().record(id, start, Profiler::clock::now(), flops, bytes);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    uint32_t id;
+    double flops;
+    double bytes;
+    bool running;
+    Profiler::clock::time_point start;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,86 @@
+#include "stage_pipeline.h"
+#include <stdexcept>
+
+// Конструктор: поток на каждую стадию
+StagePipeline::StagePipeline(std::vector<Stage> stages) : stages(std::move(stages)) {
+    if (this->stages.empty()) {
+        throw std::invalid_argument("Pipeline must have at least one stage.");
+    }
+    for (size_t i = 0; i < this->stages.size(); ++i) {
+        queues.emplace_back(new Queue());
+    }
+    for (size_t i = 0; i < this->stages.size(); ++i) {
+        threads.emplace_back(&StagePipeline::stageLoop, this, i);
+    }
+}
+
+// Деструктор: закрыть вход; каждая стадия дорабатывает очередь и закрывает следующую
+StagePipeline::~StagePipeline() {
+    {
+        std::lock_guard<std::mutex> lock(queues.front()->mutex);
+        queues.front()->closed = true;
+    }
+    queues.front()->ready.notify_one();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// Поставить элемент в очередь первой стадии
+void StagePipeline::push(Tensor data, Done done) {
+    enqueue(0, Item{std::move(data), std::move(done), nullptr});
+}
+
+// Количество стадий
+size_t StagePipeline::numStages() const {
+    return stages.size();
+}
+
+// Передать элемент стадии
+void StagePipeline::enqueue(size_t stage, Item&& item) {
+    Queue& queue = *queues[stage];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.items.push_back(std::move(item));
+    }
+    queue.ready.notify_one();
+}
+
+// Цикл стадии
+void StagePipeline::stageLoop(size_t stage) {
+    Queue& queue = *queues[stage];
+    bool last = stage + 1 == stages.size();
+    while (true) {
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        queue.ready.wait(lock, [&] { return queue.closed || !queue.items.empty(); });
+        if (queue.items.empty()) {
+            break;
+        }
+        Item item = std::move(queue.items.front());
+        queue.items.pop_front();
+        lock.unlock();
+
+        if (!item.error) {
+            try {
+                stages[stage](item.data);
+            } catch (...) {
+                item.error = std::current_exception();
+            }
+        }
+        if (last) {
+            item.done(std::move(item.data), item.error);
+        } else {
+            enqueue(stage + 1, std::move(item));
+        }
+    }
+
+    // Вход стадии закрыт и пуст: закрыть вход следующей
+    if (!last) {
+        Queue& next = *queues[stage + 1];
+        {
+            std::lock_guard<std::mutex> lock(next.mutex);
+            next.closed = true;
+        }
+        next.ready.notify_one();
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef STAGE_PIPELINE_H
+#define STAGE_PIPELINE_H
+
+#include "tensor.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Конвейер стадий: у каждой стадии свой поток и своя очередь, элементы проходят стадии
+// по порядку, поэтому пока стадия k обрабатывает элемент n, стадия k+1 обрабатывает n-1.
+// Порядок элементов сохраняется. Исключение стадии пропускает оставшиеся стадии и
+// передается в функцию завершения элемента.
+class StagePipeline {
+public:
+    // Стадия преобразует элемент на месте
+    using Stage = std::function<void(Tensor&)>;
+    // Вызывается потоком последней стадии с результатом или исключением
+    using Done = std::function<void(Tensor&&, std::exception_ptr)>;
+
+    explicit StagePipeline(std::vector<Stage> stages);
+    // Дожидается прохождения всех поставленных элементов
+    ~StagePipeline();
+
+    StagePipeline(const StagePipeline&) = delete;
+    StagePipeline& operator=(const StagePipeline&) = delete;
+
+    // Поставить элемент в очередь первой стадии (не блокирует)
+    void push(Tensor data, Done done);
+
+    size_t numStages() const;
+
+private:
+    struct Item {
+        Tensor data;
+        Done done;
+        std::exception_ptr error;
+    };
+
+    // Очередь на входе стадии
+    struct Queue {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<Item> items;
+        bool closed = false;
+    };
+
+    std::vector<Stage> stages;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    void stageLoop(size_t stage);
+    void enqueue(size_t stage, Item&& item);
+};
+
+#endif // STAGE_PIPELINE_H
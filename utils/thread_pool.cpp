@@ -0,0 +1,113 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstdlib>
+
+// Конструктор
+ThreadPool::ThreadPool(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Деструктор
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Общий пул процесса
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool([] {
+        if (const char* env = std::getenv("KOKORO_NUM_THREADS")) {
+            long n = std::atol(env);
+            return static_cast<size_t>(n > 1 ? n - 1 : 0);
+        }
+        unsigned hw = std::thread::hardware_concurrency();
+        return static_cast<size_t>(hw > 1 ? hw - 1 : 0);
+    }());
+    return pool;
+}
+
+// Количество исполнителей
+size_t ThreadPool::concurrency() const {
+    return workers.size() + 1;
+}
+
+// Разобрать куски текущего задания
+void ThreadPool::runChunks() {
+    for (;;) {
+        size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= num_chunks) {
+            return;
+        }
+        size_t lo = job_begin + chunk * job_grain;
+        size_t hi = std::min(job_end, lo + job_grain);
+        (*job)(lo, hi);
+    }
+}
+
+// Цикл рабочего потока
+void ThreadPool::workerLoop() {
+    size_t seen_generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            work_ready.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+            ++active_workers;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --active_workers;
+        }
+        work_done.notify_all();
+    }
+}
+
+// Параллельный цикл
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain,
+                             const std::function<void(size_t, size_t)>& fn) {
+    if (begin >= end) {
+        return;
+    }
+    grain = std::max<size_t>(1, grain);
+    size_t chunks = (end - begin + grain - 1) / grain;
+
+    // Мелкие задания и пул без потоков выполняются на месте
+    if (chunks == 1 || workers.empty()) {
+        fn(begin, end);
+        return;
+    }
+
+    std::lock_guard<std::mutex> job_lock(job_mutex);
+    {
+        // Опоздавшие потоки предыдущего задания должны выйти до смены задания
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [&] { return active_workers == 0; });
+        job = &fn;
+        job_begin = begin;
+        job_end = end;
+        job_grain = grain;
+        num_chunks = chunks;
+        next_chunk.store(0, std::memory_order_relaxed);
+        ++generation;
+    }
+    work_ready.notify_all();
+
+    runChunks();
+
+    // Ждем, пока все рабочие потоки выйдут из задания
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [&] { return active_workers == 0; });
+    job = nullptr;
+}
@@ -0,0 +1,57 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул постоянных рабочих потоков для параллельных циклов.
+// Вызывающий поток тоже участвует в работе, поэтому пул из N потоков дает N+1 исполнителя.
+class ThreadPool {
+public:
+    // num_threads — количество дополнительных рабочих потоков
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Общий пул процесса: hardware_concurrency - 1 рабочих потоков
+    // (переопределяется переменной окружения KOKORO_NUM_THREADS)
+    static ThreadPool& global();
+
+    // Выполнить fn(begin, end) для кусков диапазона [begin, end) длиной не меньше grain.
+    // Возвращает управление, когда все куски обработаны.
+    void parallelFor(size_t begin, size_t end, size_t grain,
+                     const std::function<void(size_t, size_t)>& fn);
+
+    // Количество исполнителей (рабочие потоки + вызывающий)
+    size_t concurrency() const;
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+
+    // Текущее задание (одно на пул; parallelFor сериализуется мьютексом job_mutex)
+    std::mutex job_mutex;
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t job_begin = 0;
+    size_t job_end = 0;
+    size_t job_grain = 1;
+    std::atomic<size_t> next_chunk{0};
+    size_t num_chunks = 0;
+    size_t active_workers = 0;
+    size_t generation = 0;
+    bool stopping = false;
+
+    void workerLoop();
+    void runChunks();
+};
+
+#endif // THREAD_POOL_H